@@ -0,0 +1,153 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "blurquality.h"
+
+#include <QTest>
+
+using namespace std::chrono_literals;
+using namespace KWin;
+
+Q_DECLARE_METATYPE(KWin::BlurQualityController::Level)
+
+static const std::chrono::nanoseconds s_budget = 16ms;
+
+class BlurQualityTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testDegradeAndRestore();
+    void testHysteresis();
+    void testInvalidBudget();
+    void testQuality_data();
+    void testQuality();
+
+private:
+    static int framesUntilChange(BlurQualityController &controller, std::chrono::nanoseconds predictedRenderTime, int limit = 1000);
+};
+
+int BlurQualityTest::framesUntilChange(BlurQualityController &controller, std::chrono::nanoseconds predictedRenderTime, int limit)
+{
+    for (int frame = 1; frame <= limit; ++frame) {
+        if (controller.update(predictedRenderTime, s_budget)) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+void BlurQualityTest::testDegradeAndRestore()
+{
+    BlurQualityController controller;
+    QCOMPARE(controller.level(), BlurQualityController::Full);
+
+    // frames that are predicted to take almost all of the budget lower the quality step by step
+    QCOMPARE(framesUntilChange(controller, 15ms), BlurQualityController::s_degradeFrames);
+    QCOMPARE(controller.level(), BlurQualityController::ReducedResolution);
+    QCOMPARE(framesUntilChange(controller, 15ms), BlurQualityController::s_coolDownFrames + BlurQualityController::s_degradeFrames);
+    QCOMPARE(controller.level(), BlurQualityController::ReducedIterations);
+    QCOMPARE(framesUntilChange(controller, 15ms), BlurQualityController::s_coolDownFrames + BlurQualityController::s_degradeFrames);
+    QCOMPARE(controller.level(), BlurQualityController::ReducedAll);
+    QCOMPARE(framesUntilChange(controller, 20ms), -1);
+    QCOMPARE(controller.level(), BlurQualityController::ReducedAll);
+
+    // with plenty of headroom, the quality is restored, but slower than it was lowered
+    QCOMPARE(framesUntilChange(controller, 4ms), BlurQualityController::s_restoreFrames);
+    QCOMPARE(controller.level(), BlurQualityController::ReducedIterations);
+    QCOMPARE(framesUntilChange(controller, 4ms), BlurQualityController::s_coolDownFrames + BlurQualityController::s_restoreFrames);
+    QCOMPARE(controller.level(), BlurQualityController::ReducedResolution);
+    QCOMPARE(framesUntilChange(controller, 4ms), BlurQualityController::s_coolDownFrames + BlurQualityController::s_restoreFrames);
+    QCOMPARE(controller.level(), BlurQualityController::Full);
+    QCOMPARE(framesUntilChange(controller, 4ms), -1);
+
+    const BlurQualityController::Statistics statistics = controller.statistics();
+    QCOMPARE(statistics.degradations, quint64(3));
+    QCOMPARE(statistics.restorations, quint64(3));
+    QVERIFY(statistics.degradedFrames > 0);
+    QVERIFY(statistics.degradedFrames < statistics.frames);
+
+    controller.reset();
+    QCOMPARE(controller.level(), BlurQualityController::Full);
+    QCOMPARE(controller.statistics().frames, quint64(0));
+}
+
+void BlurQualityTest::testHysteresis()
+{
+    BlurQualityController controller;
+
+    // a single slow frame now and then doesn't lower the quality
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(!controller.update(i % BlurQualityController::s_degradeFrames ? 15ms : 12ms, s_budget));
+    }
+    QCOMPARE(controller.level(), BlurQualityController::Full);
+
+    // once lowered, a render time between the watermarks neither lowers nor restores the quality,
+    // so the level doesn't flip back and forth when the lower quality just fits the budget
+    QCOMPARE(framesUntilChange(controller, 15ms), BlurQualityController::s_degradeFrames);
+    QCOMPARE(framesUntilChange(controller, 12ms), -1);
+    QCOMPARE(controller.level(), BlurQualityController::ReducedResolution);
+
+    // a slow frame starts the run of fast frames over
+    for (int i = 0; i < BlurQualityController::s_restoreFrames - 1; ++i) {
+        QVERIFY(!controller.update(4ms, s_budget));
+    }
+    QVERIFY(!controller.update(15ms, s_budget));
+    QCOMPARE(framesUntilChange(controller, 4ms), BlurQualityController::s_restoreFrames);
+    QCOMPARE(controller.level(), BlurQualityController::Full);
+}
+
+void BlurQualityTest::testInvalidBudget()
+{
+    BlurQualityController controller;
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(!controller.update(20ms, 0ns));
+    }
+    QCOMPARE(controller.level(), BlurQualityController::Full);
+    QCOMPARE(controller.statistics().frames, quint64(100));
+}
+
+void BlurQualityTest::testQuality_data()
+{
+    QTest::addColumn<BlurQualityController::Level>("level");
+    QTest::addColumn<int>("iterationCount");
+    QTest::addColumn<bool>("lowPriority");
+    QTest::addColumn<int>("expectedIterationCount");
+    QTest::addColumn<bool>("expectedHalfResolution");
+
+    QTest::addRow("full") << BlurQualityController::Full << 3 << true << 3 << false;
+    QTest::addRow("resolution, active") << BlurQualityController::ReducedResolution << 3 << false << 3 << false;
+    QTest::addRow("resolution, inactive") << BlurQualityController::ReducedResolution << 3 << true << 2 << true;
+    QTest::addRow("resolution, one pass") << BlurQualityController::ReducedResolution << 1 << true << 1 << false;
+    QTest::addRow("iterations, active") << BlurQualityController::ReducedIterations << 3 << false << 3 << false;
+    QTest::addRow("iterations, inactive") << BlurQualityController::ReducedIterations << 3 << true << 1 << true;
+    QTest::addRow("iterations, two passes") << BlurQualityController::ReducedIterations << 2 << true << 1 << true;
+    QTest::addRow("all, active") << BlurQualityController::ReducedAll << 4 << false << 3 << true;
+    QTest::addRow("all, inactive") << BlurQualityController::ReducedAll << 4 << true << 2 << true;
+}
+
+void BlurQualityTest::testQuality()
+{
+    QFETCH(BlurQualityController::Level, level);
+    QFETCH(int, iterationCount);
+    QFETCH(bool, lowPriority);
+
+    BlurQualityController controller;
+    while (controller.level() != level) {
+        controller.update(s_budget, s_budget);
+    }
+
+    const BlurQuality quality = controller.quality(iterationCount, lowPriority);
+    QTEST(int(quality.iterationCount), "expectedIterationCount");
+    QTEST(quality.halfResolution, "expectedHalfResolution");
+}
+
+QTEST_GUILESS_MAIN(BlurQualityTest)
+
+#include "blurqualitytest.moc"
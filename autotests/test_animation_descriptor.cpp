@@ -0,0 +1,434 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scripting/animationdescriptor.h"
+
+#include <QFile>
+#include <QJSEngine>
+#include <QJsonDocument>
+#include <QTest>
+
+using namespace KWin;
+
+class FakeWindow : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString windowClass MEMBER windowClass)
+    Q_PROPERTY(bool popupWindow MEMBER popupWindow)
+    Q_PROPERTY(bool managed MEMBER managed)
+    Q_PROPERTY(bool visible MEMBER visible)
+    Q_PROPERTY(bool outline MEMBER outline)
+    Q_PROPERTY(bool normalWindow MEMBER normalWindow)
+    Q_PROPERTY(bool dialog MEMBER dialog)
+    Q_PROPERTY(bool utility MEMBER utility)
+    Q_PROPERTY(bool notification MEMBER notification)
+    Q_PROPERTY(bool skipsCloseAnimation MEMBER skipsCloseAnimation)
+    Q_PROPERTY(bool hasDecoration MEMBER hasDecoration)
+    Q_PROPERTY(bool lockScreen MEMBER lockScreen)
+    Q_PROPERTY(bool desktopWindow MEMBER desktopWindow)
+    Q_PROPERTY(bool dock MEMBER dock)
+    Q_PROPERTY(bool modal MEMBER modal)
+    Q_PROPERTY(bool minimized MEMBER minimized)
+    Q_PROPERTY(bool unresponsive MEMBER unresponsive)
+
+public:
+    Q_INVOKABLE QVariant data(int role) const
+    {
+        return m_data.value(role);
+    }
+    Q_INVOKABLE void setData(int role, const QVariant &data)
+    {
+        m_data[role] = data;
+    }
+
+    QString windowClass = QStringLiteral("konsole org.kde.konsole");
+    bool popupWindow = false;
+    bool managed = true;
+    bool visible = true;
+    bool outline = false;
+    bool normalWindow = true;
+    bool dialog = false;
+    bool utility = false;
+    bool notification = false;
+    bool skipsCloseAnimation = false;
+    bool hasDecoration = true;
+    bool lockScreen = false;
+    bool desktopWindow = false;
+    bool dock = false;
+    bool modal = false;
+    bool minimized = false;
+    bool unresponsive = false;
+
+Q_SIGNALS:
+    void minimizedChanged();
+    void windowDesktopsChanged();
+    void windowFrameGeometryChanged();
+    void windowFullScreenChanged();
+    void windowMaximizedStateAboutToChange();
+    void windowMaximizedStateChanged();
+    void windowModalityChanged();
+    void windowStartUserMovedResized();
+    void windowFinishUserMovedResized();
+    void windowUnresponsiveChanged();
+
+private:
+    QHash<int, QVariant> m_data;
+};
+
+class TestAnimationDescriptor : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void fade();
+    void fadingPopups();
+    void invalid_data();
+    void invalid();
+    void openClose_data();
+    void openClose();
+};
+
+static AnimationDescriptor loadStockDescriptor(const QString &effectName)
+{
+    const QString fileName = QFINDTESTDATA(QStringLiteral("../src/plugins/%1/package/contents/code/animations.json").arg(effectName));
+    QString error;
+    const auto descriptor = AnimationDescriptor::load(fileName, &error);
+    if (!descriptor) {
+        qFatal("Failed to load %s: %s", qPrintable(fileName), qPrintable(error));
+    }
+    return *descriptor;
+}
+
+void TestAnimationDescriptor::fade()
+{
+    AnimationDescriptor descriptor = loadStockDescriptor(QStringLiteral("fade"));
+    descriptor.resolve(&FakeWindow::staticMetaObject);
+
+    FakeWindow window;
+    QVERIFY(descriptor.matches(AnimationDescriptor::Event::WindowAdded, &window));
+    QVERIFY(descriptor.matches(AnimationDescriptor::Event::WindowClosed, &window));
+    QVERIFY(!descriptor.matches(AnimationDescriptor::Event::WindowMinimized, &window));
+
+    window.skipsCloseAnimation = true;
+    QVERIFY(descriptor.matches(AnimationDescriptor::Event::WindowAdded, &window));
+    QVERIFY(!descriptor.matches(AnimationDescriptor::Event::WindowClosed, &window));
+
+    FakeWindow spectacle;
+    spectacle.windowClass = QStringLiteral("spectacle org.kde.spectacle");
+    QVERIFY(!descriptor.accepts(&spectacle));
+
+    FakeWindow popup;
+    popup.popupWindow = true;
+    QVERIFY(!descriptor.accepts(&popup));
+
+    FakeWindow dialog;
+    dialog.normalWindow = false;
+    dialog.dialog = true;
+    QVERIFY(descriptor.accepts(&dialog));
+    dialog.dialog = false;
+    QVERIFY(!descriptor.accepts(&dialog));
+
+    const AnimationDescriptor::Handler &added = descriptor.handler(AnimationDescriptor::Event::WindowAdded);
+    QCOMPARE(added.cancels.size(), 1);
+    QVERIFY(added.cancels[0] == AnimationDescriptor::Event::WindowClosed);
+    QCOMPARE(added.animations.size(), 1);
+    QCOMPARE(added.animations[0].type, AnimationEffect::Opacity);
+    QCOMPARE(added.animations[0].duration.configKey, QStringLiteral("FadeInTime"));
+    QCOMPARE(added.animations[0].from, FPx2(0.0));
+    QCOMPARE(added.animations[0].to, FPx2(1.0));
+
+    const AnimationDescriptor::Handler &closed = descriptor.handler(AnimationDescriptor::Event::WindowClosed);
+    QCOMPARE(closed.animations.size(), 1);
+    QCOMPARE(closed.animations[0].curve, QEasingCurve::OutQuart);
+    QCOMPARE(closed.animations[0].duration.defaultValue, 150);
+    QCOMPARE(closed.animations[0].duration.factor, 4);
+    QVERIFY(!closed.animations[0].from.isValid());
+}
+
+void TestAnimationDescriptor::fadingPopups()
+{
+    AnimationDescriptor descriptor = loadStockDescriptor(QStringLiteral("fadingpopups"));
+
+    // the properties are looked up by name if the descriptor hasn't been resolved
+    FakeWindow window;
+    QVERIFY(!descriptor.accepts(&window));
+
+    window.popupWindow = true;
+    QVERIFY(descriptor.matches(AnimationDescriptor::Event::WindowAdded, &window));
+    QVERIFY(descriptor.handler(AnimationDescriptor::Event::WindowAdded).grab);
+    window.visible = false;
+    QVERIFY(!descriptor.matches(AnimationDescriptor::Event::WindowAdded, &window));
+
+    FakeWindow unmanaged;
+    unmanaged.managed = false;
+    unmanaged.normalWindow = false;
+    QVERIFY(descriptor.accepts(&unmanaged));
+    unmanaged.utility = true;
+    QVERIFY(!descriptor.accepts(&unmanaged));
+
+    FakeWindow notification;
+    notification.normalWindow = false;
+    notification.notification = true;
+    QVERIFY(descriptor.accepts(&notification));
+}
+
+void TestAnimationDescriptor::invalid_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::addRow("no handlers") << QByteArrayLiteral(R"({"filter": {"rules": [], "default": true}})");
+    QTest::addRow("no animations") << QByteArrayLiteral(R"({"windowAdded": {"animations": []}})");
+    QTest::addRow("unknown type") << QByteArrayLiteral(R"({"windowAdded": {"animations": [{"type": "Wobble", "duration": 100, "to": 1}]}})");
+    QTest::addRow("no duration") << QByteArrayLiteral(R"({"windowAdded": {"animations": [{"type": "Opacity", "to": 1}]}})");
+    QTest::addRow("no target") << QByteArrayLiteral(R"({"windowAdded": {"animations": [{"type": "Opacity", "duration": 100}]}})");
+    QTest::addRow("unknown curve") << QByteArrayLiteral(R"({"windowAdded": {"animations": [{"type": "Opacity", "duration": 100, "to": 1, "curve": "Bouncy"}]}})");
+    QTest::addRow("unknown cancel") << QByteArrayLiteral(R"({"windowAdded": {"cancels": ["windowMoved"], "animations": [{"type": "Opacity", "duration": 100, "to": 1}]}})");
+    QTest::addRow("rule without result") << QByteArrayLiteral(R"({"filter": {"rules": [{"when": {"managed": true}}]}, "windowAdded": {"animations": [{"type": "Opacity", "duration": 100, "to": 1}]}})");
+    QTest::addRow("invalid condition") << QByteArrayLiteral(R"({"windowAdded": {"when": {"windowClass": "konsole"}, "animations": [{"type": "Opacity", "duration": 100, "to": 1}]}})");
+}
+
+void TestAnimationDescriptor::invalid()
+{
+    QFETCH(QByteArray, json);
+
+    QString error;
+    QVERIFY(!AnimationDescriptor::fromJson(QJsonDocument::fromJson(json).object(), &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestAnimationDescriptor::openClose_data()
+{
+    QTest::addColumn<bool>("declarative");
+
+    QTest::addRow("script") << false;
+    QTest::addRow("descriptor") << true;
+}
+
+// The stock scripted effects that animate or otherwise react to windows being opened and closed
+// and that can be enabled together with the fade effect. The scale effect can't, it's in the
+// same exclusive category.
+static const QStringList s_stockScripts{
+    QStringLiteral("dialogparent"),
+    QStringLiteral("dimscreen"),
+    QStringLiteral("frozenapp"),
+    QStringLiteral("fullscreen"),
+    QStringLiteral("login"),
+    QStringLiteral("logout"),
+    QStringLiteral("maximize"),
+    QStringLiteral("sessionquit"),
+    QStringLiteral("squash"),
+    QStringLiteral("translucency"),
+};
+
+// Just enough of the scripted effect API for the stock scripts to handle window events. The
+// animations aren't run and the stacking order is empty.
+static const QString s_scriptedEffectApi = QStringLiteral(R"(
+    var signal = function() {
+        var handlers = [];
+        return {
+            connect: function(handler) { handlers.push(handler); },
+            disconnect: function(handler) {
+                var index = handlers.indexOf(handler);
+                if (index != -1) {
+                    handlers.splice(index, 1);
+                }
+            },
+            emit: function() {
+                for (var i = 0; i < handlers.length; ++i) {
+                    handlers[i].apply(null, arguments);
+                }
+            }
+        };
+    };
+    var effects = {
+        activeFullScreenEffectChanged: signal(),
+        colorPickerActiveChanged: signal(),
+        desktopChanged: signal(),
+        windowActivated: signal(),
+        windowAdded: signal(),
+        windowClosed: signal(),
+        windowDataChanged: signal(),
+        activeWindow: null,
+        colorPickerActive: false,
+        hasActiveFullScreenEffect: false,
+        sessionState: 0,
+        stackingOrder: []
+    };
+    var effect = {
+        animationEnded: signal(),
+        configChanged: signal(),
+        readConfig: function(key, defaultValue) { return defaultValue; },
+        isGrabbed: function() { return false; },
+        grab: function() { return true; }
+    };
+    var Effect = new Proxy({}, { get: function() { return 0; } });
+    var QEasingCurve = Effect;
+    var animationCount = 0;
+    var animate = function() { return [++animationCount]; };
+    var set = animate;
+    var cancel = function() { return true; };
+    var retarget = cancel;
+    var redirect = cancel;
+    var complete = cancel;
+    var animationTime = function(duration) { return duration; };
+)");
+
+struct StockScript
+{
+    std::unique_ptr<QJSEngine> engine;
+    QJSValue windowAdded;
+    QJSValue windowClosed;
+};
+
+static QJSValue loadStockScript(StockScript &script, const QString &effectName)
+{
+    const QString fileName = QFINDTESTDATA(QStringLiteral("../src/plugins/%1/package/contents/code/main.js").arg(effectName));
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJSValue(QStringLiteral("Failed to open %1").arg(fileName));
+    }
+
+    script.engine = std::make_unique<QJSEngine>();
+    script.engine->evaluate(s_scriptedEffectApi);
+    const QJSValue result = script.engine->evaluate(QString::fromUtf8(file.readAll()), fileName);
+    if (result.isError()) {
+        return result;
+    }
+
+    const QJSValue effects = script.engine->globalObject().property(QStringLiteral("effects"));
+    script.windowAdded = effects.property(QStringLiteral("windowAdded")).property(QStringLiteral("emit"));
+    script.windowClosed = effects.property(QStringLiteral("windowClosed")).property(QStringLiteral("emit"));
+    return QJSValue();
+}
+
+void TestAnimationDescriptor::openClose()
+{
+    // 500 windows of various kinds are opened and closed with the stock scripted effects that
+    // handle window events enabled, fade and fading popups among them. Compare deciding whether
+    // fade and fading popups animate a window natively with the window filters of their former
+    // scripts, which got called on every window event like the other scripts still are.
+    QFETCH(bool, declarative);
+
+    std::vector<std::unique_ptr<FakeWindow>> windows;
+    for (int i = 0; i < 500; ++i) {
+        auto window = std::make_unique<FakeWindow>();
+        QJSEngine::setObjectOwnership(window.get(), QJSEngine::CppOwnership);
+        switch (i % 5) {
+        case 1:
+            window->popupWindow = true;
+            window->normalWindow = false;
+            window->hasDecoration = false;
+            break;
+        case 2:
+            window->dialog = true;
+            window->normalWindow = false;
+            break;
+        case 3:
+            window->managed = false;
+            window->normalWindow = false;
+            window->hasDecoration = false;
+            break;
+        case 4:
+            window->notification = true;
+            window->normalWindow = false;
+            window->hasDecoration = false;
+            break;
+        }
+        windows.push_back(std::move(window));
+    }
+
+    std::vector<StockScript> stockScripts(s_stockScripts.size());
+    for (int i = 0; i < s_stockScripts.size(); ++i) {
+        const QJSValue error = loadStockScript(stockScripts[i], s_stockScripts[i]);
+        QVERIFY2(error.isUndefined(), qPrintable(error.toString()));
+    }
+    const auto runStockScripts = [&stockScripts](FakeWindow *window) {
+        for (const StockScript &script : stockScripts) {
+            const QJSValue object = script.engine->newQObject(window);
+            if (const QJSValue result = script.windowAdded.call({object}); result.isError()) {
+                return result;
+            }
+            if (const QJSValue result = script.windowClosed.call({object}); result.isError()) {
+                return result;
+            }
+        }
+        return QJSValue();
+    };
+    // the API that the scripts use must be complete, otherwise they bail out early
+    for (const auto &window : windows) {
+        const QJSValue error = runStockScripts(window.get());
+        QVERIFY2(error.isUndefined(), qPrintable(error.toString()));
+    }
+
+    int animated = 0;
+    if (declarative) {
+        AnimationDescriptor fade = loadStockDescriptor(QStringLiteral("fade"));
+        AnimationDescriptor fadingPopups = loadStockDescriptor(QStringLiteral("fadingpopups"));
+        fade.resolve(&FakeWindow::staticMetaObject);
+        fadingPopups.resolve(&FakeWindow::staticMetaObject);
+
+        QBENCHMARK {
+            animated = 0;
+            for (const auto &window : windows) {
+                for (const AnimationDescriptor *descriptor : {&fade, &fadingPopups}) {
+                    animated += descriptor->matches(AnimationDescriptor::Event::WindowAdded, window.get());
+                    animated += descriptor->matches(AnimationDescriptor::Event::WindowClosed, window.get());
+                }
+                runStockScripts(window.get());
+            }
+        }
+    } else {
+        QJSEngine engine;
+        const QJSValue filters = engine.evaluate(QStringLiteral(R"((function() {
+            const fadeBlacklist = ["ksmserver ksmserver", "ksmserver-logout-greeter ksmserver-logout-greeter",
+                                   "ksplashqml ksplashqml", "spectacle spectacle", "spectacle org.kde.spectacle"];
+            const popupBlacklist = ["ksmserver ksmserver", "ksmserver-logout-greeter ksmserver-logout-greeter",
+                                    "kscreenlocker_greet kscreenlocker_greet", "ksplashqml ksplashqml",
+                                    "spectacle org.kde.spectacle", "spectacle spectacle"];
+            return [
+                function(w, closed) {
+                    if (fadeBlacklist.indexOf(w.windowClass) != -1 || w.popupWindow || !w.managed || !w.visible || w.outline) {
+                        return false;
+                    }
+                    if (closed && w.skipsCloseAnimation) {
+                        return false;
+                    }
+                    return w.normalWindow || w.dialog;
+                },
+                function(w, closed) {
+                    if (popupBlacklist.indexOf(w.windowClass) != -1) {
+                        return false;
+                    }
+                    const popup = w.popupWindow || w.outline || (!w.managed && !w.utility) || w.notification;
+                    return popup && w.visible && !(closed && w.skipsCloseAnimation);
+                }
+            ];
+        })())"));
+        QVERIFY(filters.isArray());
+        const QJSValue fade = filters.property(0);
+        const QJSValue fadingPopups = filters.property(1);
+
+        QBENCHMARK {
+            animated = 0;
+            for (const auto &window : windows) {
+                const QJSValue object = engine.newQObject(window.get());
+                for (const QJSValue &filter : {fade, fadingPopups}) {
+                    animated += filter.call({object, false}).toBool();
+                    animated += filter.call({object, true}).toBool();
+                }
+                runStockScripts(window.get());
+            }
+        }
+    }
+
+    // normal windows and dialogs get faded, popups, unmanaged windows and notifications too
+    QCOMPARE(animated, 1000);
+}
+
+QTEST_GUILESS_MAIN(TestAnimationDescriptor)
+#include "test_animation_descriptor.moc"
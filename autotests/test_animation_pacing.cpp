@@ -0,0 +1,175 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "animationpacing.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+static std::chrono::nanoseconds frameInterval(uint32_t refreshRate)
+{
+    return std::chrono::nanoseconds(1'000'000'000'000ull / refreshRate);
+}
+
+class TestAnimationPacing : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void animation_data();
+    void animation();
+    void unlimited();
+    void destroyed();
+    void timer();
+};
+
+void TestAnimationPacing::animation_data()
+{
+    QTest::addColumn<uint32_t>("renderLoopRefreshRate");
+    QTest::addColumn<uint32_t>("animationRefreshRate");
+    QTest::addColumn<int>("expectedFrames");
+
+    // a one second animation that schedules a repaint after every frame, the first frame starts it
+    QTest::addRow("60 Hz") << 60000u << 0u << 61;
+    QTest::addRow("60 Hz, 30 Hz animation") << 60000u << 30000u << 31;
+    QTest::addRow("144 Hz") << 144000u << 0u << 145;
+    QTest::addRow("144 Hz, 30 Hz animation") << 144000u << 30000u << 30;
+    QTest::addRow("144 Hz, 120 Hz animation") << 144000u << 120000u << 145;
+}
+
+void TestAnimationPacing::animation()
+{
+    // the render loop presents a frame at the first vblank that is at least one frame after the
+    // repaint was scheduled. The animation advances in the timebase of the render loop
+    QFETCH(uint32_t, renderLoopRefreshRate);
+    QFETCH(uint32_t, animationRefreshRate);
+    const std::chrono::milliseconds duration = 1000ms;
+
+    std::chrono::milliseconds now = 0ms;
+    AnimationPacing pacing([&now]() {
+        return now;
+    });
+    pacing.setRenderLoopRefreshRate(renderLoopRefreshRate);
+    QObject effect;
+    pacing.setRefreshRate(&effect, animationRefreshRate);
+    QCOMPARE(pacing.refreshRate(&effect), animationRefreshRate);
+
+    const QRegion region(0, 0, 100, 100);
+    const std::chrono::nanoseconds interval = frameInterval(renderLoopRefreshRate);
+    std::optional<std::chrono::nanoseconds> repaint = 0ns;
+    std::optional<std::chrono::milliseconds> start;
+    qreal progress = 0;
+    int frames = 0;
+    int deferred = 0;
+
+    for (int vblank = 1; vblank < 1000; ++vblank) {
+        const std::chrono::nanoseconds time = vblank * interval;
+        now = std::chrono::duration_cast<std::chrono::milliseconds>(time);
+        if (!repaint) {
+            const auto deadline = pacing.nextDeadline();
+            if (!deadline) {
+                break;
+            }
+            QCOMPARE(pacing.release(*deadline), region);
+            repaint = *deadline;
+        }
+        if (time < *repaint + interval) {
+            continue;
+        }
+
+        frames++;
+        repaint.reset();
+        const std::chrono::milliseconds presentTime = now;
+        if (!start) {
+            start = presentTime;
+        }
+        const qreal newProgress = std::min(1.0, qreal((presentTime - *start).count()) / duration.count());
+        QVERIFY(newProgress >= progress);
+        progress = newProgress;
+
+        if (progress < 1.0) {
+            if (pacing.defer(&effect, region, presentTime)) {
+                deferred++;
+            } else {
+                repaint = time;
+            }
+        }
+    }
+
+    QCOMPARE(progress, 1.0);
+    QTEST(frames, "expectedFrames");
+    QCOMPARE(pacing.statistics().deferred, quint64(deferred));
+    QCOMPARE(pacing.statistics().released, quint64(deferred));
+}
+
+void TestAnimationPacing::unlimited()
+{
+    AnimationPacing pacing([]() {
+        return 0ms;
+    });
+    pacing.setRenderLoopRefreshRate(60000);
+    QObject effect;
+    QObject other;
+
+    // effects without a limit are repainted right away
+    QVERIFY(!pacing.defer(&effect, QRegion(0, 0, 10, 10), 16ms));
+
+    // as are effects whose limit isn't lower than what the render loop can do
+    pacing.setRefreshRate(&effect, 60000);
+    QVERIFY(!pacing.defer(&effect, QRegion(0, 0, 10, 10), 16ms));
+
+    pacing.setRefreshRate(&effect, 20000);
+    QVERIFY(pacing.defer(&effect, QRegion(0, 0, 10, 10), 16ms));
+    QVERIFY(!pacing.defer(&other, QRegion(10, 10, 10, 10), 16ms));
+    QVERIFY(pacing.nextDeadline() == 41ms);
+    QCOMPARE(pacing.release(40ms), QRegion());
+    QCOMPARE(pacing.release(41ms), QRegion(0, 0, 10, 10));
+    QVERIFY(!pacing.nextDeadline());
+
+    pacing.setRefreshRate(&effect, 0);
+    QCOMPARE(pacing.refreshRate(&effect), 0u);
+    QVERIFY(!pacing.defer(&effect, QRegion(0, 0, 10, 10), 50ms));
+}
+
+void TestAnimationPacing::destroyed()
+{
+    AnimationPacing pacing([]() {
+        return 0ms;
+    });
+    QSignalSpy repaintSpy(&pacing, &AnimationPacing::repaintNeeded);
+    {
+        QObject effect;
+        pacing.setRefreshRate(&effect, 10000);
+        QVERIFY(pacing.defer(&effect, QRegion(0, 0, 10, 10), 0ms));
+    }
+
+    // what the effect left on the screen is repainted once it's gone
+    QCOMPARE(repaintSpy.count(), 1);
+    QCOMPARE(repaintSpy.last().at(0).value<QRegion>(), QRegion(0, 0, 10, 10));
+    QVERIFY(!pacing.nextDeadline());
+}
+
+void TestAnimationPacing::timer()
+{
+    AnimationPacing pacing;
+    QSignalSpy repaintSpy(&pacing, &AnimationPacing::repaintNeeded);
+    QObject effect;
+    pacing.setRefreshRate(&effect, 20000);
+
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
+    QVERIFY(pacing.defer(&effect, QRegion(0, 0, 10, 10), now));
+    QVERIFY(repaintSpy.wait());
+    QCOMPARE(repaintSpy.last().at(0).value<QRegion>(), QRegion(0, 0, 10, 10));
+    QCOMPARE(pacing.statistics().released, quint64(1));
+}
+
+QTEST_GUILESS_MAIN(TestAnimationPacing)
+#include "test_animation_pacing.moc"
@@ -0,0 +1,235 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "testutils.h"
+// KWin
+#include "clientlistproperties.h"
+#include "utils/c_ptr.h"
+// Qt
+#include <QApplication>
+#include <QTest>
+#include <private/qtx11extras_p.h>
+// xcb
+#include <xcb/xcb.h>
+
+using namespace KWin;
+
+namespace
+{
+xcb_atom_t internAtom(xcb_connection_t *c, const QByteArray &name)
+{
+    UniqueCPtr<xcb_intern_atom_reply_t> reply(xcb_intern_atom_reply(c, xcb_intern_atom(c, false, name.length(), name.constData()), nullptr));
+    return reply ? reply->atom : XCB_ATOM_NONE;
+}
+
+void sync(xcb_connection_t *c)
+{
+    free(xcb_get_input_focus_reply(c, xcb_get_input_focus(c), nullptr));
+}
+}
+
+/**
+ * Checks how often pagers and taskbars get told that the client lists on the root window
+ * changed. The lists are written on a window of their own, which stands in for the root
+ * window, and the PropertyNotify events are watched on a second connection, like a pager would.
+ */
+class TestClientListProperties : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void mapBurst_data();
+    void mapBurst();
+    void append();
+    void unchanged();
+    void remove();
+    void destroyed();
+
+private:
+    int propertyNotifyEvents();
+    QList<xcb_window_t> property(xcb_atom_t atom);
+    void waitForFlush(ClientListProperties &properties);
+
+    static constexpr int s_windowCount = 50;
+
+    xcb_connection_t *m_observer = nullptr;
+    xcb_window_t m_root = XCB_WINDOW_NONE;
+    xcb_atom_t m_clientList = XCB_ATOM_NONE;
+    xcb_atom_t m_clientListStacking = XCB_ATOM_NONE;
+};
+
+void TestClientListProperties::initTestCase()
+{
+    qApp->setProperty("x11RootWindow", QVariant::fromValue<quint32>(QX11Info::appRootWindow()));
+    qApp->setProperty("x11Connection", QVariant::fromValue<void *>(QX11Info::connection()));
+
+    m_clientList = internAtom(connection(), QByteArrayLiteral("_NET_CLIENT_LIST"));
+    m_clientListStacking = internAtom(connection(), QByteArrayLiteral("_NET_CLIENT_LIST_STACKING"));
+    QVERIFY(m_clientList != XCB_ATOM_NONE);
+    QVERIFY(m_clientListStacking != XCB_ATOM_NONE);
+}
+
+void TestClientListProperties::init()
+{
+    m_root = createWindow();
+    sync(connection());
+
+    m_observer = xcb_connect(nullptr, nullptr);
+    QVERIFY(!xcb_connection_has_error(m_observer));
+    const uint32_t mask = XCB_EVENT_MASK_PROPERTY_CHANGE;
+    xcb_change_window_attributes(m_observer, m_root, XCB_CW_EVENT_MASK, &mask);
+    sync(m_observer);
+}
+
+void TestClientListProperties::cleanup()
+{
+    xcb_disconnect(m_observer);
+    m_observer = nullptr;
+    xcb_destroy_window(connection(), m_root);
+    sync(connection());
+    m_root = XCB_WINDOW_NONE;
+}
+
+int TestClientListProperties::propertyNotifyEvents()
+{
+    sync(connection());
+    sync(m_observer);
+
+    int count = 0;
+    while (xcb_generic_event_t *event = xcb_poll_for_event(m_observer)) {
+        if ((event->response_type & ~0x80) == XCB_PROPERTY_NOTIFY) {
+            count++;
+        }
+        free(event);
+    }
+    return count;
+}
+
+QList<xcb_window_t> TestClientListProperties::property(xcb_atom_t atom)
+{
+    xcb_get_property_cookie_t cookie = xcb_get_property(connection(), false, m_root, atom, XCB_ATOM_WINDOW, 0, 1024);
+    UniqueCPtr<xcb_get_property_reply_t> reply(xcb_get_property_reply(connection(), cookie, nullptr));
+    if (!reply) {
+        return {};
+    }
+    const auto windows = reinterpret_cast<const xcb_window_t *>(xcb_get_property_value(reply.get()));
+    return QList<xcb_window_t>(windows, windows + xcb_get_property_value_length(reply.get()) / sizeof(xcb_window_t));
+}
+
+void TestClientListProperties::waitForFlush(ClientListProperties &properties)
+{
+    QTRY_VERIFY(!properties.isFlushPending());
+}
+
+void TestClientListProperties::mapBurst_data()
+{
+    QTest::addColumn<bool>("flushEveryMap");
+    QTest::addColumn<int>("expectedEvents");
+
+    // what writing the lists through NETRootInfo for every managed window amounted to
+    QTest::addRow("per map") << true << 2 * s_windowCount;
+    QTest::addRow("batched") << false << 2;
+}
+
+void TestClientListProperties::mapBurst()
+{
+    // 50 windows that are mapped while the event queue is being processed, every one of them
+    // is added to both lists, a new window goes on top of the stacking order
+    QFETCH(bool, flushEveryMap);
+
+    ClientListProperties properties(connection(), m_root, m_clientList, m_clientListStacking);
+    QList<xcb_window_t> clients;
+    QList<xcb_window_t> stacking;
+    for (int i = 0; i < s_windowCount; ++i) {
+        clients.append(0x1000 + i);
+        stacking.prepend(0x1000 + i);
+        properties.setClientList(clients);
+        properties.setClientListStacking(stacking);
+        if (flushEveryMap) {
+            properties.flush();
+        }
+    }
+    waitForFlush(properties);
+
+    QTEST(propertyNotifyEvents(), "expectedEvents");
+    QCOMPARE(property(m_clientList), clients);
+    QCOMPARE(property(m_clientListStacking), stacking);
+}
+
+void TestClientListProperties::append()
+{
+    ClientListProperties properties(connection(), m_root, m_clientList, m_clientListStacking);
+    properties.setClientList({1, 2, 3});
+    properties.setClientListStacking({1, 2, 3});
+    waitForFlush(properties);
+    QCOMPARE(propertyNotifyEvents(), 2);
+
+    // only the new window is sent for the client list, the stacking order is replaced
+    properties.setClientList({1, 2, 3, 4});
+    properties.setClientListStacking({1, 4, 2, 3});
+    waitForFlush(properties);
+    QCOMPARE(propertyNotifyEvents(), 2);
+    QCOMPARE(properties.statistics().appends, quint64(1));
+    QCOMPARE(property(m_clientList), (QList<xcb_window_t>{1, 2, 3, 4}));
+    QCOMPARE(property(m_clientListStacking), (QList<xcb_window_t>{1, 4, 2, 3}));
+}
+
+void TestClientListProperties::unchanged()
+{
+    ClientListProperties properties(connection(), m_root, m_clientList, m_clientListStacking);
+    properties.setClientList({1, 2});
+    properties.setClientListStacking({2, 1});
+    waitForFlush(properties);
+    QCOMPARE(propertyNotifyEvents(), 2);
+
+    // a restack that ends up where it started doesn't reach the root window
+    properties.setClientListStacking({1, 2});
+    properties.setClientListStacking({2, 1});
+    properties.setClientList({1, 2});
+    waitForFlush(properties);
+    QCOMPARE(propertyNotifyEvents(), 0);
+    QCOMPARE(properties.statistics().writes, quint64(2));
+    QCOMPARE(properties.statistics().skipped, quint64(2));
+}
+
+void TestClientListProperties::remove()
+{
+    ClientListProperties properties(connection(), m_root, m_clientList, m_clientListStacking);
+    properties.setClientList({1, 2, 3});
+    properties.flush();
+
+    properties.setClientList({1, 3});
+    properties.flush();
+    QCOMPARE(properties.statistics().appends, quint64(0));
+    QCOMPARE(property(m_clientList), (QList<xcb_window_t>{1, 3}));
+
+    properties.setClientList({});
+    properties.flush();
+    QCOMPARE(property(m_clientList), QList<xcb_window_t>());
+    QCOMPARE(propertyNotifyEvents(), 3);
+}
+
+void TestClientListProperties::destroyed()
+{
+    // the window manager shuts down before the event loop got to write the last update
+    {
+        ClientListProperties properties(connection(), m_root, m_clientList, m_clientListStacking);
+        properties.setClientList({1, 2});
+        properties.setClientListStacking({2, 1});
+        QVERIFY(properties.isFlushPending());
+    }
+    QCOMPARE(propertyNotifyEvents(), 2);
+    QCOMPARE(property(m_clientList), (QList<xcb_window_t>{1, 2}));
+    QCOMPARE(property(m_clientListStacking), (QList<xcb_window_t>{2, 1}));
+}
+
+Q_CONSTRUCTOR_FUNCTION(forceXcb)
+QTEST_MAIN(TestClientListProperties)
+#include "test_client_list_properties.moc"
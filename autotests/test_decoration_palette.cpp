@@ -0,0 +1,152 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "decorations/decorationpalette.h"
+#include "decorations/decorationrepaintqueue.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace KWin;
+using namespace KWin::Decoration;
+using namespace std::chrono_literals;
+
+class TestDecorationPalette : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void schemeSwitch();
+    void repaintQueue();
+};
+
+static QColor titleBarColor(int index)
+{
+    return QColor(index * 20, 255 - index * 20, 128);
+}
+
+static void writeColorScheme(const QString &path, const QColor &titleBar)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    const QByteArray color = QByteArray::number(titleBar.red()) + ',' + QByteArray::number(titleBar.green()) + ',' + QByteArray::number(titleBar.blue());
+    file.write("[Colors:Window]\nBackgroundNormal=239,240,241\nForegroundNormal=35,38,39\n\n");
+    file.write("[Colors:Header]\nBackgroundNormal=" + color + "\nForegroundNormal=252,252,252\n");
+}
+
+void TestDecorationPalette::schemeSwitch()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    QStringList schemes;
+    for (int i = 0; i < 10; ++i) {
+        schemes.append(directory.filePath(QStringLiteral("Scheme%1.colors").arg(i)));
+        writeColorScheme(schemes.last(), titleBarColor(i));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<std::unique_ptr<DecorationPalette>> palettes;
+    std::vector<std::unique_ptr<QSignalSpy>> spies;
+    for (const QString &scheme : std::as_const(schemes)) {
+        palettes.push_back(std::make_unique<DecorationPalette>(scheme));
+        spies.push_back(std::make_unique<QSignalSpy>(palettes.back().get(), &DecorationPalette::changed));
+    }
+    const qint64 loadBlocking = timer.nsecsElapsed();
+
+    for (size_t i = 0; i < palettes.size(); ++i) {
+        QTRY_COMPARE(spies[i]->count(), 1);
+        QVERIFY(!palettes[i]->isLoading());
+        QCOMPARE(palettes[i]->color(KDecoration3::ColorGroup::Active, KDecoration3::ColorRole::TitleBar), titleBarColor(i));
+    }
+
+    // the user switches the color scheme, all schemes change at once
+    for (int i = 0; i < schemes.size(); ++i) {
+        writeColorScheme(schemes[i], titleBarColor(i + 1));
+    }
+    timer.restart();
+    for (const auto &palette : palettes) {
+        palette->reload();
+    }
+    const qint64 switchBlocking = timer.nsecsElapsed();
+
+    // the old colors stay in use until the new ones are complete
+    for (size_t i = 0; i < palettes.size(); ++i) {
+        QCOMPARE(palettes[i]->color(KDecoration3::ColorGroup::Active, KDecoration3::ColorRole::TitleBar), titleBarColor(i));
+    }
+    for (size_t i = 0; i < palettes.size(); ++i) {
+        QTRY_COMPARE(spies[i]->count(), 2);
+        QCOMPARE(palettes[i]->color(KDecoration3::ColorGroup::Active, KDecoration3::ColorRole::TitleBar), titleBarColor(i + 1));
+    }
+
+    // for comparison, what the main thread used to spend on parsing the schemes
+    timer.restart();
+    for (const QString &scheme : std::as_const(schemes)) {
+        QVERIFY(DecorationPalette::parse(scheme));
+    }
+    const qint64 synchronousParsing = timer.nsecsElapsed();
+
+    qInfo() << "main thread blocked for" << loadBlocking / 1000 << "us while loading and" << switchBlocking / 1000
+            << "us while switching 10 schemes, parsing them synchronously takes" << synchronousParsing / 1000 << "us";
+}
+
+void TestDecorationPalette::repaintQueue()
+{
+    DecorationRepaintQueue queue(8, 200ms);
+
+    std::vector<std::unique_ptr<QObject>> decorations;
+    QList<QObject *> repainted;
+    for (int i = 0; i < 20; ++i) {
+        decorations.push_back(std::make_unique<QObject>());
+        QObject *decoration = decorations.back().get();
+        queue.enqueue(decoration, [decoration, &repainted]() {
+            repainted.append(decoration);
+        });
+    }
+
+    // queueing the same decoration again doesn't repaint it twice
+    QObject *first = decorations.front().get();
+    queue.enqueue(first, [first, &repainted]() {
+        repainted.append(first);
+    });
+    QCOMPARE(queue.pendingCount(), 20);
+
+    // a decoration that is gone by the time its turn comes is skipped
+    decorations.back().reset();
+    QCOMPARE(queue.pendingCount(), 19);
+
+    // one batch per frame, the first one goes out right away
+    QCoreApplication::processEvents();
+    QCOMPARE(repainted.count(), 8);
+    QCOMPARE(repainted.first(), first);
+    QCoreApplication::processEvents();
+    QCOMPARE(repainted.count(), 8);
+    QTRY_COMPARE(repainted.count(), 16);
+    QTRY_COMPARE(repainted.count(), 19);
+    QCOMPARE(queue.pendingCount(), 0);
+
+    // flushing dispatches everything right away
+    repainted.clear();
+    for (const auto &decoration : decorations) {
+        QObject *object = decoration.get();
+        if (object) {
+            queue.enqueue(object, [object, &repainted]() {
+                repainted.append(object);
+            });
+        }
+    }
+    queue.flush();
+    QCOMPARE(repainted.count(), 19);
+}
+
+QTEST_MAIN(TestDecorationPalette)
+#include "test_decoration_palette.moc"
@@ -0,0 +1,161 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "framecoalescer.h"
+
+#include <QPointF>
+#include <QTest>
+
+using namespace KWin;
+
+class TestFrameCoalescer : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void immediate();
+    void latestState();
+    void fallbackTimer();
+    void destroyed();
+    void drag_data();
+    void drag();
+};
+
+void TestFrameCoalescer::immediate()
+{
+    FrameCoalescer coalescer;
+    QObject a;
+    QObject b;
+    int deliveries = 0;
+
+    // the first change of every object in a frame isn't delayed
+    coalescer.post(&a, [&deliveries]() {
+        deliveries++;
+    });
+    coalescer.post(&b, [&deliveries]() {
+        deliveries++;
+    });
+    QCOMPARE(deliveries, 2);
+
+    coalescer.post(&a, [&deliveries]() {
+        deliveries++;
+    });
+    QCOMPARE(deliveries, 2);
+    coalescer.flush();
+    QCOMPARE(deliveries, 3);
+
+    // nothing was delivered for b in this frame
+    coalescer.post(&b, [&deliveries]() {
+        deliveries++;
+    });
+    QCOMPARE(deliveries, 4);
+}
+
+void TestFrameCoalescer::latestState()
+{
+    FrameCoalescer coalescer;
+    QObject object;
+    QList<int> delivered;
+
+    for (int i = 0; i < 5; ++i) {
+        coalescer.post(&object, [&delivered, i]() {
+            delivered.append(i);
+        });
+    }
+    coalescer.flush();
+    QCOMPARE(delivered, (QList<int>{0, 4}));
+
+    // an object that keeps changing gets one notification per frame
+    coalescer.post(&object, [&delivered]() {
+        delivered.append(5);
+    });
+    QCOMPARE(delivered.size(), 2);
+    coalescer.flush();
+    coalescer.flush();
+    QCOMPARE(delivered, (QList<int>{0, 4, 5}));
+
+    const FrameCoalescer::Statistics statistics = coalescer.statistics();
+    QCOMPARE(statistics.changes, quint64(6));
+    QCOMPARE(statistics.deliveries, quint64(3));
+}
+
+void TestFrameCoalescer::fallbackTimer()
+{
+    // without frames being painted, held back changes are still delivered
+    FrameCoalescer coalescer;
+    QObject object;
+    int last = -1;
+    for (int i = 0; i < 3; ++i) {
+        coalescer.post(&object, [&last, i]() {
+            last = i;
+        });
+    }
+    QCOMPARE(last, 0);
+    QTRY_COMPARE(last, 2);
+}
+
+void TestFrameCoalescer::destroyed()
+{
+    FrameCoalescer coalescer;
+    int deliveries = 0;
+    {
+        QObject object;
+        for (int i = 0; i < 2; ++i) {
+            coalescer.post(&object, [&deliveries]() {
+                deliveries++;
+            });
+        }
+    }
+    coalescer.flush();
+    QCOMPARE(deliveries, 1);
+}
+
+void TestFrameCoalescer::drag_data()
+{
+    QTest::addColumn<int>("motionsPerFrame");
+
+    QTest::addRow("125 Hz pointer") << 2;
+    QTest::addRow("1000 Hz pointer") << 16;
+}
+
+void TestFrameCoalescer::drag()
+{
+    // a window that is dragged for 1000 pointer motions at 60 Hz, every motion moves it by one
+    // pixel. Listeners of the frame geometry ran for every motion, with coalescing they run once
+    // per frame and still end up with the final position
+    QFETCH(int, motionsPerFrame);
+    const int motions = 1000;
+
+    FrameCoalescer coalescer;
+    QObject window;
+    QPointF position;
+    QPointF seen;
+    int invocations = 0;
+
+    for (int i = 1; i <= motions; ++i) {
+        position = QPointF(i, i);
+        coalescer.post(&window, [&]() {
+            seen = position;
+            invocations++;
+        });
+        if (i % motionsPerFrame == 0) {
+            coalescer.flush();
+        }
+    }
+    coalescer.flush();
+
+    // the first motion is delivered right away, the others with the frame after them
+    const int frames = (motions + motionsPerFrame - 1) / motionsPerFrame;
+    QCOMPARE(seen, position);
+    QCOMPARE(invocations, frames + 1);
+    QCOMPARE(coalescer.statistics().changes, quint64(motions));
+    QCOMPARE(coalescer.statistics().deliveries, quint64(invocations));
+}
+
+QTEST_GUILESS_MAIN(TestFrameCoalescer)
+#include "test_frame_coalescer.moc"
@@ -0,0 +1,436 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "core/framescheduler.h"
+
+#include <QFile>
+#include <QTest>
+
+#include <cmath>
+#include <deque>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/**
+ * A trace of the output and the frames that are rendered for it, e.g. a game that animates
+ * continuously. The render times and the vblank jitter are repeated if the trace is shorter
+ * than the simulation.
+ */
+struct Trace
+{
+    QString name;
+    /// The refresh rate of the output, in millihertz, or the highest one in its VRR range
+    int refreshRate = 60000;
+    /// The lowest refresh rate in the VRR range of the output, 0 if it has none
+    int minimumRefreshRate = 0;
+    /// How long it takes to render each frame
+    QList<std::chrono::nanoseconds> renderTimes;
+    /// How far each vblank is off the grid of the refresh rate
+    QList<std::chrono::nanoseconds> vblankJitter;
+    int frames = 600;
+};
+
+struct Policy
+{
+    QString name;
+    PresentationMode presentationMode = PresentationMode::VSync;
+    int maxPendingFrameCount = 1;
+    std::chrono::nanoseconds safetyMargin{0};
+};
+
+struct Report
+{
+    int frames = 0;
+    /// The frames that were presented after the vblank the scheduler aimed for
+    int missedFrames = 0;
+    /// How long it took from starting to render a frame until it was on the screen
+    std::chrono::nanoseconds meanLatency{0};
+    std::chrono::nanoseconds maxLatency{0};
+    /// The mean and the variance of the time between presented frames, in milliseconds
+    double meanFrameTime = 0;
+    double frameTimeVariance = 0;
+};
+
+const QList<Policy> s_policies{
+    {QStringLiteral("double buffering"), PresentationMode::VSync, 1},
+    {QStringLiteral("triple buffering"), PresentationMode::VSync, 2},
+    {QStringLiteral("adaptive sync"), PresentationMode::AdaptiveSync, 1},
+    {QStringLiteral("tearing"), PresentationMode::Async, 1},
+};
+
+/**
+ * Replays @p trace with a RenderLoop that follows @p policy, in a simulated time. Like the
+ * RenderLoop, it renders a frame when the timer that the scheduler asked for fires, and the
+ * compositor schedules a repaint after every frame. The GPU renders one frame after the other
+ * and the output flips to at most one frame per vblank, in the order they were submitted.
+ */
+Report simulate(const Trace &trace, const Policy &policy)
+{
+    std::chrono::nanoseconds now = 1s;
+    FrameScheduler scheduler([&now]() {
+        return now;
+    });
+    scheduler.setRefreshRate(trace.refreshRate);
+    scheduler.setPresentationMode(policy.presentationMode);
+    scheduler.setMaxPendingFrameCount(policy.maxPendingFrameCount);
+    scheduler.setSafetyMargin(policy.safetyMargin);
+
+    const std::chrono::nanoseconds interval(1'000'000'000'000ull / trace.refreshRate);
+    const std::chrono::nanoseconds longestInterval = trace.minimumRefreshRate ? std::chrono::nanoseconds(1'000'000'000'000ull / trace.minimumRefreshRate) : interval;
+    const auto vblank = [&trace, interval](int64_t index) {
+        const std::chrono::nanoseconds jitter = trace.vblankJitter.isEmpty() ? 0ns : trace.vblankJitter[index % trace.vblankJitter.size()];
+        return index * interval + jitter;
+    };
+
+    std::chrono::nanoseconds lastRefresh = vblank(now / interval);
+    scheduler.notifyVblank(lastRefresh);
+
+    struct Frame
+    {
+        std::chrono::nanoseconds target;
+        std::chrono::nanoseconds start;
+        std::chrono::nanoseconds completion;
+        std::chrono::nanoseconds renderTime;
+    };
+    std::deque<Frame> pendingFrames;
+    std::optional<std::chrono::nanoseconds> timer;
+    std::chrono::nanoseconds gpuIdle = 0ns;
+    bool pendingReschedule = false;
+    int renderedFrames = 0;
+
+    const auto scheduleRepaint = [&](std::chrono::nanoseconds lastTargetTimestamp) {
+        pendingReschedule = false;
+        const std::chrono::nanoseconds renderTimestamp = scheduler.schedule(lastTargetTimestamp, timer.has_value());
+        // the timer of the RenderLoop has a resolution of a millisecond
+        timer = now + std::max(0ns, std::chrono::nanoseconds(std::chrono::duration_cast<std::chrono::milliseconds>(renderTimestamp - now)));
+    };
+    const auto scheduleNextRepaint = [&]() {
+        if (!timer) {
+            scheduleRepaint(scheduler.nextPresentationTimestamp());
+        }
+    };
+    const auto requestRepaint = [&]() {
+        if (scheduler.canSubmitFrame()) {
+            scheduleNextRepaint();
+        } else {
+            pendingReschedule = true;
+        }
+    };
+    const auto presentationTimestamp = [&](const Frame &frame) {
+        switch (policy.presentationMode) {
+        case PresentationMode::Async:
+        case PresentationMode::AdaptiveAsync:
+            return std::max(frame.completion, lastRefresh);
+        case PresentationMode::AdaptiveSync: {
+            // the output refreshes with the last frame again if the next one takes too long
+            std::chrono::nanoseconds refresh = lastRefresh;
+            while (std::max(frame.completion, refresh + interval) > refresh + longestInterval) {
+                refresh += longestInterval;
+            }
+            return std::max(frame.completion, refresh + interval);
+        }
+        case PresentationMode::VSync:
+            break;
+        }
+        int64_t index = frame.completion / interval - 1;
+        while (vblank(index) < frame.completion || vblank(index) <= lastRefresh) {
+            ++index;
+        }
+        return vblank(index);
+    };
+
+    Report report;
+    QList<double> frameTimes;
+    std::chrono::nanoseconds lastPresentation = 0ns;
+    std::chrono::nanoseconds latencySum = 0ns;
+
+    requestRepaint();
+    while (report.frames < trace.frames) {
+        std::optional<std::chrono::nanoseconds> presentation;
+        if (!pendingFrames.empty()) {
+            presentation = presentationTimestamp(pendingFrames.front());
+        }
+
+        if (presentation && (!timer || *presentation <= *timer)) {
+            now = *presentation;
+            const Frame frame = pendingFrames.front();
+            pendingFrames.pop_front();
+            lastRefresh = now;
+            scheduler.framePresented(now, frame.renderTime);
+
+            report.frames++;
+            if (now > frame.target + interval / 2) {
+                report.missedFrames++;
+            }
+            const std::chrono::nanoseconds latency = now - frame.start;
+            latencySum += latency;
+            report.maxLatency = std::max(report.maxLatency, latency);
+            if (lastPresentation > 0ns) {
+                frameTimes.append((now - lastPresentation).count() / 1'000'000.0);
+            }
+            lastPresentation = now;
+
+            // what RenderLoopPrivate::notifyFrameCompleted() does
+            if (timer) {
+                scheduleRepaint(scheduler.lastPresentationTimestamp());
+            }
+            if (pendingReschedule) {
+                scheduleNextRepaint();
+            }
+        } else if (timer) {
+            now = *timer;
+            timer.reset();
+
+            const std::chrono::nanoseconds renderTime = trace.renderTimes[renderedFrames % trace.renderTimes.size()];
+            const std::chrono::nanoseconds completion = std::max(now, gpuIdle) + renderTime;
+            gpuIdle = completion;
+            pendingFrames.push_back(Frame{
+                .target = scheduler.nextPresentationTimestamp(),
+                .start = now,
+                .completion = completion,
+                .renderTime = renderTime,
+            });
+            scheduler.frameSubmitted();
+            renderedFrames++;
+
+            // the scene keeps changing
+            requestRepaint();
+        } else {
+            break;
+        }
+    }
+
+    if (report.frames) {
+        report.meanLatency = latencySum / report.frames;
+    }
+    if (!frameTimes.isEmpty()) {
+        for (double frameTime : std::as_const(frameTimes)) {
+            report.meanFrameTime += frameTime;
+        }
+        report.meanFrameTime /= frameTimes.size();
+        for (double frameTime : std::as_const(frameTimes)) {
+            report.frameTimeVariance += (frameTime - report.meanFrameTime) * (frameTime - report.meanFrameTime);
+        }
+        report.frameTimeVariance /= frameTimes.size();
+    }
+    return report;
+}
+
+void print(const Trace &trace, const Policy &policy, const Report &report)
+{
+    qInfo("%-20s %-18s frames %4d missed %4d latency %6.2f ms (max %6.2f ms) frame time %6.2f ms (variance %7.3f)",
+          qPrintable(trace.name), qPrintable(policy.name), report.frames, report.missedFrames,
+          report.meanLatency.count() / 1'000'000.0, report.maxLatency.count() / 1'000'000.0,
+          report.meanFrameTime, report.frameTimeVariance);
+}
+
+Trace steadyTrace()
+{
+    return Trace{
+        .name = QStringLiteral("steady 60 Hz"),
+        .renderTimes = {3ms},
+    };
+}
+
+Trace jitteryTrace()
+{
+    // vblank timestamps that are up to a millisecond off
+    Trace trace{
+        .name = QStringLiteral("jittery vsync"),
+        .renderTimes = {4ms},
+    };
+    for (int i = 0; i < 16; ++i) {
+        trace.vblankJitter.append(((i * 7) % 9 - 4) * 250us);
+    }
+    return trace;
+}
+
+Trace longGpuFramesTrace()
+{
+    // every 30th frame takes longer than a refresh cycle, e.g. because a shader is compiled
+    Trace trace{
+        .name = QStringLiteral("long GPU frames"),
+    };
+    for (int i = 0; i < 30; ++i) {
+        trace.renderTimes.append(i == 29 ? 24ms : 6ms);
+    }
+    return trace;
+}
+
+Trace vrrTrace()
+{
+    // render times between 4 and 12 ms on a 48 - 144 Hz output
+    Trace trace{
+        .name = QStringLiteral("VRR 48-144 Hz"),
+        .refreshRate = 144000,
+        .minimumRefreshRate = 48000,
+    };
+    for (int i = 0; i < 20; ++i) {
+        trace.renderTimes.append(4ms + (i % 5) * 2ms);
+    }
+    return trace;
+}
+
+Trace belowVrrRangeTrace()
+{
+    return Trace{
+        .name = QStringLiteral("below VRR range"),
+        .refreshRate = 144000,
+        .minimumRefreshRate = 48000,
+        .renderTimes = {25ms},
+    };
+}
+
+/**
+ * Reads a trace that the RenderLoop wrote with KWIN_LOG_PERFORMANCE_DATA=1.
+ */
+std::optional<Trace> readTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return std::nullopt;
+    }
+
+    Trace trace{
+        .name = QStringLiteral("recorded"),
+    };
+    QList<std::chrono::nanoseconds> pageflips;
+    std::chrono::nanoseconds refreshDuration = 0ns;
+    file.readLine(); // the header
+    while (!file.atEnd()) {
+        const QList<QByteArray> columns = file.readLine().trimmed().split(',');
+        if (columns.size() < 6) {
+            continue;
+        }
+        pageflips.append(std::chrono::nanoseconds(columns[1].toLongLong()));
+        const std::chrono::nanoseconds renderStart(columns[2].toLongLong());
+        const std::chrono::nanoseconds renderEnd(columns[3].toLongLong());
+        trace.renderTimes.append(std::max(renderEnd - renderStart, 0ns));
+        refreshDuration = std::chrono::nanoseconds(columns[5].toLongLong());
+    }
+    if (pageflips.isEmpty() || refreshDuration <= 0ns) {
+        return std::nullopt;
+    }
+
+    trace.refreshRate = 1'000'000'000'000ull / refreshDuration.count();
+    trace.frames = pageflips.size();
+    for (const std::chrono::nanoseconds pageflip : std::as_const(pageflips)) {
+        const auto offset = (pageflip - pageflips.constFirst()) % refreshDuration;
+        trace.vblankJitter.append(offset > refreshDuration / 2 ? offset - refreshDuration : offset);
+    }
+    return trace;
+}
+
+}
+
+class TestFrameScheduler : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void steady();
+    void jitteryVsync();
+    void longGpuFrames();
+    void vrr();
+    void report();
+    void recordedTrace();
+};
+
+void TestFrameScheduler::steady()
+{
+    // after the first frame, which doesn't know the render time yet, every vblank gets a frame
+    const Trace trace = steadyTrace();
+    const Report report = simulate(trace, s_policies[0]);
+    QCOMPARE(report.frames, trace.frames);
+    QVERIFY(report.missedFrames <= 1);
+    QVERIFY(report.frameTimeVariance < 0.01);
+    QVERIFY(std::abs(report.meanFrameTime - 1000.0 / 60) < 0.1);
+    QVERIFY(report.maxLatency < 2 * std::chrono::nanoseconds(1'000'000'000 / 60));
+}
+
+void TestFrameScheduler::jitteryVsync()
+{
+    // the jitter shows in the frame times, but the frames are still presented when planned
+    const Trace trace = jitteryTrace();
+    const Report report = simulate(trace, s_policies[0]);
+    QCOMPARE(report.frames, trace.frames);
+    QVERIFY(report.missedFrames <= 1);
+    QVERIFY(report.frameTimeVariance > 0);
+    QVERIFY(report.frameTimeVariance < 2);
+}
+
+void TestFrameScheduler::longGpuFrames()
+{
+    // triple buffering hides the long frames, at the cost of a frame of latency
+    const Trace trace = longGpuFramesTrace();
+    const Report doubleBuffering = simulate(trace, s_policies[0]);
+    const Report tripleBuffering = simulate(trace, s_policies[1]);
+    print(trace, s_policies[0], doubleBuffering);
+    print(trace, s_policies[1], tripleBuffering);
+
+    QVERIFY(doubleBuffering.missedFrames >= trace.frames / 30);
+    QVERIFY(tripleBuffering.missedFrames < doubleBuffering.missedFrames);
+    QVERIFY(tripleBuffering.frameTimeVariance < doubleBuffering.frameTimeVariance);
+    QVERIFY(tripleBuffering.meanLatency > doubleBuffering.meanLatency);
+}
+
+void TestFrameScheduler::vrr()
+{
+    // with render times that don't fit the refresh rate, adaptive sync presents frames when
+    // they're ready instead of at the next vblank
+    const Trace trace = vrrTrace();
+    const Report vsync = simulate(trace, s_policies[0]);
+    const Report adaptiveSync = simulate(trace, s_policies[2]);
+    print(trace, s_policies[0], vsync);
+    print(trace, s_policies[2], adaptiveSync);
+
+    QCOMPARE(adaptiveSync.frames, trace.frames);
+    QVERIFY(adaptiveSync.frameTimeVariance < vsync.frameTimeVariance);
+    QVERIFY(adaptiveSync.meanLatency < vsync.meanLatency);
+}
+
+void TestFrameScheduler::report()
+{
+    const QList<Trace> traces{
+        steadyTrace(),
+        jitteryTrace(),
+        longGpuFramesTrace(),
+        vrrTrace(),
+        belowVrrRangeTrace(),
+    };
+    for (const Trace &trace : traces) {
+        for (const Policy &policy : s_policies) {
+            const Report report = simulate(trace, policy);
+            print(trace, policy, report);
+            QCOMPARE(report.frames, trace.frames);
+        }
+    }
+}
+
+void TestFrameScheduler::recordedTrace()
+{
+    const QString fileName = qEnvironmentVariable("KWIN_FRAME_TRACE");
+    if (fileName.isEmpty()) {
+        QSKIP("Set KWIN_FRAME_TRACE to a file written with KWIN_LOG_PERFORMANCE_DATA=1 to replay it");
+    }
+
+    const std::optional<Trace> trace = readTrace(fileName);
+    QVERIFY(trace);
+    for (const Policy &policy : s_policies) {
+        const Report report = simulate(*trace, policy);
+        print(*trace, policy, report);
+        QCOMPARE(report.frames, trace->frames);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFrameScheduler)
+#include "test_frame_scheduler.moc"
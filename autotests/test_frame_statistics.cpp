@@ -0,0 +1,86 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "core/framestatistics.h"
+
+#include <QTest>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestFrameStatistics : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void summary();
+    void capacity();
+    void json();
+};
+
+void TestFrameStatistics::summary()
+{
+    FrameStatistics statistics;
+    QCOMPARE(statistics.summary(FrameStatistics::Phase::Paint).count, quint64(0));
+
+    // 1 to 100 ms in reverse order, the percentiles must not depend on the order
+    for (int i = 100; i > 0; --i) {
+        statistics.addSample(FrameStatistics::Phase::Paint, std::chrono::milliseconds(i));
+    }
+
+    const FrameStatistics::Summary summary = statistics.summary(FrameStatistics::Phase::Paint);
+    QCOMPARE(summary.count, quint64(100));
+    QCOMPARE(summary.mean, std::chrono::nanoseconds(50500us));
+    QCOMPARE(summary.median, std::chrono::nanoseconds(50ms));
+    QCOMPARE(summary.p95, std::chrono::nanoseconds(95ms));
+    QCOMPARE(summary.p99, std::chrono::nanoseconds(99ms));
+    QCOMPARE(summary.max, std::chrono::nanoseconds(100ms));
+
+    // the phases are independent of each other
+    QCOMPARE(statistics.summary(FrameStatistics::Phase::Present).count, quint64(0));
+
+    statistics.reset();
+    QCOMPARE(statistics.summary(FrameStatistics::Phase::Paint).count, quint64(0));
+}
+
+void TestFrameStatistics::capacity()
+{
+    // only the most recent samples are used for percentiles, but all of them are counted
+    FrameStatistics statistics(10);
+    for (int i = 0; i < 10; ++i) {
+        statistics.addSample(FrameStatistics::Phase::Gpu, 100ms);
+    }
+    for (int i = 0; i < 10; ++i) {
+        statistics.addSample(FrameStatistics::Phase::Gpu, 1ms);
+    }
+
+    const FrameStatistics::Summary summary = statistics.summary(FrameStatistics::Phase::Gpu);
+    QCOMPARE(summary.count, quint64(20));
+    QCOMPARE(summary.median, std::chrono::nanoseconds(1ms));
+    QCOMPARE(summary.p99, std::chrono::nanoseconds(1ms));
+    QCOMPARE(summary.max, std::chrono::nanoseconds(100ms));
+}
+
+void TestFrameStatistics::json()
+{
+    FrameStatistics statistics;
+    statistics.addSample(FrameStatistics::Phase::Damage, 1500us);
+    statistics.addSample(FrameStatistics::Phase::Total, 4ms);
+
+    const QJsonObject json = statistics.toJson();
+    QCOMPARE(json.keys(), (QStringList{QStringLiteral("damage"), QStringLiteral("total")}));
+
+    const QJsonObject damage = json[QStringLiteral("damage")].toObject();
+    QCOMPARE(damage[QStringLiteral("count")].toInt(), 1);
+    QCOMPARE(damage[QStringLiteral("medianUs")].toInt(), 1500);
+    QCOMPARE(damage[QStringLiteral("maxUs")].toInt(), 1500);
+    QCOMPARE(json[QStringLiteral("total")].toObject()[QStringLiteral("meanUs")].toInt(), 4000);
+}
+
+QTEST_GUILESS_MAIN(TestFrameStatistics)
+#include "test_frame_statistics.moc"
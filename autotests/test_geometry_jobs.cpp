@@ -0,0 +1,210 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/geometryjobs.h"
+#include "scene/item.h"
+
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+using namespace KWin;
+
+namespace
+{
+
+/**
+ * An item with a grid of quads, like a window with a shape made of many rectangles.
+ */
+class GridItem : public Item
+{
+public:
+    GridItem(int columns, int rows, Item *parent = nullptr)
+        : Item(parent)
+        , m_columns(columns)
+        , m_rows(rows)
+    {
+        setSize(QSizeF(columns * 10, rows * 10));
+    }
+
+    void invalidate()
+    {
+        discardQuads();
+    }
+
+    QThread *quadsThread() const
+    {
+        return m_quadsThread;
+    }
+
+protected:
+    WindowQuadList buildQuads() const override
+    {
+        m_quadsThread = QThread::currentThread();
+
+        WindowQuadList quads;
+        for (int row = 0; row < m_rows; ++row) {
+            for (int column = 0; column < m_columns; ++column) {
+                const QRectF rect(column * 10, row * 10, 10, 10);
+                WindowQuad quad;
+                quad[0] = WindowVertex(rect.topLeft(), rect.topLeft());
+                quad[1] = WindowVertex(rect.topRight(), rect.topRight());
+                quad[2] = WindowVertex(rect.bottomRight(), rect.bottomRight());
+                quad[3] = WindowVertex(rect.bottomLeft(), rect.bottomLeft());
+                quads.append(quad);
+            }
+        }
+        return quads;
+    }
+
+private:
+    const int m_columns;
+    const int m_rows;
+    mutable QThread *m_quadsThread = nullptr;
+};
+
+struct WindowItems
+{
+    std::unique_ptr<GridItem> surface;
+    std::unique_ptr<GridItem> decoration;
+};
+
+}
+
+class TestGeometryJobs : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void sameGeometry();
+    void fewBatches();
+    void prepare_data();
+    void prepare();
+
+private:
+    std::vector<WindowItems> createWindows(int count);
+    QList<GeometryJobs::Batch> batches(const std::vector<WindowItems> &windows);
+};
+
+std::vector<WindowItems> TestGeometryJobs::createWindows(int count)
+{
+    std::vector<WindowItems> windows;
+    windows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        WindowItems window;
+        window.surface = std::make_unique<GridItem>(16, 16);
+        window.decoration = std::make_unique<GridItem>(4, 1, window.surface.get());
+        windows.push_back(std::move(window));
+    }
+    return windows;
+}
+
+QList<GeometryJobs::Batch> TestGeometryJobs::batches(const std::vector<WindowItems> &windows)
+{
+    QMatrix4x4 textureMatrix;
+    textureMatrix.scale(1.0 / 160, 1.0 / 160);
+
+    // the renderer builds the quads on the main thread when it collects the jobs
+    QList<GeometryJobs::Batch> batches;
+    for (const WindowItems &window : windows) {
+        window.surface->quads();
+        window.decoration->quads();
+        batches.append(GeometryJobs::Batch{
+            {.item = window.surface.get(), .textureMatrix = textureMatrix},
+            {.item = window.decoration.get(), .textureMatrix = QMatrix4x4()},
+        });
+    }
+    return batches;
+}
+
+void TestGeometryJobs::sameGeometry()
+{
+    // the vertices that were built on the worker threads are the ones the renderer would build
+    const std::vector<WindowItems> windows = createWindows(32);
+    const QList<GeometryJobs::Batch> work = batches(windows);
+
+    GeometryJobs jobs(4);
+    jobs.setParallel(true);
+    jobs.run(work, 1.5);
+    QCOMPARE(jobs.statistics().parallelRuns, quint64(1));
+    QCOMPARE(jobs.statistics().jobs, quint64(64));
+
+    // the workers didn't rebuild the quads, they may only be built on the main thread
+    for (const WindowItems &window : windows) {
+        QCOMPARE(window.surface->quadsThread(), QThread::currentThread());
+        QCOMPARE(window.decoration->quadsThread(), QThread::currentThread());
+    }
+
+    for (const GeometryJobs::Batch &batch : work) {
+        for (const GeometryJobs::Job &job : batch) {
+            const Item::RenderGeometryStatistics before = Item::renderGeometryStatistics();
+            const RenderGeometry cached = job.item->renderGeometry(1.5, job.textureMatrix);
+            QCOMPARE(Item::renderGeometryStatistics().hits, before.hits + 1);
+
+            RenderGeometry expected;
+            for (const WindowQuad &quad : job.item->quads()) {
+                expected.appendWindowQuad(quad, 1.5);
+            }
+            expected.postProcessTextureCoordinates(job.textureMatrix);
+
+            QCOMPARE(cached.count(), expected.count());
+            for (int i = 0; i < expected.count(); ++i) {
+                QCOMPARE(cached[i].position, expected[i].position);
+                QCOMPARE(cached[i].texcoord, expected[i].texcoord);
+            }
+        }
+    }
+}
+
+void TestGeometryJobs::fewBatches()
+{
+    // a handful of windows is prepared right away, waking up the workers costs more
+    const std::vector<WindowItems> windows = createWindows(GeometryJobs::s_minimumParallelBatches - 1);
+
+    GeometryJobs jobs(4);
+    jobs.setParallel(true);
+    jobs.run(batches(windows), 1);
+    QCOMPARE(jobs.statistics().runs, quint64(1));
+    QCOMPARE(jobs.statistics().parallelRuns, quint64(0));
+}
+
+void TestGeometryJobs::prepare_data()
+{
+    QTest::addColumn<bool>("parallel");
+
+    QTest::addRow("serial") << false;
+    QTest::addRow("parallel") << true;
+}
+
+void TestGeometryJobs::prepare()
+{
+    // 150 windows in the overview, every one of them is scaled in every frame, so the vertices
+    // of all windows are rebuilt after their quads changed
+    QFETCH(bool, parallel);
+
+    const std::vector<WindowItems> windows = createWindows(150);
+    const QList<GeometryJobs::Batch> work = batches(windows);
+
+    GeometryJobs jobs;
+    jobs.setParallel(parallel);
+    QBENCHMARK {
+        for (const WindowItems &window : windows) {
+            window.surface->invalidate();
+            window.surface->quads();
+            window.decoration->invalidate();
+            window.decoration->quads();
+        }
+        jobs.run(work, 1);
+    }
+
+    QCOMPARE(jobs.statistics().jobs, jobs.statistics().runs * 300);
+}
+
+QTEST_GUILESS_MAIN(TestGeometryJobs)
+#include "test_geometry_jobs.moc"
@@ -0,0 +1,78 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/ghostitem.h"
+
+#include <QTest>
+
+using namespace KWin;
+
+Q_DECLARE_METATYPE(KWin::GhostItem::Candidate)
+
+class TestGhostItem : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void freeze();
+    void keepLive_data();
+    void keepLive();
+};
+
+void TestGhostItem::freeze()
+{
+    // a closed window that is only animated as a whole, e.g. faded out, gets frozen
+    QVERIFY(GhostItem::canFreeze(GhostItem::Candidate{
+        .closed = true,
+        .hasContents = true,
+    }));
+}
+
+void TestGhostItem::keepLive_data()
+{
+    QTest::addColumn<GhostItem::Candidate>("candidate");
+
+    QTest::addRow("open") << GhostItem::Candidate{
+        .closed = false,
+        .hasContents = true,
+    };
+    QTest::addRow("no contents") << GhostItem::Candidate{
+        .closed = true,
+        .hasContents = false,
+    };
+    QTest::addRow("live contents") << GhostItem::Candidate{
+        .closed = true,
+        .hasContents = true,
+        .liveContentsRefs = 1,
+    };
+    QTest::addRow("forced visible") << GhostItem::Candidate{
+        .closed = true,
+        .hasContents = true,
+        .forcedVisible = true,
+    };
+    QTest::addRow("thumbnail") << GhostItem::Candidate{
+        .closed = true,
+        .hasContents = true,
+        .offscreenRendering = true,
+    };
+    QTest::addRow("grabbed") << GhostItem::Candidate{
+        .closed = true,
+        .hasContents = true,
+        .grabbed = true,
+    };
+}
+
+void TestGhostItem::keepLive()
+{
+    QFETCH(GhostItem::Candidate, candidate);
+
+    QVERIFY(!GhostItem::canFreeze(candidate));
+}
+
+QTEST_GUILESS_MAIN(TestGhostItem)
+#include "test_ghost_item.moc"
@@ -0,0 +1,119 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "idledetector.h"
+#include "idletracker.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestIdleTracker : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void idleAndResume();
+    void activityDelaysIdle();
+    void inhibition();
+    void zeroTimeout();
+    void benchmarkActivity();
+};
+
+void TestIdleTracker::idleAndResume()
+{
+    IdleTracker tracker;
+    IdleDetector detector(&tracker, 50ms);
+    QSignalSpy idleSpy(&detector, &IdleDetector::idle);
+    QSignalSpy resumedSpy(&detector, &IdleDetector::resumed);
+
+    QVERIFY(idleSpy.wait());
+    QVERIFY(detector.isIdle());
+
+    tracker.activity();
+    QCOMPARE(resumedSpy.count(), 1);
+    QVERIFY(!detector.isIdle());
+
+    QVERIFY(idleSpy.wait());
+    QCOMPARE(idleSpy.count(), 2);
+}
+
+void TestIdleTracker::activityDelaysIdle()
+{
+    IdleTracker tracker;
+    IdleDetector shortDetector(&tracker, 100ms);
+    IdleDetector longDetector(&tracker, 300ms);
+    QSignalSpy shortSpy(&shortDetector, &IdleDetector::idle);
+    QSignalSpy longSpy(&longDetector, &IdleDetector::idle);
+
+    // keep the user busy for a while, nobody should go idle and the timer should not be touched
+    const quint64 restarts = tracker.timerRestarts();
+    for (int i = 0; i < 10; ++i) {
+        QTest::qWait(20);
+        tracker.activity();
+    }
+    QVERIFY(shortSpy.isEmpty());
+    QVERIFY(longSpy.isEmpty());
+    QVERIFY(tracker.timerRestarts() - restarts <= 5);
+
+    QVERIFY(shortSpy.wait());
+    QVERIFY(longSpy.isEmpty());
+    QVERIFY(longSpy.wait());
+    QCOMPARE(shortSpy.count(), 1);
+}
+
+void TestIdleTracker::inhibition()
+{
+    IdleTracker tracker;
+    tracker.setInhibited(true);
+
+    IdleDetector detector(&tracker, 20ms);
+    QVERIFY(detector.isInhibited());
+    QSignalSpy idleSpy(&detector, &IdleDetector::idle);
+    QVERIFY(!idleSpy.wait(100));
+
+    tracker.setInhibited(false);
+    QVERIFY(!detector.isInhibited());
+    QVERIFY(idleSpy.wait());
+}
+
+void TestIdleTracker::zeroTimeout()
+{
+    IdleTracker tracker;
+    auto detector = std::make_unique<IdleDetector>(&tracker, 0ms);
+    QSignalSpy idleSpy(detector.get(), &IdleDetector::idle);
+    QSignalSpy resumedSpy(detector.get(), &IdleDetector::resumed);
+
+    QVERIFY(idleSpy.wait());
+    tracker.activity();
+    QCOMPARE(resumedSpy.count(), 1);
+
+    detector.reset();
+    QVERIFY(tracker.detectors().isEmpty());
+}
+
+void TestIdleTracker::benchmarkActivity()
+{
+    IdleTracker tracker;
+    std::vector<std::unique_ptr<IdleDetector>> detectors;
+    for (int i = 0; i < 20; ++i) {
+        detectors.push_back(std::make_unique<IdleDetector>(&tracker, std::chrono::minutes(i + 1)));
+    }
+
+    const quint64 restarts = tracker.timerRestarts();
+    QBENCHMARK {
+        tracker.activity();
+    }
+    // input events must not restart the timer while nobody is idle
+    QCOMPARE(tracker.timerRestarts(), restarts);
+}
+
+QTEST_GUILESS_MAIN(TestIdleTracker)
+#include "test_idle_tracker.moc"
@@ -0,0 +1,140 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/lookupindex.h"
+
+#include <QTest>
+#include <QUuid>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace KWin;
+
+struct FakeWindow
+{
+    QUuid internalId() const
+    {
+        return id;
+    }
+
+    QUuid id = QUuid::createUuid();
+};
+
+class TestLookupIndex : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void lookup();
+    void reusedKey();
+    void resolveUuids_data();
+    void resolveUuids();
+};
+
+void TestLookupIndex::lookup()
+{
+    FakeWindow a;
+    FakeWindow b;
+
+    LookupIndex<QUuid, FakeWindow> index;
+    QCOMPARE(index.find(a.internalId()), nullptr);
+
+    index.insert(a.internalId(), &a);
+    index.insert(b.internalId(), &b);
+    QCOMPARE(index.find(a.internalId()), &a);
+    QCOMPARE(index.find(b.internalId()), &b);
+    QCOMPARE(index.find(QUuid()), nullptr);
+    QCOMPARE(index.size(), qsizetype(2));
+
+    index.remove(a.internalId(), &a);
+    index.remove(a.internalId(), &a);
+    QCOMPARE(index.find(a.internalId()), nullptr);
+    QCOMPARE(index.size(), qsizetype(1));
+
+    index.clear();
+    QCOMPARE(index.find(b.internalId()), nullptr);
+}
+
+void TestLookupIndex::reusedKey()
+{
+    // an X11 window id can be reused by a new window before the old one is removed
+    FakeWindow old;
+    FakeWindow reused;
+
+    LookupIndex<quint32, FakeWindow> index;
+    index.insert(42, &old);
+    index.insert(42, &reused);
+    index.remove(42, &old);
+    QCOMPARE(index.find(42), &reused);
+
+    index.remove(42, &reused);
+    QCOMPARE(index.find(42), nullptr);
+}
+
+void TestLookupIndex::resolveUuids_data()
+{
+    QTest::addColumn<bool>("indexed");
+
+    QTest::addRow("scan") << false;
+    QTest::addRow("index") << true;
+}
+
+void TestLookupIndex::resolveUuids()
+{
+    // 100k lookups against 500 windows, like a task manager polling window info over D-Bus.
+    // Every tenth id belongs to a window that is gone already
+    QFETCH(bool, indexed);
+
+    std::vector<std::unique_ptr<FakeWindow>> windows;
+    QList<FakeWindow *> list;
+    LookupIndex<QUuid, FakeWindow> index;
+    for (int i = 0; i < 500; ++i) {
+        auto window = std::make_unique<FakeWindow>();
+        list.append(window.get());
+        index.insert(window->internalId(), window.get());
+        windows.push_back(std::move(window));
+    }
+
+    QList<QUuid> ids;
+    ids.reserve(100000);
+    for (int i = 0; i < 100000; ++i) {
+        ids.append(i % 10 ? windows[(i * 7919) % windows.size()]->internalId() : QUuid::createUuid());
+    }
+
+    // the predicate based lookup that Workspace::findWindow() used before
+    const auto findInList = [&list](std::function<bool(const FakeWindow *)> func) -> FakeWindow * {
+        const auto it = std::find_if(list.cbegin(), list.cend(), func);
+        return it != list.cend() ? *it : nullptr;
+    };
+
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QUuid &id : std::as_const(ids)) {
+            FakeWindow *window = nullptr;
+            if (indexed) {
+                window = index.find(id);
+            } else {
+                window = findInList([&id](const FakeWindow *window) {
+                    return window->internalId() == id;
+                });
+            }
+            if (window) {
+                found++;
+            }
+        }
+    }
+
+    QCOMPARE(found, 90000);
+}
+
+QTEST_GUILESS_MAIN(TestLookupIndex)
+#include "test_lookup_index.moc"
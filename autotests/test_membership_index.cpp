@@ -0,0 +1,188 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/membershipindex.h"
+#include "virtualdesktops.h"
+
+#include <QTest>
+
+using namespace KWin;
+
+struct FakeWindow
+{
+    int stackingOrder() const
+    {
+        return order;
+    }
+
+    int order = 0;
+    QList<VirtualDesktop *> desktops;
+    QStringList activities;
+};
+
+class TestMembershipIndex : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void membership();
+    void order();
+    void switchDesktops_data();
+    void switchDesktops();
+};
+
+void TestMembershipIndex::membership()
+{
+    VirtualDesktop first;
+    VirtualDesktop second;
+    FakeWindow a{.order = 0};
+    FakeWindow b{.order = 1};
+    FakeWindow sticky{.order = 2};
+
+    MembershipIndex<VirtualDesktop *, FakeWindow> index;
+    QVERIFY(index.isEmpty(&first));
+
+    index.update(&a, {&first});
+    index.update(&b, {&first, &second});
+    index.update(&sticky, {});
+    QCOMPARE(index.count(&first), qsizetype(3));
+    QCOMPARE(index.count(&second), qsizetype(2));
+    QCOMPARE(index.countEverywhere(), qsizetype(1));
+    QVERIFY(index.contains(&second, &sticky));
+    QVERIFY(!index.contains(&second, &a));
+
+    index.update(&b, {&second});
+    QCOMPARE(index.count(&first), qsizetype(2));
+    QCOMPARE(index.items(&second), (QList<FakeWindow *>{&b, &sticky}));
+
+    index.remove(&sticky);
+    index.remove(&sticky);
+    QCOMPARE(index.items(&first), QList<FakeWindow *>{&a});
+    QCOMPARE(index.countEverywhere(), qsizetype(0));
+
+    // listing a key twice doesn't leave anything behind
+    index.update(&a, {&second, &second});
+    index.remove(&a);
+    QVERIFY(index.isEmpty(&first));
+    QCOMPARE(index.items(&second), QList<FakeWindow *>{&b});
+}
+
+void TestMembershipIndex::order()
+{
+    VirtualDesktop desktop;
+    FakeWindow a{.order = 0};
+    FakeWindow b{.order = 1};
+    FakeWindow sticky{.order = 2};
+
+    MembershipIndex<VirtualDesktop *, FakeWindow> index;
+    index.update(&b, {&desktop});
+    index.update(&a, {&desktop});
+    index.update(&sticky, {});
+    QCOMPARE(index.items(&desktop), (QList<FakeWindow *>{&a, &b, &sticky}));
+
+    sticky.order = -1;
+    a.order = 3;
+    index.invalidateOrder();
+    QCOMPARE(index.items(&desktop), (QList<FakeWindow *>{&sticky, &b, &a}));
+}
+
+void TestMembershipIndex::switchDesktops_data()
+{
+    QTest::addColumn<bool>("indexed");
+
+    QTest::addRow("filter") << false;
+    QTest::addRow("index") << true;
+}
+
+void TestMembershipIndex::switchDesktops()
+{
+    // 400 windows spread over 20 desktops and 4 activities, every tenth is on all desktops
+    // and every fifth on all activities. For every desktop and activity the windows on it
+    // are listed and counted, like switching through all of them does
+    QFETCH(bool, indexed);
+
+    std::vector<std::unique_ptr<VirtualDesktop>> desktops;
+    for (int i = 0; i < 20; ++i) {
+        desktops.push_back(std::make_unique<VirtualDesktop>());
+    }
+    const QStringList activities{QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("d")};
+
+    std::vector<std::unique_ptr<FakeWindow>> windows;
+    QList<FakeWindow *> stackingOrder;
+    for (int i = 0; i < 400; ++i) {
+        auto window = std::make_unique<FakeWindow>();
+        window->order = i;
+        if (i % 10) {
+            window->desktops = {desktops[i % desktops.size()].get()};
+        }
+        if (i % 5) {
+            window->activities = {activities[i % activities.size()]};
+        }
+        stackingOrder.append(window.get());
+        windows.push_back(std::move(window));
+    }
+
+    MembershipIndex<VirtualDesktop *, FakeWindow> desktopIndex;
+    MembershipIndex<QString, FakeWindow> activityIndex;
+    for (const auto &window : windows) {
+        desktopIndex.update(window.get(), window->desktops);
+        activityIndex.update(window.get(), window->activities);
+    }
+
+    qsizetype listed = 0;
+    qsizetype counted = 0;
+    QBENCHMARK {
+        listed = 0;
+        counted = 0;
+        if (indexed) {
+            // a restack between the queries forces the lists to be sorted again
+            desktopIndex.invalidateOrder();
+            activityIndex.invalidateOrder();
+            for (const auto &desktop : desktops) {
+                listed += desktopIndex.items(desktop.get()).size();
+                counted += desktopIndex.count(desktop.get());
+            }
+            for (const QString &activity : activities) {
+                listed += activityIndex.items(activity).size();
+                counted += activityIndex.count(activity);
+            }
+        } else {
+            for (const auto &desktop : desktops) {
+                QList<FakeWindow *> onDesktop;
+                for (FakeWindow *window : std::as_const(stackingOrder)) {
+                    if (window->desktops.isEmpty() || window->desktops.contains(desktop.get())) {
+                        onDesktop.append(window);
+                    }
+                }
+                listed += onDesktop.size();
+                counted += std::count_if(stackingOrder.cbegin(), stackingOrder.cend(), [&desktop](const FakeWindow *window) {
+                    return window->desktops.isEmpty() || window->desktops.contains(desktop.get());
+                });
+            }
+            for (const QString &activity : activities) {
+                QList<FakeWindow *> onActivity;
+                for (FakeWindow *window : std::as_const(stackingOrder)) {
+                    if (window->activities.isEmpty() || window->activities.contains(activity)) {
+                        onActivity.append(window);
+                    }
+                }
+                listed += onActivity.size();
+                counted += std::count_if(stackingOrder.cbegin(), stackingOrder.cend(), [&activity](const FakeWindow *window) {
+                    return window->activities.isEmpty() || window->activities.contains(activity);
+                });
+            }
+        }
+    }
+
+    // the windows on all desktops and activities are listed for each of them, the others once
+    QCOMPARE(listed, qsizetype(20 * 40 + 360 + 4 * 80 + 320));
+    QCOMPARE(counted, listed);
+}
+
+QTEST_GUILESS_MAIN(TestMembershipIndex)
+#include "test_membership_index.moc"
@@ -0,0 +1,147 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "core/outputconfiguration.h"
+#include "outputconfigurationstore.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QTest>
+
+using namespace KWin;
+
+class FakeOutput : public Output
+{
+    Q_OBJECT
+
+public:
+    FakeOutput(const QString &name, const QByteArray &edid)
+    {
+        auto mode = std::make_shared<OutputMode>(QSize(1920, 1080), 60000, OutputMode::Flag::Preferred);
+
+        State state{};
+        state.modes = {mode};
+        state.currentMode = mode;
+        state.enabled = true;
+        setState(state);
+
+        Information info{};
+        info.name = name;
+        info.edid = Edid(edid);
+        setInformation(info);
+    }
+
+    RenderLoop *renderLoop() const override
+    {
+        return nullptr;
+    }
+};
+
+class TestOutputConfigurationStore : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void hotplugCycles();
+    void debouncedSave();
+
+private:
+    QString configPath() const;
+};
+
+QString TestOutputConfigurationStore::configPath() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + QStringLiteral("/kwinoutputconfig.json");
+}
+
+void TestOutputConfigurationStore::init()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QFile::remove(configPath());
+}
+
+void TestOutputConfigurationStore::hotplugCycles()
+{
+    FakeOutput laptop(QStringLiteral("eDP-1"), QByteArrayLiteral("laptop"));
+    FakeOutput dock(QStringLiteral("DP-2"), QByteArrayLiteral("dock"));
+
+    {
+        OutputConfigurationStore store;
+
+        // a long history of monitors that have been connected in the past
+        std::vector<std::unique_ptr<FakeOutput>> history;
+        for (int i = 0; i < 50; ++i) {
+            history.push_back(std::make_unique<FakeOutput>(QStringLiteral("DP-%1").arg(i % 4 + 1), QByteArray("monitor-") + QByteArray::number(i)));
+            QVERIFY(store.queryConfig({&laptop, history.back().get()}, false, nullptr, false));
+        }
+
+        // a dock that flaps its connection
+        QElapsedTimer timer;
+        timer.start();
+        std::chrono::nanoseconds longestCycle = std::chrono::nanoseconds::zero();
+        for (int i = 0; i < 100; ++i) {
+            const auto start = timer.durationElapsed();
+
+            const QList<Output *> outputs = i % 2 == 0 ? QList<Output *>{&laptop, &dock} : QList<Output *>{&laptop};
+            const auto config = store.queryConfig(outputs, false, nullptr, false);
+            QVERIFY(config);
+            if (i > 1) {
+                QCOMPARE(std::get<2>(*config), OutputConfigurationStore::ConfigType::Preexisting);
+            }
+
+            longestCycle = std::max(longestCycle, timer.durationElapsed() - start);
+        }
+        qInfo() << "100 hotplug cycles blocked for" << timer.elapsed() << "ms, longest cycle took"
+                << std::chrono::duration_cast<std::chrono::microseconds>(longestCycle).count() << "us";
+
+        // nothing has been written while the outputs were being reconfigured
+        QCOMPARE(store.saveCount(), 0u);
+        store.flush();
+        QCOMPARE(store.saveCount(), 1u);
+
+        // saving again without any changes doesn't touch the file
+        store.queryConfig({&laptop, &dock}, false, nullptr, false);
+        store.flush();
+        QCOMPARE(store.saveCount(), 1u);
+    }
+
+    QFile file(configPath());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonArray document = QJsonDocument::fromJson(file.readAll()).array();
+    QCOMPARE(document.size(), 2);
+    QCOMPARE(document[0].toObject()[QStringLiteral("data")].toArray().size(), 52);
+
+    // the stored setups are found again after a restart
+    OutputConfigurationStore store;
+    const auto config = store.queryConfig({&laptop, &dock}, false, nullptr, false);
+    QVERIFY(config);
+    QCOMPARE(std::get<2>(*config), OutputConfigurationStore::ConfigType::Preexisting);
+}
+
+void TestOutputConfigurationStore::debouncedSave()
+{
+    FakeOutput output(QStringLiteral("DP-1"), QByteArrayLiteral("monitor"));
+
+    OutputConfigurationStore store;
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(store.queryConfig({&output}, false, nullptr, false));
+    }
+    QVERIFY(!QFile::exists(configPath()));
+
+    QTRY_COMPARE(store.saveCount(), 1u);
+    store.flush();
+    QVERIFY(QFile::exists(configPath()));
+}
+
+QTEST_GUILESS_MAIN(TestOutputConfigurationStore)
+#include "test_output_configuration_store.moc"
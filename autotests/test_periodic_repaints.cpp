@@ -0,0 +1,138 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "periodicrepaints.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestPeriodicRepaints : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void appLaunch_data();
+    void appLaunch();
+    void replace();
+    void fallBehind();
+    void destroyed();
+    void timer();
+};
+
+void TestPeriodicRepaints::appLaunch_data()
+{
+    QTest::addColumn<int>("period");
+    QTest::addColumn<int>("expectedFrames");
+
+    // the startup feedback repainted its icon after every frame, i.e. in all 300 frames
+    QTest::addRow("bouncing") << 30 << 166;
+    QTest::addRow("blinking") << 100 << 50;
+}
+
+void TestPeriodicRepaints::appLaunch()
+{
+    // an application takes 5 seconds to start on a 60 Hz output, with nothing else changing on
+    // the screen. A frame is only painted when the startup feedback has a new key frame
+    QFETCH(int, period);
+
+    std::chrono::milliseconds now = 0ms;
+    PeriodicRepaints repaints([&now]() {
+        return now;
+    });
+    QObject feedback;
+    const QRegion icon(100, 100, 24, 44);
+    repaints.setAnimation(&feedback, icon, std::chrono::milliseconds(period));
+
+    int frames = 0;
+    for (int vblank = 1; vblank <= 5 * 60; ++vblank) {
+        now = std::chrono::milliseconds(vblank * 1000 / 60);
+        const QRegion region = repaints.advance(now);
+        if (!region.isEmpty()) {
+            QCOMPARE(region, icon);
+            frames++;
+        }
+    }
+    QTEST(frames, "expectedFrames");
+    QCOMPARE(repaints.statistics().ticks, quint64(frames));
+
+    // the application has started, the output goes idle
+    repaints.removeAnimation(&feedback);
+    QVERIFY(repaints.isEmpty());
+    QVERIFY(!repaints.nextDeadline());
+    now += 1s;
+    QVERIFY(repaints.advance(now).isEmpty());
+}
+
+void TestPeriodicRepaints::replace()
+{
+    std::chrono::milliseconds now = 0ms;
+    PeriodicRepaints repaints([&now]() {
+        return now;
+    });
+    QObject feedback;
+    repaints.setAnimation(&feedback, QRegion(0, 0, 10, 10), 100ms);
+    QVERIFY(repaints.nextDeadline() == 100ms);
+
+    // the cursor moved, the icon follows it but keeps its pace
+    now = 50ms;
+    repaints.setAnimation(&feedback, QRegion(20, 0, 10, 10), 100ms);
+    QVERIFY(repaints.nextDeadline() == 100ms);
+
+    now = 100ms;
+    QCOMPARE(repaints.advance(now), QRegion(20, 0, 10, 10));
+    QVERIFY(repaints.nextDeadline() == 200ms);
+}
+
+void TestPeriodicRepaints::fallBehind()
+{
+    std::chrono::milliseconds now = 0ms;
+    PeriodicRepaints repaints([&now]() {
+        return now;
+    });
+    QObject spinner;
+    QObject feedback;
+    repaints.setAnimation(&spinner, QRegion(0, 0, 10, 10), 100ms);
+    repaints.setAnimation(&feedback, QRegion(50, 0, 10, 10), 30ms);
+
+    // a frame that took long doesn't cause a burst of frames to catch up
+    now = 350ms;
+    QCOMPARE(repaints.advance(now), QRegion(0, 0, 10, 10) + QRegion(50, 0, 10, 10));
+    QVERIFY(repaints.nextDeadline() == 380ms);
+    now = 380ms;
+    QCOMPARE(repaints.advance(now), QRegion(50, 0, 10, 10));
+    QCOMPARE(repaints.statistics().ticks, quint64(3));
+}
+
+void TestPeriodicRepaints::destroyed()
+{
+    PeriodicRepaints repaints;
+    {
+        QObject feedback;
+        repaints.setAnimation(&feedback, QRegion(0, 0, 10, 10), 100ms);
+        QVERIFY(!repaints.isEmpty());
+    }
+    QVERIFY(repaints.isEmpty());
+}
+
+void TestPeriodicRepaints::timer()
+{
+    PeriodicRepaints repaints;
+    QSignalSpy repaintSpy(&repaints, &PeriodicRepaints::repaintNeeded);
+    QObject spinner;
+    repaints.setAnimation(&spinner, QRegion(0, 0, 10, 10), 20ms);
+
+    QVERIFY(repaintSpy.wait());
+    QCOMPARE(repaintSpy.last().at(0).value<QRegion>(), QRegion(0, 0, 10, 10));
+    QVERIFY(repaintSpy.wait());
+}
+
+QTEST_GUILESS_MAIN(TestPeriodicRepaints)
+#include "test_periodic_repaints.moc"
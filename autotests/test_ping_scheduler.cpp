@@ -0,0 +1,201 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "pingscheduler.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestPingScheduler : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void hungClients();
+    void lateResponse();
+    void removeCarrier();
+    void anonymousClients();
+    void adaptiveTimeout();
+};
+
+static const std::chrono::milliseconds s_timeout = 200ms;
+
+void TestPingScheduler::hungClients()
+{
+    // 50 hung windows that belong to 3 clients
+    PingScheduler scheduler;
+    QSignalSpy unresponsiveSpy(&scheduler, &PingScheduler::unresponsiveChanged);
+    QSignalSpy killSpy(&scheduler, &PingScheduler::killRequested);
+
+    const PingScheduler::Client clients[] = {
+        {QStringLiteral("localhost"), 100},
+        {QStringLiteral("localhost"), 200},
+        {QStringLiteral("remote"), 100},
+    };
+
+    std::vector<std::unique_ptr<QObject>> windows;
+    int sentPings = 0;
+    for (int i = 0; i < 50; ++i) {
+        windows.push_back(std::make_unique<QObject>());
+        if (scheduler.schedule(windows.back().get(), clients[i % 3], s_timeout)) {
+            ++sentPings;
+        }
+    }
+    QCOMPARE(sentPings, 3);
+
+    // pinging again doesn't send anything
+    for (size_t i = 0; i < windows.size(); ++i) {
+        QVERIFY(scheduler.isPending(windows[i].get()));
+        QVERIFY(!scheduler.schedule(windows[i].get(), clients[i % 3], s_timeout));
+    }
+
+    // first stage, all windows are marked as unresponsive
+    QTRY_COMPARE(unresponsiveSpy.count(), 50);
+    for (const QList<QVariant> &arguments : std::as_const(unresponsiveSpy)) {
+        QCOMPARE(arguments.at(1).toBool(), true);
+    }
+    QVERIFY(killSpy.isEmpty());
+
+    // second stage, only one kill prompt per client
+    QVERIFY(killSpy.wait());
+    QTRY_COMPARE(killSpy.count(), 3);
+    QTest::qWait(s_timeout.count());
+    QCOMPARE(killSpy.count(), 3);
+
+    for (const PingScheduler::Client &client : clients) {
+        const PingScheduler::Statistics statistics = scheduler.statistics(client);
+        QCOMPARE(statistics.pings, 1u);
+        QCOMPARE(statistics.timeouts, 1u);
+        QVERIFY(statistics.unresponsive);
+    }
+
+    // pinging the hung clients again doesn't spawn more prompts
+    sentPings = 0;
+    for (size_t i = 0; i < windows.size(); ++i) {
+        if (scheduler.schedule(windows[i].get(), clients[i % 3], s_timeout)) {
+            ++sentPings;
+        }
+    }
+    QCOMPARE(sentPings, 3);
+    QTest::qWait(s_timeout.count() * 3);
+    QCOMPARE(killSpy.count(), 3);
+    QCOMPARE(unresponsiveSpy.count(), 50);
+}
+
+void TestPingScheduler::lateResponse()
+{
+    PingScheduler scheduler;
+    QSignalSpy unresponsiveSpy(&scheduler, &PingScheduler::unresponsiveChanged);
+    QSignalSpy killSpy(&scheduler, &PingScheduler::killRequested);
+
+    const PingScheduler::Client client{QStringLiteral("localhost"), 100};
+    QObject first;
+    QObject second;
+    QVERIFY(scheduler.schedule(&first, client, s_timeout));
+    QVERIFY(!scheduler.schedule(&second, client, s_timeout));
+
+    QVERIFY(killSpy.wait());
+    QCOMPARE(killSpy.first().first().value<QObject *>(), &first);
+    QCOMPARE(unresponsiveSpy.count(), 2);
+    QVERIFY(scheduler.isUnresponsive(&second));
+
+    // a late pong on the carrier marks the whole client as responsive again
+    unresponsiveSpy.clear();
+    scheduler.acknowledge(&first);
+    QCOMPARE(unresponsiveSpy.count(), 2);
+    for (const QList<QVariant> &arguments : std::as_const(unresponsiveSpy)) {
+        QCOMPARE(arguments.at(1).toBool(), false);
+    }
+    QVERIFY(!scheduler.isUnresponsive(&first));
+    QVERIFY(!scheduler.isUnresponsive(&second));
+    QVERIFY(!scheduler.statistics(client).unresponsive);
+
+    // once responsive, the client may be prompted again
+    QVERIFY(scheduler.schedule(&second, client, s_timeout));
+    QVERIFY(killSpy.wait());
+    QCOMPARE(killSpy.count(), 2);
+    QCOMPARE(killSpy.last().first().value<QObject *>(), &second);
+}
+
+void TestPingScheduler::removeCarrier()
+{
+    PingScheduler scheduler;
+    QSignalSpy pingSpy(&scheduler, &PingScheduler::pingRequested);
+    QSignalSpy unresponsiveSpy(&scheduler, &PingScheduler::unresponsiveChanged);
+
+    const PingScheduler::Client client{QStringLiteral("localhost"), 100};
+    QObject first;
+    QObject second;
+    QVERIFY(scheduler.schedule(&first, client, s_timeout));
+    QVERIFY(!scheduler.schedule(&second, client, s_timeout));
+
+    // the window that carried the ping is closed, another one has to ask on behalf of the client
+    scheduler.remove(&first);
+    QCOMPARE(pingSpy.count(), 1);
+    QCOMPARE(pingSpy.first().first().value<QObject *>(), &second);
+
+    scheduler.acknowledge(&second);
+    QVERIFY(!scheduler.isPending(&second));
+    QTest::qWait(s_timeout.count());
+    QVERIFY(unresponsiveSpy.isEmpty());
+
+    scheduler.remove(&second);
+    QVERIFY(!scheduler.isPending(&second));
+}
+
+void TestPingScheduler::anonymousClients()
+{
+    // windows without a pid are never deduplicated
+    PingScheduler scheduler;
+    QSignalSpy killSpy(&scheduler, &PingScheduler::killRequested);
+
+    QObject first;
+    QObject second;
+    QVERIFY(scheduler.schedule(&first, PingScheduler::Client{}, s_timeout));
+    QVERIFY(scheduler.schedule(&second, PingScheduler::Client{}, s_timeout));
+    QVERIFY(scheduler.clients().isEmpty());
+
+    QTRY_COMPARE(killSpy.count(), 2);
+
+    scheduler.remove(&first);
+    scheduler.remove(&second);
+}
+
+void TestPingScheduler::adaptiveTimeout()
+{
+    PingScheduler scheduler;
+    const PingScheduler::Client client{QStringLiteral("localhost"), 100};
+    const std::chrono::milliseconds timeout = 10s;
+
+    // no history yet, use the default timeout
+    QCOMPARE(scheduler.stageTimeout(client, timeout), timeout / 2);
+
+    QObject window;
+    QVERIFY(scheduler.schedule(&window, client, timeout));
+    QTest::qWait(50);
+    scheduler.acknowledge(&window);
+
+    const PingScheduler::Statistics statistics = scheduler.statistics(client);
+    QCOMPARE(statistics.pings, 1u);
+    QCOMPARE(statistics.timeouts, 0u);
+    QVERIFY(statistics.averageLatency >= 50ms);
+    QCOMPARE(statistics.maximumLatency, statistics.averageLatency);
+
+    // fast clients never get less time than configured
+    QCOMPARE(scheduler.stageTimeout(client, timeout), timeout / 2);
+
+    // slow clients get more time, but never more than the full timeout
+    const std::chrono::milliseconds shortTimeout = 60ms;
+    QCOMPARE(scheduler.stageTimeout(client, shortTimeout), shortTimeout);
+}
+
+QTEST_GUILESS_MAIN(TestPingScheduler)
+#include "test_ping_scheduler.moc"
@@ -0,0 +1,251 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/shadowatlas.h"
+
+#include <QRegion>
+#include <QTest>
+
+#include <array>
+#include <vector>
+
+using namespace KWin;
+
+namespace
+{
+
+/**
+ * Keeps the atlas texture in a QImage, so the uploaded tiles can be inspected.
+ */
+class FakeShadowAtlas : public ShadowAtlas
+{
+public:
+    using ShadowAtlas::ShadowAtlas;
+
+    QImage texture;
+    int deallocations = 0;
+
+protected:
+    bool allocate(const QSize &size) override
+    {
+        texture = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        texture.fill(Qt::transparent);
+        return true;
+    }
+
+    void upload(const QImage &image, const QPoint &position) override
+    {
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                texture.setPixel(position.x() + x, position.y() + y, image.pixel(x, y));
+            }
+        }
+    }
+
+    void deallocate() override
+    {
+        texture = QImage();
+        deallocations++;
+    }
+};
+
+using ShadowTiles = std::array<QImage, 8>;
+
+QImage shadowTile(const QSize &size, int seed)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            const int alpha = (x * 7 + y * 13 + seed * 31) % 256;
+            image.setPixel(x, y, qRgba(0, 0, seed % 2 ? alpha : 0, alpha));
+        }
+    }
+    return image;
+}
+
+// the corners and edges of a nine-patch shadow with the given size and colour
+ShadowTiles nineTileShadow(int size, int seed)
+{
+    ShadowTiles tiles;
+    for (int i = 0; i < 8; ++i) {
+        // odd elements are the edges, which are one pixel long
+        const QSize tileSize = i % 2 ? QSize(size, 1) : QSize(size, size);
+        tiles[i] = shadowTile(tileSize, seed * 8 + i);
+    }
+    return tiles;
+}
+
+QImage atlasContents(const FakeShadowAtlas &atlas, const QRect &rect)
+{
+    return atlas.texture.copy(rect);
+}
+
+}
+
+class TestShadowAtlas : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void windows_data();
+    void windows();
+    void gutter();
+    void grow();
+    void release();
+    void invalid();
+};
+
+void TestShadowAtlas::windows_data()
+{
+    QTest::addColumn<int>("themes");
+    QTest::addColumn<quint64>("expectedTiles");
+
+    QTest::addRow("one shadow") << 1 << quint64(8);
+    // like active and inactive windows with different shadows
+    QTest::addRow("two shadows") << 2 << quint64(16);
+}
+
+void TestShadowAtlas::windows()
+{
+    // 100 windows with nine-patch shadows, previously every window got a texture of its own
+    QFETCH(int, themes);
+    QFETCH(quint64, expectedTiles);
+
+    std::vector<ShadowTiles> shadows;
+    for (int i = 0; i < themes; ++i) {
+        shadows.push_back(nineTileShadow(32, i));
+    }
+
+    FakeShadowAtlas atlas;
+    std::vector<std::array<ShadowAtlas::Tile, 8>> windows;
+    for (int i = 0; i < 100; ++i) {
+        std::array<ShadowAtlas::Tile, 8> &tiles = windows.emplace_back();
+        const ShadowTiles &shadow = shadows[i % themes];
+        for (int j = 0; j < 8; ++j) {
+            tiles[j] = atlas.acquire(shadow[j]);
+            QVERIFY(tiles[j].isValid());
+            QCOMPARE(tiles[j].rect.size(), shadow[j].size());
+        }
+    }
+
+    const ShadowAtlas::Statistics statistics = atlas.statistics();
+    QCOMPARE(statistics.textureAllocations, quint64(1));
+    QCOMPARE(statistics.tileUploads, expectedTiles);
+    QCOMPARE(quint64(statistics.tiles), expectedTiles);
+    QCOMPARE(statistics.references, qsizetype(800));
+
+    // windows with the same shadow use the same tiles
+    for (size_t i = 0; i < windows.size(); ++i) {
+        for (int j = 0; j < 8; ++j) {
+            QCOMPARE(windows[i][j].id, windows[i % themes][j].id);
+            QCOMPARE(atlasContents(atlas, windows[i][j].rect), shadows[i % themes][j]);
+        }
+    }
+
+    // tiles don't overlap, including their gutters
+    QRegion used;
+    for (int i = 0; i < themes; ++i) {
+        for (const ShadowAtlas::Tile &tile : windows[i]) {
+            const QRect slot = tile.rect.adjusted(-1, -1, 1, 1);
+            QVERIFY(!used.intersects(slot));
+            QVERIFY(QRect(QPoint(0, 0), atlas.size()).contains(slot));
+            used += slot;
+        }
+    }
+}
+
+void TestShadowAtlas::gutter()
+{
+    FakeShadowAtlas atlas;
+    const QImage image = shadowTile(QSize(5, 3), 1);
+    const ShadowAtlas::Tile tile = atlas.acquire(image);
+    QVERIFY(tile.isValid());
+
+    // the gutter repeats the outermost pixels of the tile
+    const QRect rect = tile.rect;
+    for (int x = 0; x < rect.width(); ++x) {
+        QCOMPARE(atlas.texture.pixel(rect.x() + x, rect.top() - 1), image.pixel(x, 0));
+        QCOMPARE(atlas.texture.pixel(rect.x() + x, rect.bottom() + 1), image.pixel(x, image.height() - 1));
+    }
+    for (int y = 0; y < rect.height(); ++y) {
+        QCOMPARE(atlas.texture.pixel(rect.left() - 1, rect.y() + y), image.pixel(0, y));
+        QCOMPARE(atlas.texture.pixel(rect.right() + 1, rect.y() + y), image.pixel(image.width() - 1, y));
+    }
+    QCOMPARE(atlas.texture.pixel(rect.topLeft() - QPoint(1, 1)), image.pixel(0, 0));
+    QCOMPARE(atlas.texture.pixel(rect.bottomRight() + QPoint(1, 1)), image.pixel(image.width() - 1, image.height() - 1));
+}
+
+void TestShadowAtlas::grow()
+{
+    FakeShadowAtlas atlas(QSize(64, 64));
+
+    std::vector<QImage> images;
+    std::vector<ShadowAtlas::Tile> tiles;
+    for (int i = 0; i < 40; ++i) {
+        images.push_back(shadowTile(QSize(20, 20), i));
+        tiles.push_back(atlas.acquire(images.back()));
+        QVERIFY(tiles.back().isValid());
+    }
+
+    // the tiles keep their position and contents when the atlas grows
+    const ShadowAtlas::Statistics statistics = atlas.statistics();
+    QVERIFY(statistics.textureAllocations > 1);
+    QCOMPARE(statistics.size, atlas.texture.size());
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        QCOMPARE(atlasContents(atlas, tiles[i].rect), images[i]);
+    }
+}
+
+void TestShadowAtlas::release()
+{
+    FakeShadowAtlas atlas;
+    const QImage first = shadowTile(QSize(16, 16), 1);
+    const QImage second = shadowTile(QSize(16, 16), 2);
+
+    const ShadowAtlas::Tile a = atlas.acquire(first);
+    const ShadowAtlas::Tile b = atlas.acquire(first);
+    const ShadowAtlas::Tile c = atlas.acquire(second);
+    QCOMPARE(a.id, b.id);
+    QCOMPARE(atlas.statistics().tiles, qsizetype(2));
+
+    // the tile stays while it's referenced
+    atlas.release(a.id);
+    QCOMPARE(atlas.statistics().tiles, qsizetype(2));
+    atlas.release(b.id);
+    QCOMPARE(atlas.statistics().tiles, qsizetype(1));
+
+    // the slot of a released tile is reused
+    const ShadowAtlas::Tile d = atlas.acquire(shadowTile(QSize(16, 16), 3));
+    QCOMPARE(d.rect, a.rect);
+    QCOMPARE(atlas.statistics().textureAllocations, quint64(1));
+
+    // the texture is dropped together with the last tile
+    atlas.release(c.id);
+    atlas.release(d.id);
+    QCOMPARE(atlas.deallocations, 1);
+    QVERIFY(atlas.size().isEmpty());
+    QVERIFY(atlas.texture.isNull());
+
+    atlas.acquire(first);
+    QCOMPARE(atlas.statistics().textureAllocations, quint64(2));
+}
+
+void TestShadowAtlas::invalid()
+{
+    FakeShadowAtlas atlas(QSize(32, 32), 64);
+    QVERIFY(!atlas.acquire(QImage()).isValid());
+    QVERIFY(!atlas.acquire(shadowTile(QSize(64, 8), 1)).isValid());
+    QCOMPARE(atlas.statistics().textureAllocations, quint64(0));
+
+    // a tile bigger than the initial size makes the atlas start out bigger
+    QVERIFY(atlas.acquire(shadowTile(QSize(40, 8), 1)).isValid());
+    QCOMPARE(atlas.size(), QSize(64, 64));
+}
+
+QTEST_GUILESS_MAIN(TestShadowAtlas)
+#include "test_shadow_atlas.moc"
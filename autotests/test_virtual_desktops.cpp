@@ -54,6 +54,7 @@ private Q_SLOTS:
     void navigationWrapsAround();
     void current_data();
     void current();
+    void currentGeneration();
     void currentChangeOnCountChange_data();
     void currentChangeOnCountChange();
     void next_data();
@@ -225,6 +226,34 @@ void TestVirtualDesktops::current()
     }
 }
 
+void TestVirtualDesktops::currentGeneration()
+{
+    VirtualDesktopManager *vds = VirtualDesktopManager::self();
+    vds->setCount(4);
+    vds->setCurrent(2);
+    const quint64 initial = vds->currentGeneration();
+    QVERIFY(initial != 0);
+
+    // setting the same desktop doesn't invalidate anything
+    QVERIFY(!vds->setCurrent(2));
+    QCOMPARE(vds->currentGeneration(), initial);
+
+    QVERIFY(vds->setCurrent(3));
+    QCOMPARE(vds->currentGeneration(), initial + 1);
+
+    // adding a desktop keeps the current one
+    vds->setCount(5);
+    QCOMPARE(vds->currentGeneration(), initial + 1);
+
+    // removing the current desktop moves to another one
+    vds->removeVirtualDesktop(vds->currentDesktop());
+    QCOMPARE(vds->currentGeneration(), initial + 2);
+
+    vds->setCount(1);
+    QCOMPARE(vds->current(), 1u);
+    QCOMPARE(vds->currentGeneration(), initial + 3);
+}
+
 void TestVirtualDesktops::currentChangeOnCountChange_data()
 {
     QTest::addColumn<uint>("initCount");
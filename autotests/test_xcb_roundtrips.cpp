@@ -0,0 +1,307 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "testutils.h"
+// KWin
+#include "utils/xcbutils.h"
+// Qt
+#include <QApplication>
+#include <QTest>
+#include <private/qtx11extras_p.h>
+// xcb
+#include <xcb/xcb.h>
+// std
+#include <algorithm>
+#include <memory>
+
+using namespace KWin;
+
+namespace
+{
+struct ManageFetch
+{
+    Xcb::WindowAttributes attributes;
+    Xcb::WindowGeometry geometry;
+    Xcb::StringProperty name;
+    Xcb::StringProperty windowClass;
+    Xcb::TransientFor transientFor;
+
+    bool isValid()
+    {
+        xcb_window_t parent = XCB_WINDOW_NONE;
+        transientFor.getTransientFor(&parent);
+        return !attributes.isNull() && geometry.rect().isValid()
+            && QByteArray(name) == QByteArrayLiteral("Round trip benchmark")
+            && !QByteArray(windowClass).isEmpty();
+    }
+};
+
+template<typename T>
+T fetched(T wrapper)
+{
+    wrapper.data();
+    return wrapper;
+}
+}
+
+/**
+ * Benchmarks the round trips of common request patterns of the window manager, each once with
+ * the replies read right after sending the requests and once with the requests batched.
+ *
+ * The round trip counts are asserted on, so that a change which adds round trips to one of
+ * the patterns fails the test even where the latency of the X server is too low to notice.
+ */
+class TestXcbRoundTrips : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void counter();
+    void manageProperties_data();
+    void manageProperties();
+    void restack_data();
+    void restack();
+    void configureStorm_data();
+    void configureStorm();
+
+private:
+    static constexpr int s_windowCount = 50;
+    static constexpr int s_configureCount = 10;
+
+    Xcb::Window m_container;
+    std::vector<std::unique_ptr<Xcb::Window>> m_windows;
+};
+
+void TestXcbRoundTrips::initTestCase()
+{
+    qApp->setProperty("x11RootWindow", QVariant::fromValue<quint32>(QX11Info::appRootWindow()));
+    qApp->setProperty("x11Connection", QVariant::fromValue<void *>(QX11Info::connection()));
+}
+
+void TestXcbRoundTrips::init()
+{
+    // the windows are children of a container, so that querying the tree only returns them
+    const uint32_t values[] = {true};
+    m_container.create(QRect(0, 0, 100, 100), XCB_WINDOW_CLASS_INPUT_ONLY, XCB_CW_OVERRIDE_REDIRECT, values);
+    QVERIFY(m_container.isValid());
+
+    const QByteArray name = QByteArrayLiteral("Round trip benchmark");
+    const QByteArray windowClass = QByteArrayLiteral("roundtrips\0RoundTrips\0");
+    for (int i = 0; i < s_windowCount; ++i) {
+        auto window = std::make_unique<Xcb::Window>(QRect(i, i, 10, 10), XCB_WINDOW_CLASS_INPUT_ONLY, 0, nullptr, m_container);
+        xcb_change_property(connection(), XCB_PROP_MODE_REPLACE, *window, XCB_ATOM_WM_NAME, XCB_ATOM_STRING, 8, name.length(), name.constData());
+        xcb_change_property(connection(), XCB_PROP_MODE_REPLACE, *window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8, windowClass.length(), windowClass.constData());
+        if (i > 0) {
+            const xcb_window_t transientFor = *m_windows.front();
+            xcb_change_property(connection(), XCB_PROP_MODE_REPLACE, *window, XCB_ATOM_WM_TRANSIENT_FOR, XCB_ATOM_WINDOW, 32, 1, &transientFor);
+        }
+        window->map();
+        m_windows.push_back(std::move(window));
+    }
+    Xcb::sync();
+    Xcb::RoundTripCounter::reset();
+}
+
+void TestXcbRoundTrips::cleanup()
+{
+    m_windows.clear();
+    m_container.reset();
+}
+
+void TestXcbRoundTrips::counter()
+{
+    // replies read right after their requests each cost a round trip
+    for (int i = 0; i < 3; ++i) {
+        Xcb::WindowGeometry geometry(m_container);
+        QCOMPARE(geometry.rect(), QRect(0, 0, 100, 100));
+    }
+    QCOMPARE(Xcb::RoundTripCounter::counts().requests, quint64(3));
+    QCOMPARE(Xcb::RoundTripCounter::counts().replies, quint64(3));
+    QCOMPARE(Xcb::RoundTripCounter::counts().roundTrips, quint64(3));
+
+    // the replies of requests sent before a round trip are available after it, in any order
+    Xcb::RoundTripCounter::reset();
+    Xcb::WindowGeometry first(m_container);
+    Xcb::WindowGeometry second(*m_windows.front());
+    Xcb::Tree tree(m_container);
+    QCOMPARE(tree->children_len, uint16_t(s_windowCount));
+    QCOMPARE(first.rect(), QRect(0, 0, 100, 100));
+    QCOMPARE(second.rect(), QRect(0, 0, 10, 10));
+    QCOMPARE(Xcb::RoundTripCounter::counts().replies, quint64(3));
+    QCOMPARE(Xcb::RoundTripCounter::counts().roundTrips, quint64(1));
+
+    // discarded replies aren't waited for
+    Xcb::RoundTripCounter::reset();
+    {
+        Xcb::WindowAttributes attributes(m_container);
+    }
+    QCOMPARE(Xcb::RoundTripCounter::counts().requests, quint64(1));
+    QCOMPARE(Xcb::RoundTripCounter::counts().replies, quint64(0));
+
+    Xcb::RoundTripCounter::reset();
+    Xcb::Atom atom(QByteArrayLiteral("_KWIN_ROUND_TRIP_TEST"));
+    Xcb::sync();
+    QVERIFY(atom.isValid());
+    QCOMPARE(Xcb::RoundTripCounter::counts().requests, quint64(2));
+    QCOMPARE(Xcb::RoundTripCounter::counts().roundTrips, quint64(1));
+}
+
+void TestXcbRoundTrips::manageProperties_data()
+{
+    QTest::addColumn<int>("batch");
+    QTest::addColumn<quint64>("expectedRoundTrips");
+
+    QTest::addRow("sequential") << 0 << quint64(s_windowCount * 5);
+    QTest::addRow("per window") << 1 << quint64(s_windowCount);
+    QTest::addRow("all windows") << s_windowCount << quint64(1);
+}
+
+void TestXcbRoundTrips::manageProperties()
+{
+    // the properties X11Window::manage() reads first, fetched for many windows appearing at
+    // once. A batch of 0 reads every reply right after sending its request, otherwise the
+    // requests of a batch of windows are sent before any of their replies are read
+    QFETCH(int, batch);
+
+    int valid = 0;
+    QBENCHMARK {
+        Xcb::RoundTripCounter::reset();
+        valid = 0;
+
+        std::vector<std::unique_ptr<ManageFetch>> pending;
+        const auto readPending = [&pending, &valid]() {
+            for (const auto &fetch : pending) {
+                valid += fetch->isValid();
+            }
+            pending.clear();
+        };
+
+        for (const auto &window : m_windows) {
+            if (batch == 0) {
+                pending.emplace_back(new ManageFetch{
+                    fetched(Xcb::WindowAttributes(*window)),
+                    fetched(Xcb::WindowGeometry(*window)),
+                    fetched(Xcb::StringProperty(*window, XCB_ATOM_WM_NAME)),
+                    fetched(Xcb::StringProperty(*window, XCB_ATOM_WM_CLASS)),
+                    fetched(Xcb::TransientFor(*window)),
+                });
+            } else {
+                pending.emplace_back(new ManageFetch{
+                    Xcb::WindowAttributes(*window),
+                    Xcb::WindowGeometry(*window),
+                    Xcb::StringProperty(*window, XCB_ATOM_WM_NAME),
+                    Xcb::StringProperty(*window, XCB_ATOM_WM_CLASS),
+                    Xcb::TransientFor(*window),
+                });
+            }
+            if (int(pending.size()) >= std::max(batch, 1)) {
+                readPending();
+            }
+        }
+        readPending();
+    }
+
+    QCOMPARE(valid, s_windowCount);
+    QCOMPARE(Xcb::RoundTripCounter::counts().requests, quint64(s_windowCount * 5));
+    QTEST(Xcb::RoundTripCounter::counts().roundTrips, "expectedRoundTrips");
+}
+
+void TestXcbRoundTrips::restack_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::addRow("raise each") << false;
+    QTest::addRow("restack all") << true;
+}
+
+void TestXcbRoundTrips::restack()
+{
+    // reverse the stacking order of all windows and verify it with a single tree query
+    QFETCH(bool, batched);
+
+    QList<xcb_window_t> stack;
+    for (const auto &window : m_windows) {
+        stack.prepend(*window);
+    }
+
+    bool reversed = false;
+    QBENCHMARK {
+        Xcb::RoundTripCounter::reset();
+        if (batched) {
+            // the list is ordered top to bottom
+            Xcb::restackWindowsWithRaise(stack);
+        } else {
+            for (auto it = stack.crbegin(); it != stack.crend(); ++it) {
+                const uint32_t values[] = {XCB_STACK_MODE_ABOVE};
+                xcb_configure_window(connection(), *it, XCB_CONFIG_WINDOW_STACK_MODE, values);
+            }
+        }
+
+        Xcb::Tree tree(m_container);
+        const xcb_window_t *children = tree.children();
+        // the tree lists the children bottom to top
+        const xcb_window_t topmost = children[tree->children_len - 1];
+        reversed = topmost == stack.first();
+        std::reverse(stack.begin(), stack.end());
+    }
+
+    QVERIFY(reversed);
+    QCOMPARE(Xcb::RoundTripCounter::counts().roundTrips, quint64(1));
+}
+
+void TestXcbRoundTrips::configureStorm_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<quint64>("expectedRoundTrips");
+
+    QTest::addRow("query each") << false << quint64(s_windowCount * s_configureCount);
+    QTest::addRow("query once") << true << quint64(1);
+}
+
+void TestXcbRoundTrips::configureStorm()
+{
+    // every window gets moved several times in a row, like during an interactive resize of a
+    // group of windows, and the resulting geometries are read back
+    QFETCH(bool, batched);
+
+    int matching = 0;
+    QBENCHMARK {
+        Xcb::RoundTripCounter::reset();
+        matching = 0;
+
+        for (int i = 1; i <= s_configureCount; ++i) {
+            for (const auto &window : m_windows) {
+                window->move(QPoint(i, i));
+                if (!batched) {
+                    Xcb::WindowGeometry geometry(*window);
+                    matching += geometry.rect().topLeft() == QPoint(i, i);
+                }
+            }
+        }
+
+        if (batched) {
+            std::vector<Xcb::WindowGeometry> geometries;
+            geometries.reserve(m_windows.size());
+            for (const auto &window : m_windows) {
+                geometries.emplace_back(*window);
+            }
+            for (Xcb::WindowGeometry &geometry : geometries) {
+                matching += geometry.rect().topLeft() == QPoint(s_configureCount, s_configureCount);
+            }
+        }
+    }
+
+    QCOMPARE(matching, batched ? s_windowCount : s_windowCount * s_configureCount);
+    QTEST(Xcb::RoundTripCounter::counts().roundTrips, "expectedRoundTrips");
+}
+
+Q_CONSTRUCTOR_FUNCTION(forceXcb)
+QTEST_MAIN(TestXcbRoundTrips)
+#include "test_xcb_roundtrips.moc"
@@ -95,6 +95,7 @@ void Activities::slotCurrentChanged(const QString &newActivity)
     Q_EMIT currentAboutToChange();
     m_previous = m_current;
     m_current = newActivity;
+    ++m_currentGeneration;
 
     if (m_previous != nullUuid()) {
         m_lastVirtualDesktop[m_previous] = VirtualDesktopManager::self()->currentDesktop()->id();
@@ -49,6 +49,12 @@ public:
     const QString &current() const;
     const QString &previous() const;
 
+    /**
+     * Returns a counter that is incremented every time the current activity changes.
+     * It never returns @c 0, so callers can use that value to mark stale caches.
+     */
+    quint64 currentGeneration() const;
+
     static QString nullUuid();
 
     KActivities::Controller::ServiceStatus serviceStatus() const;
@@ -87,6 +93,7 @@ private Q_SLOTS:
 private:
     QString m_previous;
     QString m_current;
+    quint64 m_currentGeneration = 1;
     KActivities::Controller *m_controller;
     std::unordered_map<QString, QString> m_lastVirtualDesktop;
     KSharedConfig::Ptr m_config;
@@ -102,6 +109,11 @@ inline const QString &Activities::current() const
     return m_current;
 }
 
+inline quint64 Activities::currentGeneration() const
+{
+    return m_currentGeneration;
+}
+
 inline const QString &Activities::previous() const
 {
     return m_previous;
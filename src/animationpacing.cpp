@@ -0,0 +1,165 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "animationpacing.h"
+
+namespace KWin
+{
+
+static std::chrono::milliseconds steadyClock()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
+}
+
+static std::chrono::nanoseconds frameInterval(uint32_t refreshRate)
+{
+    return std::chrono::nanoseconds(1'000'000'000'000ull / refreshRate);
+}
+
+AnimationPacing::AnimationPacing(QObject *parent)
+    : AnimationPacing(steadyClock, parent)
+{
+}
+
+AnimationPacing::AnimationPacing(const Clock &clock, QObject *parent)
+    : QObject(parent)
+    , m_clock(clock)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, [this]() {
+        const QRegion region = release(m_clock());
+        if (!region.isEmpty()) {
+            Q_EMIT repaintNeeded(region);
+        }
+    });
+}
+
+AnimationPacing::~AnimationPacing()
+{
+}
+
+void AnimationPacing::setRefreshRate(QObject *owner, uint32_t refreshRate)
+{
+    if (!refreshRate) {
+        remove(owner);
+        return;
+    }
+
+    auto it = m_owners.find(owner);
+    if (it != m_owners.end()) {
+        it->refreshRate = refreshRate;
+    } else {
+        m_owners.insert(owner, Owner{
+                                   .refreshRate = refreshRate,
+                                   .region = QRegion(),
+                                   .deadline = std::nullopt,
+                                   .destroyedConnection = connect(owner, &QObject::destroyed, this, [this, owner]() {
+                                       remove(owner);
+                                   }),
+                               });
+    }
+}
+
+uint32_t AnimationPacing::refreshRate(QObject *owner) const
+{
+    const auto it = m_owners.constFind(owner);
+    return it != m_owners.constEnd() ? it->refreshRate : 0;
+}
+
+void AnimationPacing::setRenderLoopRefreshRate(uint32_t refreshRate)
+{
+    m_renderLoopInterval = refreshRate ? frameInterval(refreshRate) : std::chrono::nanoseconds::zero();
+}
+
+void AnimationPacing::remove(QObject *owner)
+{
+    auto it = m_owners.find(owner);
+    if (it == m_owners.end()) {
+        return;
+    }
+    const QRegion region = it->region;
+    disconnect(it->destroyedConnection);
+    m_owners.erase(it);
+    scheduleTimer();
+
+    // whatever was held back is still on screen and must not be left behind
+    if (!region.isEmpty()) {
+        Q_EMIT repaintNeeded(region);
+    }
+}
+
+bool AnimationPacing::defer(QObject *owner, const QRegion &region, std::chrono::milliseconds presentTime)
+{
+    auto it = m_owners.find(owner);
+    if (it == m_owners.end()) {
+        return false;
+    }
+
+    // the render loop needs about a frame to present a repaint, release the region half a frame
+    // earlier than that so that it ends up in the frame closest to when it's due rather than in
+    // the one after it
+    const std::chrono::nanoseconds lead = m_renderLoopInterval + m_renderLoopInterval / 2;
+    const std::chrono::nanoseconds interval = frameInterval(it->refreshRate);
+    if (interval <= lead) {
+        return false;
+    }
+
+    const auto deadline = presentTime + std::chrono::duration_cast<std::chrono::milliseconds>(interval - lead);
+    if (!it->deadline || deadline < *it->deadline) {
+        it->deadline = deadline;
+    }
+    it->region += region;
+    m_statistics.deferred++;
+    scheduleTimer();
+    return true;
+}
+
+QRegion AnimationPacing::release(std::chrono::milliseconds now)
+{
+    QRegion region;
+    for (Owner &owner : m_owners) {
+        if (!owner.deadline || *owner.deadline > now) {
+            continue;
+        }
+        region += owner.region;
+        owner.region = QRegion();
+        owner.deadline.reset();
+        m_statistics.released++;
+    }
+    scheduleTimer();
+    return region;
+}
+
+std::optional<std::chrono::milliseconds> AnimationPacing::nextDeadline() const
+{
+    std::optional<std::chrono::milliseconds> deadline;
+    for (const Owner &owner : m_owners) {
+        if (owner.deadline && (!deadline || *owner.deadline < *deadline)) {
+            deadline = owner.deadline;
+        }
+    }
+    return deadline;
+}
+
+AnimationPacing::Statistics AnimationPacing::statistics() const
+{
+    return m_statistics;
+}
+
+void AnimationPacing::scheduleTimer()
+{
+    const auto deadline = nextDeadline();
+    if (!deadline) {
+        m_timer.stop();
+        return;
+    }
+    m_timer.start(std::max(*deadline - m_clock(), std::chrono::milliseconds::zero()));
+}
+
+} // namespace KWin
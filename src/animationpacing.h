@@ -0,0 +1,116 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QObject>
+#include <QRegion>
+#include <QTimer>
+
+#include <chrono>
+#include <functional>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The AnimationPacing class lets animations run at a lower rate than the render loop.
+ *
+ * An effect that schedules a repaint after every frame keeps the render loop at its full rate
+ * for as long as it animates, even if its animation is slow enough that every other frame would
+ * look the same. An effect can ask for a lower rate instead. The repaints it schedules after a
+ * frame are held back until its next frame is due, and if nothing else changes in between, the
+ * render loop skips the frames in between.
+ *
+ * On X11 all outputs are painted in the same frame by a single render loop, there are no
+ * per-output frames or presentation timestamps. Animations advance in the timebase of that
+ * render loop, and their rate can only be limited below the rate of the render loop.
+ */
+class KWIN_EXPORT AnimationPacing : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Clock = std::function<std::chrono::milliseconds()>;
+
+    struct Statistics
+    {
+        /// The number of repaints that were held back
+        quint64 deferred = 0;
+        /// The number of times held back repaints were released
+        quint64 released = 0;
+    };
+
+    explicit AnimationPacing(QObject *parent = nullptr);
+    /**
+     * Creates an AnimationPacing that reads the time from @p clock, e.g. in tests.
+     */
+    explicit AnimationPacing(const Clock &clock, QObject *parent = nullptr);
+    ~AnimationPacing() override;
+
+    /**
+     * Limits the animations of @p owner to @p refreshRate, in millihertz, until @p owner is
+     * destroyed. A refresh rate of 0 removes the limit.
+     */
+    void setRefreshRate(QObject *owner, uint32_t refreshRate);
+    uint32_t refreshRate(QObject *owner) const;
+
+    /**
+     * Sets the refresh rate of the render loop, in millihertz. Held back repaints are released
+     * early enough for the render loop to present them in the frame closest to when they're due.
+     */
+    void setRenderLoopRefreshRate(uint32_t refreshRate);
+
+    /**
+     * Holds back @p region, which @p owner wants repainted after the frame presented at
+     * @p presentTime, until the next frame of @p owner is due. Returns @c false if the
+     * animations of @p owner aren't limited, the region must be repainted right away then.
+     */
+    bool defer(QObject *owner, const QRegion &region, std::chrono::milliseconds presentTime);
+
+    /**
+     * Returns the held back regions that are due at @p now and forgets about them.
+     */
+    QRegion release(std::chrono::milliseconds now);
+    /**
+     * Returns when the next held back region is due, if there is any.
+     */
+    std::optional<std::chrono::milliseconds> nextDeadline() const;
+
+    Statistics statistics() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the timer found the held back @p region to be due.
+     */
+    void repaintNeeded(const QRegion &region);
+
+private:
+    struct Owner
+    {
+        uint32_t refreshRate;
+        QRegion region;
+        std::optional<std::chrono::milliseconds> deadline;
+        QMetaObject::Connection destroyedConnection;
+    };
+
+    void remove(QObject *owner);
+    void scheduleTimer();
+
+    Clock m_clock;
+    QHash<QObject *, Owner> m_owners;
+    std::chrono::nanoseconds m_renderLoopInterval{0};
+    QTimer m_timer;
+    Statistics m_statistics;
+};
+
+} // namespace KWin
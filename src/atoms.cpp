@@ -31,6 +31,8 @@ Atoms::Atoms()
     , kde_net_wm_user_creation_time(QByteArrayLiteral("_KDE_NET_WM_USER_CREATION_TIME"))
     , net_wm_take_activity(QByteArrayLiteral("_NET_WM_TAKE_ACTIVITY"))
     , net_wm_window_opacity(QByteArrayLiteral("_NET_WM_WINDOW_OPACITY"))
+    , net_client_list(QByteArrayLiteral("_NET_CLIENT_LIST"))
+    , net_client_list_stacking(QByteArrayLiteral("_NET_CLIENT_LIST_STACKING"))
     , xdnd_selection(QByteArrayLiteral("XdndSelection"))
     , xdnd_aware(QByteArrayLiteral("XdndAware"))
     , xdnd_enter(QByteArrayLiteral("XdndEnter"))
@@ -41,6 +41,8 @@ public:
     Xcb::Atom kde_net_wm_user_creation_time;
     Xcb::Atom net_wm_take_activity;
     Xcb::Atom net_wm_window_opacity;
+    Xcb::Atom net_client_list;
+    Xcb::Atom net_client_list_stacking;
     Xcb::Atom xdnd_selection;
     Xcb::Atom xdnd_aware;
     Xcb::Atom xdnd_enter;
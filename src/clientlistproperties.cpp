@@ -0,0 +1,103 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "clientlistproperties.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+ClientListProperties::ClientListProperties(xcb_connection_t *connection, xcb_window_t rootWindow, xcb_atom_t clientList, xcb_atom_t clientListStacking)
+    : m_connection(connection)
+    , m_rootWindow(rootWindow)
+    , m_clientList{.atom = clientList}
+    , m_clientListStacking{.atom = clientListStacking}
+{
+    // a zero timeout fires once the events that are queued up now have been processed
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    QObject::connect(&m_flushTimer, &QTimer::timeout, [this]() {
+        flush();
+    });
+}
+
+ClientListProperties::~ClientListProperties()
+{
+    // the last update before the window manager goes away must still reach the root window
+    if (isFlushPending()) {
+        flush();
+        xcb_flush(m_connection);
+    }
+}
+
+void ClientListProperties::setClientList(const QList<xcb_window_t> &windows)
+{
+    update(m_clientList, windows);
+}
+
+void ClientListProperties::setClientListStacking(const QList<xcb_window_t> &windows)
+{
+    update(m_clientListStacking, windows);
+}
+
+void ClientListProperties::update(Property &property, const QList<xcb_window_t> &windows)
+{
+    property.pending = windows;
+    property.dirty = true;
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void ClientListProperties::flush()
+{
+    m_flushTimer.stop();
+    write(m_clientList, true);
+    // windows are inserted into the stacking order wherever their layer is, not at the end
+    write(m_clientListStacking, false);
+}
+
+bool ClientListProperties::isFlushPending() const
+{
+    return m_flushTimer.isActive();
+}
+
+void ClientListProperties::write(Property &property, bool canAppend)
+{
+    if (!property.dirty) {
+        return;
+    }
+    property.dirty = false;
+
+    if (property.written == property.pending) {
+        m_statistics.skipped++;
+        return;
+    }
+
+    const QList<xcb_window_t> &windows = property.pending;
+    if (canAppend && property.written && windows.size() > property.written->size()
+        && std::equal(property.written->cbegin(), property.written->cend(), windows.cbegin())) {
+        const qsizetype offset = property.written->size();
+        xcb_change_property(m_connection, XCB_PROP_MODE_APPEND, m_rootWindow, property.atom, XCB_ATOM_WINDOW,
+                            32, windows.size() - offset, windows.constData() + offset);
+        m_statistics.appends++;
+    } else {
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, m_rootWindow, property.atom, XCB_ATOM_WINDOW,
+                            32, windows.size(), windows.constData());
+    }
+    m_statistics.writes++;
+    property.written = windows;
+}
+
+ClientListProperties::Statistics ClientListProperties::statistics() const
+{
+    return m_statistics;
+}
+
+} // namespace KWin
@@ -0,0 +1,86 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QList>
+#include <QTimer>
+
+#include <optional>
+#include <xcb/xcb.h>
+
+namespace KWin
+{
+
+/**
+ * The ClientListProperties class maintains _NET_CLIENT_LIST and _NET_CLIENT_LIST_STACKING
+ * on the root window.
+ *
+ * Every write makes pagers, taskbars and docks re-read the whole list, so the lists are written
+ * at most once per event loop iteration and not at all if they didn't change. If windows were
+ * only added to the end of _NET_CLIENT_LIST, just the new windows are appended to the property.
+ */
+class KWIN_EXPORT ClientListProperties
+{
+public:
+    struct Statistics
+    {
+        /// The number of properties written, including appends
+        quint64 writes = 0;
+        /// The number of writes that only appended windows to the property
+        quint64 appends = 0;
+        /// The number of writes that were dropped because the list didn't change
+        quint64 skipped = 0;
+    };
+
+    ClientListProperties(xcb_connection_t *connection, xcb_window_t rootWindow, xcb_atom_t clientList, xcb_atom_t clientListStacking);
+    /**
+     * Writes the pending changes, if there are any.
+     */
+    ~ClientListProperties();
+
+    /**
+     * Sets the managed windows in the order they were mapped, the oldest first.
+     */
+    void setClientList(const QList<xcb_window_t> &windows);
+    /**
+     * Sets the managed windows in stacking order, the bottommost first.
+     */
+    void setClientListStacking(const QList<xcb_window_t> &windows);
+
+    /**
+     * Writes pending changes right away instead of waiting for the event loop.
+     */
+    void flush();
+    bool isFlushPending() const;
+
+    Statistics statistics() const;
+
+private:
+    struct Property
+    {
+        xcb_atom_t atom;
+        QList<xcb_window_t> pending;
+        std::optional<QList<xcb_window_t>> written;
+        bool dirty = false;
+    };
+
+    void update(Property &property, const QList<xcb_window_t> &windows);
+    void write(Property &property, bool canAppend);
+
+    xcb_connection_t *m_connection;
+    xcb_window_t m_rootWindow;
+    Property m_clientList;
+    Property m_clientListStacking;
+    QTimer m_flushTimer;
+    Statistics m_statistics;
+};
+
+} // namespace KWin
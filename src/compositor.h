@@ -41,7 +41,12 @@ public:
         On = 0,
         Off,
         Starting,
-        Stopping
+        Stopping,
+        /**
+         * The windows are unredirected, but the scene, the render backend and the
+         * effects are kept alive so compositing can be resumed quickly.
+         */
+        Suspended,
     };
 
     ~Compositor() override;
@@ -9,9 +9,11 @@
 
 #include "compositor_x11.h"
 #include "core/outputbackend.h"
+#include "core/framestatistics.h"
 #include "core/overlaywindow.h"
 #include "core/renderbackend.h"
 #include "core/renderlayer.h"
+#include "core/renderloop.h"
 #include "effect/effecthandler.h"
 #include "ftrace.h"
 #include "opengl/glplatform.h"
@@ -34,6 +36,7 @@
 #endif
 
 #include <QAction>
+#include <QElapsedTimer>
 #include <QOpenGLContext>
 #include <QQuickWindow>
 #include <QThread>
@@ -84,6 +87,9 @@ X11Compositor::X11Compositor(QObject *parent)
     if (qEnvironmentVariableIsSet("KWIN_MAX_FRAMES_TESTED")) {
         m_framesToTestForSafety = qEnvironmentVariableIntValue("KWIN_MAX_FRAMES_TESTED");
     }
+    if (qEnvironmentVariableIsSet("KWIN_X11_NO_WARM_SUSPEND")) {
+        m_warmSuspendEnabled = false;
+    }
 
     connect(options, &Options::configChanged, this, [this]() {
         if (m_suspended) {
@@ -151,7 +157,14 @@ void X11Compositor::suspend(X11Compositor::SuspendReason reason)
 {
     Q_ASSERT(reason != NoReasonSuspend);
     m_suspended |= reason;
-    stop();
+    if (m_state == State::Suspended) {
+        return;
+    }
+    if (m_warmSuspendEnabled && m_state == State::On) {
+        warmSuspend();
+    } else {
+        stop();
+    }
 }
 
 void X11Compositor::resume(X11Compositor::SuspendReason reason)
@@ -176,6 +189,7 @@ void X11Compositor::releaseCompositorSelection()
         // We are compositing at the moment. Don't release.
         break;
     case State::Off:
+    case State::Suspended:
         if (m_selectionOwner) {
             qCDebug(KWIN_CORE) << "Releasing compositor selection";
             m_selectionOwner->setOwning(false);
@@ -268,10 +282,17 @@ void X11Compositor::start()
     if (kwinApp()->isTerminating()) {
         return;
     }
+    if (m_state == State::Suspended) {
+        warmResume();
+        return;
+    }
     if (m_state != State::Off) {
         return;
     }
 
+    QElapsedTimer timer;
+    timer.start();
+
     Q_EMIT aboutToToggleCompositing();
     m_state = State::Starting;
 
@@ -364,6 +385,7 @@ void X11Compositor::start()
         m_releaseSelectionTimer.stop();
     }
 
+    m_toggleStatistics.lastStartLatency = std::chrono::duration_cast<std::chrono::microseconds>(timer.durationElapsed());
     Q_EMIT compositingToggled(true);
 }
 
@@ -372,6 +394,11 @@ void X11Compositor::stop()
     if (m_state == State::Off || m_state == State::Stopping) {
         return;
     }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool wasSuspended = m_state == State::Suspended;
     m_state = State::Stopping;
     Q_EMIT aboutToToggleCompositing();
 
@@ -388,9 +415,14 @@ void X11Compositor::stop()
         for (Window *window : windows) {
             window->finishCompositing();
         }
-        xcb_composite_unredirect_subwindows(kwinApp()->x11Connection(),
-                                            kwinApp()->x11RootWindow(),
-                                            XCB_COMPOSITE_REDIRECT_MANUAL);
+        if (!wasSuspended) {
+            xcb_composite_unredirect_subwindows(kwinApp()->x11Connection(),
+                                                kwinApp()->x11RootWindow(),
+                                                XCB_COMPOSITE_REDIRECT_MANUAL);
+        }
+    }
+    if (wasSuspended) {
+        setRenderLoopsInhibited(false);
     }
 
     if (m_backend->compositingType() == OpenGLCompositing) {
@@ -410,24 +442,128 @@ void X11Compositor::stop()
     kwinApp()->setX11CompositeWindow(XCB_WINDOW_NONE);
 
     m_state = State::Off;
+    m_toggleStatistics.lastStopLatency = std::chrono::duration_cast<std::chrono::microseconds>(timer.durationElapsed());
+    Q_EMIT compositingToggled(false);
+}
+
+void X11Compositor::warmSuspend()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Q_EMIT aboutToToggleCompositing();
+    m_state = State::Suspended;
+    m_releaseSelectionTimer.start();
+
+    // Keep the scene, the effects and the OpenGL context, only stop painting
+    setRenderLoopsInhibited(true);
+    if (OverlayWindow *overlayWindow = m_backend->overlayWindow()) {
+        overlayWindow->hide();
+    }
+
+    const auto windows = workspace()->windows();
+    for (Window *window : windows) {
+        window->suspendCompositing();
+    }
+    xcb_composite_unredirect_subwindows(kwinApp()->x11Connection(),
+                                        kwinApp()->x11RootWindow(),
+                                        XCB_COMPOSITE_REDIRECT_MANUAL);
+
+    kwinApp()->setX11CompositeWindow(XCB_WINDOW_NONE);
+
+    ++m_toggleStatistics.warmSuspends;
+    m_toggleStatistics.lastSuspendLatency = std::chrono::duration_cast<std::chrono::microseconds>(timer.durationElapsed());
+    qCDebug(KWIN_CORE) << "Compositing suspended in" << m_toggleStatistics.lastSuspendLatency;
     Q_EMIT compositingToggled(false);
 }
 
+void X11Compositor::warmResume()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Q_EMIT aboutToToggleCompositing();
+    m_state = State::Starting;
+
+    if (!m_selectionOwner->owning()) {
+        // Force claim ownership.
+        m_selectionOwner->claim(true);
+        m_selectionOwner->setOwning(true);
+    }
+    if (m_releaseSelectionTimer.isActive()) {
+        m_releaseSelectionTimer.stop();
+    }
+
+    xcb_composite_redirect_subwindows(kwinApp()->x11Connection(),
+                                      kwinApp()->x11RootWindow(),
+                                      XCB_COMPOSITE_REDIRECT_MANUAL);
+    kwinApp()->setX11CompositeWindow(backend()->overlayWindow()->window());
+
+    m_state = State::On;
+
+    // The window pixmaps are bound again as the windows get painted rather than all at once
+    const auto windows = workspace()->windows();
+    for (Window *window : windows) {
+        if (window->windowItem()) {
+            window->resumeCompositing();
+        } else {
+            window->setupCompositing();
+        }
+    }
+
+    setRenderLoopsInhibited(false);
+    m_scene->addRepaintFull();
+
+    ++m_toggleStatistics.warmResumes;
+    m_toggleStatistics.lastResumeLatency = std::chrono::duration_cast<std::chrono::microseconds>(timer.durationElapsed());
+    qCDebug(KWIN_CORE) << "Compositing resumed in" << m_toggleStatistics.lastResumeLatency;
+    Q_EMIT compositingToggled(true);
+}
+
+void X11Compositor::setRenderLoopsInhibited(bool inhibited)
+{
+    for (auto it = m_superlayers.cbegin(); it != m_superlayers.cend(); ++it) {
+        if (inhibited) {
+            it.key()->inhibit();
+        } else {
+            it.key()->uninhibit();
+        }
+    }
+}
+
+X11Compositor::ToggleStatistics X11Compositor::toggleStatistics() const
+{
+    return m_toggleStatistics;
+}
+
 void X11Compositor::composite(RenderLoop *renderLoop)
 {
+    if (m_state == State::Suspended) {
+        return;
+    }
     if (backend()->overlayWindow() && !backend()->overlayWindow()->isVisible()) {
         // Return since nothing is visible.
         return;
     }
 
+    FrameStatistics *statistics = renderLoop->frameStatistics();
+    const auto frameStart = std::chrono::steady_clock::now();
+    auto phaseStart = frameStart;
+    const auto endPhase = [statistics, &phaseStart](FrameStatistics::Phase phase) {
+        const auto now = std::chrono::steady_clock::now();
+        statistics->addSample(phase, now - phaseStart);
+        phaseStart = now;
+    };
+
     QList<Window *> windows = workspace()->stackingOrder();
     QList<SurfaceItemX11 *> dirtyItems;
 
     // Reset the damage state of each window and fetch the damage region
     // without waiting for a reply
     for (Window *window : std::as_const(windows)) {
+        // closed windows that have become ghosts have no surface anymore
         SurfaceItemX11 *surfaceItem = static_cast<SurfaceItemX11 *>(window->surfaceItem());
-        if (surfaceItem->fetchDamage()) {
+        if (surfaceItem && surfaceItem->fetchDamage()) {
             dirtyItems.append(surfaceItem);
         }
     }
@@ -443,6 +579,7 @@ void X11Compositor::composite(RenderLoop *renderLoop)
     for (SurfaceItemX11 *item : std::as_const(dirtyItems)) {
         item->waitForDamage();
     }
+    endPhase(FrameStatistics::Phase::Damage);
 
     if (m_framesToTestForSafety > 0 && (backend()->compositingType() & OpenGLCompositing)) {
         createOpenGLSafePoint(OpenGLSafePoint::PreFrame);
@@ -471,10 +608,12 @@ void X11Compositor::composite(RenderLoop *renderLoop)
 
     if (primaryLayer->needsRepaint() || superLayer->needsRepaint()) {
         renderLoop->beginPaint();
+        phaseStart = std::chrono::steady_clock::now();
 
         QRegion surfaceDamage = primaryLayer->repaints();
         primaryLayer->resetRepaints();
         prePaintPass(superLayer, &surfaceDamage);
+        endPhase(FrameStatistics::Phase::PrePaint);
 
         if (auto beginInfo = primaryLayer->beginFrame()) {
             auto &[renderTarget, repaint] = beginInfo.value();
@@ -484,11 +623,15 @@ void X11Compositor::composite(RenderLoop *renderLoop)
             paintPass(superLayer, renderTarget, bufferDamage);
             primaryLayer->endFrame(bufferDamage, surfaceDamage, frame.get());
         }
+        endPhase(FrameStatistics::Phase::Paint);
 
         postPaintPass(superLayer);
+        endPhase(FrameStatistics::Phase::PostPaint);
     }
 
+    phaseStart = std::chrono::steady_clock::now();
     m_backend->present(nullptr, frame);
+    endPhase(FrameStatistics::Phase::Present);
 
     framePass(superLayer, frame.get());
 
@@ -500,6 +643,8 @@ void X11Compositor::composite(RenderLoop *renderLoop)
         }
     }
 
+    statistics->addSample(FrameStatistics::Phase::Total, std::chrono::steady_clock::now() - frameStart);
+
     if (m_framesToTestForSafety > 0) {
         if (backend()->compositingType() & OpenGLCompositing) {
             createOpenGLSafePoint(OpenGLSafePoint::PostFrame);
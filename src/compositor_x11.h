@@ -13,6 +13,8 @@
 #include "compositor.h"
 #include <QSet>
 
+#include <chrono>
+
 namespace KWin
 {
 
@@ -34,6 +36,16 @@ public:
     Q_ENUM(SuspendReason)
     Q_FLAG(SuspendReasons)
 
+    struct ToggleStatistics
+    {
+        uint warmSuspends = 0;
+        uint warmResumes = 0;
+        std::chrono::microseconds lastSuspendLatency = std::chrono::microseconds::zero();
+        std::chrono::microseconds lastResumeLatency = std::chrono::microseconds::zero();
+        std::chrono::microseconds lastStartLatency = std::chrono::microseconds::zero();
+        std::chrono::microseconds lastStopLatency = std::chrono::microseconds::zero();
+    };
+
     static X11Compositor *create(QObject *parent = nullptr);
     ~X11Compositor() override;
 
@@ -52,6 +64,10 @@ public:
     /**
      * @brief Suspends the Compositor if it is currently active.
      *
+     * The compositor is suspended warm: the windows get unredirected and the render loop
+     * stops, but the OpenGL context, the scene and the effects stay alive, so a subsequent
+     * resume doesn't have to set them up again.
+     *
      * Note: it is possible that the Compositor is not able to suspend. Use isActive to check
      * whether the Compositor has been suspended.
      *
@@ -105,6 +121,11 @@ public:
     QString compositingNotPossibleReason() const override;
     bool openGLCompositingIsBroken() const override;
 
+    /**
+     * Returns the latencies of the most recent compositing state changes.
+     */
+    ToggleStatistics toggleStatistics() const;
+
     static X11Compositor *self();
 
 protected:
@@ -114,6 +135,9 @@ private:
     explicit X11Compositor(QObject *parent);
 
     bool attemptOpenGLCompositing();
+    void warmSuspend();
+    void warmResume();
+    void setRenderLoopsInhibited(bool inhibited);
 
     void releaseCompositorSelection();
     void destroyCompositorSelection();
@@ -129,6 +153,8 @@ private:
     SuspendReasons m_suspended;
     QSet<Window *> m_inhibitors;
     int m_framesToTestForSafety = 3;
+    bool m_warmSuspendEnabled = true;
+    ToggleStatistics m_toggleStatistics;
 };
 
 } // namespace KWin
@@ -0,0 +1,212 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "framescheduler.h"
+#include "utils/common.h"
+
+#include <cmath>
+
+using namespace std::chrono_literals;
+
+namespace KWin
+{
+
+static std::chrono::nanoseconds steadyClock()
+{
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+
+FrameScheduler::FrameScheduler()
+    : FrameScheduler(steadyClock)
+{
+}
+
+FrameScheduler::FrameScheduler(const Clock &clock)
+    : m_clock(clock)
+{
+}
+
+std::chrono::nanoseconds FrameScheduler::now() const
+{
+    return m_clock();
+}
+
+int FrameScheduler::refreshRate() const
+{
+    return m_refreshRate;
+}
+
+void FrameScheduler::setRefreshRate(int refreshRate)
+{
+    m_refreshRate = refreshRate;
+}
+
+std::chrono::nanoseconds FrameScheduler::safetyMargin() const
+{
+    return m_safetyMargin;
+}
+
+void FrameScheduler::setSafetyMargin(std::chrono::nanoseconds safetyMargin)
+{
+    m_safetyMargin = safetyMargin;
+}
+
+PresentationMode FrameScheduler::presentationMode() const
+{
+    return m_presentationMode;
+}
+
+void FrameScheduler::setPresentationMode(PresentationMode mode)
+{
+    m_presentationMode = mode;
+}
+
+int FrameScheduler::maxPendingFrameCount() const
+{
+    return m_maxPendingFrameCount;
+}
+
+void FrameScheduler::setMaxPendingFrameCount(int maxCount)
+{
+    m_maxPendingFrameCount = maxCount;
+}
+
+bool FrameScheduler::canSubmitFrame() const
+{
+    const bool vrr = m_presentationMode == PresentationMode::AdaptiveSync || m_presentationMode == PresentationMode::AdaptiveAsync;
+    const bool tearing = m_presentationMode == PresentationMode::Async || m_presentationMode == PresentationMode::AdaptiveAsync;
+    const int effectiveMaxPendingFrameCount = (vrr || tearing) ? 1 : m_maxPendingFrameCount;
+    return m_pendingFrameCount < effectiveMaxPendingFrameCount;
+}
+
+int FrameScheduler::pendingFrameCount() const
+{
+    return m_pendingFrameCount;
+}
+
+std::chrono::nanoseconds FrameScheduler::schedule(std::chrono::nanoseconds lastTargetTimestamp, bool rescheduling)
+{
+    const std::chrono::nanoseconds vblankInterval(1'000'000'000'000ull / m_refreshRate);
+    const std::chrono::nanoseconds currentTime = m_clock();
+
+    // Estimate when it's a good time to perform the next compositing cycle.
+    // the 1ms on top of the safety margin is required for timer and scheduler inaccuracies
+    std::chrono::nanoseconds expectedCompositingTime = std::min(m_renderJournal.result() + m_safetyMargin + 1ms, 2 * vblankInterval);
+
+    if (m_presentationMode == PresentationMode::VSync) {
+        // normal presentation: pageflips only happen at vblank
+        const uint64_t pageflipsSince = std::max<int64_t>((currentTime - m_lastPresentationTimestamp) / vblankInterval, 0);
+        if (pageflipsSince > 100) {
+            // if it's been a while since the last frame, the GPU is likely in a low power state and render time will be increased
+            // -> take that into account and start compositing very early
+            expectedCompositingTime = std::max(vblankInterval - 1us, expectedCompositingTime);
+        }
+        const uint64_t pageflipsSinceLastToTarget = std::max<int64_t>(std::round((lastTargetTimestamp - m_lastPresentationTimestamp).count() / double(vblankInterval.count())), 0);
+        uint64_t pageflipsInAdvance = std::min<int64_t>(expectedCompositingTime / vblankInterval + 1, m_maxPendingFrameCount);
+
+        // switching from double to triple buffering causes a frame drop
+        // -> apply some amount of hysteresis to avoid switching back and forth constantly
+        if (pageflipsInAdvance > 1) {
+            // immediately switch to triple buffering when needed
+            m_wasTripleBuffering = true;
+            m_doubleBufferingCounter = 0;
+        } else if (m_wasTripleBuffering) {
+            // but wait a bit before switching back to double buffering
+            if (m_doubleBufferingCounter >= 10) {
+                m_wasTripleBuffering = false;
+            } else if (expectedCompositingTime >= vblankInterval * 0.95) {
+                // also don't switch back if render times are just barely enough for double buffering
+                pageflipsInAdvance = 2;
+                m_doubleBufferingCounter = 0;
+                expectedCompositingTime = vblankInterval;
+            } else {
+                m_doubleBufferingCounter++;
+                pageflipsInAdvance = 2;
+                expectedCompositingTime = vblankInterval;
+            }
+        }
+
+        if (rescheduling) {
+            // we already scheduled this frame, but we got a new timestamp
+            // which might require starting to composite earlier than we planned
+            // It's important here that we do not change the targeted vblank interval,
+            // otherwise with a pessimistic compositing time estimation we might
+            // unnecessarily drop frames
+            const uint32_t intervalsSinceLastTimestamp = std::max<int32_t>(std::round((m_nextPresentationTimestamp - m_lastPresentationTimestamp).count() / double(vblankInterval.count())), 0);
+            m_nextPresentationTimestamp = m_lastPresentationTimestamp + intervalsSinceLastTimestamp * vblankInterval;
+        } else {
+            m_nextPresentationTimestamp = m_lastPresentationTimestamp + std::max(pageflipsSince + pageflipsInAdvance, pageflipsSinceLastToTarget + 1) * vblankInterval;
+        }
+    } else {
+        m_wasTripleBuffering = false;
+        m_doubleBufferingCounter = 0;
+        if (m_presentationMode == PresentationMode::Async || m_presentationMode == PresentationMode::AdaptiveAsync) {
+            // tearing: pageflips happen ASAP
+            m_nextPresentationTimestamp = currentTime;
+        } else {
+            // adaptive sync: pageflips happen after one vblank interval
+            // TODO read minimum refresh rate from the EDID and take it into account here
+            m_nextPresentationTimestamp = m_lastPresentationTimestamp + vblankInterval;
+        }
+    }
+
+    return m_nextPresentationTimestamp - expectedCompositingTime;
+}
+
+std::chrono::nanoseconds FrameScheduler::lastPresentationTimestamp() const
+{
+    return m_lastPresentationTimestamp;
+}
+
+std::chrono::nanoseconds FrameScheduler::nextPresentationTimestamp() const
+{
+    return m_nextPresentationTimestamp;
+}
+
+std::chrono::nanoseconds FrameScheduler::predictedRenderTime() const
+{
+    return m_renderJournal.result();
+}
+
+void FrameScheduler::frameSubmitted()
+{
+    m_pendingFrameCount++;
+}
+
+void FrameScheduler::frameDropped()
+{
+    Q_ASSERT(m_pendingFrameCount > 0);
+    m_pendingFrameCount--;
+}
+
+void FrameScheduler::framePresented(std::chrono::nanoseconds timestamp, std::optional<std::chrono::nanoseconds> renderTime)
+{
+    Q_ASSERT(m_pendingFrameCount > 0);
+    m_pendingFrameCount--;
+
+    notifyVblank(timestamp);
+
+    if (renderTime) {
+        m_renderJournal.add(*renderTime, timestamp);
+    }
+}
+
+void FrameScheduler::notifyVblank(std::chrono::nanoseconds timestamp)
+{
+    if (m_lastPresentationTimestamp <= timestamp) {
+        m_lastPresentationTimestamp = timestamp;
+    } else {
+        qCDebug(KWIN_CORE,
+                "Got invalid presentation timestamp: %lld (current %lld)",
+                static_cast<long long>(timestamp.count()),
+                static_cast<long long>(m_lastPresentationTimestamp.count()));
+        m_lastPresentationTimestamp = m_clock();
+    }
+}
+
+} // namespace KWin
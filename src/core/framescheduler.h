@@ -0,0 +1,114 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "effect/globals.h"
+#include "kwin_export.h"
+#include "renderjournal.h"
+
+#include <chrono>
+#include <functional>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The FrameScheduler class decides when the compositor should start rendering the next frame
+ * and when that frame is going to be presented.
+ *
+ * It predicts the next vblank from the timestamps of presented frames, estimates the render
+ * time with a RenderJournal and decides between double and triple buffering. It doesn't own a
+ * timer and reads the time from a clock that can be replaced, so that its decisions can be
+ * replayed against recorded or synthetic traces without a display. The RenderLoop drives it
+ * with a timer and feeds it the presentation feedback of the output.
+ */
+class KWIN_EXPORT FrameScheduler
+{
+public:
+    using Clock = std::function<std::chrono::nanoseconds()>;
+
+    explicit FrameScheduler();
+    /**
+     * Creates a FrameScheduler that reads the time from @p clock, e.g. in a simulation.
+     */
+    explicit FrameScheduler(const Clock &clock);
+
+    std::chrono::nanoseconds now() const;
+
+    /**
+     * Returns the refresh rate of the output, in millihertz.
+     */
+    int refreshRate() const;
+    void setRefreshRate(int refreshRate);
+
+    std::chrono::nanoseconds safetyMargin() const;
+    void setSafetyMargin(std::chrono::nanoseconds safetyMargin);
+
+    PresentationMode presentationMode() const;
+    void setPresentationMode(PresentationMode mode);
+
+    int maxPendingFrameCount() const;
+    void setMaxPendingFrameCount(int maxCount);
+
+    /**
+     * Returns whether another frame can be submitted while the frames that have been submitted
+     * already wait to be presented.
+     */
+    bool canSubmitFrame() const;
+    int pendingFrameCount() const;
+
+    /**
+     * Decides when the next frame should be presented and returns when rendering it should
+     * start. @p lastTargetTimestamp is the presentation timestamp that the previous frame
+     * aimed for. If @p rescheduling is @c true, a frame has been scheduled already and only the
+     * time to start rendering it is updated, the vblank that it aims for stays the same.
+     */
+    std::chrono::nanoseconds schedule(std::chrono::nanoseconds lastTargetTimestamp, bool rescheduling);
+
+    std::chrono::nanoseconds lastPresentationTimestamp() const;
+    std::chrono::nanoseconds nextPresentationTimestamp() const;
+    /**
+     * Returns how long it's expected to take to render the next frame.
+     */
+    std::chrono::nanoseconds predictedRenderTime() const;
+
+    /**
+     * Notifies the scheduler that a frame has been submitted to the output.
+     */
+    void frameSubmitted();
+    /**
+     * Notifies the scheduler that a submitted frame has been discarded without being presented.
+     */
+    void frameDropped();
+    /**
+     * Notifies the scheduler that a submitted frame has been presented at @p timestamp. The
+     * @p renderTime is the time the GPU took to render it, if it's known.
+     */
+    void framePresented(std::chrono::nanoseconds timestamp, std::optional<std::chrono::nanoseconds> renderTime);
+    /**
+     * Notifies the scheduler about a vblank at @p timestamp, e.g. the one a frame was presented at.
+     */
+    void notifyVblank(std::chrono::nanoseconds timestamp);
+
+private:
+    Clock m_clock;
+    RenderJournal m_renderJournal;
+    std::chrono::nanoseconds m_lastPresentationTimestamp = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds m_nextPresentationTimestamp = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds m_safetyMargin{0};
+    PresentationMode m_presentationMode = PresentationMode::VSync;
+    int m_refreshRate = 60000;
+    int m_maxPendingFrameCount = 1;
+    int m_pendingFrameCount = 0;
+    int m_doubleBufferingCounter = 0;
+    bool m_wasTripleBuffering = false;
+};
+
+} // namespace KWin
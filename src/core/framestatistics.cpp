@@ -0,0 +1,112 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "framestatistics.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+FrameStatistics::FrameStatistics(size_t capacity)
+    : m_capacity(std::max<size_t>(capacity, 1))
+{
+}
+
+void FrameStatistics::addSample(Phase phase, std::chrono::nanoseconds duration)
+{
+    Samples &samples = m_phases[int(phase)];
+    if (samples.recent.size() < m_capacity) {
+        samples.recent.push_back(duration);
+    } else {
+        samples.recent[samples.next] = duration;
+    }
+    samples.next = (samples.next + 1) % m_capacity;
+    samples.count++;
+    samples.sum += duration;
+    samples.max = std::max(samples.max, duration);
+}
+
+void FrameStatistics::reset()
+{
+    m_phases = {};
+}
+
+static std::chrono::nanoseconds percentile(std::vector<std::chrono::nanoseconds> &samples, int percent)
+{
+    // nearest-rank percentile, so the result is always one of the samples
+    const size_t rank = std::max<size_t>((samples.size() * percent + 99) / 100, 1) - 1;
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+FrameStatistics::Summary FrameStatistics::summary(Phase phase) const
+{
+    const Samples &samples = m_phases[int(phase)];
+    if (!samples.count) {
+        return Summary{};
+    }
+
+    std::vector<std::chrono::nanoseconds> recent = samples.recent;
+    return Summary{
+        .count = samples.count,
+        .mean = samples.sum / samples.count,
+        .median = percentile(recent, 50),
+        .p95 = percentile(recent, 95),
+        .p99 = percentile(recent, 99),
+        .max = samples.max,
+    };
+}
+
+QJsonObject FrameStatistics::toJson() const
+{
+    const auto microseconds = [](std::chrono::nanoseconds duration) {
+        return qint64(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    };
+
+    QJsonObject phases;
+    for (int i = 0; i < PhaseCount; ++i) {
+        const Phase phase = Phase(i);
+        const Summary summary = this->summary(phase);
+        if (!summary.count) {
+            continue;
+        }
+        phases[phaseName(phase)] = QJsonObject{
+            {QStringLiteral("count"), qint64(summary.count)},
+            {QStringLiteral("meanUs"), microseconds(summary.mean)},
+            {QStringLiteral("medianUs"), microseconds(summary.median)},
+            {QStringLiteral("p95Us"), microseconds(summary.p95)},
+            {QStringLiteral("p99Us"), microseconds(summary.p99)},
+            {QStringLiteral("maxUs"), microseconds(summary.max)},
+        };
+    }
+    return phases;
+}
+
+QString FrameStatistics::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Phase::Damage:
+        return QStringLiteral("damage");
+    case Phase::PrePaint:
+        return QStringLiteral("prePaint");
+    case Phase::Paint:
+        return QStringLiteral("paint");
+    case Phase::PostPaint:
+        return QStringLiteral("postPaint");
+    case Phase::Present:
+        return QStringLiteral("present");
+    case Phase::Total:
+        return QStringLiteral("total");
+    case Phase::Gpu:
+        return QStringLiteral("gpu");
+    }
+    Q_UNREACHABLE();
+}
+
+} // namespace KWin
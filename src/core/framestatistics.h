@@ -0,0 +1,81 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QJsonObject>
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace KWin
+{
+
+/**
+ * The FrameStatistics class collects how long the phases of rendering frames take.
+ *
+ * Every phase keeps a count, the sum and the maximum of all samples since the last reset, and
+ * the most recent samples to compute percentiles from. The CPU phases are measured by the
+ * compositor, the GPU time is taken from the render time queries of presented frames.
+ */
+class KWIN_EXPORT FrameStatistics
+{
+public:
+    enum class Phase {
+        Damage,
+        PrePaint,
+        Paint,
+        PostPaint,
+        Present,
+        Total,
+        Gpu,
+    };
+    static constexpr int PhaseCount = 7;
+
+    struct Summary
+    {
+        quint64 count = 0;
+        std::chrono::nanoseconds mean = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds median = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds p95 = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds p99 = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds max = std::chrono::nanoseconds::zero();
+    };
+
+    explicit FrameStatistics(size_t capacity = 4096);
+
+    void addSample(Phase phase, std::chrono::nanoseconds duration);
+    void reset();
+
+    Summary summary(Phase phase) const;
+
+    /**
+     * Returns the summaries of all phases that have samples, durations are in microseconds.
+     */
+    QJsonObject toJson() const;
+
+    static QString phaseName(Phase phase);
+
+private:
+    struct Samples
+    {
+        std::vector<std::chrono::nanoseconds> recent;
+        size_t next = 0;
+        quint64 count = 0;
+        std::chrono::nanoseconds sum = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds max = std::chrono::nanoseconds::zero();
+    };
+
+    size_t m_capacity;
+    std::array<Samples, PhaseCount> m_phases;
+};
+
+} // namespace KWin
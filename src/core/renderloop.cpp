@@ -51,78 +51,14 @@ void RenderLoopPrivate::scheduleNextRepaint()
     if (kwinApp()->isTerminating() || compositeTimer.isActive()) {
         return;
     }
-    scheduleRepaint(nextPresentationTimestamp);
+    scheduleRepaint(scheduler.nextPresentationTimestamp());
 }
 
 void RenderLoopPrivate::scheduleRepaint(std::chrono::nanoseconds lastTargetTimestamp)
 {
     pendingReschedule = false;
-    const std::chrono::nanoseconds vblankInterval(1'000'000'000'000ull / refreshRate);
-    const std::chrono::nanoseconds currentTime(std::chrono::steady_clock::now().time_since_epoch());
-
-    // Estimate when it's a good time to perform the next compositing cycle.
-    // the 1ms on top of the safety margin is required for timer and scheduler inaccuracies
-    std::chrono::nanoseconds expectedCompositingTime = std::min(renderJournal.result() + safetyMargin + 1ms, 2 * vblankInterval);
-
-    if (presentationMode == PresentationMode::VSync) {
-        // normal presentation: pageflips only happen at vblank
-        const uint64_t pageflipsSince = std::max<int64_t>((currentTime - lastPresentationTimestamp) / vblankInterval, 0);
-        if (pageflipsSince > 100) {
-            // if it's been a while since the last frame, the GPU is likely in a low power state and render time will be increased
-            // -> take that into account and start compositing very early
-            expectedCompositingTime = std::max(vblankInterval - 1us, expectedCompositingTime);
-        }
-        const uint64_t pageflipsSinceLastToTarget = std::max<int64_t>(std::round((lastTargetTimestamp - lastPresentationTimestamp).count() / double(vblankInterval.count())), 0);
-        uint64_t pageflipsInAdvance = std::min<int64_t>(expectedCompositingTime / vblankInterval + 1, maxPendingFrameCount);
-
-        // switching from double to triple buffering causes a frame drop
-        // -> apply some amount of hysteresis to avoid switching back and forth constantly
-        if (pageflipsInAdvance > 1) {
-            // immediately switch to triple buffering when needed
-            wasTripleBuffering = true;
-            doubleBufferingCounter = 0;
-        } else if (wasTripleBuffering) {
-            // but wait a bit before switching back to double buffering
-            if (doubleBufferingCounter >= 10) {
-                wasTripleBuffering = false;
-            } else if (expectedCompositingTime >= vblankInterval * 0.95) {
-                // also don't switch back if render times are just barely enough for double buffering
-                pageflipsInAdvance = 2;
-                doubleBufferingCounter = 0;
-                expectedCompositingTime = vblankInterval;
-            } else {
-                doubleBufferingCounter++;
-                pageflipsInAdvance = 2;
-                expectedCompositingTime = vblankInterval;
-            }
-        }
-
-        if (compositeTimer.isActive()) {
-            // we already scheduled this frame, but we got a new timestamp
-            // which might require starting to composite earlier than we planned
-            // It's important here that we do not change the targeted vblank interval,
-            // otherwise with a pessimistic compositing time estimation we might
-            // unnecessarily drop frames
-            const uint32_t intervalsSinceLastTimestamp = std::max<int32_t>(std::round((nextPresentationTimestamp - lastPresentationTimestamp).count() / double(vblankInterval.count())), 0);
-            nextPresentationTimestamp = lastPresentationTimestamp + intervalsSinceLastTimestamp * vblankInterval;
-        } else {
-            nextPresentationTimestamp = lastPresentationTimestamp + std::max(pageflipsSince + pageflipsInAdvance, pageflipsSinceLastToTarget + 1) * vblankInterval;
-        }
-    } else {
-        wasTripleBuffering = false;
-        doubleBufferingCounter = 0;
-        if (presentationMode == PresentationMode::Async || presentationMode == PresentationMode::AdaptiveAsync) {
-            // tearing: pageflips happen ASAP
-            nextPresentationTimestamp = currentTime;
-        } else {
-            // adaptive sync: pageflips happen after one vblank interval
-            // TODO read minimum refresh rate from the EDID and take it into account here
-            nextPresentationTimestamp = lastPresentationTimestamp + vblankInterval;
-        }
-    }
-
-    const std::chrono::nanoseconds nextRenderTimestamp = nextPresentationTimestamp - expectedCompositingTime;
-    compositeTimer.start(std::max(0ms, std::chrono::duration_cast<std::chrono::milliseconds>(nextRenderTimestamp - currentTime)));
+    const std::chrono::nanoseconds nextRenderTimestamp = scheduler.schedule(lastTargetTimestamp, compositeTimer.isActive());
+    compositeTimer.start(std::max(0ms, std::chrono::duration_cast<std::chrono::milliseconds>(nextRenderTimestamp - scheduler.now())));
 }
 
 void RenderLoopPrivate::delayScheduleRepaint()
@@ -132,8 +68,7 @@ void RenderLoopPrivate::delayScheduleRepaint()
 
 void RenderLoopPrivate::notifyFrameDropped()
 {
-    Q_ASSERT(pendingFrameCount > 0);
-    pendingFrameCount--;
+    scheduler.frameDropped();
 
     if (!inhibitCount && pendingReschedule) {
         scheduleNextRepaint();
@@ -151,20 +86,19 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp,
         const bool vrr = mode == PresentationMode::AdaptiveSync || mode == PresentationMode::AdaptiveAsync;
         const bool tearing = mode == PresentationMode::Async || mode == PresentationMode::AdaptiveAsync;
         *m_debugOutput << frame->targetPageflipTime().time_since_epoch().count() << "," << timestamp.count() << "," << times.start.time_since_epoch().count() << "," << times.end.time_since_epoch().count()
-                       << "," << safetyMargin.count() << "," << frame->refreshDuration().count() << "," << (vrr ? 1 : 0) << "," << (tearing ? 1 : 0) << "," << frame->predictedRenderTime().count() << "\n";
+                       << "," << scheduler.safetyMargin().count() << "," << frame->refreshDuration().count() << "," << (vrr ? 1 : 0) << "," << (tearing ? 1 : 0) << "," << frame->predictedRenderTime().count() << "\n";
     }
 
-    Q_ASSERT(pendingFrameCount > 0);
-    pendingFrameCount--;
-
-    notifyVblank(timestamp);
-
+    std::optional<std::chrono::nanoseconds> gpuTime;
     if (renderTime) {
-        renderJournal.add(renderTime->end - renderTime->start, timestamp);
+        gpuTime = renderTime->end - renderTime->start;
+        frameStatistics.addSample(FrameStatistics::Phase::Gpu, *gpuTime);
     }
+    scheduler.framePresented(timestamp, gpuTime);
+
     if (compositeTimer.isActive()) {
         // reschedule to match the new timestamp and render time
-        scheduleRepaint(lastPresentationTimestamp);
+        scheduleRepaint(scheduler.lastPresentationTimestamp());
     }
     if (!inhibitCount && pendingReschedule) {
         scheduleNextRepaint();
@@ -175,15 +109,7 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp,
 
 void RenderLoopPrivate::notifyVblank(std::chrono::nanoseconds timestamp)
 {
-    if (lastPresentationTimestamp <= timestamp) {
-        lastPresentationTimestamp = timestamp;
-    } else {
-        qCDebug(KWIN_CORE,
-                "Got invalid presentation timestamp: %lld (current %lld)",
-                static_cast<long long>(timestamp.count()),
-                static_cast<long long>(lastPresentationTimestamp.count()));
-        lastPresentationTimestamp = std::chrono::steady_clock::now().time_since_epoch();
-    }
+    scheduler.notifyVblank(timestamp);
 }
 
 void RenderLoopPrivate::dispatch()
@@ -229,7 +155,7 @@ void RenderLoop::uninhibit()
 
 void RenderLoop::prepareNewFrame()
 {
-    d->pendingFrameCount++;
+    d->scheduler.frameSubmitted();
 }
 
 void RenderLoop::beginPaint()
@@ -239,21 +165,21 @@ void RenderLoop::beginPaint()
 
 int RenderLoop::refreshRate() const
 {
-    return d->refreshRate;
+    return d->scheduler.refreshRate();
 }
 
 void RenderLoop::setRefreshRate(int refreshRate)
 {
-    if (d->refreshRate == refreshRate) {
+    if (d->scheduler.refreshRate() == refreshRate) {
         return;
     }
-    d->refreshRate = refreshRate;
+    d->scheduler.setRefreshRate(refreshRate);
     Q_EMIT refreshRateChanged();
 }
 
 void RenderLoop::setPresentationSafetyMargin(std::chrono::nanoseconds safetyMargin)
 {
-    d->safetyMargin = safetyMargin;
+    d->scheduler.setSafetyMargin(safetyMargin);
 }
 
 void RenderLoop::scheduleRepaint(Item *item, RenderLayer *layer, OutputLayer *outputLayer)
@@ -261,8 +187,9 @@ void RenderLoop::scheduleRepaint(Item *item, RenderLayer *layer, OutputLayer *ou
     if (d->pendingRepaint) {
         return;
     }
-    const bool vrr = d->presentationMode == PresentationMode::AdaptiveSync || d->presentationMode == PresentationMode::AdaptiveAsync;
-    const bool tearing = d->presentationMode == PresentationMode::Async || d->presentationMode == PresentationMode::AdaptiveAsync;
+    const PresentationMode presentationMode = d->scheduler.presentationMode();
+    const bool vrr = presentationMode == PresentationMode::AdaptiveSync || presentationMode == PresentationMode::AdaptiveAsync;
+    const bool tearing = presentationMode == PresentationMode::Async || presentationMode == PresentationMode::AdaptiveAsync;
     if ((vrr || tearing) && workspace()->activeWindow() && d->output) {
         Window *const activeWindow = workspace()->activeWindow();
         if ((item || layer || outputLayer) && activeWindow->isOnOutput(d->output) && activeWindow->surfaceItem() && item != activeWindow->surfaceItem() && activeWindow->surfaceItem()->frameTimeEstimation() <= std::chrono::nanoseconds(1'000'000'000) / 30) {
@@ -271,8 +198,7 @@ void RenderLoop::scheduleRepaint(Item *item, RenderLayer *layer, OutputLayer *ou
         }
     }
     d->delayedVrrTimer.stop();
-    const int effectiveMaxPendingFrameCount = (vrr || tearing) ? 1 : d->maxPendingFrameCount;
-    if (d->pendingFrameCount < effectiveMaxPendingFrameCount && !d->inhibitCount) {
+    if (d->scheduler.canSubmitFrame() && !d->inhibitCount) {
         d->scheduleNextRepaint();
     } else {
         d->delayScheduleRepaint();
@@ -281,30 +207,35 @@ void RenderLoop::scheduleRepaint(Item *item, RenderLayer *layer, OutputLayer *ou
 
 std::chrono::nanoseconds RenderLoop::lastPresentationTimestamp() const
 {
-    return d->lastPresentationTimestamp;
+    return d->scheduler.lastPresentationTimestamp();
 }
 
 std::chrono::nanoseconds RenderLoop::nextPresentationTimestamp() const
 {
-    return d->nextPresentationTimestamp;
+    return d->scheduler.nextPresentationTimestamp();
 }
 
 void RenderLoop::setPresentationMode(PresentationMode mode)
 {
-    if (mode != d->presentationMode) {
+    if (mode != d->scheduler.presentationMode()) {
         qCDebug(KWIN_CORE) << "Changed presentation mode to" << mode;
     }
-    d->presentationMode = mode;
+    d->scheduler.setPresentationMode(mode);
 }
 
 void RenderLoop::setMaxPendingFrameCount(uint32_t maxCount)
 {
-    d->maxPendingFrameCount = maxCount;
+    d->scheduler.setMaxPendingFrameCount(maxCount);
 }
 
 std::chrono::nanoseconds RenderLoop::predictedRenderTime() const
 {
-    return d->renderJournal.result();
+    return d->scheduler.predictedRenderTime();
+}
+
+FrameStatistics *RenderLoop::frameStatistics() const
+{
+    return &d->frameStatistics;
 }
 
 } // namespace KWin
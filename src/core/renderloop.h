@@ -13,6 +13,7 @@
 namespace KWin
 {
 
+class FrameStatistics;
 class RenderLoopPrivate;
 class SurfaceItem;
 class Item;
@@ -101,6 +102,12 @@ public:
      */
     std::chrono::nanoseconds predictedRenderTime() const;
 
+    /**
+     * Returns the timings of the frames rendered by this RenderLoop. The compositor adds the
+     * CPU time spent in each phase of a frame, the GPU time is added when the frame is presented.
+     */
+    FrameStatistics *frameStatistics() const;
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the refresh rate of this RenderLoop has changed.
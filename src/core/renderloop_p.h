@@ -6,8 +6,9 @@
 
 #pragma once
 
+#include "framescheduler.h"
+#include "framestatistics.h"
 #include "renderbackend.h"
-#include "renderjournal.h"
 #include "renderloop.h"
 
 #include <QTimer>
@@ -40,21 +41,12 @@ public:
     RenderLoop *const q;
     Output *const output;
     std::optional<std::fstream> m_debugOutput;
-    std::chrono::nanoseconds lastPresentationTimestamp = std::chrono::nanoseconds::zero();
-    std::chrono::nanoseconds nextPresentationTimestamp = std::chrono::nanoseconds::zero();
-    bool wasTripleBuffering = false;
-    int doubleBufferingCounter = 0;
     QTimer compositeTimer;
-    RenderJournal renderJournal;
-    int refreshRate = 60000;
-    int pendingFrameCount = 0;
+    FrameScheduler scheduler;
+    FrameStatistics frameStatistics;
     int inhibitCount = 0;
     bool pendingReschedule = false;
     bool pendingRepaint = false;
-    std::chrono::nanoseconds safetyMargin{0};
-
-    PresentationMode presentationMode = PresentationMode::VSync;
-    int maxPendingFrameCount = 1;
 
     QTimer delayedVrrTimer;
 };
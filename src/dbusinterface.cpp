@@ -14,23 +14,37 @@
 #include "virtualdesktopmanageradaptor.h"
 
 // kwin
-#include "compositor.h"
+#include "animationpacing.h"
+#include "compositor_x11.h"
+#include "core/framestatistics.h"
 #include "core/output.h"
 #include "core/renderbackend.h"
+#include "core/renderloop.h"
 #include "debug_console.h"
+#include "effect/effecthandler.h"
+#include "framecoalescer.h"
 #include "kwinadaptor.h"
 #include "main.h"
+#include "periodicrepaints.h"
+#include "pingscheduler.h"
 #include "placement.h"
 #include "pluginmanager.h"
+#include "scene/ghostitem.h"
+#include "scene/item.h"
+#include "scene/workspacescene.h"
 #include "virtualdesktops.h"
 #include "window.h"
 #include "workspace.h"
 #if KWIN_BUILD_ACTIVITIES
 #include "activities.h"
 #endif
+#if KWIN_BUILD_TABBOX
+#include "tabbox/tabbox.h"
+#endif
 
 // Qt
 #include <QDBusConnection>
+#include <QJsonDocument>
 #include <QOpenGLContext>
 
 namespace KWin
@@ -204,6 +218,25 @@ QVariantMap DBusInterface::getWindowInfo(const QString &uuid)
     }
 }
 
+QVariantMap DBusInterface::pingStatistics()
+{
+    const PingScheduler *scheduler = workspace()->pingScheduler();
+    QVariantMap result;
+    const auto clients = scheduler->clients();
+    for (const PingScheduler::Client &client : clients) {
+        const PingScheduler::Statistics statistics = scheduler->statistics(client);
+        result.insert(QStringLiteral("%1:%2").arg(client.hostName).arg(client.pid),
+                      QVariantMap{
+                          {QStringLiteral("pings"), statistics.pings},
+                          {QStringLiteral("timeouts"), statistics.timeouts},
+                          {QStringLiteral("averageLatency"), qlonglong(statistics.averageLatency.count())},
+                          {QStringLiteral("maximumLatency"), qlonglong(statistics.maximumLatency.count())},
+                          {QStringLiteral("unresponsive"), statistics.unresponsive},
+                      });
+    }
+    return result;
+}
+
 void DBusInterface::showDesktop(bool show)
 {
     workspace()->setShowingDesktop(show, true);
@@ -303,6 +336,98 @@ void CompositorDBusInterface::reinitialize()
     m_compositor->reinitialize();
 }
 
+QString CompositorDBusInterface::frameStatistics() const
+{
+    QJsonObject outputs;
+    QList<RenderLoop *> renderLoops;
+    const auto allOutputs = workspace()->outputs();
+    for (Output *output : allOutputs) {
+        // outputs that share a render loop would report the same frames
+        RenderLoop *renderLoop = output->renderLoop();
+        if (!renderLoop || renderLoops.contains(renderLoop)) {
+            continue;
+        }
+        renderLoops.append(renderLoop);
+        outputs[output->name()] = renderLoop->frameStatistics()->toJson();
+    }
+
+    const QJsonObject ghosts{
+        {QStringLiteral("live"), GhostItem::liveCount()},
+        {QStringLiteral("created"), qint64(GhostItem::createdCount())},
+    };
+    const Workspace::DesktopSwitchStatistics switchStats = workspace()->desktopSwitchStatistics();
+    const QJsonObject desktopSwitches{
+        {QStringLiteral("count"), int(switchStats.count)},
+        {QStringLiteral("lastUs"), qint64(switchStats.lastDuration.count())},
+        {QStringLiteral("lastRequests"), int(switchStats.lastRequestCount)},
+    };
+    QJsonObject statistics{
+        {QStringLiteral("outputs"), outputs},
+        {QStringLiteral("ghosts"), ghosts},
+        {QStringLiteral("desktopSwitches"), desktopSwitches},
+    };
+    if (WorkspaceScene *scene = Compositor::self()->scene()) {
+        const WorkspaceScene::OcclusionStatistics occlusionStats = scene->occlusionStatistics();
+        statistics[QStringLiteral("occlusion")] = QJsonObject{
+            {QStringLiteral("frames"), qint64(occlusionStats.frames)},
+            {QStringLiteral("culledPixels"), qint64(occlusionStats.culledPixels)},
+            {QStringLiteral("lastCulledPixels"), qint64(occlusionStats.lastCulledPixels)},
+        };
+    }
+    if (effects) {
+        statistics[QStringLiteral("effects")] = QJsonObject{
+            {QStringLiteral("stackingOrderRebuilds"), qint64(effects->stackingOrderRebuilds())},
+            {QStringLiteral("periodicRepaints"), qint64(effects->periodicRepaints()->statistics().ticks)},
+            {QStringLiteral("deferredAnimationRepaints"), qint64(effects->animationPacing()->statistics().deferred)},
+        };
+    }
+    const Item::RenderGeometryStatistics renderGeometryStats = Item::renderGeometryStatistics();
+    statistics[QStringLiteral("renderGeometry")] = QJsonObject{
+        {QStringLiteral("hits"), qint64(renderGeometryStats.hits)},
+        {QStringLiteral("misses"), qint64(renderGeometryStats.misses)},
+    };
+    const FrameCoalescer::Statistics geometryStats = workspace()->frameCoalescer()->statistics();
+    statistics[QStringLiteral("geometryNotifications")] = QJsonObject{
+        {QStringLiteral("changes"), qint64(geometryStats.changes)},
+        {QStringLiteral("deliveries"), qint64(geometryStats.deliveries)},
+    };
+#if KWIN_BUILD_TABBOX
+    if (TabBox::TabBox *tabBox = workspace()->tabbox()) {
+        const TabBox::TabBoxHandler::ShowStatistics tabBoxStats = tabBox->showStatistics();
+        statistics[QStringLiteral("tabBox")] = QJsonObject{
+            {QStringLiteral("count"), int(tabBoxStats.count)},
+            {QStringLiteral("coldCount"), int(tabBoxStats.coldCount)},
+            {QStringLiteral("lastFirstFrameUs"), qint64(tabBoxStats.lastFirstFrame.count())},
+        };
+    }
+#endif
+    if (X11Compositor *compositor = X11Compositor::self()) {
+        const X11Compositor::ToggleStatistics toggleStats = compositor->toggleStatistics();
+        statistics[QStringLiteral("compositingToggles")] = QJsonObject{
+            {QStringLiteral("warmSuspends"), int(toggleStats.warmSuspends)},
+            {QStringLiteral("warmResumes"), int(toggleStats.warmResumes)},
+            {QStringLiteral("lastSuspendUs"), qint64(toggleStats.lastSuspendLatency.count())},
+            {QStringLiteral("lastResumeUs"), qint64(toggleStats.lastResumeLatency.count())},
+            {QStringLiteral("lastStartUs"), qint64(toggleStats.lastStartLatency.count())},
+            {QStringLiteral("lastStopUs"), qint64(toggleStats.lastStopLatency.count())},
+        };
+    }
+    return QString::fromUtf8(QJsonDocument(statistics).toJson(QJsonDocument::Compact));
+}
+
+void CompositorDBusInterface::resetFrameStatistics()
+{
+    const auto outputs = workspace()->outputs();
+    for (Output *output : outputs) {
+        if (RenderLoop *renderLoop = output->renderLoop()) {
+            renderLoop->frameStatistics()->reset();
+        }
+    }
+    if (WorkspaceScene *scene = Compositor::self()->scene()) {
+        scene->resetOcclusionStatistics();
+    }
+}
+
 QStringList CompositorDBusInterface::supportedOpenGLPlatformInterfaces() const
 {
     QStringList interfaces;
@@ -89,6 +89,15 @@ public Q_SLOTS: // METHODS
      */
     QVariantMap getWindowInfo(const QString &uuid);
 
+    /**
+     * Returns the ping response statistics of X11 clients.
+     *
+     * The map is keyed by "hostname:pid", every value is a map with the number of
+     * pings, timeouts, the average and maximum response latency in milliseconds,
+     * and whether the client is currently unresponsive.
+     */
+    QVariantMap pingStatistics();
+
     Q_NOREPLY void showDesktop(bool show);
 
 Q_SIGNALS:
@@ -170,6 +179,20 @@ public Q_SLOTS:
      */
     void reinitialize();
 
+    /**
+     * @brief Returns the frame timings collected since the last reset as a JSON document.
+     *
+     * The document contains a summary of each rendering phase per output, in microseconds,
+     * the pixels saved by occlusion culling and the compositing toggle and desktop switch
+     * statistics. It is meant for benchmarks.
+     */
+    QString frameStatistics() const;
+
+    /**
+     * @brief Discards the frame timings collected so far.
+     */
+    void resetFrameStatistics();
+
 Q_SIGNALS:
     void compositingToggled(bool active);
 
@@ -11,6 +11,7 @@
 #include "config-kwin.h"
 
 #include "decoratedwindow.h"
+#include "decorationrepaintqueue.h"
 #include "decorations_logging.h"
 #include "settings.h"
 // KWin core
@@ -44,6 +45,10 @@ static const QString s_defaultPlugin = BREEZE_KDECORATION_PLUGIN_ID;
 static const QString s_defaultPlugin = s_aurorae;
 #endif
 
+// Number of decorations that pick up a new palette per frame
+static const int s_repaintBatchSize = 8;
+static const std::chrono::milliseconds s_repaintInterval = std::chrono::milliseconds(16);
+
 static void migrateAuroraeTheme()
 {
     const QString themeName = kwinApp()->config()->group(s_configKeyName).readEntry("theme");
@@ -63,12 +68,20 @@ DecorationBridge::DecorationBridge()
     : m_factory(nullptr)
     , m_showToolTips(false)
     , m_settings()
+    , m_repaintQueue(std::make_unique<DecorationRepaintQueue>(s_repaintBatchSize, s_repaintInterval))
     , m_noPlugin(false)
 {
     migrateAuroraeTheme();
     readDecorationOptions();
 }
 
+DecorationBridge::~DecorationBridge() = default;
+
+DecorationRepaintQueue *DecorationBridge::repaintQueue() const
+{
+    return m_repaintQueue.get();
+}
+
 QString DecorationBridge::readPlugin()
 {
     return kwinApp()->config()->group(s_configKeyName).readEntry("library", s_defaultPlugin);
@@ -26,11 +26,14 @@ class Window;
 namespace Decoration
 {
 
+class DecorationRepaintQueue;
+
 class KWIN_EXPORT DecorationBridge : public KDecoration3::DecorationBridge
 {
     Q_OBJECT
 public:
     explicit DecorationBridge();
+    ~DecorationBridge() override;
 
     static bool hasPlugin();
 
@@ -59,6 +62,11 @@ public:
 
     QString supportInformation() const;
 
+    /**
+     * Returns the queue that spreads palette changes of the decorations over several frames.
+     */
+    DecorationRepaintQueue *repaintQueue() const;
+
 Q_SIGNALS:
     void metaDataLoaded();
 
@@ -76,6 +84,7 @@ private:
     QString m_defaultTheme;
     QString m_theme;
     std::shared_ptr<KDecoration3::DecorationSettings> m_settings;
+    std::unique_ptr<DecorationRepaintQueue> m_repaintQueue;
     bool m_noPlugin;
 };
 } // Decoration
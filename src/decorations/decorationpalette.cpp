@@ -12,29 +12,36 @@
 
 #include "decorationpalette.h"
 
+#include <KColorScheme>
 #include <KConfigGroup>
 
-#include <QFileInfo>
-#include <QStandardPaths>
+#include <QtConcurrentRun>
 
 namespace KWin
 {
 namespace Decoration
 {
 
+static KConfig::OpenFlags openFlags(const QString &colorScheme)
+{
+    return colorScheme.isEmpty() ? KConfig::FullConfig : KConfig::SimpleConfig;
+}
+
 DecorationPalette::DecorationPalette(const QString &colorScheme)
     : m_colorScheme(colorScheme != QStringLiteral("kdeglobals") ? colorScheme : QString())
 {
-    if (m_colorScheme.isEmpty()) {
-        m_colorSchemeConfig = KSharedConfig::openConfig(m_colorScheme, KConfig::FullConfig);
-    } else {
-        m_colorSchemeConfig = KSharedConfig::openConfig(m_colorScheme, KConfig::SimpleConfig);
-    }
+    m_colorSchemeConfig = KSharedConfig::openConfig(m_colorScheme, openFlags(m_colorScheme));
     m_watcher = KConfigWatcher::create(m_colorSchemeConfig);
 
-    connect(m_watcher.data(), &KConfigWatcher::configChanged, this, &DecorationPalette::update);
+    connect(m_watcher.data(), &KConfigWatcher::configChanged, this, &DecorationPalette::reload);
+    connect(&m_reloadWatcher, &QFutureWatcher<std::shared_ptr<const Snapshot>>::finished, this, &DecorationPalette::handleReloadFinished);
 
-    update();
+    reload();
+}
+
+DecorationPalette::~DecorationPalette()
+{
+    m_reloadWatcher.waitForFinished();
 }
 
 bool DecorationPalette::isValid() const
@@ -42,74 +49,44 @@ bool DecorationPalette::isValid() const
     return true;
 }
 
+bool DecorationPalette::isLoading() const
+{
+    return m_reloadWatcher.isRunning();
+}
+
 QColor DecorationPalette::color(KDecoration3::ColorGroup group, KDecoration3::ColorRole role) const
 {
     using KDecoration3::ColorGroup;
     using KDecoration3::ColorRole;
 
-    if (m_legacyColors.has_value()) {
-        switch (role) {
-        case ColorRole::Frame:
-            switch (group) {
-            case ColorGroup::Active:
-                return m_legacyColors->activeFrameColor;
-            case ColorGroup::Inactive:
-                return m_legacyColors->inactiveFrameColor;
-            default:
-                return QColor();
-            }
-        case ColorRole::TitleBar:
-            switch (group) {
-            case ColorGroup::Active:
-                return m_legacyColors->activeTitleBarColor;
-            case ColorGroup::Inactive:
-                return m_legacyColors->inactiveTitleBarColor;
-            default:
-                return QColor();
-            }
-        case ColorRole::Foreground:
-            switch (group) {
-            case ColorGroup::Active:
-                return m_legacyColors->activeForegroundColor;
-            case ColorGroup::Inactive:
-                return m_legacyColors->inactiveForegroundColor;
-            case ColorGroup::Warning:
-                return m_legacyColors->warningForegroundColor;
-            default:
-                return QColor();
-            }
-        default:
-            return QColor();
-        }
-    }
-
+    const Snapshot &colors = snapshot();
     switch (role) {
     case ColorRole::Frame:
         switch (group) {
         case ColorGroup::Active:
-            return m_colors.active.background().color();
+            return colors.activeFrameColor;
         case ColorGroup::Inactive:
-            return m_colors.inactive.background().color();
+            return colors.inactiveFrameColor;
         default:
             return QColor();
         }
     case ColorRole::TitleBar:
         switch (group) {
         case ColorGroup::Active:
-            return m_colors.active.background().color();
+            return colors.activeTitleBarColor;
         case ColorGroup::Inactive:
-            return m_colors.inactive.background().color();
+            return colors.inactiveTitleBarColor;
         default:
             return QColor();
         }
     case ColorRole::Foreground:
         switch (group) {
         case ColorGroup::Active:
-            return m_colors.active.foreground().color();
+            return colors.activeForegroundColor;
         case ColorGroup::Inactive:
-            return m_colors.inactive.foreground().color();
+            return colors.inactiveForegroundColor;
         case ColorGroup::Warning:
-            return m_colors.inactive.foreground(KColorScheme::ForegroundRole::NegativeText).color();
+            return colors.warningForegroundColor;
         default:
             return QColor();
         }
@@ -120,43 +97,85 @@ QColor DecorationPalette::color(KDecoration3::ColorGroup group, KDecoration3::Co
 
 QPalette DecorationPalette::palette() const
 {
-    return m_palette;
+    return snapshot().palette;
 }
 
-void DecorationPalette::update()
+const DecorationPalette::Snapshot &DecorationPalette::snapshot() const
 {
-    m_colorSchemeConfig->sync();
-    m_palette = KColorScheme::createApplicationPalette(m_colorSchemeConfig);
-
-    if (KColorScheme::isColorSetSupported(m_colorSchemeConfig, KColorScheme::Header)) {
-        m_colors.active = KColorScheme(QPalette::Normal, KColorScheme::Header, m_colorSchemeConfig);
-        m_colors.inactive = KColorScheme(QPalette::Inactive, KColorScheme::Header, m_colorSchemeConfig);
-        m_legacyColors.reset();
-    } else {
-        KConfigGroup wmConfig(m_colorSchemeConfig, QStringLiteral("WM"));
-
-        if (!wmConfig.exists()) {
-            m_colors.active = KColorScheme(QPalette::Normal, KColorScheme::Window, m_colorSchemeConfig);
-            m_colors.inactive = KColorScheme(QPalette::Inactive, KColorScheme::Window, m_colorSchemeConfig);
-            m_legacyColors.reset();
-            return;
-        }
-
-        m_legacyColors = LegacyColors{};
-        m_legacyColors->activeFrameColor = wmConfig.readEntry("frame", m_palette.color(QPalette::Active, QPalette::Window));
-        m_legacyColors->inactiveFrameColor = wmConfig.readEntry("inactiveFrame", m_legacyColors->activeFrameColor);
-        m_legacyColors->activeTitleBarColor = wmConfig.readEntry("activeBackground", m_palette.color(QPalette::Active, QPalette::Highlight));
-        m_legacyColors->inactiveTitleBarColor = wmConfig.readEntry("inactiveBackground", m_legacyColors->inactiveTitleBarColor);
-        m_legacyColors->activeForegroundColor = wmConfig.readEntry("activeForeground", m_palette.color(QPalette::Active, QPalette::HighlightedText));
-        m_legacyColors->inactiveForegroundColor = wmConfig.readEntry("inactiveForeground", m_legacyColors->activeForegroundColor.darker());
+    if (!m_snapshot) {
+        // The colors are needed before the color scheme has been parsed for the first time
+        QFuture<std::shared_ptr<const Snapshot>> future = m_reloadWatcher.future();
+        future.waitForFinished();
+        m_snapshot = future.result();
+    }
+    return *m_snapshot;
+}
 
-        KConfigGroup windowColorsConfig(m_colorSchemeConfig, QStringLiteral("Colors:Window"));
-        m_legacyColors->warningForegroundColor = windowColorsConfig.readEntry("ForegroundNegative", QColor(237, 21, 2));
+void DecorationPalette::reload()
+{
+    if (m_reloadWatcher.isRunning()) {
+        m_reloadQueued = true;
+        return;
     }
+    m_reloadWatcher.setFuture(QtConcurrent::run(&DecorationPalette::parse, m_colorScheme));
+}
 
+void DecorationPalette::handleReloadFinished()
+{
+    const std::shared_ptr<const Snapshot> snapshot = m_reloadWatcher.result();
+    if (std::exchange(m_reloadQueued, false)) {
+        // The color scheme has changed while it was being parsed, the result is already outdated
+        reload();
+    }
+    m_snapshot = snapshot;
     Q_EMIT changed();
 }
 
+std::shared_ptr<const DecorationPalette::Snapshot> DecorationPalette::parse(const QString &colorScheme)
+{
+    // KSharedConfig instances are per thread, make sure this one isn't stale
+    const KSharedConfig::Ptr config = KSharedConfig::openConfig(colorScheme, openFlags(colorScheme));
+    config->reparseConfiguration();
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->palette = KColorScheme::createApplicationPalette(config);
+
+    const auto readColorScheme = [&snapshot, &config](KColorScheme::ColorSet colorSet) {
+        const KColorScheme active(QPalette::Normal, colorSet, config);
+        const KColorScheme inactive(QPalette::Inactive, colorSet, config);
+        snapshot->activeFrameColor = active.background().color();
+        snapshot->inactiveFrameColor = inactive.background().color();
+        snapshot->activeTitleBarColor = active.background().color();
+        snapshot->inactiveTitleBarColor = inactive.background().color();
+        snapshot->activeForegroundColor = active.foreground().color();
+        snapshot->inactiveForegroundColor = inactive.foreground().color();
+        snapshot->warningForegroundColor = inactive.foreground(KColorScheme::ForegroundRole::NegativeText).color();
+    };
+
+    if (KColorScheme::isColorSetSupported(config, KColorScheme::Header)) {
+        readColorScheme(KColorScheme::Header);
+        return snapshot;
+    }
+
+    KConfigGroup wmConfig(config, QStringLiteral("WM"));
+    if (!wmConfig.exists()) {
+        readColorScheme(KColorScheme::Window);
+        return snapshot;
+    }
+
+    const QPalette &palette = snapshot->palette;
+    snapshot->activeFrameColor = wmConfig.readEntry("frame", palette.color(QPalette::Active, QPalette::Window));
+    snapshot->inactiveFrameColor = wmConfig.readEntry("inactiveFrame", snapshot->activeFrameColor);
+    snapshot->activeTitleBarColor = wmConfig.readEntry("activeBackground", palette.color(QPalette::Active, QPalette::Highlight));
+    snapshot->inactiveTitleBarColor = wmConfig.readEntry("inactiveBackground", snapshot->inactiveTitleBarColor);
+    snapshot->activeForegroundColor = wmConfig.readEntry("activeForeground", palette.color(QPalette::Active, QPalette::HighlightedText));
+    snapshot->inactiveForegroundColor = wmConfig.readEntry("inactiveForeground", snapshot->activeForegroundColor.darker());
+
+    KConfigGroup windowColorsConfig(config, QStringLiteral("Colors:Window"));
+    snapshot->warningForegroundColor = windowColorsConfig.readEntry("ForegroundNegative", QColor(237, 21, 2));
+    return snapshot;
+}
+
 }
 }
 
@@ -11,63 +11,84 @@
 
 #pragma once
 
-#include <KColorScheme>
 #include <KConfigWatcher>
 #include <KDecoration3/DecorationSettings>
 #include <KSharedConfig>
-#include <QFileSystemWatcher>
+#include <QFutureWatcher>
 #include <QPalette>
 
-#include <optional>
+#include <memory>
 
 namespace KWin
 {
 namespace Decoration
 {
 
+/**
+ * The DecorationPalette provides the colors of a color scheme to the decorations.
+ *
+ * Color schemes are parsed on a worker thread into an immutable Snapshot. The snapshot
+ * that is currently in use is replaced only once a new one has been fully parsed, so
+ * the decorations never see a half updated palette and the main thread doesn't block
+ * when the color scheme is changed.
+ */
 class DecorationPalette : public QObject
 {
     Q_OBJECT
 public:
+    struct Snapshot
+    {
+        QPalette palette;
+
+        QColor activeTitleBarColor;
+        QColor inactiveTitleBarColor;
+
+        QColor activeFrameColor;
+        QColor inactiveFrameColor;
+
+        QColor activeForegroundColor;
+        QColor inactiveForegroundColor;
+        QColor warningForegroundColor;
+    };
+
     DecorationPalette(const QString &colorScheme);
+    ~DecorationPalette() override;
 
     bool isValid() const;
 
+    /**
+     * Returns @c true while the color scheme is being parsed.
+     */
+    bool isLoading() const;
+
     QColor color(KDecoration3::ColorGroup group, KDecoration3::ColorRole role) const;
     QPalette palette() const;
 
+    /**
+     * Re-reads the color scheme in the background. changed() is emitted once the new
+     * colors are available.
+     */
+    void reload();
+
+    /**
+     * Parses @p colorScheme. It is safe to call this function from any thread.
+     */
+    static std::shared_ptr<const Snapshot> parse(const QString &colorScheme);
+
 Q_SIGNALS:
     void changed();
 
 private:
-    void update();
+    const Snapshot &snapshot() const;
+    void handleReloadFinished();
 
     QString m_colorScheme;
+    KSharedConfig::Ptr m_colorSchemeConfig;
     KConfigWatcher::Ptr m_watcher;
 
-    struct LegacyColors
-    {
-        QColor activeTitleBarColor;
-        QColor inactiveTitleBarColor;
-
-        QColor activeFrameColor;
-        QColor inactiveFrameColor;
-
-        QColor activeForegroundColor;
-        QColor inactiveForegroundColor;
-        QColor warningForegroundColor;
-    };
-
-    struct ModernColors
-    {
-        KColorScheme active;
-        KColorScheme inactive;
-    };
-
-    KSharedConfig::Ptr m_colorSchemeConfig;
-    QPalette m_palette;
-    ModernColors m_colors;
-    std::optional<LegacyColors> m_legacyColors;
+    QFutureWatcher<std::shared_ptr<const Snapshot>> m_reloadWatcher;
+    bool m_reloadQueued = false;
+    mutable std::shared_ptr<const Snapshot> m_snapshot;
 };
 
 }
@@ -0,0 +1,83 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "decorationrepaintqueue.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+namespace Decoration
+{
+
+DecorationRepaintQueue::DecorationRepaintQueue(int batchSize, std::chrono::milliseconds interval, QObject *parent)
+    : QObject(parent)
+    , m_batchSize(std::max(batchSize, 1))
+    , m_interval(interval)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, [this]() {
+        dispatch(m_batchSize);
+    });
+}
+
+DecorationRepaintQueue::~DecorationRepaintQueue() = default;
+
+void DecorationRepaintQueue::enqueue(QObject *target, std::function<void()> callback)
+{
+    const auto it = std::find_if(m_queue.begin(), m_queue.end(), [target](const Entry &entry) {
+        return entry.target == target;
+    });
+    if (it != m_queue.end()) {
+        it->callback = std::move(callback);
+        return;
+    }
+
+    m_queue.append(Entry{
+        .target = target,
+        .callback = std::move(callback),
+    });
+    if (!m_timer.isActive()) {
+        // the first batch goes out with the next event loop iteration
+        m_timer.start(0);
+    }
+}
+
+void DecorationRepaintQueue::flush()
+{
+    m_timer.stop();
+    dispatch(m_queue.size());
+}
+
+int DecorationRepaintQueue::pendingCount() const
+{
+    return std::count_if(m_queue.begin(), m_queue.end(), [](const Entry &entry) {
+        return !entry.target.isNull();
+    });
+}
+
+void DecorationRepaintQueue::dispatch(int count)
+{
+    int dispatched = 0;
+    while (dispatched < count && !m_queue.isEmpty()) {
+        const Entry entry = m_queue.takeFirst();
+        if (entry.target) {
+            entry.callback();
+            ++dispatched;
+        }
+    }
+
+    if (!m_queue.isEmpty()) {
+        m_timer.start(m_interval);
+    }
+}
+
+} // namespace Decoration
+} // namespace KWin
+
+#include "moc_decorationrepaintqueue.cpp"
@@ -0,0 +1,70 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <chrono>
+#include <functional>
+
+namespace KWin
+{
+namespace Decoration
+{
+
+/**
+ * The DecorationRepaintQueue spreads decoration updates over several frames.
+ *
+ * When the color scheme changes, all decorations that use it have to be repainted. Rather
+ * than repainting all of them in a single frame, the updates are queued and dispatched in
+ * small batches, one batch per frame.
+ */
+class KWIN_EXPORT DecorationRepaintQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DecorationRepaintQueue(int batchSize, std::chrono::milliseconds interval, QObject *parent = nullptr);
+    ~DecorationRepaintQueue() override;
+
+    /**
+     * Queues @p callback to be invoked on behalf of @p target. If @p target is already
+     * queued, it keeps its position and only the latest callback is invoked.
+     */
+    void enqueue(QObject *target, std::function<void()> callback);
+
+    /**
+     * Dispatches all queued updates right away.
+     */
+    void flush();
+
+    int pendingCount() const;
+
+private:
+    void dispatch(int count);
+
+    struct Entry
+    {
+        QPointer<QObject> target;
+        std::function<void()> callback;
+    };
+
+    QTimer m_timer;
+    QList<Entry> m_queue;
+    int m_batchSize;
+    std::chrono::milliseconds m_interval;
+};
+
+} // namespace Decoration
+} // namespace KWin
@@ -525,6 +525,11 @@ bool Effect::blocksDirectScanout() const
     return true;
 }
 
+bool Effect::leavesWindowUntransformed(EffectWindow *) const
+{
+    return false;
+}
+
 EffectPluginFactory::EffectPluginFactory()
 {
 }
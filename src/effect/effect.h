@@ -903,6 +903,14 @@ public:
      */
     virtual bool blocksDirectScanout() const;
 
+    /**
+     * Overwrite this method to return true if your effect paints @a w at its position, with its
+     * size and without making it translucent. While the screen is painted with transformed
+     * windows, a window that all active effects leave untransformed still occludes the windows
+     * below it. The default implementation returns false.
+     */
+    virtual bool leavesWindowUntransformed(EffectWindow *w) const;
+
 public Q_SLOTS:
     virtual bool borderActivated(ElectricBorder border);
 };
@@ -13,10 +13,12 @@
 
 #include "config-kwin.h"
 
+#include "animationpacing.h"
 #include "compositor.h"
 #include "core/inputdevice.h"
 #include "core/output.h"
 #include "core/renderbackend.h"
+#include "core/renderloop.h"
 #include "core/rendertarget.h"
 #include "core/renderviewport.h"
 #include "decorations/decorationbridge.h"
@@ -30,6 +32,7 @@
 #include "opengl/glshadermanager.h"
 #include "opengl/gltexture.h"
 #include "osd.h"
+#include "periodicrepaints.h"
 #include "pointer_input.h"
 #include "scene/itemrenderer.h"
 #include "scene/windowitem.h"
@@ -117,6 +120,8 @@ EffectsHandler::EffectsHandler(Compositor *compositor, WorkspaceScene *scene)
     , m_compositor(compositor)
     , m_scene(scene)
     , m_effectLoader(new EffectLoader(this))
+    , m_periodicRepaints(std::make_unique<PeriodicRepaints>())
+    , m_animationPacing(std::make_unique<AnimationPacing>())
 {
     if (compositing_type == NoCompositing) {
         return;
@@ -184,6 +189,10 @@ EffectsHandler::EffectsHandler(Compositor *compositor, WorkspaceScene *scene)
     }
 #endif
     connect(ws, &Workspace::stackingOrderChanged, this, &EffectsHandler::stackingOrderChanged);
+    // windows that were added while compositing was suspended get their effect windows on resume
+    connect(m_compositor, &Compositor::compositingToggled, this, [this]() {
+        m_stackingOrderGeneration.reset();
+    });
 #if KWIN_BUILD_TABBOX
     TabBox::TabBox *tabBox = workspace()->tabbox();
     connect(tabBox, &TabBox::TabBox::tabBoxAdded, this, &EffectsHandler::tabBoxAdded);
@@ -229,6 +238,8 @@ EffectsHandler::EffectsHandler(Compositor *compositor, WorkspaceScene *scene)
     connect(ws, &Workspace::outputRemoved, this, &EffectsHandler::screenRemoved);
 
     connect(Cursors::self()->mouse(), &Cursor::cursorChanged, this, &EffectsHandler::cursorShapeChanged);
+    connect(m_periodicRepaints.get(), &PeriodicRepaints::repaintNeeded, this, qOverload<const QRegion &>(&EffectsHandler::addRepaint));
+    connect(m_animationPacing.get(), &AnimationPacing::repaintNeeded, this, qOverload<const QRegion &>(&EffectsHandler::addRepaint));
 
     reconfigure();
 }
@@ -295,6 +306,12 @@ void EffectsHandler::reconfigure()
 // the idea is that effects call this function again which calls the next one
 void EffectsHandler::prePaintScreen(ScreenPrePaintData &data, std::chrono::milliseconds presentTime)
 {
+    if (m_currentPaintScreenIterator == m_activeEffects.constBegin()) {
+        m_presentTime = presentTime;
+        if (const RenderLoop *renderLoop = data.screen->renderLoop()) {
+            m_animationPacing->setRenderLoopRefreshRate(renderLoop->refreshRate());
+        }
+    }
     if (m_currentPaintScreenIterator != m_activeEffects.constEnd()) {
         (*m_currentPaintScreenIterator++)->prePaintScreen(data, presentTime);
         --m_currentPaintScreenIterator;
@@ -315,7 +332,10 @@ void EffectsHandler::paintScreen(const RenderTarget &renderTarget, const RenderV
 void EffectsHandler::postPaintScreen()
 {
     if (m_currentPaintScreenIterator != m_activeEffects.constEnd()) {
-        (*m_currentPaintScreenIterator++)->postPaintScreen();
+        Effect *effect = *m_currentPaintScreenIterator++;
+        Effect *previous = std::exchange(m_postPaintingEffect, effect);
+        effect->postPaintScreen();
+        m_postPaintingEffect = previous;
         --m_currentPaintScreenIterator;
     }
     // no special final code
@@ -343,7 +363,10 @@ void EffectsHandler::paintWindow(const RenderTarget &renderTarget, const RenderV
 void EffectsHandler::postPaintWindow(EffectWindow *w)
 {
     if (m_currentPaintWindowIterator != m_activeEffects.constEnd()) {
-        (*m_currentPaintWindowIterator++)->postPaintWindow(w);
+        Effect *effect = *m_currentPaintWindowIterator++;
+        Effect *previous = std::exchange(m_postPaintingEffect, effect);
+        effect->postPaintWindow(w);
+        m_postPaintingEffect = previous;
         --m_currentPaintWindowIterator;
     }
     // no special final code
@@ -910,16 +933,30 @@ EffectWindow *EffectsHandler::findWindow(const QUuid &id) const
 
 QList<EffectWindow *> EffectsHandler::stackingOrder() const
 {
-    QList<Window *> list = workspace()->stackingOrder();
+    const quint64 generation = workspace()->stackingOrderGeneration();
+    if (m_stackingOrderGeneration == generation) {
+        return m_stackingOrder;
+    }
+
+    const QList<Window *> &list = workspace()->stackingOrder();
     QList<EffectWindow *> ret;
+    ret.reserve(list.size());
     for (Window *t : list) {
         if (EffectWindow *w = t->effectWindow()) {
             ret.append(w);
         }
     }
+    m_stackingOrder = ret;
+    m_stackingOrderGeneration = generation;
+    m_stackingOrderRebuilds++;
     return ret;
 }
 
+quint64 EffectsHandler::stackingOrderRebuilds() const
+{
+    return m_stackingOrderRebuilds;
+}
+
 void EffectsHandler::setElevatedWindow(KWin::EffectWindow *w, bool set)
 {
     WindowItem *item = w->windowItem();
@@ -991,27 +1028,73 @@ EffectWindow *EffectsHandler::currentTabBoxWindow() const
 
 void EffectsHandler::addRepaintFull()
 {
+    if (deferAnimationRepaint(m_compositor->scene()->geometry())) {
+        return;
+    }
     m_compositor->scene()->addRepaintFull();
 }
 
 void EffectsHandler::addRepaint(const QRect &r)
 {
-    m_compositor->scene()->addRepaint(r);
+    addRepaint(QRegion(r));
 }
 
 void EffectsHandler::addRepaint(const QRectF &r)
 {
-    m_compositor->scene()->addRepaint(r.toAlignedRect());
+    addRepaint(QRegion(r.toAlignedRect()));
 }
 
 void EffectsHandler::addRepaint(const QRegion &r)
 {
+    if (deferAnimationRepaint(r)) {
+        return;
+    }
     m_compositor->scene()->addRepaint(r);
 }
 
 void EffectsHandler::addRepaint(int x, int y, int w, int h)
 {
-    m_compositor->scene()->addRepaint(x, y, w, h);
+    addRepaint(QRegion(x, y, w, h));
+}
+
+void EffectsHandler::setPeriodicRepaint(QObject *owner, const QRegion &region, std::chrono::milliseconds period)
+{
+    m_periodicRepaints->setAnimation(owner, region, period);
+}
+
+void EffectsHandler::removePeriodicRepaint(QObject *owner)
+{
+    m_periodicRepaints->removeAnimation(owner);
+}
+
+PeriodicRepaints *EffectsHandler::periodicRepaints() const
+{
+    return m_periodicRepaints.get();
+}
+
+void EffectsHandler::setAnimationRefreshRate(Effect *effect, uint32_t refreshRate)
+{
+    m_animationPacing->setRefreshRate(effect, refreshRate);
+}
+
+uint32_t EffectsHandler::animationRefreshRate(Effect *effect) const
+{
+    return m_animationPacing->refreshRate(effect);
+}
+
+AnimationPacing *EffectsHandler::animationPacing() const
+{
+    return m_animationPacing.get();
+}
+
+bool EffectsHandler::deferAnimationRepaint(const QRegion &region)
+{
+    // only the repaints that an effect schedules for its next frame are paced, not the ones
+    // that start an animation
+    if (!m_postPaintingEffect) {
+        return false;
+    }
+    return m_animationPacing->defer(m_postPaintingEffect, region, m_presentTime);
 }
 
 Output *EffectsHandler::activeScreen() const
@@ -1311,6 +1394,13 @@ bool EffectsHandler::blocksDirectScanout() const
     });
 }
 
+bool EffectsHandler::isWindowUntransformed(EffectWindow *w) const
+{
+    return std::all_of(m_activeEffects.constBegin(), m_activeEffects.constEnd(), [w](const Effect *effect) {
+        return effect->leavesWindowUntransformed(w);
+    });
+}
+
 QVariant EffectsHandler::kwinOption(KWinOption kwopt)
 {
     switch (kwopt) {
@@ -29,6 +29,7 @@
 #include <QStack>
 
 #include <functional>
+#include <optional>
 
 #include <xcb/xcb.h>
 
@@ -68,6 +69,8 @@ class OffscreenQuickView;
 class Group;
 class Output;
 class Effect;
+class AnimationPacing;
+class PeriodicRepaints;
 struct TabletToolProximityEvent;
 struct TabletToolAxisEvent;
 struct TabletToolTipEvent;
@@ -438,7 +441,18 @@ public:
      * @since 5.16
      */
     Q_SCRIPTABLE KWin::EffectWindow *findWindow(const QUuid &id) const;
+    /**
+     * Returns the windows sorted in stacking order, with the topmost window at the last position.
+     *
+     * The list is only rebuilt when the stacking order of the workspace changed since the last
+     * call, otherwise the same implicitly shared list is returned, so calling this in every frame
+     * doesn't allocate anything.
+     */
     QList<EffectWindow *> stackingOrder() const;
+    /**
+     * Returns how many times stackingOrder() had to rebuild its list.
+     */
+    quint64 stackingOrderRebuilds() const;
     // window will be temporarily painted as if being at the top of the stack
     Q_SCRIPTABLE void setElevatedWindow(KWin::EffectWindow *w, bool set);
 
@@ -462,6 +476,32 @@ public:
     Q_SCRIPTABLE void addRepaint(const QRect &r);
     Q_SCRIPTABLE void addRepaint(const QRegion &r);
     Q_SCRIPTABLE void addRepaint(int x, int y, int w, int h);
+    /**
+     * Repaints @p region every @p period until removePeriodicRepaint() is called or @p owner is
+     * destroyed. Meant for animations that only change at their own rate, e.g. an icon that
+     * bounces next to the cursor, so they don't have to schedule a repaint after every frame.
+     * Calling it again for the same @p owner replaces the region and the period.
+     */
+    void setPeriodicRepaint(QObject *owner, const QRegion &region, std::chrono::milliseconds period);
+    void removePeriodicRepaint(QObject *owner);
+    PeriodicRepaints *periodicRepaints() const;
+    /**
+     * Limits the animations of @p effect to @p refreshRate, in millihertz, for effects whose
+     * animations are slow enough that painting them at the rate of the render loop is wasted.
+     * The repaints that @p effect schedules in postPaintScreen() and postPaintWindow() are held
+     * back until its next frame is due, so the render loop can skip the frames in between.
+     * A refresh rate of 0 removes the limit. All outputs are painted by a single render loop,
+     * so the limit is relative to that render loop rather than to each output.
+     */
+    void setAnimationRefreshRate(Effect *effect, uint32_t refreshRate);
+    uint32_t animationRefreshRate(Effect *effect) const;
+    AnimationPacing *animationPacing() const;
+    /**
+     * Holds back the repaint of @p region, in scene coordinates, if it is scheduled by an effect
+     * whose animations are limited to a lower refresh rate. Returns @c true if the repaint has
+     * been held back. Used by EffectWindow, effects call addRepaint() as usual.
+     */
+    bool deferAnimationRepaint(const QRegion &region);
 
     CompositingType compositingType() const;
     /**
@@ -723,6 +763,11 @@ public:
      */
     bool blocksDirectScanout() const;
 
+    /**
+     * @returns whether all active effects leave @p w untransformed, see Effect::leavesWindowUntransformed()
+     */
+    bool isWindowUntransformed(EffectWindow *w) const;
+
     WorkspaceScene *scene() const
     {
         return m_scene;
@@ -1102,6 +1147,13 @@ protected:
     QList<Effect *> m_grabbedMouseEffects;
     EffectLoader *m_effectLoader;
     std::unique_ptr<WindowPropertyNotifyX11Filter> m_x11WindowPropertyNotify;
+    mutable QList<EffectWindow *> m_stackingOrder;
+    mutable std::optional<quint64> m_stackingOrderGeneration;
+    mutable quint64 m_stackingOrderRebuilds = 0;
+    std::unique_ptr<PeriodicRepaints> m_periodicRepaints;
+    std::unique_ptr<AnimationPacing> m_animationPacing;
+    Effect *m_postPaintingEffect = nullptr;
+    std::chrono::milliseconds m_presentTime = std::chrono::milliseconds::zero();
 };
 
 /**
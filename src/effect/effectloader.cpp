@@ -128,13 +128,13 @@ bool ScriptedEffectLoader::loadEffect(const KPluginMetaData &effect, LoadEffectF
     }
 
     const QString api = effect.value(QStringLiteral("X-Plasma-API"));
-    if (api == QLatin1String("javascript")) {
+    if (api == QLatin1String("javascript") || api == QLatin1String("declarativeanimation")) {
         return loadJavascriptEffect(effect);
     } else if (api == QLatin1String("declarativescript")) {
         return loadDeclarativeEffect(effect);
     } else {
         qCWarning(KWIN_CORE, "Failed to load %s effect: invalid X-Plasma-API field: %s. "
-                             "Available options are javascript, and declarativescript", qPrintable(name), qPrintable(api));
+                             "Available options are javascript, declarativeanimation, and declarativescript", qPrintable(name), qPrintable(api));
     }
 
     return false;
@@ -90,7 +90,7 @@ EffectWindow::EffectWindow(WindowItem *windowItem)
     connect(d->m_window, &Window::modalChanged, this, [this]() {
         Q_EMIT windowModalityChanged(this);
     });
-    connect(d->m_window, &Window::frameGeometryChanged, this, [this](const QRectF &oldGeometry) {
+    connect(d->m_window, &Window::coalescedFrameGeometryChanged, this, [this](const QRectF &oldGeometry) {
         Q_EMIT windowFrameGeometryChanged(this, oldGeometry);
     });
     connect(d->m_window, &Window::damaged, this, [this]() {
@@ -198,16 +198,26 @@ void EffectWindow::unrefVisible(const EffectWindowVisibleRef *holder)
 
 void EffectWindow::addRepaint(const QRect &r)
 {
+    if (effects->deferAnimationRepaint(d->m_windowItem->mapToScene(QRegion(r)))) {
+        return;
+    }
     d->m_windowItem->scheduleRepaint(QRegion(r));
 }
 
 void EffectWindow::addRepaintFull()
 {
-    d->m_windowItem->scheduleRepaint(d->m_windowItem->boundingRect());
+    const QRectF rect = d->m_windowItem->boundingRect();
+    if (effects->deferAnimationRepaint(d->m_windowItem->mapToScene(rect).toAlignedRect())) {
+        return;
+    }
+    d->m_windowItem->scheduleRepaint(rect);
 }
 
 void EffectWindow::addLayerRepaint(const QRect &r)
 {
+    if (effects->deferAnimationRepaint(r)) {
+        return;
+    }
     d->m_windowItem->scheduleRepaint(d->m_windowItem->mapFromScene(r));
 }
 
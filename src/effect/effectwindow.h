@@ -746,9 +746,10 @@ Q_SIGNALS:
     void windowMaximizedStateAboutToChange(KWin::EffectWindow *w, bool horizontal, bool vertical);
 
     /**
-     * This signal is emitted when the frame geometry of a window changed.
+     * This signal is emitted when the frame geometry of a window changed. It is emitted at most
+     * once per frame, use windowStepUserMovedResized to follow every step of an interactive move.
      * @param window The window whose geometry changed
-     * @param oldGeometry The previous geometry
+     * @param oldGeometry The geometry when the signal was emitted last
      */
     void windowFrameGeometryChanged(KWin::EffectWindow *window, const QRectF &oldGeometry);
 
@@ -0,0 +1,73 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "framecoalescer.h"
+
+namespace KWin
+{
+
+FrameCoalescer::FrameCoalescer(QObject *parent)
+    : QObject(parent)
+{
+    m_fallbackTimer.setSingleShot(true);
+    m_fallbackTimer.setInterval(s_fallbackInterval);
+    connect(&m_fallbackTimer, &QTimer::timeout, this, &FrameCoalescer::flush);
+}
+
+FrameCoalescer::~FrameCoalescer()
+{
+}
+
+void FrameCoalescer::post(QObject *object, std::function<void()> deliver)
+{
+    m_statistics.changes++;
+    if (!m_fallbackTimer.isActive()) {
+        m_fallbackTimer.start();
+    }
+
+    if (m_delivered.contains(object)) {
+        m_pending.insert(object, Pending{
+                                     .object = object,
+                                     .deliver = std::move(deliver),
+                                 });
+        return;
+    }
+
+    m_delivered.insert(object);
+    m_statistics.deliveries++;
+    deliver();
+}
+
+void FrameCoalescer::flush()
+{
+    m_fallbackTimer.stop();
+    m_delivered.clear();
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    // the delivered changes count towards the new frame, so an object that keeps changing
+    // gets exactly one notification per frame
+    const QHash<QObject *, Pending> pending = std::exchange(m_pending, {});
+    for (const Pending &change : pending) {
+        if (!change.object) {
+            continue;
+        }
+        m_delivered.insert(change.object);
+        m_statistics.deliveries++;
+        change.deliver();
+    }
+    m_fallbackTimer.start();
+}
+
+FrameCoalescer::Statistics FrameCoalescer::statistics() const
+{
+    return m_statistics;
+}
+
+} // namespace KWin
@@ -0,0 +1,81 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QTimer>
+
+#include <chrono>
+#include <functional>
+
+namespace KWin
+{
+
+/**
+ * The FrameCoalescer delivers change notifications at most once per frame and object, for
+ * listeners that only need the latest state, e.g. the geometry of a window during an
+ * interactive move.
+ *
+ * The first change of an object in a frame is delivered right away, so one-off changes like
+ * maximizing a window aren't delayed. Further changes of the same object are held back and
+ * delivered once when the next frame starts. If no frame is painted, e.g. because compositing
+ * is off, a timer takes the place of the frame.
+ */
+class KWIN_EXPORT FrameCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Statistics
+    {
+        /// The number of changes that were posted
+        quint64 changes = 0;
+        /// The number of times a change was delivered
+        quint64 deliveries = 0;
+    };
+
+    /// How long a frame lasts if no frame is painted
+    static constexpr std::chrono::milliseconds s_fallbackInterval{25};
+
+    explicit FrameCoalescer(QObject *parent = nullptr);
+    ~FrameCoalescer() override;
+
+    /**
+     * Notifies that @p object changed. @p deliver is called right away if nothing has been
+     * delivered for the object in the current frame, otherwise when the next frame starts.
+     * If the object changes several times in between, only the last @p deliver is called.
+     */
+    void post(QObject *object, std::function<void()> deliver);
+
+    /**
+     * Starts a new frame and delivers the changes that have been held back.
+     */
+    void flush();
+
+    Statistics statistics() const;
+
+private:
+    struct Pending
+    {
+        QPointer<QObject> object;
+        std::function<void()> deliver;
+    };
+
+    QHash<QObject *, Pending> m_pending;
+    QSet<QObject *> m_delivered;
+    QTimer m_fallbackTimer;
+    Statistics m_statistics;
+};
+
+} // namespace KWin
@@ -5,6 +5,7 @@
 */
 
 #include "idledetector.h"
+#include "idletracker.h"
 #include "input.h"
 
 using namespace std::chrono_literals;
@@ -13,28 +14,40 @@ namespace KWin
 {
 
 IdleDetector::IdleDetector(std::chrono::milliseconds timeout, QObject *parent)
+    : IdleDetector(input()->idleTracker(), timeout, parent)
+{
+}
+
+IdleDetector::IdleDetector(IdleTracker *tracker, std::chrono::milliseconds timeout, QObject *parent)
     : QObject(parent)
+    , m_tracker(tracker)
     , m_timeout(timeout)
+    , m_armedSince(std::chrono::steady_clock::now())
 {
     Q_ASSERT(timeout >= 0ms);
-    m_timer.start(timeout, this);
-
-    input()->addIdleDetector(this);
+    m_tracker->add(this);
 }
 
 IdleDetector::~IdleDetector()
 {
-    if (input()) {
-        input()->removeIdleDetector(this);
+    if (m_tracker) {
+        m_tracker->remove(this);
     }
 }
 
-void IdleDetector::timerEvent(QTimerEvent *event)
+std::chrono::milliseconds IdleDetector::timeout() const
 {
-    if (event->timerId() == m_timer.timerId()) {
-        m_timer.stop();
-        markAsIdle();
-    }
+    return m_timeout;
+}
+
+std::chrono::steady_clock::time_point IdleDetector::deadline() const
+{
+    return std::max(m_armedSince, m_tracker->lastActivity()) + m_timeout;
+}
+
+bool IdleDetector::isIdle() const
+{
+    return m_isIdle;
 }
 
 bool IdleDetector::isInhibited() const
@@ -48,34 +61,20 @@ void IdleDetector::setInhibited(bool inhibited)
         return;
     }
     m_isInhibited = inhibited;
-    if (inhibited) {
-        m_timer.stop();
-    } else {
-        m_timer.start(m_timeout, this);
-    }
-}
-
-void IdleDetector::activity()
-{
-    if (!m_isInhibited) {
-        m_timer.start(m_timeout, this);
-        markAsResumed();
+    if (!inhibited) {
+        m_armedSince = std::chrono::steady_clock::now();
     }
-}
-
-void IdleDetector::markAsIdle()
-{
-    if (!m_isIdle) {
-        m_isIdle = true;
-        Q_EMIT idle();
+    if (m_tracker) {
+        m_tracker->rearm();
     }
 }
 
-void IdleDetector::markAsResumed()
+void IdleDetector::activity()
 {
-    if (m_isIdle) {
-        m_isIdle = false;
-        Q_EMIT resumed();
+    if (!m_isInhibited && m_tracker) {
+        m_armedSince = std::chrono::steady_clock::now();
+        m_tracker->markAsResumed(this);
+        m_tracker->rearm();
     }
 }
 
@@ -8,40 +8,49 @@
 
 #include <kwin_export.h>
 
-#include <QBasicTimer>
 #include <QObject>
 
+#include <chrono>
+
 namespace KWin
 {
 
+class IdleTracker;
+
 class KWIN_EXPORT IdleDetector : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * Creates an idle detector that is driven by the idle tracker of the input redirection.
+     */
     explicit IdleDetector(std::chrono::milliseconds timeout, QObject *parent = nullptr);
+    IdleDetector(IdleTracker *tracker, std::chrono::milliseconds timeout, QObject *parent = nullptr);
     ~IdleDetector() override;
 
     void activity();
 
+    bool isIdle() const;
     bool isInhibited() const;
     void setInhibited(bool inhibited);
 
+    std::chrono::milliseconds timeout() const;
+
 Q_SIGNALS:
     void idle();
     void resumed();
 
-protected:
-    void timerEvent(QTimerEvent *event) override;
-
 private:
-    void markAsIdle();
-    void markAsResumed();
+    std::chrono::steady_clock::time_point deadline() const;
 
-    QBasicTimer m_timer;
+    IdleTracker *m_tracker = nullptr;
     std::chrono::milliseconds m_timeout;
+    std::chrono::steady_clock::time_point m_armedSince;
     bool m_isIdle = false;
     bool m_isInhibited = false;
+
+    friend class IdleTracker;
 };
 
 } // namespace KWin
@@ -0,0 +1,163 @@
+/*
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "idletracker.h"
+#include "idledetector.h"
+
+#include <QTimerEvent>
+
+#include <optional>
+
+using namespace std::chrono_literals;
+
+namespace KWin
+{
+
+IdleTracker::IdleTracker(QObject *parent)
+    : QObject(parent)
+    , m_lastActivity(std::chrono::steady_clock::now())
+{
+}
+
+IdleTracker::~IdleTracker()
+{
+    for (IdleDetector *detector : std::as_const(m_detectors)) {
+        detector->m_tracker = nullptr;
+    }
+}
+
+void IdleTracker::activity()
+{
+    m_lastActivity = std::chrono::steady_clock::now();
+
+    // The deadlines of active detectors move implicitly with the last activity, so the
+    // timer only needs to be touched if some detector goes from idle to active.
+    if (!m_idleCount) {
+        return;
+    }
+
+    const auto detectors = m_detectors; // the detector list can potentially change
+    for (IdleDetector *detector : detectors) {
+        if (!detector->m_isInhibited) {
+            markAsResumed(detector);
+        }
+    }
+    rearm();
+}
+
+std::chrono::steady_clock::time_point IdleTracker::lastActivity() const
+{
+    return m_lastActivity;
+}
+
+void IdleTracker::add(IdleDetector *detector)
+{
+    Q_ASSERT(!m_detectors.contains(detector));
+    detector->setInhibited(m_inhibited);
+    m_detectors.append(detector);
+    rearm();
+}
+
+void IdleTracker::remove(IdleDetector *detector)
+{
+    if (m_detectors.removeOne(detector)) {
+        if (detector->m_isIdle) {
+            --m_idleCount;
+        }
+        rearm();
+    }
+}
+
+QList<IdleDetector *> IdleTracker::detectors() const
+{
+    return m_detectors;
+}
+
+bool IdleTracker::isInhibited() const
+{
+    return m_inhibited;
+}
+
+void IdleTracker::setInhibited(bool inhibited)
+{
+    if (m_inhibited == inhibited) {
+        return;
+    }
+    m_inhibited = inhibited;
+    for (IdleDetector *detector : std::as_const(m_detectors)) {
+        detector->setInhibited(inhibited);
+    }
+}
+
+quint64 IdleTracker::timerRestarts() const
+{
+    return m_timerRestarts;
+}
+
+void IdleTracker::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    m_timer.stop();
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto detectors = m_detectors; // the detector list can potentially change
+    for (IdleDetector *detector : detectors) {
+        if (!detector->m_isIdle && !detector->m_isInhibited && detector->deadline() <= now) {
+            markAsIdle(detector);
+        }
+    }
+
+    rearm();
+}
+
+void IdleTracker::rearm()
+{
+    std::optional<std::chrono::steady_clock::time_point> earliest;
+    for (const IdleDetector *detector : std::as_const(m_detectors)) {
+        if (detector->m_isIdle || detector->m_isInhibited) {
+            continue;
+        }
+        const auto deadline = detector->deadline();
+        if (!earliest || deadline < *earliest) {
+            earliest = deadline;
+        }
+    }
+
+    if (!earliest) {
+        m_timer.stop();
+        return;
+    }
+
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*earliest - std::chrono::steady_clock::now());
+    m_timer.start(std::max(remaining, 0ms), Qt::PreciseTimer, this);
+    ++m_timerRestarts;
+}
+
+void IdleTracker::markAsIdle(IdleDetector *detector)
+{
+    if (!detector->m_isIdle) {
+        detector->m_isIdle = true;
+        ++m_idleCount;
+        Q_EMIT detector->idle();
+    }
+}
+
+void IdleTracker::markAsResumed(IdleDetector *detector)
+{
+    if (detector->m_isIdle) {
+        detector->m_isIdle = false;
+        --m_idleCount;
+        Q_EMIT detector->resumed();
+    }
+}
+
+} // namespace KWin
+
+#include "moc_idletracker.cpp"
@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <kwin_export.h>
+
+#include <QBasicTimer>
+#include <QList>
+#include <QObject>
+
+#include <chrono>
+
+namespace KWin
+{
+
+class IdleDetector;
+
+/**
+ * The IdleTracker drives all IdleDetector objects from a single timer.
+ *
+ * Input events only update the timestamp of the last user activity, the timer is armed to
+ * the earliest deadline of the registered detectors and re-evaluates them when it fires.
+ * This keeps the per-event cost constant regardless of the number of detectors.
+ */
+class KWIN_EXPORT IdleTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IdleTracker(QObject *parent = nullptr);
+    ~IdleTracker() override;
+
+    /**
+     * Records user activity. Detectors that are idle are resumed.
+     */
+    void activity();
+
+    std::chrono::steady_clock::time_point lastActivity() const;
+
+    void add(IdleDetector *detector);
+    void remove(IdleDetector *detector);
+    QList<IdleDetector *> detectors() const;
+
+    bool isInhibited() const;
+    void setInhibited(bool inhibited);
+
+    /**
+     * Returns how many times the timer has been (re)started, for diagnostic purposes.
+     */
+    quint64 timerRestarts() const;
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    void rearm();
+    void markAsIdle(IdleDetector *detector);
+    void markAsResumed(IdleDetector *detector);
+
+    QBasicTimer m_timer;
+    QList<IdleDetector *> m_detectors;
+    std::chrono::steady_clock::time_point m_lastActivity;
+    int m_idleCount = 0;
+    quint64 m_timerRestarts = 0;
+    bool m_inhibited = false;
+
+    friend class IdleDetector;
+};
+
+} // namespace KWin
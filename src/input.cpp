@@ -17,7 +17,7 @@
 #include "gestures.h"
 #include "globalshortcuts.h"
 #include "hide_cursor_spy.h"
-#include "idledetector.h"
+#include "idletracker.h"
 #include "input_event.h"
 #include "input_event_spy.h"
 #include "keyboard_input.h"
@@ -1754,6 +1754,7 @@ InputRedirection::InputRedirection(QObject *parent)
     , m_pointer(new PointerInputRedirection(this))
     , m_tablet(new TabletInputRedirection(this))
     , m_touch(new TouchInputRedirection(this))
+    , m_idleTracker(std::make_unique<IdleTracker>())
 {
     setupInputBackends();
 
@@ -2244,22 +2245,12 @@ Qt::MouseButtons InputRedirection::qtButtonStates() const
 
 void InputRedirection::simulateUserActivity()
 {
-    const auto idleDetectors = m_idleDetectors; // the detector list can potentially change
-    for (IdleDetector *idleDetector : idleDetectors) {
-        idleDetector->activity();
-    }
-}
-
-void InputRedirection::addIdleDetector(IdleDetector *detector)
-{
-    Q_ASSERT(!m_idleDetectors.contains(detector));
-    detector->setInhibited(!m_idleInhibitors.isEmpty());
-    m_idleDetectors.append(detector);
+    m_idleTracker->activity();
 }
 
-void InputRedirection::removeIdleDetector(IdleDetector *detector)
+IdleTracker *InputRedirection::idleTracker() const
 {
-    m_idleDetectors.removeOne(detector);
+    return m_idleTracker.get();
 }
 
 QList<Window *> InputRedirection::idleInhibitors() const
@@ -2271,18 +2262,14 @@ void InputRedirection::addIdleInhibitor(Window *inhibitor)
 {
     if (!m_idleInhibitors.contains(inhibitor)) {
         m_idleInhibitors.append(inhibitor);
-        for (IdleDetector *idleDetector : std::as_const(m_idleDetectors)) {
-            idleDetector->setInhibited(true);
-        }
+        m_idleTracker->setInhibited(true);
     }
 }
 
 void InputRedirection::removeIdleInhibitor(Window *inhibitor)
 {
     if (m_idleInhibitors.removeOne(inhibitor) && m_idleInhibitors.isEmpty()) {
-        for (IdleDetector *idleDetector : std::as_const(m_idleDetectors)) {
-            idleDetector->setInhibited(false);
-        }
+        m_idleTracker->setInhibited(false);
     }
 }
 
@@ -31,7 +31,7 @@ class QWheelEvent;
 
 namespace KWin
 {
-class IdleDetector;
+class IdleTracker;
 class Window;
 class GlobalShortcutsManager;
 class InputEventFilter;
@@ -111,8 +111,10 @@ public:
 
     void simulateUserActivity();
 
-    void addIdleDetector(IdleDetector *detector);
-    void removeIdleDetector(IdleDetector *detector);
+    /**
+     * Returns the tracker that drives all idle detectors.
+     */
+    IdleTracker *idleTracker() const;
 
     QList<Window *> idleInhibitors() const;
     void addIdleInhibitor(Window *inhibitor);
@@ -272,7 +274,7 @@ private:
     std::vector<std::unique_ptr<InputBackend>> m_inputBackends;
     QList<InputDevice *> m_inputDevices;
 
-    QList<IdleDetector *> m_idleDetectors;
+    std::unique_ptr<IdleTracker> m_idleTracker;
     QList<Window *> m_idleInhibitors;
     std::unique_ptr<WindowSelectorFilter> m_windowSelector;
 
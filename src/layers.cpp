@@ -64,6 +64,7 @@
 
 */
 
+#include "clientlistproperties.h"
 #include "compositor.h"
 #include "effect/effecthandler.h"
 #include "focuschain.h"
@@ -101,12 +102,17 @@ void Workspace::updateStackingOrder(bool propagate_new_windows)
     bool changed = (force_restacking || new_stacking_order != stacking_order);
     force_restacking = false;
     stacking_order = new_stacking_order;
+    if (changed) {
+        m_stackingOrderGeneration++;
+    }
     if (changed || propagate_new_windows) {
         propagateWindows(propagate_new_windows);
 
         for (int i = 0; i < stacking_order.size(); ++i) {
             stacking_order[i]->setStackingOrder(i);
         }
+        m_desktopMembership.invalidateOrder();
+        m_activityMembership.invalidateOrder();
 
         Q_EMIT stackingOrderChanged();
 
@@ -198,7 +204,7 @@ void Workspace::propagateWindows(bool propagate_new_windows)
                 cl.push_back(x11Window->window());
             }
         }
-        rootInfo()->setClientList(cl.constData(), cl.size());
+        rootInfo()->clientLists()->setClientList(cl);
     }
 
     cl.clear();
@@ -211,7 +217,7 @@ void Workspace::propagateWindows(bool propagate_new_windows)
     for (const auto win : std::as_const(manual_overlays)) {
         cl.push_back(win);
     }
-    rootInfo()->setClientListStacking(cl.constData(), cl.size());
+    rootInfo()->clientLists()->setClientListStacking(cl);
 }
 
 /**
@@ -225,7 +231,7 @@ Window *Workspace::topWindowOnDesktop(VirtualDesktop *desktop, Output *output, b
     // TODO    Q_ASSERT( block_stacking_updates == 0 );
     QList<Window *> list;
     if (!unconstrained) {
-        list = stacking_order;
+        list = windowsOnDesktop(desktop);
     } else {
         list = unconstrained_stacking_order;
     }
@@ -252,12 +258,13 @@ Window *Workspace::topWindowOnDesktop(VirtualDesktop *desktop, Output *output, b
 Window *Workspace::findDesktop(VirtualDesktop *desktop, Output *output) const
 {
     // TODO    Q_ASSERT( block_stacking_updates == 0 );
-    for (int i = stacking_order.size() - 1; i >= 0; i--) {
-        auto window = stacking_order.at(i);
+    const QList<Window *> candidates = windowsOnDesktop(desktop);
+    for (int i = candidates.size() - 1; i >= 0; i--) {
+        auto window = candidates.at(i);
         if (window->isDeleted()) {
             continue;
         }
-        if (window->isClient() && window->isOnDesktop(desktop) && window->isOnOutput(output) && window->isDesktop() && window->isShown()) {
+        if (window->isOnOutput(output) && window->isDesktop() && window->isShown()) {
             return window;
         }
     }
@@ -11,6 +11,8 @@
 // own
 #include "netinfo.h"
 // kwin
+#include "atoms.h"
+#include "clientlistproperties.h"
 #include "rootinfo_filter.h"
 #include "virtualdesktops.h"
 #include "workspace.h"
@@ -134,9 +136,18 @@ RootInfo::RootInfo(xcb_window_t w, const char *name, NET::Properties properties,
     : NETRootInfo(kwinApp()->x11Connection(), w, name, properties, types, states, properties2, actions, scr)
     , m_activeWindow(activeWindow())
     , m_eventFilter(std::make_unique<RootInfoFilter>(this))
+    , m_clientLists(std::make_unique<ClientListProperties>(kwinApp()->x11Connection(), kwinApp()->x11RootWindow(),
+                                                           atoms->net_client_list, atoms->net_client_list_stacking))
 {
 }
 
+RootInfo::~RootInfo() = default;
+
+ClientListProperties *RootInfo::clientLists() const
+{
+    return m_clientLists.get();
+}
+
 void RootInfo::changeNumberOfDesktops(int n)
 {
     VirtualDesktopManager::self()->setCount(n);
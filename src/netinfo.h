@@ -21,6 +21,7 @@
 namespace KWin
 {
 
+class ClientListProperties;
 class Window;
 class RootInfoFilter;
 class X11Window;
@@ -35,9 +36,16 @@ public:
     static void destroy();
     RootInfo(xcb_window_t w, const char *name, NET::Properties properties, NET::WindowTypes types,
              NET::States states, NET::Properties2 properties2, NET::Actions actions, int scr = -1);
+    ~RootInfo() override;
 
     void setActiveClient(Window *client);
 
+    /**
+     * Returns the writer of _NET_CLIENT_LIST and _NET_CLIENT_LIST_STACKING. They are not set
+     * through NETRootInfo, so that unchanged lists aren't written again.
+     */
+    ClientListProperties *clientLists() const;
+
 protected:
     void changeNumberOfDesktops(int n) override;
     void changeCurrentDesktop(int d) override;
@@ -56,6 +64,7 @@ private:
 
     xcb_window_t m_activeWindow;
     std::unique_ptr<RootInfoFilter> m_eventFilter;
+    std::unique_ptr<ClientListProperties> m_clientLists;
 };
 
 inline RootInfo *rootInfo()
@@ -17,24 +17,44 @@
 #include "kscreenintegration.h"
 #include "workspace.h"
 
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QOrientationReading>
+#include <QSaveFile>
+#include <numeric>
 #include <ranges>
 
+using namespace std::chrono_literals;
+
 namespace KWin
 {
 
+// Docks and KVM switches can flap the connection many times in a row, don't write out every single change
+static const std::chrono::milliseconds s_saveDelay = 1s;
+
 OutputConfigurationStore::OutputConfigurationStore()
 {
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(s_saveDelay);
+    QObject::connect(&m_saveTimer, &QTimer::timeout, [this]() {
+        save();
+    });
+    m_saveThreadPool.setMaxThreadCount(1);
+
     load();
+    for (qsizetype i = 0; i < m_outputs.size(); ++i) {
+        indexOutput(i);
+    }
 }
 
 OutputConfigurationStore::~OutputConfigurationStore()
 {
     save();
+    m_saveThreadPool.waitForDone();
 }
 
 std::optional<std::tuple<OutputConfiguration, QList<Output *>, OutputConfigurationStore::ConfigType>> OutputConfigurationStore::queryConfig(const QList<Output *> &outputs, bool isLidClosed, QOrientationReading *orientation, bool isTabletMode)
@@ -133,8 +153,26 @@ std::optional<size_t> OutputConfigurationStore::findOutput(Output *output, const
         std::optional<QString> connectorName;
     };
     const auto filterBy = [this](const Properties &props) {
+        // only look at the outputs that share the most selective property
+        std::optional<QList<size_t>> candidates;
+        const auto narrow = [&candidates](const QHash<QString, QList<size_t>> &index, const std::optional<QString> &key) {
+            if (key.has_value()) {
+                const QList<size_t> indices = index.value(*key);
+                if (!candidates || indices.size() < candidates->size()) {
+                    candidates = indices;
+                }
+            }
+        };
+        narrow(m_edidHashIndex, props.edidHash);
+        narrow(m_connectorIndex, props.connectorName);
+        narrow(m_edidIdentifierIndex, props.edidIdentifier);
+        if (!candidates) {
+            candidates = QList<size_t>(m_outputs.size());
+            std::iota(candidates->begin(), candidates->end(), 0);
+        }
+
         std::vector<size_t> ret;
-        for (ssize_t i = 0; i < m_outputs.size(); i++) {
+        for (size_t i : std::as_const(*candidates)) {
             const auto &state = m_outputs[i];
             if (props.edidIdentifier.has_value() && state.edidIdentifier != *props.edidIdentifier) {
                 continue;
@@ -246,6 +284,7 @@ void OutputConfigurationStore::storeConfig(const QList<Output *> &allOutputs, bo
         if (!outputIndex) {
             m_outputs.push_back(OutputState{});
             outputIndex = m_outputs.size() - 1;
+            indexOutput(*outputIndex);
         }
         auto outputIt = std::find_if(setup->outputs.begin(), setup->outputs.end(), [outputIndex](const auto &output) {
             return output.outputIndex == outputIndex;
@@ -263,7 +302,7 @@ void OutputConfigurationStore::storeConfig(const QList<Output *> &allOutputs, bo
             if (refreshRate == 0) {
                 refreshRate = output->currentMode()->refreshRate();
             }
-            m_outputs[*outputIndex] = OutputState{
+            setOutputState(*outputIndex, OutputState{
                 .edidIdentifier = output->edid().identifier(),
                 .connectorName = output->name(),
                 .edidHash = output->edid().hash(),
@@ -291,7 +330,7 @@ void OutputConfigurationStore::storeConfig(const QList<Output *> &allOutputs, bo
                 .brightness = changeSet->brightness.value_or(output->brightnessSetting()),
                 .allowSdrSoftwareBrightness = changeSet->allowSdrSoftwareBrightness.value_or(output->allowSdrSoftwareBrightness()),
                 .colorPowerTradeoff = changeSet->colorPowerTradeoff.value_or(output->colorPowerTradeoff()),
-            };
+            });
             *outputIt = SetupState{
                 .outputIndex = *outputIndex,
                 .position = changeSet->pos.value_or(output->geometry().topLeft()),
@@ -307,7 +346,7 @@ void OutputConfigurationStore::storeConfig(const QList<Output *> &allOutputs, bo
             if (refreshRate == 0) {
                 refreshRate = output->currentMode()->refreshRate();
             }
-            m_outputs[*outputIndex] = OutputState{
+            setOutputState(*outputIndex, OutputState{
                 .edidIdentifier = output->edid().identifier(),
                 .connectorName = output->name(),
                 .edidHash = output->edid().hash(),
@@ -335,7 +374,7 @@ void OutputConfigurationStore::storeConfig(const QList<Output *> &allOutputs, bo
                 .brightness = output->brightnessSetting(),
                 .allowSdrSoftwareBrightness = output->allowSdrSoftwareBrightness(),
                 .colorPowerTradeoff = output->colorPowerTradeoff(),
-            };
+            });
             *outputIt = SetupState{
                 .outputIndex = *outputIndex,
                 .position = output->geometry().topLeft(),
@@ -344,7 +383,49 @@ void OutputConfigurationStore::storeConfig(const QList<Output *> &allOutputs, bo
             };
         }
     }
-    save();
+    scheduleSave();
+}
+
+void OutputConfigurationStore::setOutputState(size_t index, const OutputState &state)
+{
+    unindexOutput(index);
+    m_outputs[index] = state;
+    indexOutput(index);
+}
+
+static void insertIndex(QHash<QString, QList<size_t>> &index, const QString &key, size_t value)
+{
+    QList<size_t> &indices = index[key];
+    // keep the indices sorted, so matches are reported in the same order as in m_outputs
+    indices.insert(std::lower_bound(indices.begin(), indices.end(), value), value);
+}
+
+static void removeIndex(QHash<QString, QList<size_t>> &index, const QString &key, size_t value)
+{
+    const auto it = index.find(key);
+    if (it == index.end()) {
+        return;
+    }
+    it->removeOne(value);
+    if (it->isEmpty()) {
+        index.erase(it);
+    }
+}
+
+void OutputConfigurationStore::indexOutput(size_t index)
+{
+    const OutputState &state = m_outputs[index];
+    insertIndex(m_edidIdentifierIndex, state.edidIdentifier, index);
+    insertIndex(m_edidHashIndex, state.edidHash, index);
+    insertIndex(m_connectorIndex, state.connectorName, index);
+}
+
+void OutputConfigurationStore::unindexOutput(size_t index)
+{
+    const OutputState &state = m_outputs[index];
+    removeIndex(m_edidIdentifierIndex, state.edidIdentifier, index);
+    removeIndex(m_edidHashIndex, state.edidHash, index);
+    removeIndex(m_connectorIndex, state.connectorName, index);
 }
 
 std::pair<OutputConfiguration, QList<Output *>> OutputConfigurationStore::setupToConfig(Setup *setup, const std::unordered_map<Output *, size_t> &outputMap) const
@@ -988,14 +1069,60 @@ void OutputConfigurationStore::load()
     }
 }
 
+void OutputConfigurationStore::scheduleSave()
+{
+    m_saveTimer.start();
+}
+
+void OutputConfigurationStore::flush()
+{
+    if (m_saveTimer.isActive()) {
+        save();
+    }
+    m_saveThreadPool.waitForDone();
+}
+
+uint OutputConfigurationStore::saveCount() const
+{
+    return m_saveCount;
+}
+
 void OutputConfigurationStore::save()
+{
+    m_saveTimer.stop();
+
+    // The lists are implicitly shared, the worker gets a snapshot without copying the data
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/kwinoutputconfig.json";
+    m_saveThreadPool.start([this, path, outputs = m_outputs, setups = m_setups]() {
+        const QByteArray data = serialize(outputs, setups);
+        if (data == m_lastSaved) {
+            return;
+        }
+
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QSaveFile f(path);
+        if (!f.open(QIODevice::WriteOnly)) {
+            qCWarning(KWIN_CORE, "Couldn't open output config file %s", qPrintable(path));
+            return;
+        }
+        f.write(data);
+        if (!f.commit()) {
+            qCWarning(KWIN_CORE, "Couldn't write output config file %s", qPrintable(path));
+            return;
+        }
+        m_lastSaved = data;
+        ++m_saveCount;
+    });
+}
+
+QByteArray OutputConfigurationStore::serialize(const QList<OutputState> &outputStates, const QList<Setup> &setupStates)
 {
     QJsonDocument document;
     QJsonArray array;
     QJsonObject outputs;
     outputs["name"] = "outputs";
     QJsonArray outputsData;
-    for (const auto &output : m_outputs) {
+    for (const auto &output : outputStates) {
         QJsonObject o;
         if (!output.edidIdentifier.isEmpty()) {
             o["edidIdentifier"] = output.edidIdentifier;
@@ -1127,7 +1254,7 @@ void OutputConfigurationStore::save()
     QJsonObject setups;
     setups["name"] = "setups";
     QJsonArray setupData;
-    for (const auto &setup : m_setups) {
+    for (const auto &setup : setupStates) {
         QJsonObject o;
         o["lidClosed"] = setup.lidClosed;
         QJsonArray outputs;
@@ -1151,15 +1278,8 @@ void OutputConfigurationStore::save()
     setups["data"] = setupData;
     array.append(setups);
 
-    const QString path = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/kwinoutputconfig.json";
-    QFile f(path);
-    if (!f.open(QIODevice::WriteOnly)) {
-        qCWarning(KWIN_CORE, "Couldn't open output config file %s", qPrintable(path));
-        return;
-    }
     document.setArray(array);
-    f.write(document.toJson());
-    f.flush();
+    return document.toJson();
 }
 
 bool OutputConfigurationStore::isAutoRotateActive(const QList<Output *> &outputs, bool isTabletMode) const
@@ -10,9 +10,13 @@
 
 #include "core/output.h"
 
+#include <QHash>
 #include <QList>
 #include <QPoint>
 #include <QSize>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <tuple>
@@ -41,12 +45,23 @@ public:
 
     bool isAutoRotateActive(const QList<Output *> &outputs, bool isTabletMode) const;
 
+    /**
+     * Writes pending changes to disk and blocks until all writes have finished.
+     */
+    void flush();
+
+    /**
+     * Returns the number of times the configuration file has been written.
+     */
+    uint saveCount() const;
+
 private:
     void applyOrientationReading(OutputConfiguration &config, const QList<Output *> &outputs, QOrientationReading *orientation, bool isTabletMode);
     std::optional<std::pair<OutputConfiguration, QList<Output *>>> generateLidClosedConfig(const QList<Output *> &outputs);
     std::shared_ptr<OutputMode> chooseMode(Output *output) const;
     double chooseScale(Output *output, OutputMode *mode) const;
     void load();
+    void scheduleSave();
     void save();
 
     struct ModeData
@@ -99,8 +114,23 @@ private:
     std::pair<OutputConfiguration, QList<Output *>> setupToConfig(Setup *setup, const std::unordered_map<Output *, size_t> &outputMap) const;
     std::optional<std::pair<Setup *, std::unordered_map<Output *, size_t>>> findSetup(const QList<Output *> &outputs, bool lidClosed);
     std::optional<size_t> findOutput(Output *output, const QList<Output *> &allOutputs) const;
+    void setOutputState(size_t index, const OutputState &state);
+    void indexOutput(size_t index);
+    void unindexOutput(size_t index);
+
+    static QByteArray serialize(const QList<OutputState> &outputStates, const QList<Setup> &setupStates);
 
     QList<OutputState> m_outputs;
     QList<Setup> m_setups;
+    // indexes into m_outputs, so that lookups during hotplug don't have to scan the whole history
+    QHash<QString, QList<size_t>> m_edidIdentifierIndex;
+    QHash<QString, QList<size_t>> m_edidHashIndex;
+    QHash<QString, QList<size_t>> m_connectorIndex;
+
+    // saves are coalesced and written on a dedicated thread, in order
+    QTimer m_saveTimer;
+    QThreadPool m_saveThreadPool;
+    QByteArray m_lastSaved;
+    std::atomic<uint> m_saveCount = 0;
 };
 }
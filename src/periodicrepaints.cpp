@@ -0,0 +1,123 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "periodicrepaints.h"
+
+namespace KWin
+{
+
+static std::chrono::milliseconds steadyClock()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
+}
+
+PeriodicRepaints::PeriodicRepaints(QObject *parent)
+    : PeriodicRepaints(steadyClock, parent)
+{
+}
+
+PeriodicRepaints::PeriodicRepaints(const Clock &clock, QObject *parent)
+    : QObject(parent)
+    , m_clock(clock)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, [this]() {
+        const QRegion region = advance(m_clock());
+        if (!region.isEmpty()) {
+            Q_EMIT repaintNeeded(region);
+        }
+    });
+}
+
+PeriodicRepaints::~PeriodicRepaints()
+{
+}
+
+void PeriodicRepaints::setAnimation(QObject *owner, const QRegion &region, std::chrono::milliseconds period)
+{
+    period = std::max(period, std::chrono::milliseconds(1));
+
+    auto it = m_animations.find(owner);
+    if (it != m_animations.end()) {
+        it->region = region;
+        it->period = period;
+    } else {
+        m_animations.insert(owner, Animation{
+                                       .region = region,
+                                       .period = period,
+                                       .deadline = m_clock() + period,
+                                       .destroyedConnection = connect(owner, &QObject::destroyed, this, [this, owner]() {
+                                           removeAnimation(owner);
+                                       }),
+                                   });
+    }
+    scheduleTimer();
+}
+
+void PeriodicRepaints::removeAnimation(QObject *owner)
+{
+    auto it = m_animations.find(owner);
+    if (it == m_animations.end()) {
+        return;
+    }
+    disconnect(it->destroyedConnection);
+    m_animations.erase(it);
+    scheduleTimer();
+}
+
+bool PeriodicRepaints::isEmpty() const
+{
+    return m_animations.isEmpty();
+}
+
+QRegion PeriodicRepaints::advance(std::chrono::milliseconds now)
+{
+    QRegion region;
+    for (Animation &animation : m_animations) {
+        if (animation.deadline > now) {
+            continue;
+        }
+        region += animation.region;
+        m_statistics.ticks++;
+        animation.deadline += animation.period;
+        if (animation.deadline <= now) {
+            animation.deadline = now + animation.period;
+        }
+    }
+    scheduleTimer();
+    return region;
+}
+
+std::optional<std::chrono::milliseconds> PeriodicRepaints::nextDeadline() const
+{
+    std::optional<std::chrono::milliseconds> deadline;
+    for (const Animation &animation : m_animations) {
+        if (!deadline || animation.deadline < *deadline) {
+            deadline = animation.deadline;
+        }
+    }
+    return deadline;
+}
+
+PeriodicRepaints::Statistics PeriodicRepaints::statistics() const
+{
+    return m_statistics;
+}
+
+void PeriodicRepaints::scheduleTimer()
+{
+    const auto deadline = nextDeadline();
+    if (!deadline) {
+        m_timer.stop();
+        return;
+    }
+    m_timer.start(std::max(*deadline - m_clock(), std::chrono::milliseconds::zero()));
+}
+
+} // namespace KWin
@@ -0,0 +1,98 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QObject>
+#include <QRegion>
+#include <QTimer>
+
+#include <chrono>
+#include <functional>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The PeriodicRepaints class repaints the regions of animations that only change at their own
+ * rate, e.g. a spinner next to the cursor that shows a new frame ten times per second.
+ *
+ * Scheduling a repaint after every painted frame makes such an animation run at the refresh
+ * rate of the output, even though most of the frames look the same. Instead, the animation
+ * declares its region and its period, and the region is repainted once per period. While
+ * nothing else changes, the compositor only paints at the rate of the animation.
+ */
+class KWIN_EXPORT PeriodicRepaints : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Clock = std::function<std::chrono::milliseconds()>;
+
+    struct Statistics
+    {
+        /// The number of times the region of an animation was due
+        quint64 ticks = 0;
+    };
+
+    explicit PeriodicRepaints(QObject *parent = nullptr);
+    /**
+     * Creates a PeriodicRepaints that reads the time from @p clock, e.g. in tests.
+     */
+    explicit PeriodicRepaints(const Clock &clock, QObject *parent = nullptr);
+    ~PeriodicRepaints() override;
+
+    /**
+     * Repaints @p region every @p period for @p owner, until removeAnimation() is called or
+     * @p owner is destroyed. If @p owner has an animation already, its region and period are
+     * replaced, the time of its next frame stays the same.
+     */
+    void setAnimation(QObject *owner, const QRegion &region, std::chrono::milliseconds period);
+    void removeAnimation(QObject *owner);
+    bool isEmpty() const;
+
+    /**
+     * Returns the region of the animations that are due at @p now and moves them on to their
+     * next frame. An animation that fell behind doesn't catch up on the frames it missed.
+     */
+    QRegion advance(std::chrono::milliseconds now);
+    /**
+     * Returns when the next animation is due, if there is any.
+     */
+    std::optional<std::chrono::milliseconds> nextDeadline() const;
+
+    Statistics statistics() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the timer found the animations in @p region to be due.
+     */
+    void repaintNeeded(const QRegion &region);
+
+private:
+    struct Animation
+    {
+        QRegion region;
+        std::chrono::milliseconds period;
+        std::chrono::milliseconds deadline;
+        QMetaObject::Connection destroyedConnection;
+    };
+
+    void scheduleTimer();
+
+    Clock m_clock;
+    QHash<QObject *, Animation> m_animations;
+    QTimer m_timer;
+    Statistics m_statistics;
+};
+
+} // namespace KWin
@@ -0,0 +1,299 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "pingscheduler.h"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+namespace KWin
+{
+
+// Statistics of idle clients are kept for a while, but not forever, pids get recycled
+static const int s_maxIdleClients = 64;
+// A client gets this many times its average response latency before it is considered hung
+static const int s_latencyFactor = 4;
+
+size_t qHash(const PingScheduler::Key &key, size_t seed)
+{
+    return qHashMulti(seed, key.client.hostName, key.client.pid, key.anonymous);
+}
+
+PingScheduler::PingScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &PingScheduler::handleTimeout);
+}
+
+PingScheduler::~PingScheduler() = default;
+
+std::chrono::milliseconds PingScheduler::stageTimeout(const Client &client, std::chrono::milliseconds timeout) const
+{
+    const std::chrono::milliseconds minimum = timeout / 2;
+    const auto it = m_clients.constFind(Key{client});
+    if (it == m_clients.constEnd() || it->statistics.pings == 0) {
+        return minimum;
+    }
+    return std::clamp(it->statistics.averageLatency * s_latencyFactor, minimum, timeout);
+}
+
+bool PingScheduler::schedule(QObject *target, const Client &client, std::chrono::milliseconds timeout)
+{
+    if (isPending(target)) {
+        return false;
+    }
+
+    const Key key{client, client.isValid() ? nullptr : target};
+    m_targets[target] = key;
+
+    const auto now = std::chrono::steady_clock::now();
+    ClientState &state = m_clients[key];
+    state.lastUsed = now;
+
+    if (state.pending) {
+        state.pending->targets.append(target);
+        if (state.pending->firstStageExpired && !state.unresponsiveTargets.contains(target)) {
+            state.unresponsiveTargets.append(target);
+            Q_EMIT unresponsiveChanged(target, true);
+        }
+        return false;
+    }
+
+    const std::chrono::milliseconds stage = stageTimeout(client, timeout);
+    state.pending = PendingPing{
+        .carrier = target,
+        .targets = {target},
+        .sent = now,
+        .deadline = now + stage,
+        .timeout = stage,
+    };
+    ++state.statistics.pings;
+
+    rearm();
+    return true;
+}
+
+void PingScheduler::acknowledge(QObject *target)
+{
+    const auto targetIt = m_targets.constFind(target);
+    if (targetIt == m_targets.constEnd()) {
+        return;
+    }
+    const auto clientIt = m_clients.find(*targetIt);
+    if (clientIt == m_clients.end()) {
+        return;
+    }
+
+    ClientState &state = *clientIt;
+    state.lastUsed = std::chrono::steady_clock::now();
+    if (state.pending) {
+        if (state.pending->carrier == target) {
+            addLatencySample(state, std::chrono::duration_cast<std::chrono::milliseconds>(state.lastUsed - state.pending->sent));
+        }
+        state.pending.reset();
+    }
+    markResponsive(state);
+
+    rearm();
+    pruneClients();
+}
+
+void PingScheduler::remove(QObject *target)
+{
+    const auto targetIt = m_targets.constFind(target);
+    if (targetIt == m_targets.constEnd()) {
+        return;
+    }
+    const Key key = *targetIt;
+    m_targets.erase(targetIt);
+
+    const auto clientIt = m_clients.find(key);
+    if (clientIt == m_clients.end()) {
+        return;
+    }
+
+    ClientState &state = *clientIt;
+    state.unresponsiveTargets.removeOne(target);
+    if (state.promptTarget == target) {
+        state.promptTarget = nullptr;
+    }
+
+    if (state.pending) {
+        state.pending->targets.removeOne(target);
+        if (state.pending->targets.isEmpty()) {
+            state.pending.reset();
+        } else if (state.pending->carrier == target) {
+            // The window that carried the ping is gone, its pong will never arrive.
+            state.pending->carrier = state.pending->targets.constFirst();
+            Q_EMIT pingRequested(state.pending->carrier);
+        }
+    }
+
+    if (key.anonymous) {
+        m_clients.erase(clientIt);
+    }
+
+    rearm();
+    pruneClients();
+}
+
+bool PingScheduler::isPending(QObject *target) const
+{
+    const auto targetIt = m_targets.constFind(target);
+    if (targetIt == m_targets.constEnd()) {
+        return false;
+    }
+    const auto clientIt = m_clients.constFind(*targetIt);
+    return clientIt != m_clients.constEnd() && clientIt->pending && clientIt->pending->targets.contains(target);
+}
+
+bool PingScheduler::isUnresponsive(QObject *target) const
+{
+    const auto targetIt = m_targets.constFind(target);
+    if (targetIt == m_targets.constEnd()) {
+        return false;
+    }
+    const auto clientIt = m_clients.constFind(*targetIt);
+    return clientIt != m_clients.constEnd() && clientIt->unresponsiveTargets.contains(target);
+}
+
+QList<PingScheduler::Client> PingScheduler::clients() const
+{
+    QList<Client> clients;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (!it.key().anonymous) {
+            clients.append(it.key().client);
+        }
+    }
+    return clients;
+}
+
+PingScheduler::Statistics PingScheduler::statistics(const Client &client) const
+{
+    const auto it = m_clients.constFind(Key{client});
+    if (it == m_clients.constEnd()) {
+        return Statistics{};
+    }
+    Statistics statistics = it->statistics;
+    statistics.unresponsive = !it->unresponsiveTargets.isEmpty();
+    return statistics;
+}
+
+void PingScheduler::handleTimeout()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    // Collect the expired clients first, the signals may call back into the scheduler.
+    QList<Key> expired;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (it->pending && it->pending->deadline <= now) {
+            expired.append(it.key());
+        }
+    }
+
+    for (const Key &key : std::as_const(expired)) {
+        auto it = m_clients.find(key);
+        if (it == m_clients.end() || !it->pending || it->pending->deadline > now) {
+            continue;
+        }
+
+        ClientState &state = *it;
+        if (!state.pending->firstStageExpired) {
+            state.pending->firstStageExpired = true;
+            state.pending->deadline = now + state.pending->timeout;
+            ++state.statistics.timeouts;
+
+            const QList<QObject *> targets = state.pending->targets;
+            for (QObject *target : targets) {
+                if (!state.unresponsiveTargets.contains(target)) {
+                    state.unresponsiveTargets.append(target);
+                    Q_EMIT unresponsiveChanged(target, true);
+                }
+            }
+        } else {
+            QObject *carrier = state.pending->carrier;
+            // Keep the targets flagged as unresponsive, a late pong still clears them.
+            state.pending.reset();
+            if (!state.promptTarget) {
+                state.promptTarget = carrier;
+                Q_EMIT killRequested(carrier);
+            }
+        }
+    }
+
+    rearm();
+}
+
+void PingScheduler::rearm()
+{
+    std::optional<std::chrono::steady_clock::time_point> earliest;
+    for (const ClientState &state : std::as_const(m_clients)) {
+        if (state.pending && (!earliest || state.pending->deadline < *earliest)) {
+            earliest = state.pending->deadline;
+        }
+    }
+
+    if (!earliest) {
+        m_timer.stop();
+        return;
+    }
+
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*earliest - std::chrono::steady_clock::now());
+    m_timer.start(std::max(remaining, 0ms));
+}
+
+void PingScheduler::pruneClients()
+{
+    QList<Key> idle;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (!it->pending && it->unresponsiveTargets.isEmpty() && !it->promptTarget) {
+            idle.append(it.key());
+        }
+    }
+    if (idle.size() <= s_maxIdleClients) {
+        return;
+    }
+
+    std::sort(idle.begin(), idle.end(), [this](const Key &a, const Key &b) {
+        return m_clients[a].lastUsed < m_clients[b].lastUsed;
+    });
+    for (int i = 0; i < idle.size() - s_maxIdleClients; ++i) {
+        m_clients.remove(idle[i]);
+        m_targets.removeIf([&idle, i](const auto &it) {
+            return it.value() == idle[i];
+        });
+    }
+}
+
+void PingScheduler::addLatencySample(ClientState &state, std::chrono::milliseconds latency)
+{
+    Statistics &statistics = state.statistics;
+    // Exponentially weighted moving average, like the smoothed round-trip time in TCP
+    if (statistics.averageLatency == 0ms) {
+        statistics.averageLatency = latency;
+    } else {
+        statistics.averageLatency = (statistics.averageLatency * 7 + latency) / 8;
+    }
+    statistics.maximumLatency = std::max(statistics.maximumLatency, latency);
+}
+
+void PingScheduler::markResponsive(ClientState &state)
+{
+    state.promptTarget = nullptr;
+    const QList<QObject *> targets = std::exchange(state.unresponsiveTargets, {});
+    for (QObject *target : targets) {
+        Q_EMIT unresponsiveChanged(target, false);
+    }
+}
+
+} // namespace KWin
+
+#include "moc_pingscheduler.cpp"
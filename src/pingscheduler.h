@@ -0,0 +1,153 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The PingScheduler keeps track of all outstanding _NET_WM_PING requests.
+ *
+ * Pending pings share a single timer that is armed to the earliest deadline. Pings are
+ * deduplicated per client, i.e. per (host name, pid) pair: if a client already has an
+ * outstanding ping, the windows that get pinged afterwards are attached to it instead of
+ * sending another request. If the client doesn't respond, all its windows are marked as
+ * unresponsive and a kill prompt is requested only once for the whole client.
+ *
+ * The timeouts adapt to the response latency observed for the client so far, so clients that
+ * are known to be slow get more time before they are considered to be hung.
+ */
+class KWIN_EXPORT PingScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Client
+    {
+        QString hostName;
+        qint64 pid = 0;
+
+        bool isValid() const
+        {
+            return pid > 0 && !hostName.isEmpty();
+        }
+        bool operator==(const Client &other) const = default;
+    };
+
+    struct Statistics
+    {
+        uint pings = 0;
+        uint timeouts = 0;
+        std::chrono::milliseconds averageLatency = std::chrono::milliseconds::zero();
+        std::chrono::milliseconds maximumLatency = std::chrono::milliseconds::zero();
+        bool unresponsive = false;
+    };
+
+    explicit PingScheduler(QObject *parent = nullptr);
+    ~PingScheduler() override;
+
+    /**
+     * Starts pinging @p target that belongs to @p client. @p timeout is the configured time
+     * after which the client is considered to be hung, half of it is spent before the target
+     * is marked as unresponsive.
+     *
+     * Returns @c true if the caller has to send a ping request to @p target, or @c false if
+     * the target is already being pinged or has been attached to an outstanding ping of its client.
+     */
+    bool schedule(QObject *target, const Client &client, std::chrono::milliseconds timeout);
+
+    /**
+     * Notifies the scheduler that @p target has answered its ping.
+     */
+    void acknowledge(QObject *target);
+
+    /**
+     * Forgets about @p target, e.g. because the window has been closed.
+     */
+    void remove(QObject *target);
+
+    bool isPending(QObject *target) const;
+    bool isUnresponsive(QObject *target) const;
+
+    /**
+     * Returns the time to wait for @p client in each of the two ping stages.
+     */
+    std::chrono::milliseconds stageTimeout(const Client &client, std::chrono::milliseconds timeout) const;
+
+    QList<Client> clients() const;
+    Statistics statistics(const Client &client) const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when @p target stops or starts responding to pings.
+     */
+    void unresponsiveChanged(QObject *target, bool unresponsive);
+    /**
+     * Emitted when the client of @p target hasn't answered within both ping stages. It is
+     * emitted once per client until the client responds again.
+     */
+    void killRequested(QObject *target);
+    /**
+     * Emitted when the window that carried the ping of a client is gone and @p target has to
+     * send a new ping on behalf of the client.
+     */
+    void pingRequested(QObject *target);
+
+private:
+    struct Key
+    {
+        Client client;
+        // Only set for clients that cannot be identified, they are never deduplicated
+        const QObject *anonymous = nullptr;
+
+        bool operator==(const Key &other) const = default;
+    };
+    friend size_t qHash(const Key &key, size_t seed);
+
+    struct PendingPing
+    {
+        QObject *carrier = nullptr;
+        QList<QObject *> targets;
+        std::chrono::steady_clock::time_point sent;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::milliseconds timeout;
+        bool firstStageExpired = false;
+    };
+
+    struct ClientState
+    {
+        std::optional<PendingPing> pending;
+        QList<QObject *> unresponsiveTargets;
+        QObject *promptTarget = nullptr;
+        Statistics statistics;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    void handleTimeout();
+    void rearm();
+    void pruneClients();
+    void addLatencySample(ClientState &state, std::chrono::milliseconds latency);
+    void markResponsive(ClientState &state);
+
+    QTimer m_timer;
+    QHash<QObject *, Key> m_targets;
+    QHash<Key, ClientState> m_clients;
+};
+
+} // namespace KWin
@@ -10,7 +10,9 @@
 // KConfigSkeleton
 #include "blurconfig.h"
 
+#include "core/output.h"
 #include "core/pixelgrid.h"
+#include "core/renderloop.h"
 #include "core/rendertarget.h"
 #include "core/renderviewport.h"
 #include "effect/effecthandler.h"
@@ -23,6 +25,8 @@
 #include "utils/xcbutils.h"
 
 #include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMatrix4x4>
 #include <QScreen>
 #include <QTime>
@@ -214,6 +218,8 @@ void BlurEffect::reconfigure(ReconfigureFlags flags)
     m_offset = blurStrengthValues[blurStrength].offset;
     m_expandSize = blurOffsets[m_iterationCount - 1].expandSize;
     m_noiseStrength = BlurConfig::noiseStrength();
+    m_adaptiveQuality = BlurConfig::adaptiveQuality();
+    m_quality.reset();
 
     // Update all windows for the blur to take effect
     effects->addRepaintFull();
@@ -395,6 +401,17 @@ void BlurEffect::prePaintScreen(ScreenPrePaintData &data, std::chrono::milliseco
     m_paintedArea = QRegion();
     m_currentBlur = QRegion();
 
+    // only frames that blurred something tell how expensive the blur is
+    m_qualityChanged = false;
+    if (m_adaptiveQuality && m_blurredInLastFrame && data.screen) {
+        const RenderLoop *renderLoop = data.screen->renderLoop();
+        if (renderLoop && renderLoop->refreshRate() > 0) {
+            const std::chrono::nanoseconds budget(1'000'000'000'000 / renderLoop->refreshRate());
+            m_qualityChanged = m_quality.update(renderLoop->predictedRenderTime(), budget);
+        }
+    }
+    m_blurredInLastFrame = false;
+
     effects->prePaintScreen(data, presentTime);
 }
 
@@ -426,9 +443,16 @@ void BlurEffect::prePaintWindow(EffectWindow *w, WindowPrePaintData &data, std::
     // in case this window has regions to be blurred
     const QRegion blurArea = blurRegion(w).boundingRect().translated(w->pos().toPoint());
 
+    // the cached background is copied anew if the window is blurred at another quality than
+    // before, e.g. because it got activated while the quality is lowered
+    bool qualityChanged = m_qualityChanged;
+    if (auto it = m_windows.find(w); it != m_windows.end() && it->second.render.quality) {
+        qualityChanged |= *it->second.render.quality != m_quality.quality(m_iterationCount, w != effects->activeWindow());
+    }
+
     // if this window or a window underneath the blurred area is painted again we have to
-    // blur everything
-    if (m_paintedArea.intersects(blurArea) || data.paint.intersects(blurArea)) {
+    // blur everything, the same goes for when the cached background changes its resolution
+    if (qualityChanged || m_paintedArea.intersects(blurArea) || data.paint.intersects(blurArea)) {
         data.paint += blurArea;
         // we have to check again whether we do not damage a blurred area
         // of a window
@@ -563,6 +587,12 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
     if (effectiveShape.isEmpty()) {
         return;
     }
+    m_blurredInLastFrame = true;
+
+    // Under GPU pressure, the windows other than the active one are blurred at a lower quality first.
+    const BlurQuality quality = m_quality.quality(m_iterationCount, w != effects->activeWindow());
+    const int resolutionShift = quality.halfResolution ? 1 : 0;
+    const QSize backgroundSize = backgroundRect.size() / (1 << resolutionShift);
 
     // Maybe reallocate offscreen render targets. Keep in mind that the first one contains
     // original background behind the window, it's not blurred.
@@ -571,12 +601,15 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
         textureFormat = renderTarget.texture()->internalFormat();
     }
 
-    if (renderInfo.framebuffers.size() != (m_iterationCount + 1) || renderInfo.textures[0]->size() != backgroundRect.size() || renderInfo.textures[0]->internalFormat() != textureFormat) {
+    bool reallocated = false;
+    if (renderInfo.framebuffers.size() != (quality.iterationCount + 1) || renderInfo.textures[0]->size() != backgroundSize || renderInfo.textures[0]->internalFormat() != textureFormat) {
         renderInfo.framebuffers.clear();
         renderInfo.textures.clear();
+        renderInfo.quality.reset();
+        reallocated = true;
 
-        for (size_t i = 0; i <= m_iterationCount; ++i) {
-            auto texture = GLTexture::allocate(textureFormat, backgroundRect.size() / (1 << i));
+        for (size_t i = 0; i <= quality.iterationCount; ++i) {
+            auto texture = GLTexture::allocate(textureFormat, backgroundSize / (1 << i));
             if (!texture) {
                 qCWarning(KWIN_BLUR) << "Failed to allocate an offscreen texture";
                 return;
@@ -592,12 +625,29 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
             renderInfo.textures.push_back(std::move(texture));
             renderInfo.framebuffers.push_back(std::move(framebuffer));
         }
+        renderInfo.quality = quality;
     }
 
-    // Fetch the pixels behind the shape that is going to be blurred.
-    const QRegion dirtyRegion = region & backgroundRect;
+    // Fetch the pixels behind the shape that is going to be blurred. New render targets don't
+    // contain anything yet, so the whole background is fetched then.
+    const QRegion dirtyRegion = reallocated ? QRegion(backgroundRect) : (region & backgroundRect);
     for (const QRect &dirtyRect : dirtyRegion) {
-        renderInfo.framebuffers[0]->blitFromRenderTarget(renderTarget, viewport, dirtyRect, dirtyRect.translated(-backgroundRect.topLeft()));
+        if (!resolutionShift) {
+            renderInfo.framebuffers[0]->blitFromRenderTarget(renderTarget, viewport, dirtyRect, dirtyRect.translated(-backgroundRect.topLeft()));
+            continue;
+        }
+        // scale the rect down rounding outwards, so no pixel of the cached background goes stale
+        const QRect localRect = dirtyRect.translated(-backgroundRect.topLeft());
+        const int factor = 1 << resolutionShift;
+        const QRect destination = QRect(QPoint(localRect.x() / factor, localRect.y() / factor),
+                                        QPoint((localRect.x() + localRect.width() + factor - 1) / factor - 1,
+                                               (localRect.y() + localRect.height() + factor - 1) / factor - 1))
+                                      .intersected(QRect(QPoint(0, 0), backgroundSize));
+        if (destination.isEmpty()) {
+            continue;
+        }
+        const QRect source(destination.topLeft() * factor + backgroundRect.topLeft(), destination.size() * factor);
+        renderInfo.framebuffers[0]->blitFromRenderTarget(renderTarget, viewport, source, destination);
     }
 
     // Upload the geometry: the first 6 vertices are used when downsampling and upsampling offscreen,
@@ -874,6 +924,27 @@ bool BlurEffect::blocksDirectScanout() const
     return false;
 }
 
+bool BlurEffect::leavesWindowUntransformed(EffectWindow *) const
+{
+    // only the background behind windows is blurred
+    return true;
+}
+
+QString BlurEffect::debug(const QString &) const
+{
+    // reports the adaptive quality, reconfiguring the effect starts over at full quality
+    const BlurQualityController::Statistics statistics = m_quality.statistics();
+    const QJsonObject quality{
+        {QStringLiteral("adaptive"), m_adaptiveQuality},
+        {QStringLiteral("level"), int(m_quality.level())},
+        {QStringLiteral("frames"), qint64(statistics.frames)},
+        {QStringLiteral("degradedFrames"), qint64(statistics.degradedFrames)},
+        {QStringLiteral("degradations"), qint64(statistics.degradations)},
+        {QStringLiteral("restorations"), qint64(statistics.restorations)},
+    };
+    return QString::fromUtf8(QJsonDocument(quality).toJson(QJsonDocument::Compact));
+}
+
 } // namespace KWin
 
 #include "moc_blur.cpp"
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "blurquality.h"
 #include "effect/effect.h"
 #include "opengl/glutils.h"
 #include "scene/item.h"
@@ -26,6 +27,9 @@ struct BlurRenderData
     /// contains not blurred background behind the window, it's cached.
     std::vector<std::unique_ptr<GLTexture>> textures;
     std::vector<std::unique_ptr<GLFramebuffer>> framebuffers;
+
+    /// The quality that the render targets were allocated for
+    std::optional<BlurQuality> quality;
 };
 
 struct BlurEffectData
@@ -69,6 +73,8 @@ public:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
     bool blocksDirectScanout() const override;
+    bool leavesWindowUntransformed(EffectWindow *w) const override;
+    QString debug(const QString &parameter) const override;
 
 public Q_SLOTS:
     void slotWindowAdded(KWin::EffectWindow *w);
@@ -144,6 +150,11 @@ private:
     int m_expandSize;
     int m_noiseStrength;
 
+    bool m_adaptiveQuality = true;
+    bool m_blurredInLastFrame = false;
+    bool m_qualityChanged = false;
+    BlurQualityController m_quality;
+
     struct OffsetStruct
     {
         float minOffset;
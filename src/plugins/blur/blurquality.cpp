@@ -0,0 +1,96 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "blurquality.h"
+
+namespace KWin
+{
+
+// the quality is lowered above the high and raised below the low watermark, in percent of the budget
+static const int s_highWatermark = 90;
+static const int s_lowWatermark = 60;
+
+bool BlurQualityController::update(std::chrono::nanoseconds predictedRenderTime, std::chrono::nanoseconds budget)
+{
+    m_statistics.frames++;
+    if (m_level != Full) {
+        m_statistics.degradedFrames++;
+    }
+
+    if (budget <= std::chrono::nanoseconds::zero()) {
+        return false;
+    }
+    if (m_coolDownFrames > 0) {
+        m_coolDownFrames--;
+        return false;
+    }
+
+    if (predictedRenderTime * 100 > budget * s_highWatermark) {
+        m_overBudgetFrames++;
+        m_underBudgetFrames = 0;
+    } else if (predictedRenderTime * 100 < budget * s_lowWatermark) {
+        m_underBudgetFrames++;
+        m_overBudgetFrames = 0;
+    } else {
+        m_overBudgetFrames = 0;
+        m_underBudgetFrames = 0;
+    }
+
+    if (m_overBudgetFrames >= s_degradeFrames && m_level != ReducedAll) {
+        m_level = Level(m_level + 1);
+        m_statistics.degradations++;
+    } else if (m_underBudgetFrames >= s_restoreFrames && m_level != Full) {
+        m_level = Level(m_level - 1);
+        m_statistics.restorations++;
+    } else {
+        return false;
+    }
+
+    m_overBudgetFrames = 0;
+    m_underBudgetFrames = 0;
+    m_coolDownFrames = s_coolDownFrames;
+    return true;
+}
+
+void BlurQualityController::reset()
+{
+    *this = BlurQualityController();
+}
+
+BlurQualityController::Level BlurQualityController::level() const
+{
+    return m_level;
+}
+
+BlurQualityController::Statistics BlurQualityController::statistics() const
+{
+    return m_statistics;
+}
+
+BlurQuality BlurQualityController::quality(size_t iterationCount, bool lowPriority) const
+{
+    BlurQuality quality{
+        .iterationCount = iterationCount,
+        .halfResolution = false,
+    };
+
+    // copying the background at half resolution replaces a downsample pass, so the blur
+    // looks about as strong as before. With a single pass there is nothing to replace
+    const Level halfResolutionLevel = lowPriority ? ReducedResolution : ReducedAll;
+    if (m_level >= halfResolutionLevel && quality.iterationCount > 1) {
+        quality.halfResolution = true;
+        quality.iterationCount--;
+    }
+    if (lowPriority && m_level >= ReducedIterations && quality.iterationCount > 1) {
+        quality.iterationCount--;
+    }
+    return quality;
+}
+
+} // namespace KWin
@@ -0,0 +1,100 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <chrono>
+
+namespace KWin
+{
+
+/**
+ * The BlurQuality struct describes how the background behind a window is blurred.
+ */
+struct BlurQuality
+{
+    bool operator==(const BlurQuality &other) const = default;
+
+    /// The number of times the background is downsampled
+    size_t iterationCount = 1;
+    /// Whether the background is copied at half its resolution, which takes the place of
+    /// the first downsample pass
+    bool halfResolution = false;
+};
+
+/**
+ * The BlurQualityController class lowers the quality of the blur when frames are predicted to
+ * miss their deadline, and restores it once there is enough headroom again.
+ *
+ * The windows that the user is less likely to look at, i.e. all but the active window, are
+ * degraded first. The quality is only lowered after several frames in a row were close to the
+ * budget and only raised after a longer run of frames that were well within it. After every
+ * change, the predictions are ignored for a while, so the render time prediction has the time
+ * to reflect the change and the quality doesn't oscillate between two levels.
+ */
+class BlurQualityController
+{
+public:
+    enum Level {
+        /// Every window is blurred at full quality
+        Full,
+        /// Inactive windows are blurred at half resolution
+        ReducedResolution,
+        /// Inactive windows are additionally downsampled once less
+        ReducedIterations,
+        /// The active window is blurred at half resolution as well
+        ReducedAll,
+    };
+
+    struct Statistics
+    {
+        quint64 frames = 0;
+        quint64 degradedFrames = 0;
+        quint64 degradations = 0;
+        quint64 restorations = 0;
+    };
+
+    /// The number of frames in a row that have to be close to the budget to lower the quality
+    static constexpr int s_degradeFrames = 3;
+    /// The number of frames in a row that have to be well within the budget to raise the quality
+    static constexpr int s_restoreFrames = 60;
+    /// The number of frames after a change during which the quality isn't changed again
+    static constexpr int s_coolDownFrames = 30;
+
+    /**
+     * Feeds the predicted render time of the next frame and the time available to render it.
+     * Returns @c true if the level changed.
+     */
+    bool update(std::chrono::nanoseconds predictedRenderTime, std::chrono::nanoseconds budget);
+
+    /**
+     * Goes back to full quality and forgets the statistics.
+     */
+    void reset();
+
+    Level level() const;
+    Statistics statistics() const;
+
+    /**
+     * Returns how to blur a window at the current level, given the configured
+     * @a iterationCount. The active window is not a @a lowPriority one.
+     */
+    BlurQuality quality(size_t iterationCount, bool lowPriority) const;
+
+private:
+    Level m_level = Full;
+    int m_overBudgetFrames = 0;
+    int m_underBudgetFrames = 0;
+    int m_coolDownFrames = 0;
+    Statistics m_statistics;
+};
+
+} // namespace KWin
@@ -226,6 +226,11 @@ bool FallApartEffect::isActive() const
     return !windows.isEmpty();
 }
 
+bool FallApartEffect::leavesWindowUntransformed(EffectWindow *w) const
+{
+    return !windows.contains(w);
+}
+
 } // namespace
 
 #include "moc_fallapart.cpp"
@@ -38,6 +38,9 @@ public:
         if (api == QLatin1StringView("javascript")) {
             package->addFileDefinition("mainscript", QStringLiteral("code/main.js"));
             package->setRequired("mainscript", true);
+        } else if (api == QLatin1StringView("declarativeanimation")) {
+            package->addFileDefinition("mainscript", QStringLiteral("code/animations.json"));
+            package->setRequired("mainscript", true);
         } else if (api == QLatin1StringView("declarativescript")) {
             package->addFileDefinition("mainscript", QStringLiteral("ui/main.qml"));
             package->setRequired("mainscript", true);
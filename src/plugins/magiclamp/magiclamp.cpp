@@ -435,6 +435,11 @@ bool MagicLampEffect::isActive() const
     return !m_animations.isEmpty();
 }
 
+bool MagicLampEffect::leavesWindowUntransformed(EffectWindow *w) const
+{
+    return !m_animations.contains(w);
+}
+
 } // namespace
 
 #include "moc_magiclamp.cpp"
@@ -34,6 +34,7 @@ public:
     void prePaintWindow(EffectWindow *w, WindowPrePaintData &data, std::chrono::milliseconds presentTime) override;
     void postPaintScreen() override;
     bool isActive() const override;
+    bool leavesWindowUntransformed(EffectWindow *w) const override;
 
     int requestedEffectChainPosition() const override
     {
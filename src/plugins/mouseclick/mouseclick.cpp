@@ -41,6 +41,10 @@ MouseClickEffect::MouseClickEffect()
     KGlobalAccel::self()->setShortcut(a, QList<QKeySequence>() << (Qt::META | Qt::Key_Asterisk));
     connect(a, &QAction::triggered, this, &MouseClickEffect::toggleEnabled);
 
+    // the rings only show where the user clicked, e.g. in a screencast, and they advance by the
+    // time between frames, so they don't need to keep a high refresh rate output at full rate
+    effects->setAnimationRefreshRate(this, 60000);
+
     reconfigure(ReconfigureAll);
 
     m_buttons[0] = std::make_unique<MouseButton>(i18nc("Left mouse button", "Left"), Qt::LeftButton);
@@ -32,6 +32,8 @@
 #include "cursorsource.h"
 #include "effect/effecthandler.h"
 #include "opengl/glutils.h"
+// std
+#include <algorithm>
 
 // based on StartupId in KRunner by Lubos Lunak
 // SPDX-FileCopyrightText: 2001 Lubos Lunak <l.lunak@kde.org>
@@ -242,9 +244,6 @@ void StartupFeedbackEffect::postPaintScreen()
 {
     if (m_active) {
         m_dirtyRect = m_currentGeometry; // ensure the now dirty region is cleaned on the next pass
-        if (m_type == BlinkingFeedback || m_type == BouncingFeedback) {
-            effects->addRepaint(m_dirtyRect); // we also have to trigger a repaint
-        }
     }
     effects->postPaintScreen();
 }
@@ -257,6 +256,7 @@ void StartupFeedbackEffect::slotMouseChanged(const QPointF &pos, const QPointF &
         m_currentGeometry = feedbackRect();
         m_dirtyRect |= m_currentGeometry;
         effects->addRepaint(m_dirtyRect);
+        updatePeriodicRepaint();
     }
 }
 
@@ -343,6 +343,7 @@ void StartupFeedbackEffect::start(const Startup &startup)
     prepareTextures(iconPixmap, output->scale());
     m_dirtyRect = m_currentGeometry = feedbackRect();
     effects->addRepaint(m_dirtyRect);
+    updatePeriodicRepaint();
 }
 
 void StartupFeedbackEffect::stop()
@@ -351,6 +352,7 @@ void StartupFeedbackEffect::stop()
         return;
     }
     disconnect(effects, &EffectsHandler::mouseChanged, this, &StartupFeedbackEffect::slotMouseChanged);
+    effects->removePeriodicRepaint(this);
     m_active = false;
     m_lastPresentTime = std::chrono::milliseconds::zero();
     effects->makeOpenGLContextCurrent();
@@ -465,6 +467,34 @@ QRect StartupFeedbackEffect::feedbackRect() const
     return rect;
 }
 
+QRect StartupFeedbackEffect::animatedRect() const
+{
+    QRect rect = feedbackRect();
+    if (m_type == BouncingFeedback && rect.isValid()) {
+        // the icon bounces up and down next to the cursor
+        const auto [highest, lowest] = std::minmax_element(std::begin(FRAME_TO_BOUNCE_YOFFSET), std::end(FRAME_TO_BOUNCE_YOFFSET));
+        const int yOffset = FRAME_TO_BOUNCE_YOFFSET[m_frame] * m_bounceSizesRatio;
+        rect.adjust(0, int(*highest * m_bounceSizesRatio) - yOffset, 0, int(*lowest * m_bounceSizesRatio) - yOffset);
+    }
+    return rect;
+}
+
+void StartupFeedbackEffect::updatePeriodicRepaint()
+{
+    // the animations only have a new key frame every so often, in between, nothing has to be
+    // painted, unless the cursor moves
+    switch (m_type) {
+    case BouncingFeedback:
+        effects->setPeriodicRepaint(this, animatedRect(), std::chrono::milliseconds(BOUNCE_FRAME_DURATION));
+        break;
+    case BlinkingFeedback:
+        effects->setPeriodicRepaint(this, animatedRect(), std::chrono::milliseconds(BLINKING_FRAME_DURATION));
+        break;
+    default:
+        break;
+    }
+}
+
 bool StartupFeedbackEffect::isActive() const
 {
     return m_active;
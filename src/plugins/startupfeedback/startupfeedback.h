@@ -76,6 +76,8 @@ private:
     QImage scalePixmap(const QPixmap &pm, const QSize &size, qreal devicePixelRatio) const;
     void prepareTextures(const QPixmap &pix, qreal devicePixelRatio);
     QRect feedbackRect() const;
+    QRect animatedRect() const;
+    void updatePeriodicRepaint();
     QSize feedbackIconSize() const;
 
     qreal m_bounceSizesRatio;
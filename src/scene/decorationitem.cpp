@@ -126,9 +126,6 @@ QList<QRectF> DecorationItem::shape() const
 
 QRegion DecorationItem::opaque() const
 {
-    if (m_window->decorationHasAlpha()) {
-        return QRegion();
-    }
     QRectF left, top, right, bottom;
     m_window->layoutDecorationRects(left, top, right, bottom);
 
@@ -141,7 +138,22 @@ QRegion DecorationItem::opaque() const
     QRegion roundedRight = right.toAlignedRect().marginsRemoved(roundingPad);
     QRegion roundedBottom = bottom.toAlignedRect().marginsRemoved(roundingPad);
 
-    return roundedLeft | roundedTop | roundedRight | roundedBottom;
+    const QRegion borders = roundedLeft | roundedTop | roundedRight | roundedBottom;
+    if (!m_window->decorationHasAlpha()) {
+        return borders;
+    }
+
+    // KDecoration only knows fully opaque decorations. A decoration that is translucent only in
+    // some parts, e.g. in its rounded corners, can report the opaque parts in the dynamic
+    // "opaqueRegion" property, a QRegion in decoration coordinates
+    if (!m_decoration) {
+        return QRegion();
+    }
+    const QVariant reported = m_decoration->property("opaqueRegion");
+    if (!reported.canConvert<QRegion>()) {
+        return QRegion();
+    }
+    return borders & reported.value<QRegion>();
 }
 
 void DecorationItem::preprocess()
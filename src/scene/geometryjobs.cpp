@@ -0,0 +1,74 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/geometryjobs.h"
+#include "scene/item.h"
+
+#include <QElapsedTimer>
+#include <QtConcurrentMap>
+
+namespace KWin
+{
+
+GeometryJobs::GeometryJobs(int maxThreads)
+    : m_parallel(maxThreads > 1 && qEnvironmentVariableIntValue("KWIN_X11_NO_PARALLEL_PREPARE") == 0)
+{
+    m_threadPool.setMaxThreadCount(std::max(maxThreads, 1));
+    // the workers are needed again in the next frame
+    m_threadPool.setExpiryTimeout(-1);
+}
+
+GeometryJobs::~GeometryJobs()
+{
+    m_threadPool.waitForDone();
+}
+
+bool GeometryJobs::isParallel() const
+{
+    return m_parallel;
+}
+
+void GeometryJobs::setParallel(bool parallel)
+{
+    m_parallel = parallel;
+}
+
+void GeometryJobs::run(const QList<Batch> &batches, qreal deviceScale)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto runBatch = [deviceScale](const Batch &batch) {
+        for (const Job &job : batch) {
+            job.item->renderGeometry(deviceScale, job.textureMatrix);
+        }
+    };
+
+    m_statistics.runs++;
+    if (m_parallel && batches.size() >= s_minimumParallelBatches) {
+        m_statistics.parallelRuns++;
+        QtConcurrent::blockingMap(&m_threadPool, batches.cbegin(), batches.cend(), runBatch);
+    } else {
+        for (const Batch &batch : batches) {
+            runBatch(batch);
+        }
+    }
+
+    for (const Batch &batch : batches) {
+        m_statistics.jobs += batch.size();
+    }
+    m_statistics.lastDuration = timer.durationElapsed();
+}
+
+GeometryJobs::Statistics GeometryJobs::statistics() const
+{
+    return m_statistics;
+}
+
+} // namespace KWin
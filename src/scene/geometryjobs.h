@@ -0,0 +1,89 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QList>
+#include <QMatrix4x4>
+#include <QThread>
+#include <QThreadPool>
+
+#include <chrono>
+
+namespace KWin
+{
+
+class Item;
+
+/**
+ * The GeometryJobs class builds the vertices of many items on worker threads, before they are
+ * painted.
+ *
+ * The jobs are grouped in batches, usually one per window, and all jobs of a batch run on the
+ * same thread one after the other, so the items of a window, which share the window state, are
+ * never touched by two threads. The caller is blocked until all batches are done, so nothing
+ * changes the items in the mean time. The results end up in the render geometry cache of the
+ * items, the renderer picks them up when it paints the items on the main thread.
+ *
+ * Only the vertices are built here. The quads of the items have to be built beforehand on the
+ * main thread, building them may query the X server or the window decoration. Likewise,
+ * textures have to be updated beforehand, on the thread with the OpenGL context.
+ */
+class KWIN_EXPORT GeometryJobs
+{
+public:
+    struct Job
+    {
+        Item *item;
+        QMatrix4x4 textureMatrix;
+    };
+    using Batch = QList<Job>;
+
+    struct Statistics
+    {
+        /// The number of times batches were built
+        quint64 runs = 0;
+        /// The number of times the batches were spread over several threads
+        quint64 parallelRuns = 0;
+        /// The number of jobs that were run
+        quint64 jobs = 0;
+        /// How long the last run took
+        std::chrono::nanoseconds lastDuration{0};
+    };
+
+    /// With fewer batches, starting the worker threads costs more than it saves
+    static constexpr qsizetype s_minimumParallelBatches = 8;
+
+    explicit GeometryJobs(int maxThreads = QThread::idealThreadCount());
+    ~GeometryJobs();
+
+    /**
+     * Whether batches are spread over worker threads. It's disabled if there is only one CPU
+     * or the KWIN_X11_NO_PARALLEL_PREPARE environment variable is set.
+     */
+    bool isParallel() const;
+    void setParallel(bool parallel);
+
+    /**
+     * Builds the render geometry of the items in @p batches for @p deviceScale, returns once
+     * all of them are done. The quads of the items must have been built already.
+     */
+    void run(const QList<Batch> &batches, qreal deviceScale);
+
+    Statistics statistics() const;
+
+private:
+    QThreadPool m_threadPool;
+    bool m_parallel;
+    Statistics m_statistics;
+};
+
+} // namespace KWin
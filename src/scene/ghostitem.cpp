@@ -0,0 +1,83 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/ghostitem.h"
+#include "compositor.h"
+#include "opengl/gltexture.h"
+#include "scene/workspacescene.h"
+
+namespace KWin
+{
+
+static int s_liveCount = 0;
+static quint64 s_createdCount = 0;
+
+GhostItem::GhostItem(std::shared_ptr<GLTexture> texture, Item *parent)
+    : Item(parent)
+    , m_texture(std::move(texture))
+{
+    s_liveCount++;
+    s_createdCount++;
+}
+
+GhostItem::~GhostItem()
+{
+    s_liveCount--;
+    if (WorkspaceScene *scene = Compositor::self()->scene()) {
+        scene->makeOpenGLContextCurrent();
+    }
+    m_texture.reset();
+}
+
+GLTexture *GhostItem::texture() const
+{
+    return m_texture.get();
+}
+
+bool GhostItem::canFreeze(const Candidate &candidate)
+{
+    if (!candidate.closed || !candidate.hasContents) {
+        return false;
+    }
+    return !candidate.liveContentsRefs && !candidate.forcedVisible && !candidate.offscreenRendering && !candidate.grabbed;
+}
+
+int GhostItem::liveCount()
+{
+    return s_liveCount;
+}
+
+quint64 GhostItem::createdCount()
+{
+    return s_createdCount;
+}
+
+WindowQuadList GhostItem::buildQuads() const
+{
+    const QRectF geometry = rect();
+    if (geometry.isEmpty()) {
+        return WindowQuadList{};
+    }
+
+    const QRectF textureRect(QPointF(0, 0), m_texture->size());
+
+    WindowQuad quad;
+    quad[0] = WindowVertex(geometry.topLeft(), textureRect.topLeft());
+    quad[1] = WindowVertex(geometry.topRight(), textureRect.topRight());
+    quad[2] = WindowVertex(geometry.bottomRight(), textureRect.bottomRight());
+    quad[3] = WindowVertex(geometry.bottomLeft(), textureRect.bottomLeft());
+
+    WindowQuadList ret;
+    ret.append(quad);
+    return ret;
+}
+
+} // namespace KWin
+
+#include "moc_ghostitem.cpp"
@@ -0,0 +1,79 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "scene/item.h"
+
+namespace KWin
+{
+
+class GLTexture;
+
+/**
+ * The GhostItem class represents the contents of a closed window frozen into a single texture.
+ *
+ * Once a closed window doesn't need live contents anymore, its surface, decoration and shadow
+ * are rendered into a texture and replaced by a ghost item, so the closing animation only
+ * paints a single quad and the window pixmap can be released right away.
+ */
+class KWIN_EXPORT GhostItem : public Item
+{
+    Q_OBJECT
+
+public:
+    explicit GhostItem(std::shared_ptr<GLTexture> texture, Item *parent = nullptr);
+    ~GhostItem() override;
+
+    GLTexture *texture() const;
+
+    /**
+     * Describes a closed window and what might still need its surface, decoration and shadow.
+     */
+    struct Candidate
+    {
+        /// Whether the window has been closed
+        bool closed = false;
+        /// Whether the window still has contents that can be frozen
+        bool hasContents = false;
+        /// The number of WindowItem::refLiveContents() calls
+        int liveContentsRefs = 0;
+        /// Whether an effect forces the window to be shown, e.g. in an overview
+        bool forcedVisible = false;
+        /// Whether the window is rendered offscreen, e.g. for a thumbnail
+        bool offscreenRendering = false;
+        /// Whether an effect grabbed the window to paint it in its own way
+        bool grabbed = false;
+    };
+
+    /**
+     * Returns @c true if the contents of @a candidate can be frozen into a ghost item. A closed
+     * window is only frozen if nothing that could read its individual items holds it, effects
+     * that merely transform the whole window, such as the generic close animations, don't
+     * prevent that.
+     */
+    static bool canFreeze(const Candidate &candidate);
+
+    /**
+     * Returns the number of ghost items that currently exist.
+     */
+    static int liveCount();
+    /**
+     * Returns the number of ghost items that have been created so far.
+     */
+    static quint64 createdCount();
+
+protected:
+    WindowQuadList buildQuads() const override;
+
+private:
+    std::shared_ptr<GLTexture> m_texture;
+};
+
+} // namespace KWin
@@ -10,9 +10,15 @@
 #include "scene/scene.h"
 #include "utils/common.h"
 
+#include <atomic>
+
 namespace KWin
 {
 
+// the render geometry can be built on the worker threads of GeometryJobs
+static std::atomic<quint64> s_renderGeometryHits;
+static std::atomic<quint64> s_renderGeometryMisses;
+
 ItemEffect::ItemEffect(Item *item)
     : m_item(item)
 {
@@ -484,6 +490,7 @@ WindowQuadList Item::buildQuads() const
 void Item::discardQuads()
 {
     m_quads.reset();
+    m_renderGeometry.reset();
 }
 
 WindowQuadList Item::quads() const
@@ -494,6 +501,38 @@ WindowQuadList Item::quads() const
     return m_quads.value();
 }
 
+RenderGeometry Item::renderGeometry(qreal deviceScale, const QMatrix4x4 &textureMatrix) const
+{
+    if (m_renderGeometry && m_renderGeometry->deviceScale == deviceScale && m_renderGeometry->textureMatrix == textureMatrix) {
+        s_renderGeometryHits.fetch_add(1, std::memory_order_relaxed);
+        return m_renderGeometry->geometry;
+    }
+    s_renderGeometryMisses.fetch_add(1, std::memory_order_relaxed);
+
+    const WindowQuadList quads = this->quads();
+    RenderGeometry geometry;
+    geometry.reserve(quads.count() * 6);
+    for (const WindowQuad &quad : quads) {
+        geometry.appendWindowQuad(quad, deviceScale);
+    }
+    geometry.postProcessTextureCoordinates(textureMatrix);
+
+    m_renderGeometry = CachedRenderGeometry{
+        .geometry = geometry,
+        .deviceScale = deviceScale,
+        .textureMatrix = textureMatrix,
+    };
+    return geometry;
+}
+
+Item::RenderGeometryStatistics Item::renderGeometryStatistics()
+{
+    return RenderGeometryStatistics{
+        .hits = s_renderGeometryHits.load(std::memory_order_relaxed),
+        .misses = s_renderGeometryMisses.load(std::memory_order_relaxed),
+    };
+}
+
 QRegion Item::takeRepaints(SceneDelegate *delegate)
 {
     auto &repaints = m_repaints[delegate];
@@ -12,6 +12,7 @@
 #include "scene/itemgeometry.h"
 
 #include <QList>
+#include <QMatrix4x4>
 #include <QObject>
 #include <QPointer>
 #include <QTransform>
@@ -139,6 +140,24 @@ public:
     void resetRepaints(SceneDelegate *delegate);
 
     WindowQuadList quads() const;
+
+    /**
+     * Returns the quads of this item as vertices in device coordinates, with the texture
+     * coordinates mapped by @p textureMatrix. The transforms of the item and of effects aren't
+     * applied, so the vertices are only rebuilt when the quads, the scale or the texture change,
+     * not in every frame of an animation.
+     */
+    RenderGeometry renderGeometry(qreal deviceScale, const QMatrix4x4 &textureMatrix) const;
+
+    struct RenderGeometryStatistics
+    {
+        /// The number of times the vertices were reused
+        quint64 hits = 0;
+        /// The number of times the vertices had to be rebuilt
+        quint64 misses = 0;
+    };
+    static RenderGeometryStatistics renderGeometryStatistics();
+
     virtual void preprocess();
     const ColorDescription &colorDescription() const;
     RenderingIntent renderingIntent() const;
@@ -203,6 +222,13 @@ private:
     bool m_effectiveVisible = true;
     QMap<SceneDelegate *, QRegion> m_repaints;
     mutable std::optional<WindowQuadList> m_quads;
+    struct CachedRenderGeometry
+    {
+        RenderGeometry geometry;
+        qreal deviceScale;
+        QMatrix4x4 textureMatrix;
+    };
+    mutable std::optional<CachedRenderGeometry> m_renderGeometry;
     mutable std::optional<QList<Item *>> m_sortedChildItems;
     ColorDescription m_colorDescription = ColorDescription::sRGB;
     RenderingIntent m_renderingIntent = RenderingIntent::Perceptual;
@@ -32,4 +32,8 @@ void ItemRenderer::endFrame()
 {
 }
 
+void ItemRenderer::prepareItems(const RenderViewport &viewport, const QList<Item *> &items)
+{
+}
+
 } // namespace KWin
@@ -8,6 +8,7 @@
 
 #include <kwin_export.h>
 
+#include <QList>
 #include <QMatrix4x4>
 #include <memory>
 
@@ -34,6 +35,13 @@ public:
     virtual void beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport);
     virtual void endFrame();
 
+    /**
+     * Prepares the given @p items and their children for being painted transformed in this
+     * frame, e.g. builds their vertices ahead of time. Called between beginFrame() and the
+     * renderItem() calls.
+     */
+    virtual void prepareItems(const RenderViewport &viewport, const QList<Item *> &items);
+
     virtual void renderBackground(const RenderTarget &renderTarget, const RenderViewport &viewport, const QRegion &region) = 0;
     virtual void renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const QRegion &region, const WindowPaintData &data) = 0;
 
@@ -14,6 +14,7 @@
 #include "opengl/eglnativefence.h"
 #include "platformsupport/scenes/opengl/openglsurfacetexture.h"
 #include "scene/decorationitem.h"
+#include "scene/ghostitem.h"
 #include "scene/imageitem.h"
 #include "scene/outlinedborderitem.h"
 #include "scene/shadowitem.h"
@@ -62,6 +63,7 @@ void ItemRendererOpenGL::endFrame()
         }
     }
     m_releasePoints.clear();
+    m_preparedItems.clear();
 }
 
 QVector4D ItemRendererOpenGL::modulate(float opacity, float brightness) const
@@ -96,32 +98,98 @@ static RenderGeometry clipQuads(const Item *item, const ItemRendererOpenGL::Rend
 
     // split all quads in bounding rect with the actual rects in the region
     for (const WindowQuad &quad : std::as_const(quads)) {
-        if (context->clip != infiniteRegion() && !context->hardwareClipping) {
-            // Scale to device coordinates, rounding as needed.
-            QRectF deviceBounds = snapToPixelGridF(scaledRect(quad.bounds(), scale));
-
-            for (const QRect &clipRect : std::as_const(context->clip)) {
-                QRectF deviceClipRect = snapToPixelGridF(scaledRect(clipRect, scale)).translated(-worldTranslation);
-
-                const QRectF &intersected = deviceClipRect.intersected(deviceBounds);
-                if (intersected.isValid()) {
-                    if (deviceBounds == intersected) {
-                        // case 1: completely contains, include and do not check other rects
-                        geometry.appendWindowQuad(quad, scale);
-                        break;
-                    }
-                    // case 2: intersection
-                    geometry.appendSubQuad(quad, intersected, scale);
+        // Scale to device coordinates, rounding as needed.
+        QRectF deviceBounds = snapToPixelGridF(scaledRect(quad.bounds(), scale));
+
+        for (const QRect &clipRect : std::as_const(context->clip)) {
+            QRectF deviceClipRect = snapToPixelGridF(scaledRect(clipRect, scale)).translated(-worldTranslation);
+
+            const QRectF &intersected = deviceClipRect.intersected(deviceBounds);
+            if (intersected.isValid()) {
+                if (deviceBounds == intersected) {
+                    // case 1: completely contains, include and do not check other rects
+                    geometry.appendWindowQuad(quad, scale);
+                    break;
                 }
+                // case 2: intersection
+                geometry.appendSubQuad(quad, intersected, scale);
             }
-        } else {
-            geometry.appendWindowQuad(quad, scale);
         }
     }
 
     return geometry;
 }
 
+static std::optional<QMatrix4x4> textureMatrix(Item *item)
+{
+    if (auto shadowItem = qobject_cast<ShadowItem *>(item)) {
+        OpenGLShadowTextureProvider *textureProvider = static_cast<OpenGLShadowTextureProvider *>(shadowItem->textureProvider());
+        if (textureProvider->shadowTexture()) {
+            return textureProvider->shadowTexture()->matrix(UnnormalizedCoordinates);
+        }
+    } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
+        auto renderer = static_cast<const SceneOpenGLDecorationRenderer *>(decorationItem->renderer());
+        if (renderer->texture()) {
+            return renderer->texture()->matrix(UnnormalizedCoordinates);
+        }
+    } else if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
+        if (SurfacePixmap *pixmap = surfaceItem->pixmap()) {
+            OpenGLSurfaceTexture *surfaceTexture = static_cast<OpenGLSurfaceTexture *>(pixmap->texture());
+            if (surfaceTexture->isValid()) {
+                return surfaceTexture->texture().planes.at(0)->matrix(UnnormalizedCoordinates);
+            }
+        }
+    } else if (auto imageItem = qobject_cast<ImageItemOpenGL *>(item)) {
+        if (imageItem->texture()) {
+            return imageItem->texture()->matrix(UnnormalizedCoordinates);
+        }
+    } else if (auto ghostItem = qobject_cast<GhostItem *>(item)) {
+        if (ghostItem->texture()) {
+            return ghostItem->texture()->matrix(UnnormalizedCoordinates);
+        }
+    } else if (qobject_cast<OutlinedBorderItem *>(item)) {
+        return QMatrix4x4();
+    }
+    return std::nullopt;
+}
+
+static void collectGeometryJobs(Item *item, GeometryJobs::Batch *batch, std::unordered_set<Item *> *preparedItems)
+{
+    // textures are uploaded here, on the thread with the OpenGL context
+    item->preprocess();
+    preparedItems->insert(item);
+    if (const auto matrix = textureMatrix(item)) {
+        // building the quads may talk to the X server or the decoration, e.g. to fetch the shape
+        // of a window, so it's done here, and the workers only turn the quads into vertices
+        item->quads();
+        batch->append(GeometryJobs::Job{
+            .item = item,
+            .textureMatrix = *matrix,
+        });
+    }
+
+    const QList<Item *> childItems = item->childItems();
+    for (Item *childItem : childItems) {
+        if (childItem->explicitVisible()) {
+            collectGeometryJobs(childItem, batch, preparedItems);
+        }
+    }
+}
+
+void ItemRendererOpenGL::prepareItems(const RenderViewport &viewport, const QList<Item *> &items)
+{
+    QList<GeometryJobs::Batch> batches;
+    batches.reserve(items.size());
+    for (Item *item : items) {
+        GeometryJobs::Batch batch;
+        collectGeometryJobs(item, &batch, &m_preparedItems);
+        if (!batch.isEmpty()) {
+            batches.append(batch);
+        }
+    }
+    m_geometryJobs.run(batches, viewport.scale());
+}
+
 void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
 {
     const QList<Item *> sortedChildItems = item->sortedChildItems();
@@ -167,18 +235,35 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
         });
     }
 
-    item->preprocess();
+    // preprocessing an item again in the same frame would e.g. make an X11 surface wait for the
+    // replies to the requests it has just sent
+    if (!m_preparedItems.contains(item)) {
+        item->preprocess();
+    }
 
-    RenderGeometry geometry = clipQuads(item, context);
+    // Unless the quads are clipped on the CPU, the vertices don't depend on where the item is
+    // painted, the transforms of the item and of effects are applied in the vertex shader. That
+    // way, the vertices of a window that is only moved or scaled by an animation are reused.
+    const bool softwareClipping = context->clip != infiniteRegion() && !context->hardwareClipping;
+    const RenderGeometry clippedGeometry = softwareClipping ? clipQuads(item, context) : RenderGeometry();
+    const bool hasGeometry = softwareClipping ? !clippedGeometry.isEmpty() : !item->quads().isEmpty();
+    const auto geometry = [&](const QMatrix4x4 &textureMatrix) {
+        if (!softwareClipping) {
+            return item->renderGeometry(scale, textureMatrix);
+        }
+        RenderGeometry clipped = clippedGeometry;
+        clipped.postProcessTextureCoordinates(textureMatrix);
+        return clipped;
+    };
 
     if (auto shadowItem = qobject_cast<ShadowItem *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             OpenGLShadowTextureProvider *textureProvider = static_cast<OpenGLShadowTextureProvider *>(shadowItem->textureProvider());
             if (textureProvider->shadowTexture()) {
-                RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
+                context->renderNodes.append(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = {textureProvider->shadowTexture()},
-                    .geometry = geometry,
+                    .geometry = geometry(textureProvider->shadowTexture()->matrix(UnnormalizedCoordinates)),
                     .transformMatrix = context->transformStack.top(),
                     .opacity = context->opacityStack.top(),
                     .hasAlpha = true,
@@ -189,17 +274,16 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
                     .borderRadius = {},
                     .borderColor = {},
                 });
-                renderNode.geometry.postProcessTextureCoordinates(textureProvider->shadowTexture()->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             auto renderer = static_cast<const SceneOpenGLDecorationRenderer *>(decorationItem->renderer());
             if (renderer->texture()) {
-                RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
+                context->renderNodes.append(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = {renderer->texture()},
-                    .geometry = geometry,
+                    .geometry = geometry(renderer->texture()->matrix(UnnormalizedCoordinates)),
                     .transformMatrix = context->transformStack.top(),
                     .opacity = context->opacityStack.top(),
                     .hasAlpha = true,
@@ -210,19 +294,18 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
                     .borderRadius = {},
                     .borderColor = {},
                 });
-                renderNode.geometry.postProcessTextureCoordinates(renderer->texture()->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
         SurfacePixmap *pixmap = surfaceItem->pixmap();
         if (pixmap) {
-            if (!geometry.isEmpty()) {
+            if (hasGeometry) {
                 OpenGLSurfaceTexture *surfaceTexture = static_cast<OpenGLSurfaceTexture *>(pixmap->texture());
                 if (surfaceTexture->isValid()) {
                     RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
                         .traits = ShaderTrait::MapTexture,
                         .textures = surfaceTexture->texture().toVarLengthArray(),
-                        .geometry = geometry,
+                        .geometry = geometry(surfaceTexture->texture().planes.at(0)->matrix(UnnormalizedCoordinates)),
                         .transformMatrix = context->transformStack.top(),
                         .opacity = context->opacityStack.top(),
                         .hasAlpha = pixmap->hasAlphaChannel(),
@@ -233,7 +316,6 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
                         .borderRadius = {},
                         .borderColor = {},
                     });
-                    renderNode.geometry.postProcessTextureCoordinates(surfaceTexture->texture().planes.at(0)->matrix(UnnormalizedCoordinates));
 
                     if (!context->cornerStack.isEmpty()) {
                         const auto &top = context->cornerStack.top();
@@ -250,12 +332,12 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
             }
         }
     } else if (auto imageItem = qobject_cast<ImageItemOpenGL *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             if (imageItem->texture()) {
-                RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
+                context->renderNodes.append(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = {imageItem->texture()},
-                    .geometry = geometry,
+                    .geometry = geometry(imageItem->texture()->matrix(UnnormalizedCoordinates)),
                     .transformMatrix = context->transformStack.top(),
                     .opacity = context->opacityStack.top(),
                     .hasAlpha = imageItem->image().hasAlphaChannel(),
@@ -266,11 +348,27 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
                     .borderRadius = {},
                     .borderColor = {},
                 });
-                renderNode.geometry.postProcessTextureCoordinates(imageItem->texture()->matrix(UnnormalizedCoordinates));
             }
         }
+    } else if (auto ghostItem = qobject_cast<GhostItem *>(item)) {
+        if (hasGeometry) {
+            context->renderNodes.append(RenderNode{
+                .traits = ShaderTrait::MapTexture,
+                .textures = {ghostItem->texture()},
+                .geometry = geometry(ghostItem->texture()->matrix(UnnormalizedCoordinates)),
+                .transformMatrix = context->transformStack.top(),
+                .opacity = context->opacityStack.top(),
+                .hasAlpha = true,
+                .colorDescription = item->colorDescription(),
+                .renderingIntent = item->renderingIntent(),
+                .bufferReleasePoint = nullptr,
+                .box = {},
+                .borderRadius = {},
+                .borderColor = {},
+            });
+        }
     } else if (auto borderItem = qobject_cast<OutlinedBorderItem *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             const BorderOutline outline = borderItem->outline();
             const int thickness = std::round(outline.thickness() * context->renderTargetScale);
             const QRectF outerRect = snapToPixelGridF(scaledRect(borderItem->rect(), context->renderTargetScale));
@@ -278,7 +376,7 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
             context->renderNodes.append(RenderNode{
                 .traits = ShaderTrait::Border,
                 .textures = {},
-                .geometry = geometry,
+                .geometry = geometry(QMatrix4x4()),
                 .transformMatrix = context->transformStack.top(),
                 .opacity = context->opacityStack.top(),
                 .hasAlpha = true,
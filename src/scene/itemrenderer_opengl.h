@@ -8,6 +8,7 @@
 
 #include "opengl/glutils.h"
 #include "platformsupport/scenes/opengl/openglsurfacetexture.h"
+#include "scene/geometryjobs.h"
 #include "scene/itemrenderer.h"
 
 #include <unordered_set>
@@ -62,6 +63,7 @@ public:
 
     void beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport) override;
     void endFrame() override;
+    void prepareItems(const RenderViewport &viewport, const QList<Item *> &items) override;
 
     void renderBackground(const RenderTarget &renderTarget, const RenderViewport &viewport, const QRegion &region) override;
     void renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const QRegion &region, const WindowPaintData &data) override;
@@ -77,6 +79,9 @@ private:
     bool m_blendingEnabled = false;
     EglDisplay *const m_eglDisplay;
     std::unordered_set<std::shared_ptr<SyncReleasePoint>> m_releasePoints;
+    GeometryJobs m_geometryJobs;
+    /// The items that prepareItems() preprocessed in the current frame
+    std::unordered_set<Item *> m_preparedItems;
 
     struct
     {
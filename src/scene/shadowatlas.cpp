@@ -0,0 +1,257 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "scene/shadowatlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace KWin
+{
+
+// every tile is surrounded by a gutter of this many pixels on each side
+static const int s_gutter = 1;
+
+ShadowAtlas::ShadowAtlas(const QSize &initialSize, int maximumSize)
+    : m_initialSize(initialSize.boundedTo(QSize(maximumSize, maximumSize)))
+    , m_maximumSize(maximumSize)
+{
+}
+
+ShadowAtlas::~ShadowAtlas()
+{
+}
+
+QSize ShadowAtlas::size() const
+{
+    return m_size;
+}
+
+ShadowAtlas::Statistics ShadowAtlas::statistics() const
+{
+    Statistics statistics{
+        .textureAllocations = m_textureAllocations,
+        .tileUploads = m_tileUploads,
+        .tiles = m_entries.size(),
+        .references = 0,
+        .size = m_size,
+    };
+    for (const Entry &entry : m_entries) {
+        statistics.references += entry.references;
+    }
+    return statistics;
+}
+
+static size_t hashImage(const QImage &image)
+{
+    return qHashBits(image.constBits(), image.sizeInBytes(), qHashMulti(0, image.width(), image.height()));
+}
+
+ShadowAtlas::Tile ShadowAtlas::acquire(const QImage &image)
+{
+    if (image.isNull()) {
+        return Tile{};
+    }
+
+    const QImage tile = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const size_t hash = hashImage(tile);
+    const auto [first, last] = m_entriesByHash.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        Entry &entry = m_entries[*it];
+        if (entry.image == tile) {
+            entry.references++;
+            return Tile{
+                .id = *it,
+                .rect = entry.slot.marginsRemoved(QMargins(s_gutter, s_gutter, s_gutter, s_gutter)),
+            };
+        }
+    }
+
+    const QSize slotSize = tile.size().grownBy(QMargins(s_gutter, s_gutter, s_gutter, s_gutter));
+    if (slotSize.width() > m_maximumSize || slotSize.height() > m_maximumSize) {
+        return Tile{};
+    }
+
+    if (m_size.isEmpty()) {
+        QSize size = m_initialSize;
+        while (size.width() < slotSize.width() || size.height() < slotSize.height()) {
+            size = (size * 2).boundedTo(QSize(m_maximumSize, m_maximumSize));
+        }
+        if (!allocate(size)) {
+            return Tile{};
+        }
+        m_size = size;
+        m_textureAllocations++;
+    }
+
+    const std::optional<QPoint> position = findSlot(slotSize);
+    if (!position) {
+        if (m_entries.isEmpty()) {
+            clear();
+        }
+        return Tile{};
+    }
+
+    const int id = ++m_lastId;
+    const Entry &entry = m_entries.insert(id, Entry{
+                                                  .image = tile,
+                                                  .slot = QRect(*position, slotSize),
+                                                  .hash = hash,
+                                                  .references = 1,
+                                              })
+                             .value();
+    m_entriesByHash.insert(hash, id);
+    uploadEntry(entry);
+
+    return Tile{
+        .id = id,
+        .rect = entry.slot.marginsRemoved(QMargins(s_gutter, s_gutter, s_gutter, s_gutter)),
+    };
+}
+
+void ShadowAtlas::release(int id)
+{
+    const auto it = m_entries.find(id);
+    if (it == m_entries.end()) {
+        return;
+    }
+    if (--it->references > 0) {
+        return;
+    }
+
+    m_entriesByHash.remove(it->hash, id);
+    m_freeSlots.append(it->slot);
+    m_entries.erase(it);
+
+    if (m_entries.isEmpty()) {
+        clear();
+    }
+}
+
+std::optional<QPoint> ShadowAtlas::findSlot(const QSize &size)
+{
+    while (true) {
+        if (const auto position = takeFreeSlot(size)) {
+            return position;
+        }
+        if (const auto position = placeOnShelf(size)) {
+            return position;
+        }
+        if (!grow()) {
+            return std::nullopt;
+        }
+    }
+}
+
+std::optional<QPoint> ShadowAtlas::takeFreeSlot(const QSize &size)
+{
+    // the smallest slot that is big enough, the remainder is split into the part to the
+    // right and the part below the tile
+    auto best = m_freeSlots.end();
+    for (auto it = m_freeSlots.begin(); it != m_freeSlots.end(); ++it) {
+        if (it->width() < size.width() || it->height() < size.height()) {
+            continue;
+        }
+        if (best == m_freeSlots.end() || it->width() * it->height() < best->width() * best->height()) {
+            best = it;
+        }
+    }
+    if (best == m_freeSlots.end()) {
+        return std::nullopt;
+    }
+
+    const QRect slot = *best;
+    m_freeSlots.erase(best);
+
+    const QRect right(slot.x() + size.width(), slot.y(), slot.width() - size.width(), size.height());
+    const QRect below(slot.x(), slot.y() + size.height(), slot.width(), slot.height() - size.height());
+    if (!right.isEmpty()) {
+        m_freeSlots.append(right);
+    }
+    if (!below.isEmpty()) {
+        m_freeSlots.append(below);
+    }
+    return slot.topLeft();
+}
+
+std::optional<QPoint> ShadowAtlas::placeOnShelf(const QSize &size)
+{
+    // the lowest shelf the tile fits on, so that short tiles don't waste tall shelves
+    Shelf *best = nullptr;
+    for (Shelf &shelf : m_shelves) {
+        if (shelf.height < size.height() || shelf.used + size.width() > m_size.width()) {
+            continue;
+        }
+        if (!best || shelf.height < best->height) {
+            best = &shelf;
+        }
+    }
+
+    if (!best) {
+        const int y = m_shelves.isEmpty() ? 0 : m_shelves.last().y + m_shelves.last().height;
+        if (y + size.height() > m_size.height() || size.width() > m_size.width()) {
+            return std::nullopt;
+        }
+        best = &m_shelves.emplace_back(Shelf{
+            .y = y,
+            .height = size.height(),
+            .used = 0,
+        });
+    }
+
+    const QPoint position(best->used, best->y);
+    best->used += size.width();
+    return position;
+}
+
+bool ShadowAtlas::grow()
+{
+    const QSize size = (m_size * 2).boundedTo(QSize(m_maximumSize, m_maximumSize));
+    if (size == m_size || !allocate(size)) {
+        return false;
+    }
+    m_size = size;
+    m_textureAllocations++;
+
+    // the tiles keep their position, only the contents of the new texture need to be restored
+    for (const Entry &entry : std::as_const(m_entries)) {
+        uploadEntry(entry);
+    }
+    return true;
+}
+
+void ShadowAtlas::uploadEntry(const Entry &entry)
+{
+    const QImage &tile = entry.image;
+    QImage image(entry.slot.size(), QImage::Format_ARGB32_Premultiplied);
+
+    for (int y = 0; y < image.height(); ++y) {
+        const int sourceY = std::clamp(y - s_gutter, 0, tile.height() - 1);
+        const uint32_t *source = reinterpret_cast<const uint32_t *>(tile.constScanLine(sourceY));
+        uint32_t *destination = reinterpret_cast<uint32_t *>(image.scanLine(y));
+
+        std::fill_n(destination, s_gutter, source[0]);
+        std::memcpy(destination + s_gutter, source, tile.width() * sizeof(uint32_t));
+        std::fill_n(destination + s_gutter + tile.width(), s_gutter, source[tile.width() - 1]);
+    }
+
+    upload(image, entry.slot.topLeft());
+    m_tileUploads++;
+}
+
+void ShadowAtlas::clear()
+{
+    m_shelves.clear();
+    m_freeSlots.clear();
+    if (m_size.isValid()) {
+        deallocate();
+        m_size = QSize();
+    }
+}
+
+} // namespace KWin
@@ -0,0 +1,128 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QRect>
+
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The ShadowAtlas class packs the corner and edge tiles of the nine-patch shadows of all
+ * windows into one texture.
+ *
+ * Tiles are shared by content, so windows with the same shadow only add references to the
+ * tiles that are already in the atlas. Every tile is surrounded by a one pixel gutter that
+ * repeats its outermost pixels, so that linear filtering doesn't pick up the neighbouring tiles.
+ *
+ * The atlas grows by doubling its size, tiles keep their position when it grows, so texture
+ * coordinates in pixels stay valid. Once the last tile is released, the texture is dropped.
+ *
+ * The texture itself is managed by a subclass, which gets asked to allocate the storage and
+ * to upload the tiles.
+ */
+class KWIN_EXPORT ShadowAtlas
+{
+public:
+    struct Tile
+    {
+        bool isValid() const
+        {
+            return id != 0;
+        }
+
+        int id = 0;
+        QRect rect;
+    };
+
+    struct Statistics
+    {
+        quint64 textureAllocations = 0;
+        quint64 tileUploads = 0;
+        qsizetype tiles = 0;
+        qsizetype references = 0;
+        QSize size;
+    };
+
+    explicit ShadowAtlas(const QSize &initialSize = QSize(256, 256), int maximumSize = 8192);
+    virtual ~ShadowAtlas();
+
+    /**
+     * Adds a reference to a tile with the contents of @a image and returns where it is in the
+     * atlas. Returns an invalid tile if @a image is empty or doesn't fit into the atlas.
+     */
+    Tile acquire(const QImage &image);
+
+    /**
+     * Drops a reference to the tile with the given @a id.
+     */
+    void release(int id);
+
+    QSize size() const;
+    Statistics statistics() const;
+
+protected:
+    /**
+     * Allocates the texture storage with the given @a size, replacing the previous texture.
+     * Returns @c false if that failed.
+     */
+    virtual bool allocate(const QSize &size) = 0;
+    /**
+     * Uploads @a image to the texture at @a position.
+     */
+    virtual void upload(const QImage &image, const QPoint &position) = 0;
+    /**
+     * Drops the texture storage.
+     */
+    virtual void deallocate() = 0;
+
+private:
+    struct Entry
+    {
+        QImage image;
+        QRect slot;
+        size_t hash = 0;
+        int references = 0;
+    };
+
+    struct Shelf
+    {
+        int y = 0;
+        int height = 0;
+        int used = 0;
+    };
+
+    std::optional<QPoint> findSlot(const QSize &size);
+    std::optional<QPoint> takeFreeSlot(const QSize &size);
+    std::optional<QPoint> placeOnShelf(const QSize &size);
+    bool grow();
+    void uploadEntry(const Entry &entry);
+    void clear();
+
+    QSize m_initialSize;
+    int m_maximumSize;
+    QSize m_size;
+    QList<Shelf> m_shelves;
+    QList<QRect> m_freeSlots;
+    QHash<int, Entry> m_entries;
+    QMultiHash<size_t, int> m_entriesByHash;
+    int m_lastId = 0;
+    quint64 m_textureAllocations = 0;
+    quint64 m_tileUploads = 0;
+};
+
+} // namespace KWin
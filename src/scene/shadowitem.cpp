@@ -112,9 +112,6 @@ WindowQuadList ShadowItem::buildQuads() const
 
     const QRectF outerRect = rect();
 
-    const int width = shadowMargins.left() + std::max(top.width(), bottom.width()) + shadowMargins.right();
-    const int height = shadowMargins.top() + std::max(left.height(), right.height()) + shadowMargins.bottom();
-
     QRectF topLeftRect;
     if (!topLeft.isEmpty()) {
         topLeftRect = QRectF(outerRect.topLeft(), topLeft);
@@ -172,10 +169,11 @@ WindowQuadList ShadowItem::buildQuads() const
     quads.reserve(8);
 
     if (topLeftRect.isValid()) {
-        tx1 = 0.0;
-        ty1 = 0.0;
-        tx2 = topLeftRect.width();
-        ty2 = topLeftRect.height();
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementTopLeft);
+        tx1 = source.left();
+        ty1 = source.top();
+        tx2 = source.left() + topLeftRect.width();
+        ty2 = source.top() + topLeftRect.height();
         WindowQuad topLeftQuad;
         topLeftQuad[0] = WindowVertex(topLeftRect.left(), topLeftRect.top(), tx1, ty1);
         topLeftQuad[1] = WindowVertex(topLeftRect.right(), topLeftRect.top(), tx2, ty1);
@@ -185,10 +183,11 @@ WindowQuadList ShadowItem::buildQuads() const
     }
 
     if (topRightRect.isValid()) {
-        tx1 = width - topRightRect.width();
-        ty1 = 0.0;
-        tx2 = width;
-        ty2 = topRightRect.height();
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementTopRight);
+        tx1 = source.right() - topRightRect.width();
+        ty1 = source.top();
+        tx2 = source.right();
+        ty2 = source.top() + topRightRect.height();
         WindowQuad topRightQuad;
         topRightQuad[0] = WindowVertex(topRightRect.left(), topRightRect.top(), tx1, ty1);
         topRightQuad[1] = WindowVertex(topRightRect.right(), topRightRect.top(), tx2, ty1);
@@ -198,10 +197,11 @@ WindowQuadList ShadowItem::buildQuads() const
     }
 
     if (bottomRightRect.isValid()) {
-        tx1 = width - bottomRightRect.width();
-        tx2 = width;
-        ty1 = height - bottomRightRect.height();
-        ty2 = height;
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementBottomRight);
+        tx1 = source.right() - bottomRightRect.width();
+        tx2 = source.right();
+        ty1 = source.bottom() - bottomRightRect.height();
+        ty2 = source.bottom();
         WindowQuad bottomRightQuad;
         bottomRightQuad[0] = WindowVertex(bottomRightRect.left(), bottomRightRect.top(), tx1, ty1);
         bottomRightQuad[1] = WindowVertex(bottomRightRect.right(), bottomRightRect.top(), tx2, ty1);
@@ -211,10 +211,11 @@ WindowQuadList ShadowItem::buildQuads() const
     }
 
     if (bottomLeftRect.isValid()) {
-        tx1 = 0.0;
-        tx2 = bottomLeftRect.width();
-        ty1 = height - bottomLeftRect.height();
-        ty2 = height;
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementBottomLeft);
+        tx1 = source.left();
+        tx2 = source.left() + bottomLeftRect.width();
+        ty1 = source.bottom() - bottomLeftRect.height();
+        ty2 = source.bottom();
         WindowQuad bottomLeftQuad;
         bottomLeftQuad[0] = WindowVertex(bottomLeftRect.left(), bottomLeftRect.top(), tx1, ty1);
         bottomLeftQuad[1] = WindowVertex(bottomLeftRect.right(), bottomLeftRect.top(), tx2, ty1);
@@ -244,10 +245,11 @@ WindowQuadList ShadowItem::buildQuads() const
     distributeVertically(topRect, bottomRect);
 
     if (topRect.isValid()) {
-        tx1 = shadowMargins.left();
-        ty1 = 0.0;
-        tx2 = tx1 + top.width();
-        ty2 = topRect.height();
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementTop);
+        tx1 = source.left();
+        ty1 = source.top();
+        tx2 = source.right();
+        ty2 = source.top() + topRect.height();
         WindowQuad topQuad;
         topQuad[0] = WindowVertex(topRect.left(), topRect.top(), tx1, ty1);
         topQuad[1] = WindowVertex(topRect.right(), topRect.top(), tx2, ty1);
@@ -257,10 +259,11 @@ WindowQuadList ShadowItem::buildQuads() const
     }
 
     if (rightRect.isValid()) {
-        tx1 = width - rightRect.width();
-        ty1 = shadowMargins.top();
-        tx2 = width;
-        ty2 = ty1 + right.height();
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementRight);
+        tx1 = source.right() - rightRect.width();
+        ty1 = source.top();
+        tx2 = source.right();
+        ty2 = source.bottom();
         WindowQuad rightQuad;
         rightQuad[0] = WindowVertex(rightRect.left(), rightRect.top(), tx1, ty1);
         rightQuad[1] = WindowVertex(rightRect.right(), rightRect.top(), tx2, ty1);
@@ -270,10 +273,11 @@ WindowQuadList ShadowItem::buildQuads() const
     }
 
     if (bottomRect.isValid()) {
-        tx1 = shadowMargins.left();
-        ty1 = height - bottomRect.height();
-        tx2 = tx1 + bottom.width();
-        ty2 = height;
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementBottom);
+        tx1 = source.left();
+        ty1 = source.bottom() - bottomRect.height();
+        tx2 = source.right();
+        ty2 = source.bottom();
         WindowQuad bottomQuad;
         bottomQuad[0] = WindowVertex(bottomRect.left(), bottomRect.top(), tx1, ty1);
         bottomQuad[1] = WindowVertex(bottomRect.right(), bottomRect.top(), tx2, ty1);
@@ -283,10 +287,11 @@ WindowQuadList ShadowItem::buildQuads() const
     }
 
     if (leftRect.isValid()) {
-        tx1 = 0.0;
-        ty1 = shadowMargins.top();
-        tx2 = leftRect.width();
-        ty2 = ty1 + left.height();
+        const QRectF source = m_textureProvider->elementRect(Shadow::ShadowElementLeft);
+        tx1 = source.left();
+        ty1 = source.top();
+        tx2 = source.left() + leftRect.width();
+        ty2 = source.bottom();
         WindowQuad leftQuad;
         leftQuad[0] = WindowVertex(leftRect.left(), leftRect.top(), tx1, ty1);
         leftQuad[1] = WindowVertex(leftRect.right(), leftRect.top(), tx2, ty1);
@@ -303,6 +308,8 @@ void ShadowItem::preprocess()
     if (m_textureDirty) {
         m_textureDirty = false;
         m_textureProvider->update();
+        // the elements may have moved in the texture
+        discardQuads();
     }
 }
 
@@ -7,11 +7,11 @@
 #pragma once
 
 #include "scene/item.h"
+#include "shadow.h"
 
 namespace KWin
 {
 
-class Shadow;
 class Window;
 
 class KWIN_EXPORT ShadowTextureProvider
@@ -23,6 +23,10 @@ public:
     Shadow *shadow() const { return m_shadow; }
 
     virtual void update() = 0;
+    /**
+     * Returns where the given shadow @a element is in the texture, in pixels.
+     */
+    virtual QRectF elementRect(Shadow::ShadowElements element) const = 0;
 
 protected:
     Shadow *m_shadow;
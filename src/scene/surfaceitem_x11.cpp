@@ -21,6 +21,10 @@ SurfaceItemX11::SurfaceItemX11(X11Window *window, Item *parent)
             this, &SurfaceItemX11::handleBufferGeometryChanged);
     connect(window, &X11Window::shapeChanged,
             this, &SurfaceItemX11::handleShapeChanged);
+    connect(window, &X11Window::opaqueRegionChanged,
+            this, &SurfaceItemX11::handleOpaqueRegionChanged);
+    connect(window, &Window::opacityChanged,
+            this, &SurfaceItemX11::discardAlphaProbe);
 
     m_damageHandle = xcb_generate_id(kwinApp()->x11Connection());
     xcb_damage_create(kwinApp()->x11Connection(), m_damageHandle, window->frameId(),
@@ -41,6 +45,7 @@ SurfaceItemX11::SurfaceItemX11(X11Window *window, Item *parent)
 
 SurfaceItemX11::~SurfaceItemX11()
 {
+    discardAlphaProbe();
     destroyDamage();
 }
 
@@ -58,10 +63,96 @@ void SurfaceItemX11::preprocess()
         }
     }
     SurfaceItem::preprocess();
+    probeAlpha();
+}
+
+void SurfaceItemX11::probeAlpha()
+{
+    // Many clients use an ARGB visual without ever drawing a translucent pixel and without
+    // setting _NET_WM_OPAQUE_REGION. A few lines across the pixmap are fetched to find out, the
+    // replies are read in the next frame so the compositor doesn't wait for them
+    static const bool probeEnabled = qEnvironmentVariableIntValue("KWIN_X11_NO_ALPHA_PROBE") == 0;
+    xcb_connection_t *connection = kwinApp()->x11Connection();
+
+    switch (m_alphaProbe) {
+    case AlphaProbe::Unknown: {
+        if (!probeEnabled || !m_window->hasAlpha() || !m_window->opaqueRegion().isEmpty() || m_window->isDeleted()) {
+            return;
+        }
+        const auto pixmap = static_cast<const SurfacePixmapX11 *>(this->pixmap());
+        if (!pixmap || !pixmap->isValid() || pixmap->size().isEmpty()) {
+            return;
+        }
+        // the pixmap is of the frame, only the client area is drawn by the client
+        const QRect area = m_window->clientGeometry().translated(-m_window->bufferGeometry().topLeft()).toRect() & QRect(QPoint(0, 0), pixmap->size());
+        if (area.isEmpty()) {
+            return;
+        }
+        // a window that keeps changing is sampled again once in a while, not after every frame
+        if (m_alphaProbeTimer.isValid() && !m_alphaProbeTimer.hasExpired(s_alphaProbeInterval.count())) {
+            return;
+        }
+        m_alphaProbeTimer.start();
+        for (int y : {area.top(), area.center().y(), area.bottom()}) {
+            m_alphaProbeCookies.append(xcb_get_image_unchecked(connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap->pixmap(), area.x(), y, area.width(), 1, ~0));
+        }
+        for (int x : {area.left(), area.center().x(), area.right()}) {
+            m_alphaProbeCookies.append(xcb_get_image_unchecked(connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap->pixmap(), x, area.y(), 1, area.height(), ~0));
+        }
+        m_alphaProbe = AlphaProbe::Pending;
+        break;
+    }
+    case AlphaProbe::Pending: {
+        const int alphaByte = xcb_get_setup(connection)->image_byte_order == XCB_IMAGE_ORDER_LSB_FIRST ? 3 : 0;
+        bool opaque = true;
+        for (const xcb_get_image_cookie_t &cookie : std::as_const(m_alphaProbeCookies)) {
+            xcb_get_image_reply_t *reply = xcb_get_image_reply(connection, cookie, nullptr);
+            if (!reply) {
+                opaque = false;
+                continue;
+            }
+            if (reply->depth != 32) {
+                opaque = false;
+            } else {
+                const uint8_t *data = xcb_get_image_data(reply);
+                const int length = xcb_get_image_data_length(reply);
+                for (int i = alphaByte; opaque && i < length; i += 4) {
+                    opaque = data[i] == 0xff;
+                }
+            }
+            free(reply);
+        }
+        m_alphaProbeCookies.clear();
+        m_alphaProbe = opaque ? AlphaProbe::Opaque : AlphaProbe::Translucent;
+        break;
+    }
+    case AlphaProbe::Opaque:
+    case AlphaProbe::Translucent:
+        break;
+    }
+}
+
+void SurfaceItemX11::discardAlphaProbe()
+{
+    for (const xcb_get_image_cookie_t &cookie : std::as_const(m_alphaProbeCookies)) {
+        xcb_discard_reply(kwinApp()->x11Connection(), cookie.sequence);
+    }
+    m_alphaProbeCookies.clear();
+    m_alphaProbe = AlphaProbe::Unknown;
+}
+
+bool SurfaceItemX11::isProbedOpaque() const
+{
+    return m_alphaProbe == AlphaProbe::Opaque;
 }
 
 void SurfaceItemX11::processDamage()
 {
+    // the client may have drawn translucent pixels where there were none, until the window is
+    // sampled again it's only as opaque as it says it is
+    if (m_alphaProbe == AlphaProbe::Opaque || m_alphaProbe == AlphaProbe::Pending) {
+        discardAlphaProbe();
+    }
     m_isDamaged = true;
     scheduleFrame();
 }
@@ -142,6 +233,10 @@ void SurfaceItemX11::destroyDamage()
 
 void SurfaceItemX11::handleBufferGeometryChanged()
 {
+    if (bufferSize() != m_window->bufferGeometry().size().toSize()) {
+        // the client redraws at the new size, maybe differently
+        discardAlphaProbe();
+    }
     setDestinationSize(m_window->bufferGeometry().size());
     setBufferSourceBox(QRectF(QPointF(0, 0), m_window->bufferGeometry().size()));
     setBufferSize(m_window->bufferGeometry().size().toSize());
@@ -151,6 +246,12 @@ void SurfaceItemX11::handleShapeChanged()
 {
     scheduleRepaint(boundingRect());
     discardQuads();
+    discardAlphaProbe();
+}
+
+void SurfaceItemX11::handleOpaqueRegionChanged()
+{
+    discardAlphaProbe();
 }
 
 QList<QRectF> SurfaceItemX11::shape() const
@@ -171,7 +272,7 @@ QRegion SurfaceItemX11::opaque() const
     for (const QRectF &shapePart : shape()) {
         shapeRegion += shapePart.toRect();
     }
-    if (!m_window->hasAlpha()) {
+    if (!m_window->hasAlpha() || isProbedOpaque()) {
         return shapeRegion;
     } else {
         return m_window->opaqueRegion() & shapeRegion;
@@ -8,6 +8,10 @@
 
 #include "scene/surfaceitem.h"
 
+#include <QElapsedTimer>
+
+#include <chrono>
+
 #include <xcb/damage.h>
 #include <xcb/xfixes.h>
 
@@ -40,15 +44,44 @@ public:
     QList<QRectF> shape() const override;
     QRegion opaque() const override;
 
+    /**
+     * Returns @c true if the window has an alpha channel but sampling its contents showed that
+     * it doesn't draw any translucent pixels.
+     *
+     * The result is dropped when the window is damaged, resized or reshaped, or when its opacity
+     * or opaque region changes. The window is then probed again, at most once per
+     * s_alphaProbeInterval, so a window that keeps changing rarely counts as opaque.
+     * Only a few lines of the window are sampled, translucent pixels that are drawn elsewhere,
+     * e.g. only in the middle of one quadrant, go unnoticed.
+     */
+    bool isProbedOpaque() const;
+
+    /// How often the alpha channel of a window that keeps changing is sampled at most
+    static constexpr std::chrono::milliseconds s_alphaProbeInterval{1000};
+
 private Q_SLOTS:
     void handleBufferGeometryChanged();
     void handleShapeChanged();
+    void handleOpaqueRegionChanged();
 
 protected:
     std::unique_ptr<SurfacePixmap> createPixmap() override;
 
 private:
+    enum class AlphaProbe {
+        Unknown,
+        Pending,
+        Opaque,
+        Translucent,
+    };
+
+    void probeAlpha();
+    void discardAlphaProbe();
+
     X11Window *m_window;
+    AlphaProbe m_alphaProbe = AlphaProbe::Unknown;
+    QList<xcb_get_image_cookie_t> m_alphaProbeCookies;
+    QElapsedTimer m_alphaProbeTimer;
     xcb_damage_damage_t m_damageHandle = XCB_NONE;
     xcb_xfixes_fetch_region_cookie_t m_damageCookie;
     bool m_isDamaged = false;
@@ -8,6 +8,7 @@
 #include "effect/effecthandler.h"
 #include "internalwindow.h"
 #include "scene/decorationitem.h"
+#include "scene/ghostitem.h"
 #include "scene/shadowitem.h"
 #include "scene/surfaceitem_internal.h"
 #include "scene/surfaceitem_x11.h"
@@ -78,6 +79,11 @@ ShadowItem *WindowItem::shadowItem() const
     return m_shadowItem.get();
 }
 
+GhostItem *WindowItem::ghostItem() const
+{
+    return m_ghostItem.get();
+}
+
 Window *WindowItem::window() const
 {
     return m_window;
@@ -144,6 +150,51 @@ void WindowItem::deelevate()
     updateStackingOrder();
 }
 
+void WindowItem::refLiveContents()
+{
+    m_liveContentsCount++;
+}
+
+void WindowItem::unrefLiveContents()
+{
+    Q_ASSERT(m_liveContentsCount > 0);
+    m_liveContentsCount--;
+}
+
+bool WindowItem::canBecomeGhost() const
+{
+    static const bool ghostsEnabled = qEnvironmentVariableIntValue("KWIN_X11_NO_WINDOW_GHOSTS") == 0;
+    if (!ghostsEnabled || m_ghostItem || m_ghostRejected) {
+        return false;
+    }
+
+    const auto isGrabbed = [this](int role) {
+        return m_effectWindow->data(role).value<void *>() != nullptr;
+    };
+    return GhostItem::canFreeze(GhostItem::Candidate{
+        .closed = m_window->isDeleted(),
+        .hasContents = m_surfaceItem != nullptr,
+        .liveContentsRefs = m_liveContentsCount,
+        .forcedVisible = m_forceVisibleByHiddenCount || m_forceVisibleByDesktopCount || m_forceVisibleByMinimizeCount || m_forceVisibleByActivityCount,
+        .offscreenRendering = m_window->isOffscreenRendering(),
+        .grabbed = isGrabbed(WindowAddedGrabRole) || isGrabbed(WindowClosedGrabRole) || isGrabbed(WindowMinimizedGrabRole) || isGrabbed(WindowUnminimizedGrabRole),
+    });
+}
+
+void WindowItem::setGhostItem(std::unique_ptr<GhostItem> &&ghostItem)
+{
+    if (!ghostItem) {
+        m_ghostRejected = true;
+        return;
+    }
+
+    // the ghost already shows everything, the pixmap and textures can be released right away
+    m_ghostItem = std::move(ghostItem);
+    updateSurfaceItem(nullptr);
+    m_decorationItem.reset();
+    m_shadowItem.reset();
+}
+
 bool WindowItem::computeVisibility() const
 {
     if (!m_window->readyForPainting()) {
@@ -240,6 +291,9 @@ void WindowItem::updateSurfaceBorderRadius()
 
 void WindowItem::updateShadowItem()
 {
+    if (m_ghostItem) {
+        return;
+    }
     Shadow *shadow = m_window->shadow();
     if (shadow) {
         if (!m_shadowItem || m_shadowItem->shadow() != shadow) {
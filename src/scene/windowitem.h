@@ -20,6 +20,7 @@ namespace KWin
 class Window;
 class DecorationItem;
 class EffectWindow;
+class GhostItem;
 class InternalWindow;
 class Shadow;
 class ShadowItem;
@@ -49,6 +50,7 @@ public:
     SurfaceItem *surfaceItem() const;
     DecorationItem *decorationItem() const;
     ShadowItem *shadowItem() const;
+    GhostItem *ghostItem() const;
     Window *window() const;
     EffectWindow *effectWindow() const;
 
@@ -58,6 +60,28 @@ public:
     void elevate();
     void deelevate();
 
+    /**
+     * Keeps the surface, decoration and shadow items of the window after it has been closed
+     * instead of replacing them with a ghost item. This must be called before the window is
+     * painted for the first time after closing, e.g. when the windowClosed signal is emitted.
+     *
+     * Effects that grab the window, force it to be visible or render it offscreen keep its
+     * contents live as well, for as long as they hold it.
+     */
+    void refLiveContents();
+    void unrefLiveContents();
+
+    /**
+     * Returns @c true if the window has been closed and its contents can be frozen into a
+     * ghost item, see GhostItem::canFreeze().
+     */
+    bool canBecomeGhost() const;
+    /**
+     * Replaces the surface, decoration and shadow items with @a ghostItem. If @a ghostItem is
+     * null, the window keeps its contents and won't become a ghost.
+     */
+    void setGhostItem(std::unique_ptr<GhostItem> &&ghostItem);
+
 protected:
     explicit WindowItem(Window *window, Item *parent = nullptr);
     void updateSurfaceItem(std::unique_ptr<SurfaceItem> &&surfaceItem);
@@ -83,12 +107,15 @@ private:
     std::unique_ptr<SurfaceItem> m_surfaceItem;
     std::unique_ptr<DecorationItem> m_decorationItem;
     std::unique_ptr<ShadowItem> m_shadowItem;
+    std::unique_ptr<GhostItem> m_ghostItem;
     std::unique_ptr<EffectWindow> m_effectWindow;
     std::optional<int> m_elevation;
     int m_forceVisibleByHiddenCount = 0;
     int m_forceVisibleByDesktopCount = 0;
     int m_forceVisibleByMinimizeCount = 0;
     int m_forceVisibleByActivityCount = 0;
+    int m_liveContentsCount = 0;
+    bool m_ghostRejected = false;
 };
 
 /**
@@ -63,6 +63,7 @@
 #include "internalwindow.h"
 #include "scene/decorationitem.h"
 #include "scene/dndiconitem.h"
+#include "scene/ghostitem.h"
 #include "scene/itemrenderer.h"
 #include "scene/rootitem.h"
 #include "scene/shadowitem.h"
@@ -275,6 +276,16 @@ QRegion WorkspaceScene::prePaint(SceneDelegate *delegate)
     effects->makeOpenGLContextCurrent();
     Q_EMIT preFrameRender();
 
+    // closed windows are painted as a single texture as soon as possible, they can't change
+    for (WindowItem *windowItem : std::as_const(stacking_order)) {
+        if (windowItem->canBecomeGhost()) {
+            windowItem->setGhostItem(createGhostItem(windowItem));
+        }
+    }
+
+    m_occlusionStatistics.frames++;
+    m_occlusionStatistics.lastCulledPixels = 0;
+
     effects->prePaintScreen(prePaintData, m_expectedPresentTimestamp);
     m_paintContext.damage = prePaintData.paint;
     m_paintContext.mask = prePaintData.mask;
@@ -309,6 +320,35 @@ static void accumulateRepaints(Item *item, SceneDelegate *delegate, QRegion *rep
     }
 }
 
+static QRegion opaqueRegion(const WindowItem *windowItem)
+{
+    // Clip out the decoration for opaque windows; the decoration is drawn in the second pass.
+    if (windowItem->window()->opacity() != 1.0) {
+        return QRegion();
+    }
+
+    QRegion opaque;
+    const SurfaceItem *surfaceItem = windowItem->surfaceItem();
+    if (Q_LIKELY(surfaceItem)) {
+        opaque = surfaceItem->mapToScene(surfaceItem->borderRadius().clip(surfaceItem->opaque(), surfaceItem->rect()));
+    }
+
+    const DecorationItem *decorationItem = windowItem->decorationItem();
+    if (decorationItem) {
+        opaque += decorationItem->mapToScene(decorationItem->borderRadius().clip(decorationItem->opaque(), decorationItem->rect()));
+    }
+    return opaque;
+}
+
+static quint64 pixelCount(const QRegion &region)
+{
+    quint64 count = 0;
+    for (const QRect &rect : region) {
+        count += quint64(rect.width()) * rect.height();
+    }
+    return count;
+}
+
 void WorkspaceScene::preparePaintGenericScreen()
 {
     for (WindowItem *windowItem : std::as_const(stacking_order)) {
@@ -317,6 +357,7 @@ void WorkspaceScene::preparePaintGenericScreen()
         WindowPrePaintData data;
         data.mask = m_paintContext.mask;
         data.paint = infiniteRegion(); // no clipping, so doesn't really matter
+        data.opaque = opaqueRegion(windowItem);
 
         effects->prePaintWindow(windowItem->effectWindow(), data, m_expectedPresentTimestamp);
         m_paintContext.phase2Data.append(Phase2Data{
@@ -334,23 +375,10 @@ void WorkspaceScene::preparePaintGenericScreen()
 void WorkspaceScene::preparePaintSimpleScreen()
 {
     for (WindowItem *windowItem : std::as_const(stacking_order)) {
-        Window *window = windowItem->window();
         WindowPrePaintData data;
         data.mask = m_paintContext.mask;
         accumulateRepaints(windowItem, painted_delegate, &data.paint);
-
-        // Clip out the decoration for opaque windows; the decoration is drawn in the second pass.
-        if (window->opacity() == 1.0) {
-            const SurfaceItem *surfaceItem = windowItem->surfaceItem();
-            if (Q_LIKELY(surfaceItem)) {
-                data.opaque = surfaceItem->mapToScene(surfaceItem->borderRadius().clip(surfaceItem->opaque(), surfaceItem->rect()));
-            }
-
-            const DecorationItem *decorationItem = windowItem->decorationItem();
-            if (decorationItem) {
-                data.opaque += decorationItem->mapToScene(decorationItem->borderRadius().clip(decorationItem->opaque(), decorationItem->rect()));
-            }
-        }
+        data.opaque = opaqueRegion(windowItem);
 
         effects->prePaintWindow(windowItem->effectWindow(), data, m_expectedPresentTimestamp);
         m_paintContext.phase2Data.append(Phase2Data{
@@ -391,6 +419,7 @@ void WorkspaceScene::paint(const RenderTarget &renderTarget, const QRegion &regi
     RenderViewport viewport(output ? output->geometryF() : workspace()->geometry(), output ? output->scale() : 1, renderTarget);
 
     m_renderer->beginFrame(renderTarget, viewport);
+    prepareTransformedWindows(viewport);
 
     effects->paintScreen(renderTarget, viewport, m_paintContext.mask, region, painted_screen);
     m_paintScreenCount = 0;
@@ -406,6 +435,24 @@ void WorkspaceScene::paint(const RenderTarget &renderTarget, const QRegion &regi
     m_renderer->endFrame();
 }
 
+void WorkspaceScene::prepareTransformedWindows(const RenderViewport &viewport)
+{
+    // The quads of transformed windows aren't cut at the clip region, so their vertices can be
+    // built for all windows at once before any of them is painted, e.g. in the overview
+    if (!(m_paintContext.mask & (PAINT_SCREEN_TRANSFORMED | PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS))) {
+        return;
+    }
+    QList<Item *> items;
+    for (const Phase2Data &paintData : std::as_const(m_paintContext.phase2Data)) {
+        if ((m_paintContext.mask & PAINT_SCREEN_TRANSFORMED) || (paintData.mask & PAINT_WINDOW_TRANSFORMED)) {
+            items.append(paintData.item);
+        }
+    }
+    if (!items.isEmpty()) {
+        m_renderer->prepareItems(viewport, items);
+    }
+}
+
 // the function that'll be eventually called by paintScreen() above
 void WorkspaceScene::finalPaintScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int mask, const QRegion &region, Output *screen)
 {
@@ -419,7 +466,7 @@ void WorkspaceScene::finalPaintScreen(const RenderTarget &renderTarget, const Re
 
 // The generic painting code that can handle even transformations.
 // It simply paints bottom-to-top.
-void WorkspaceScene::paintGenericScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int, Output *screen)
+void WorkspaceScene::paintGenericScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int mask, Output *screen)
 {
     if (m_paintContext.mask & PAINT_SCREEN_BACKGROUND_FIRST) {
         if (m_paintScreenCount == 1) {
@@ -429,6 +476,23 @@ void WorkspaceScene::paintGenericScreen(const RenderTarget &renderTarget, const
         m_renderer->renderBackground(renderTarget, viewport, infiniteRegion());
     }
 
+    // Only some windows are transformed, the ones that none of the active effects touch still
+    // occlude the windows below them
+    if (!((mask | m_paintContext.mask) & PAINT_SCREEN_TRANSFORMED)) {
+        QRegion visible = infiniteRegion();
+        for (int i = m_paintContext.phase2Data.size() - 1; i >= 0; --i) {
+            Phase2Data *data = &m_paintContext.phase2Data[i];
+            data->region = visible;
+            if (data->mask & PAINT_WINDOW_TRANSFORMED) {
+                continue;
+            }
+            addCulledPixels(*data, infiniteRegion());
+            if (!(data->mask & PAINT_WINDOW_TRANSLUCENT) && effects->isWindowUntransformed(data->item->effectWindow())) {
+                visible -= data->opaque;
+            }
+        }
+    }
+
     for (const Phase2Data &paintData : std::as_const(m_paintContext.phase2Data)) {
         paintWindow(renderTarget, viewport, paintData.item, paintData.mask, paintData.region);
     }
@@ -447,6 +511,7 @@ void WorkspaceScene::paintSimpleScreen(const RenderTarget &renderTarget, const R
 
         if (!(data->mask & PAINT_WINDOW_TRANSFORMED)) {
             data->region &= data->item->mapToScene(data->item->boundingRect()).toAlignedRect();
+            addCulledPixels(*data, region);
 
             if (!(data->mask & PAINT_WINDOW_TRANSLUCENT)) {
                 visible -= data->opaque;
@@ -461,6 +526,24 @@ void WorkspaceScene::paintSimpleScreen(const RenderTarget &renderTarget, const R
     }
 }
 
+void WorkspaceScene::addCulledPixels(const Phase2Data &data, const QRegion &unculled)
+{
+    const QRect bounds = data.item->mapToScene(data.item->boundingRect()).toAlignedRect();
+    const quint64 culled = pixelCount(unculled & bounds) - pixelCount(data.region & bounds);
+    m_occlusionStatistics.culledPixels += culled;
+    m_occlusionStatistics.lastCulledPixels += culled;
+}
+
+WorkspaceScene::OcclusionStatistics WorkspaceScene::occlusionStatistics() const
+{
+    return m_occlusionStatistics;
+}
+
+void WorkspaceScene::resetOcclusionStatistics()
+{
+    m_occlusionStatistics = {};
+}
+
 void WorkspaceScene::createStackingOrder()
 {
     QList<Item *> items = m_containerItem->sortedChildItems();
@@ -504,6 +587,11 @@ bool WorkspaceScene::makeOpenGLContextCurrent()
     return false;
 }
 
+std::unique_ptr<GhostItem> WorkspaceScene::createGhostItem(WindowItem *)
+{
+    return nullptr;
+}
+
 void WorkspaceScene::doneOpenGLContextCurrent()
 {
 }
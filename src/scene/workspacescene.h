@@ -24,6 +24,7 @@ class DecorationRenderer;
 class Deleted;
 class DragAndDropIconItem;
 class EffectWindow;
+class GhostItem;
 class GLTexture;
 class Item;
 class RenderLoop;
@@ -63,6 +64,24 @@ public:
 
     virtual std::unique_ptr<DecorationRenderer> createDecorationRenderer(Decoration::DecoratedWindowImpl *) = 0;
     virtual std::unique_ptr<ShadowTextureProvider> createShadowTextureProvider(Shadow *shadow) = 0;
+    /**
+     * Renders the contents of the closed window @a windowItem into a ghost item. Returns
+     * @c null if the scene doesn't support ghosts.
+     */
+    virtual std::unique_ptr<GhostItem> createGhostItem(WindowItem *windowItem);
+
+    struct OcclusionStatistics
+    {
+        quint64 frames = 0;
+        quint64 culledPixels = 0;
+        quint64 lastCulledPixels = 0;
+    };
+    /**
+     * Returns how many window pixels the occlusion culling kept from being painted, in total
+     * and in the most recent frame.
+     */
+    OcclusionStatistics occlusionStatistics() const;
+    void resetOcclusionStatistics();
 
     /**
      * Whether the Scene is able to drive animations.
@@ -127,11 +146,14 @@ protected:
 private:
     void createDndIconItem();
     void destroyDndIconItem();
+    void addCulledPixels(const Phase2Data &data, const QRegion &unculled);
+    void prepareTransformedWindows(const RenderViewport &viewport);
 
     std::chrono::milliseconds m_expectedPresentTimestamp = std::chrono::milliseconds::zero();
     // how many times finalPaintScreen() has been called
     int m_paintScreenCount = 0;
     PaintContext m_paintContext;
+    OcclusionStatistics m_occlusionStatistics;
     std::unique_ptr<Item> m_containerItem;
     std::unique_ptr<Item> m_overlayItem;
     std::unique_ptr<DragAndDropIconItem> m_dndIcon;
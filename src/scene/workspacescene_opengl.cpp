@@ -17,11 +17,18 @@
 
 #include "compositor.h"
 #include "core/output.h"
+#include "core/rendertarget.h"
+#include "core/renderviewport.h"
 #include "decorations/decoratedwindow.h"
+#include "effect/effect.h"
+#include "opengl/glframebuffer.h"
+#include "scene/ghostitem.h"
 #include "scene/itemrenderer_opengl.h"
+#include "scene/windowitem.h"
 #include "shadow.h"
 #include "window.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 
@@ -80,6 +87,49 @@ std::unique_ptr<ShadowTextureProvider> WorkspaceSceneOpenGL::createShadowTexture
     return std::make_unique<OpenGLShadowTextureProvider>(shadow);
 }
 
+std::unique_ptr<GhostItem> WorkspaceSceneOpenGL::createGhostItem(WindowItem *windowItem)
+{
+    const QRectF geometry = windowItem->boundingRect().toAlignedRect();
+    const qreal scale = windowItem->window()->targetScale();
+    const QSize textureSize = (geometry.size() * scale).toSize();
+    if (textureSize.isEmpty()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<GLTexture> texture = GLTexture::allocate(GL_RGBA8, textureSize);
+    if (!texture) {
+        return nullptr;
+    }
+    texture->setContentTransform(OutputTransform::FlipY);
+    texture->setFilter(GL_LINEAR);
+    texture->setWrapMode(GL_CLAMP_TO_EDGE);
+
+    GLFramebuffer framebuffer(texture.get());
+    if (!framebuffer.valid()) {
+        return nullptr;
+    }
+
+    // render the children rather than the window item, the opacity and the transforms of the
+    // window item still get applied to the ghost
+    RenderTarget renderTarget(&framebuffer);
+    RenderViewport viewport(geometry, scale, renderTarget);
+    GLFramebuffer::pushFramebuffer(&framebuffer);
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    const QList<Item *> childItems = windowItem->sortedChildItems();
+    for (Item *childItem : childItems) {
+        if (childItem->explicitVisible()) {
+            renderer()->renderItem(renderTarget, viewport, childItem, PAINT_WINDOW_TRANSFORMED, infiniteRegion(), WindowPaintData{});
+        }
+    }
+    GLFramebuffer::popFramebuffer();
+
+    auto ghostItem = std::make_unique<GhostItem>(std::move(texture), windowItem);
+    ghostItem->setPosition(geometry.topLeft());
+    ghostItem->setSize(geometry.size());
+    return ghostItem;
+}
+
 bool WorkspaceSceneOpenGL::animationsSupported() const
 {
     const auto context = openglContext();
@@ -94,83 +144,62 @@ std::pair<std::shared_ptr<GLTexture>, ColorDescription> WorkspaceSceneOpenGL::te
 //****************************************
 // SceneOpenGL::Shadow
 //****************************************
-class DecorationShadowTextureCache
+class GLShadowAtlas : public ShadowAtlas
 {
 public:
-    ~DecorationShadowTextureCache();
-    DecorationShadowTextureCache(const DecorationShadowTextureCache &) = delete;
-    static DecorationShadowTextureCache &instance();
+    static GLShadowAtlas &instance();
 
-    void unregister(ShadowTextureProvider *provider);
-    std::shared_ptr<GLTexture> getTexture(ShadowTextureProvider *provider);
+    GLTexture *texture() const
+    {
+        return m_texture.get();
+    }
+
+protected:
+    bool allocate(const QSize &size) override;
+    void upload(const QImage &image, const QPoint &position) override;
+    void deallocate() override;
 
 private:
-    DecorationShadowTextureCache() = default;
-    struct Data
-    {
-        std::shared_ptr<GLTexture> texture;
-        QList<ShadowTextureProvider *> providers;
-    };
-    QHash<KDecoration3::DecorationShadow *, Data> m_cache;
+    explicit GLShadowAtlas(int maximumSize);
+
+    std::unique_ptr<GLTexture> m_texture;
 };
 
-DecorationShadowTextureCache &DecorationShadowTextureCache::instance()
+GLShadowAtlas &GLShadowAtlas::instance()
 {
-    static DecorationShadowTextureCache s_instance;
+    static GLShadowAtlas s_instance([]() {
+        GLint maximumSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maximumSize);
+        return std::clamp(maximumSize, 256, 8192);
+    }());
     return s_instance;
 }
 
-DecorationShadowTextureCache::~DecorationShadowTextureCache()
+GLShadowAtlas::GLShadowAtlas(int maximumSize)
+    : ShadowAtlas(QSize(256, 256), maximumSize)
 {
-    Q_ASSERT(m_cache.isEmpty());
 }
 
-void DecorationShadowTextureCache::unregister(ShadowTextureProvider *provider)
+bool GLShadowAtlas::allocate(const QSize &size)
 {
-    auto it = m_cache.begin();
-    while (it != m_cache.end()) {
-        auto &d = it.value();
-        // check whether the Vector of Shadows contains our shadow and remove all of them
-        auto glIt = d.providers.begin();
-        while (glIt != d.providers.end()) {
-            if (*glIt == provider) {
-                glIt = d.providers.erase(glIt);
-            } else {
-                glIt++;
-            }
-        }
-        // if there are no shadows any more we can erase the cache entry
-        if (d.providers.isEmpty()) {
-            it = m_cache.erase(it);
-        } else {
-            it++;
-        }
+    std::unique_ptr<GLTexture> texture = GLTexture::allocate(GL_RGBA8, size);
+    if (!texture) {
+        return false;
     }
+    texture->setFilter(GL_LINEAR);
+    texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    m_texture = std::move(texture);
+    return true;
 }
 
-std::shared_ptr<GLTexture> DecorationShadowTextureCache::getTexture(ShadowTextureProvider *provider)
+void GLShadowAtlas::upload(const QImage &image, const QPoint &position)
 {
-    Shadow *shadow = provider->shadow();
-    Q_ASSERT(shadow->hasDecorationShadow());
-    unregister(provider);
-    const auto decoShadow = shadow->decorationShadow().lock();
-    Q_ASSERT(decoShadow);
-    auto it = m_cache.find(decoShadow.get());
-    if (it != m_cache.end()) {
-        Q_ASSERT(!it.value().providers.contains(provider));
-        it.value().providers << provider;
-        return it.value().texture;
-    }
-    Data d;
-    d.providers << provider;
-    d.texture = GLTexture::upload(shadow->decorationShadowImage());
-    if (!d.texture) {
-        return nullptr;
-    }
-    d.texture->setFilter(GL_LINEAR);
-    d.texture->setWrapMode(GL_CLAMP_TO_EDGE);
-    m_cache.insert(decoShadow.get(), d);
-    return d.texture;
+    m_texture->update(image, image.rect(), position);
+}
+
+void GLShadowAtlas::deallocate()
+{
+    m_texture.reset();
 }
 
 OpenGLShadowTextureProvider::OpenGLShadowTextureProvider(Shadow *shadow)
@@ -180,95 +209,57 @@ OpenGLShadowTextureProvider::OpenGLShadowTextureProvider(Shadow *shadow)
 
 OpenGLShadowTextureProvider::~OpenGLShadowTextureProvider()
 {
-    if (m_texture) {
+    if (m_hasTiles) {
         Compositor::self()->scene()->makeOpenGLContextCurrent();
-        DecorationShadowTextureCache::instance().unregister(this);
-        m_texture.reset();
+        releaseTiles();
     }
 }
 
-void OpenGLShadowTextureProvider::update()
+GLTexture *OpenGLShadowTextureProvider::shadowTexture() const
 {
-    if (m_shadow->hasDecorationShadow()) {
-        // simplifies a lot by going directly to
-        m_texture = DecorationShadowTextureCache::instance().getTexture(this);
-        return;
-    }
-
-    const QSize top(m_shadow->shadowElement(Shadow::ShadowElementTop).size());
-    const QSize topRight(m_shadow->shadowElement(Shadow::ShadowElementTopRight).size());
-    const QSize right(m_shadow->shadowElement(Shadow::ShadowElementRight).size());
-    const QSize bottom(m_shadow->shadowElement(Shadow::ShadowElementBottom).size());
-    const QSize bottomLeft(m_shadow->shadowElement(Shadow::ShadowElementBottomLeft).size());
-    const QSize left(m_shadow->shadowElement(Shadow::ShadowElementLeft).size());
-    const QSize topLeft(m_shadow->shadowElement(Shadow::ShadowElementTopLeft).size());
-    const QSize bottomRight(m_shadow->shadowElement(Shadow::ShadowElementBottomRight).size());
-
-    const int width = std::max({topLeft.width(), left.width(), bottomLeft.width()}) + std::max(top.width(), bottom.width()) + std::max({topRight.width(), right.width(), bottomRight.width()});
-    const int height = std::max({topLeft.height(), top.height(), topRight.height()}) + std::max(left.height(), right.height()) + std::max({bottomLeft.height(), bottom.height(), bottomRight.height()});
-
-    if (width == 0 || height == 0) {
-        return;
-    }
-
-    QImage image(width, height, QImage::Format_ARGB32);
-    image.fill(Qt::transparent);
-
-    const int innerRectTop = std::max({topLeft.height(), top.height(), topRight.height()});
-    const int innerRectLeft = std::max({topLeft.width(), left.width(), bottomLeft.width()});
-
-    QPainter p;
-    p.begin(&image);
-
-    p.drawImage(QRectF(0, 0, topLeft.width(), topLeft.height()), m_shadow->shadowElement(Shadow::ShadowElementTopLeft));
-    p.drawImage(QRectF(innerRectLeft, 0, top.width(), top.height()), m_shadow->shadowElement(Shadow::ShadowElementTop));
-    p.drawImage(QRectF(width - topRight.width(), 0, topRight.width(), topRight.height()), m_shadow->shadowElement(Shadow::ShadowElementTopRight));
-
-    p.drawImage(QRectF(0, innerRectTop, left.width(), left.height()), m_shadow->shadowElement(Shadow::ShadowElementLeft));
-    p.drawImage(QRectF(width - right.width(), innerRectTop, right.width(), right.height()), m_shadow->shadowElement(Shadow::ShadowElementRight));
-
-    p.drawImage(QRectF(0, height - bottomLeft.height(), bottomLeft.width(), bottomLeft.height()), m_shadow->shadowElement(Shadow::ShadowElementBottomLeft));
-    p.drawImage(QRectF(innerRectLeft, height - bottom.height(), bottom.width(), bottom.height()), m_shadow->shadowElement(Shadow::ShadowElementBottom));
-    p.drawImage(QRectF(width - bottomRight.width(), height - bottomRight.height(), bottomRight.width(), bottomRight.height()), m_shadow->shadowElement(Shadow::ShadowElementBottomRight));
-
-    p.end();
-
-    // Check if the image is alpha-only in practice, and if so convert it to an 8-bpp format
-    const auto context = OpenGlContext::currentContext();
-    if (!context->isOpenGLES() && context->supportsTextureSwizzle() && context->supportsRGTextures()) {
-        QImage alphaImage(image.size(), QImage::Format_Alpha8);
-        bool alphaOnly = true;
+    return m_hasTiles ? GLShadowAtlas::instance().texture() : nullptr;
+}
 
-        for (ptrdiff_t y = 0; alphaOnly && y < image.height(); y++) {
-            const uint32_t *const src = reinterpret_cast<const uint32_t *>(image.scanLine(y));
-            uint8_t *const dst = reinterpret_cast<uint8_t *>(alphaImage.scanLine(y));
+QRectF OpenGLShadowTextureProvider::elementRect(Shadow::ShadowElements element) const
+{
+    return m_tiles[element].rect;
+}
 
-            for (ptrdiff_t x = 0; x < image.width(); x++) {
-                if (src[x] & 0x00ffffff) {
-                    alphaOnly = false;
-                }
+void OpenGLShadowTextureProvider::update()
+{
+    GLShadowAtlas &atlas = GLShadowAtlas::instance();
 
-                dst[x] = qAlpha(src[x]);
+    // The new tiles are acquired before the old ones are released, so the tiles that didn't
+    // change keep their place in the atlas and aren't uploaded again
+    Tiles tiles;
+    if (m_shadow->hasDecorationShadow()) {
+        const QImage image = m_shadow->decorationShadowImage();
+        for (int i = 0; i < Shadow::ShadowElementsCount; ++i) {
+            const QRect geometry = m_shadow->decorationElementGeometry(Shadow::ShadowElements(i)).toAlignedRect();
+            if (!geometry.isEmpty()) {
+                tiles[i] = atlas.acquire(image.copy(geometry));
             }
         }
-
-        if (alphaOnly) {
-            image = alphaImage;
+    } else {
+        for (int i = 0; i < Shadow::ShadowElementsCount; ++i) {
+            tiles[i] = atlas.acquire(m_shadow->shadowElement(Shadow::ShadowElements(i)));
         }
     }
 
-    m_texture = GLTexture::upload(image);
-    if (!m_texture) {
-        return;
-    }
-    m_texture->setFilter(GL_LINEAR);
-    m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    releaseTiles();
+    m_tiles = tiles;
+    m_hasTiles = std::ranges::any_of(m_tiles, &ShadowAtlas::Tile::isValid);
+}
 
-    if (m_texture->internalFormat() == GL_R8) {
-        // Swizzle red to alpha and all other channels to zero
-        m_texture->bind();
-        m_texture->setSwizzle(GL_ZERO, GL_ZERO, GL_ZERO, GL_RED);
+void OpenGLShadowTextureProvider::releaseTiles()
+{
+    for (ShadowAtlas::Tile &tile : m_tiles) {
+        if (tile.isValid()) {
+            GLShadowAtlas::instance().release(tile.id);
+        }
+        tile = ShadowAtlas::Tile{};
     }
+    m_hasTiles = false;
 }
 
 SceneOpenGLDecorationRenderer::SceneOpenGLDecorationRenderer(Decoration::DecoratedWindowImpl *client)
@@ -13,11 +13,14 @@
 #include "platformsupport/scenes/opengl/openglbackend.h"
 
 #include "scene/decorationitem.h"
+#include "scene/shadowatlas.h"
 #include "scene/shadowitem.h"
 #include "scene/workspacescene.h"
 
 #include "opengl/glutils.h"
 
+#include <array>
+
 namespace KWin
 {
 class OpenGLBackend;
@@ -36,6 +39,7 @@ public:
     OpenGlContext *openglContext() const override;
     std::unique_ptr<DecorationRenderer> createDecorationRenderer(Decoration::DecoratedWindowImpl *impl) override;
     std::unique_ptr<ShadowTextureProvider> createShadowTextureProvider(Shadow *shadow) override;
+    std::unique_ptr<GhostItem> createGhostItem(WindowItem *windowItem) override;
     bool animationsSupported() const override;
 
     OpenGLBackend *backend() const
@@ -53,7 +57,8 @@ private:
 /**
  * @short OpenGL implementation of Shadow.
  *
- * This class extends Shadow by the Elements required for OpenGL rendering.
+ * This class extends Shadow by the Elements required for OpenGL rendering. The elements are
+ * tiles in an atlas shared by all shadows, so identical shadows are uploaded only once.
  * @author Martin Gräßlin <mgraesslin@kde.org>
  */
 class OpenGLShadowTextureProvider : public ShadowTextureProvider
@@ -62,15 +67,21 @@ public:
     explicit OpenGLShadowTextureProvider(Shadow *shadow);
     ~OpenGLShadowTextureProvider() override;
 
-    GLTexture *shadowTexture()
-    {
-        return m_texture.get();
-    }
+    /**
+     * Returns the shadow atlas texture, which is shared by all shadows.
+     */
+    GLTexture *shadowTexture() const;
 
     void update() override;
+    QRectF elementRect(Shadow::ShadowElements element) const override;
 
 private:
-    std::shared_ptr<GLTexture> m_texture;
+    using Tiles = std::array<ShadowAtlas::Tile, Shadow::ShadowElementsCount>;
+
+    void releaseTiles();
+
+    Tiles m_tiles;
+    bool m_hasTiles = false;
 };
 
 class SceneOpenGLDecorationRenderer : public DecorationRenderer
@@ -0,0 +1,361 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "animationdescriptor.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMetaEnum>
+#include <QMetaProperty>
+
+#include <algorithm>
+
+namespace KWin
+{
+
+static const AnimationDescriptor::Event s_events[] = {
+    AnimationDescriptor::Event::WindowAdded,
+    AnimationDescriptor::Event::WindowClosed,
+    AnimationDescriptor::Event::WindowMinimized,
+    AnimationDescriptor::Event::WindowUnminimized,
+};
+
+static void setError(QString *error, const QString &message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+static std::optional<AnimationDescriptor::Event> eventFromName(const QString &name)
+{
+    for (const AnimationDescriptor::Event event : s_events) {
+        if (AnimationDescriptor::eventName(event) == name) {
+            return event;
+        }
+    }
+    return std::nullopt;
+}
+
+static std::optional<QList<AnimationDescriptor::Condition>> parseConditions(const QJsonValue &value, QString *error)
+{
+    QList<AnimationDescriptor::Condition> conditions;
+    if (value.isUndefined()) {
+        return conditions;
+    }
+    if (!value.isObject()) {
+        setError(error, QStringLiteral("\"when\" must be an object"));
+        return std::nullopt;
+    }
+
+    const QJsonObject object = value.toObject();
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        AnimationDescriptor::Condition condition;
+        condition.property = it.key().toUtf8();
+        if (it->isArray()) {
+            const QJsonArray values = it->toArray();
+            for (const QJsonValue &item : values) {
+                condition.anyOf.append(item.toString());
+            }
+        } else if (it->isBool() || it->isDouble()) {
+            condition.value = it->toVariant();
+        } else {
+            setError(error, QStringLiteral("Invalid value for condition \"%1\"").arg(it.key()));
+            return std::nullopt;
+        }
+        conditions.append(condition);
+    }
+    return conditions;
+}
+
+static std::optional<FPx2> parseValue(const QJsonValue &value)
+{
+    if (value.isDouble()) {
+        return FPx2(value.toDouble());
+    }
+    if (value.isArray()) {
+        const QJsonArray values = value.toArray();
+        if (values.size() == 2 && values[0].isDouble() && values[1].isDouble()) {
+            return FPx2(values[0].toDouble(), values[1].toDouble());
+        }
+    }
+    return std::nullopt;
+}
+
+static std::optional<AnimationDescriptor::Animation> parseAnimation(const QJsonObject &object, QString *error)
+{
+    AnimationDescriptor::Animation animation;
+
+    bool ok = false;
+    const QMetaEnum attributes = QMetaEnum::fromType<AnimationEffect::Attribute>();
+    animation.type = static_cast<AnimationEffect::Attribute>(attributes.keyToValue(object[QStringLiteral("type")].toString().toUtf8().constData(), &ok));
+    if (!ok) {
+        setError(error, QStringLiteral("Unknown animation type \"%1\"").arg(object[QStringLiteral("type")].toString()));
+        return std::nullopt;
+    }
+
+    const QJsonValue duration = object[QStringLiteral("duration")];
+    if (duration.isDouble()) {
+        animation.duration.defaultValue = duration.toInt();
+    } else if (duration.isObject()) {
+        const QJsonObject durationObject = duration.toObject();
+        animation.duration.configKey = durationObject[QStringLiteral("config")].toString();
+        animation.duration.defaultValue = durationObject[QStringLiteral("default")].toInt();
+        animation.duration.factor = durationObject[QStringLiteral("factor")].toInt(1);
+    } else {
+        setError(error, QStringLiteral("Duration property missing in animation options"));
+        return std::nullopt;
+    }
+
+    const std::optional<FPx2> to = parseValue(object[QStringLiteral("to")]);
+    if (!to) {
+        setError(error, QStringLiteral("Invalid or missing target value in animation options"));
+        return std::nullopt;
+    }
+    animation.to = *to;
+
+    if (object.contains(QStringLiteral("from"))) {
+        const std::optional<FPx2> from = parseValue(object[QStringLiteral("from")]);
+        if (!from) {
+            setError(error, QStringLiteral("Invalid start value in animation options"));
+            return std::nullopt;
+        }
+        animation.from = *from;
+    }
+
+    if (object.contains(QStringLiteral("curve"))) {
+        const QMetaEnum curves = QMetaEnum::fromType<QEasingCurve::Type>();
+        animation.curve = static_cast<QEasingCurve::Type>(curves.keyToValue(object[QStringLiteral("curve")].toString().toUtf8().constData(), &ok));
+        if (!ok || animation.curve >= QEasingCurve::Custom) {
+            setError(error, QStringLiteral("Unknown easing curve \"%1\"").arg(object[QStringLiteral("curve")].toString()));
+            return std::nullopt;
+        }
+    }
+
+    static const std::pair<AnimationEffect::MetaType, QLatin1StringView> metaTypes[] = {
+        {AnimationEffect::SourceAnchor, QLatin1StringView("sourceAnchor")},
+        {AnimationEffect::TargetAnchor, QLatin1StringView("targetAnchor")},
+        {AnimationEffect::RelativeSourceX, QLatin1StringView("relativeSourceX")},
+        {AnimationEffect::RelativeSourceY, QLatin1StringView("relativeSourceY")},
+        {AnimationEffect::RelativeTargetX, QLatin1StringView("relativeTargetX")},
+        {AnimationEffect::RelativeTargetY, QLatin1StringView("relativeTargetY")},
+        {AnimationEffect::Axis, QLatin1StringView("axis")},
+    };
+    for (const auto &[metaType, key] : metaTypes) {
+        const QJsonValue value = object[key];
+        if (value.isDouble()) {
+            AnimationEffect::setMetaData(metaType, value.toInt(), animation.metaData);
+        }
+    }
+
+    animation.delay = object[QStringLiteral("delay")].toInt();
+    animation.fullScreen = object[QStringLiteral("fullScreen")].toBool(false);
+    animation.keepAlive = object[QStringLiteral("keepAlive")].toBool(true);
+    return animation;
+}
+
+static std::optional<AnimationDescriptor::Handler> parseHandler(const QJsonObject &object, QString *error)
+{
+    AnimationDescriptor::Handler handler;
+    handler.enabled = true;
+
+    const auto conditions = parseConditions(object[QStringLiteral("when")], error);
+    if (!conditions) {
+        return std::nullopt;
+    }
+    handler.conditions = *conditions;
+    handler.skipDuringFullScreenEffect = object[QStringLiteral("skipDuringFullScreenEffect")].toBool(true);
+    handler.skipIfGrabbed = object[QStringLiteral("skipIfGrabbed")].toBool(true);
+    handler.grab = object[QStringLiteral("grab")].toBool(false);
+
+    const QJsonArray cancels = object[QStringLiteral("cancels")].toArray();
+    for (const QJsonValue &value : cancels) {
+        const auto event = eventFromName(value.toString());
+        if (!event) {
+            setError(error, QStringLiteral("Unknown event \"%1\"").arg(value.toString()));
+            return std::nullopt;
+        }
+        handler.cancels.append(*event);
+    }
+
+    const QJsonArray animations = object[QStringLiteral("animations")].toArray();
+    if (animations.isEmpty()) {
+        setError(error, QStringLiteral("No animations provided"));
+        return std::nullopt;
+    }
+    for (const QJsonValue &value : animations) {
+        const auto animation = parseAnimation(value.toObject(), error);
+        if (!animation) {
+            return std::nullopt;
+        }
+        handler.animations.append(*animation);
+    }
+
+    return handler;
+}
+
+std::optional<AnimationDescriptor> AnimationDescriptor::fromJson(const QJsonObject &object, QString *error)
+{
+    AnimationDescriptor descriptor;
+
+    const QJsonValue filter = object[QStringLiteral("filter")];
+    if (filter.isObject()) {
+        const QJsonObject filterObject = filter.toObject();
+        const QJsonArray rules = filterObject[QStringLiteral("rules")].toArray();
+        for (const QJsonValue &value : rules) {
+            const QJsonObject ruleObject = value.toObject();
+            const auto conditions = parseConditions(ruleObject[QStringLiteral("when")], error);
+            if (!conditions) {
+                return std::nullopt;
+            }
+            if (!ruleObject[QStringLiteral("result")].isBool()) {
+                setError(error, QStringLiteral("Filter rule without a result"));
+                return std::nullopt;
+            }
+            descriptor.m_rules.append(Rule{
+                .conditions = *conditions,
+                .result = ruleObject[QStringLiteral("result")].toBool(),
+            });
+        }
+        descriptor.m_defaultResult = filterObject[QStringLiteral("default")].toBool(true);
+    } else if (!filter.isUndefined()) {
+        setError(error, QStringLiteral("\"filter\" must be an object"));
+        return std::nullopt;
+    }
+
+    bool hasHandler = false;
+    for (const Event event : s_events) {
+        const QJsonValue value = object[eventName(event)];
+        if (value.isUndefined()) {
+            continue;
+        }
+        const auto handler = parseHandler(value.toObject(), error);
+        if (!handler) {
+            return std::nullopt;
+        }
+        descriptor.m_handlers[int(event)] = *handler;
+        hasHandler = true;
+    }
+    if (!hasHandler) {
+        setError(error, QStringLiteral("The descriptor doesn't handle any event"));
+        return std::nullopt;
+    }
+
+    return descriptor;
+}
+
+std::optional<AnimationDescriptor> AnimationDescriptor::load(const QString &fileName, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(error, file.errorString());
+        return std::nullopt;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        setError(error, QStringLiteral("%1 at offset %2").arg(parseError.errorString()).arg(parseError.offset));
+        return std::nullopt;
+    }
+    if (!document.isObject()) {
+        setError(error, QStringLiteral("The descriptor must be an object"));
+        return std::nullopt;
+    }
+    return fromJson(document.object(), error);
+}
+
+void AnimationDescriptor::resolve(const QMetaObject *metaObject)
+{
+    m_metaObject = metaObject;
+    const auto resolveConditions = [metaObject](QList<Condition> &conditions) {
+        for (Condition &condition : conditions) {
+            condition.propertyIndex = metaObject->indexOfProperty(condition.property.constData());
+        }
+    };
+    for (Rule &rule : m_rules) {
+        resolveConditions(rule.conditions);
+    }
+    for (Handler &handler : m_handlers) {
+        resolveConditions(handler.conditions);
+    }
+}
+
+bool AnimationDescriptor::evaluate(const Condition &condition, const QObject *object) const
+{
+    QVariant value;
+    if (condition.propertyIndex != -1 && object->metaObject()->inherits(m_metaObject)) {
+        value = m_metaObject->property(condition.propertyIndex).read(object);
+    } else {
+        value = object->property(condition.property.constData());
+    }
+
+    if (!condition.value.isValid()) {
+        return condition.anyOf.contains(value.toString());
+    }
+    if (condition.value.typeId() == QMetaType::Bool) {
+        return value.toBool() == condition.value.toBool();
+    }
+    return value.toDouble() == condition.value.toDouble();
+}
+
+bool AnimationDescriptor::evaluate(const QList<Condition> &conditions, const QObject *object) const
+{
+    return std::ranges::all_of(conditions, [this, object](const Condition &condition) {
+        return evaluate(condition, object);
+    });
+}
+
+bool AnimationDescriptor::accepts(const QObject *window) const
+{
+    for (const Rule &rule : m_rules) {
+        if (evaluate(rule.conditions, window)) {
+            return rule.result;
+        }
+    }
+    return m_defaultResult;
+}
+
+bool AnimationDescriptor::matches(Event event, const QObject *window) const
+{
+    const Handler &eventHandler = handler(event);
+    return eventHandler.enabled && accepts(window) && evaluate(eventHandler.conditions, window);
+}
+
+const AnimationDescriptor::Handler &AnimationDescriptor::handler(Event event) const
+{
+    return m_handlers[int(event)];
+}
+
+QList<AnimationDescriptor::Rule> AnimationDescriptor::rules() const
+{
+    return m_rules;
+}
+
+bool AnimationDescriptor::defaultResult() const
+{
+    return m_defaultResult;
+}
+
+QString AnimationDescriptor::eventName(Event event)
+{
+    switch (event) {
+    case Event::WindowAdded:
+        return QStringLiteral("windowAdded");
+    case Event::WindowClosed:
+        return QStringLiteral("windowClosed");
+    case Event::WindowMinimized:
+        return QStringLiteral("windowMinimized");
+    case Event::WindowUnminimized:
+        return QStringLiteral("windowUnminimized");
+    }
+    Q_UNREACHABLE();
+}
+
+} // namespace KWin
@@ -0,0 +1,159 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "effect/animationeffect.h"
+
+#include <QEasingCurve>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+#include <QVariant>
+
+#include <array>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The AnimationDescriptor describes a scripted effect that only maps window events to
+ * animations, without any imperative logic.
+ *
+ * The descriptor is read from contents/code/animations.json in the effect package, whose
+ * X-Plasma-API is "declarativeanimation". It consists
+ * of an ordered list of filter rules that decide which windows the effect is interested in, and
+ * a handler per window event that lists the animations to start. The first rule whose conditions
+ * all match decides about a window, if none matches, the default result is used:
+ *
+ * @code
+ * {
+ *     "filter": {
+ *         "rules": [
+ *             { "when": { "windowClass": ["ksplashqml ksplashqml"] }, "result": false },
+ *             { "when": { "popupWindow": true }, "result": true }
+ *         ],
+ *         "default": false
+ *     },
+ *     "windowAdded": {
+ *         "when": { "visible": true },
+ *         "grab": true,
+ *         "animations": [
+ *             { "type": "Opacity", "duration": { "config": "FadeInTime", "default": 150 }, "from": 0, "to": 1 }
+ *         ]
+ *     }
+ * }
+ * @endcode
+ *
+ * Conditions refer to properties of the EffectWindow. A boolean or numeric value must be equal
+ * to the property, a list of strings must contain it. Durations are in milliseconds and get
+ * scaled by the global animation speed, just like animationTime() in scripts.
+ */
+class KWIN_EXPORT AnimationDescriptor
+{
+public:
+    enum class Event {
+        WindowAdded,
+        WindowClosed,
+        WindowMinimized,
+        WindowUnminimized,
+    };
+    static constexpr int EventCount = 4;
+
+    struct Condition
+    {
+        QByteArray property;
+        QVariant value;
+        QStringList anyOf;
+        int propertyIndex = -1;
+    };
+
+    struct Rule
+    {
+        QList<Condition> conditions;
+        bool result = false;
+    };
+
+    struct Duration
+    {
+        // The KConfigXT entry to read the duration from, the default is used if it's empty
+        QString configKey;
+        int defaultValue = 0;
+        int factor = 1;
+    };
+
+    struct Animation
+    {
+        AnimationEffect::Attribute type = AnimationEffect::Opacity;
+        Duration duration;
+        // An invalid value means the animation starts from the current state
+        FPx2 from;
+        FPx2 to;
+        QEasingCurve::Type curve = QEasingCurve::Linear;
+        uint metaData = 0;
+        int delay = 0;
+        bool fullScreen = false;
+        bool keepAlive = true;
+    };
+
+    struct Handler
+    {
+        bool enabled = false;
+        QList<Condition> conditions;
+        // Skip the window if another effect is the active fullscreen effect
+        bool skipDuringFullScreenEffect = true;
+        // Skip the window if another effect has grabbed it for this event
+        bool skipIfGrabbed = true;
+        // Grab the window for this event before animating it
+        bool grab = false;
+        // The animations started for these events are cancelled before this event is handled
+        QList<Event> cancels;
+        QList<Animation> animations;
+    };
+
+    /**
+     * Parses the descriptor in @p object. Returns an empty optional and sets @p error if the
+     * descriptor is malformed.
+     */
+    static std::optional<AnimationDescriptor> fromJson(const QJsonObject &object, QString *error = nullptr);
+    static std::optional<AnimationDescriptor> load(const QString &fileName, QString *error = nullptr);
+
+    /**
+     * Looks up the properties the conditions refer to in @p metaObject, so they don't have to be
+     * searched by name every time a window is matched. Objects of other types are still matched
+     * by name.
+     */
+    void resolve(const QMetaObject *metaObject);
+
+    /**
+     * Returns whether the effect is interested in @p window at all.
+     */
+    bool accepts(const QObject *window) const;
+    /**
+     * Returns whether @p window passes the filter and the conditions of the handler for @p event.
+     */
+    bool matches(Event event, const QObject *window) const;
+
+    const Handler &handler(Event event) const;
+    QList<Rule> rules() const;
+    bool defaultResult() const;
+
+    static QString eventName(Event event);
+
+private:
+    bool evaluate(const Condition &condition, const QObject *object) const;
+    bool evaluate(const QList<Condition> &conditions, const QObject *object) const;
+
+    const QMetaObject *m_metaObject = nullptr;
+    QList<Rule> m_rules;
+    bool m_defaultResult = true;
+    std::array<Handler, EventCount> m_handlers;
+};
+
+} // namespace KWin
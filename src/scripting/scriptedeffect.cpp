@@ -155,16 +155,24 @@ static KWin::FPx2 fpx2FromScriptValue(const QJSValue &value)
     return FPx2();
 }
 
+static QString locateEffectFile(const QString &effectName, const QString &relativePath)
+{
+    const QString fileName = QStandardPaths::locate(QStandardPaths::GenericDataLocation, KWIN_DATADIR + QLatin1String("/effects/") + effectName + relativePath);
+    if (!fileName.isEmpty()) {
+        return fileName;
+    }
+    return QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("kwin/effects/") + effectName + relativePath);
+}
+
 ScriptedEffect *ScriptedEffect::create(const KPluginMetaData &effect)
 {
     const QString name = effect.pluginId();
-    QString scriptFile = QStandardPaths::locate(QStandardPaths::GenericDataLocation, KWIN_DATADIR + QLatin1String("/effects/") + name + QLatin1String("/contents/code/main.js"));
+    // effects that only map window events to animations describe them instead of scripting them
+    const bool declarative = effect.value(QStringLiteral("X-Plasma-API")) == QLatin1String("declarativeanimation");
+    const QString scriptFile = locateEffectFile(name, declarative ? QStringLiteral("/contents/code/animations.json") : QStringLiteral("/contents/code/main.js"));
     if (scriptFile.isEmpty()) {
-        scriptFile = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("kwin/effects/") + name + QLatin1String("/contents/code/main.js"));
-        if (scriptFile.isEmpty()) {
-            qCDebug(KWIN_SCRIPTING) << "Could not locate effect script" << name;
-            return nullptr;
-        }
+        qCDebug(KWIN_SCRIPTING) << "Could not locate effect script" << name;
+        return nullptr;
     }
 
     return ScriptedEffect::create(name, scriptFile, effect.value(QStringLiteral("X-KDE-Ordering"), 0), effect.value(QStringLiteral("X-KWin-Exclusive-Category")));
@@ -190,7 +198,6 @@ bool ScriptedEffect::supported()
 
 ScriptedEffect::ScriptedEffect()
     : AnimationEffect()
-    , m_engine(new QJSEngine(this))
     , m_scriptFile(QString())
     , m_config(nullptr)
     , m_chainPosition(0)
@@ -224,10 +231,7 @@ bool ScriptedEffect::init(const QString &effectName, const QString &pathToScript
     m_scriptFile = pathToScript;
 
     // does the effect contain an KConfigXT file?
-    QString kconfigXTFile = QStandardPaths::locate(QStandardPaths::GenericDataLocation, KWIN_DATADIR + QLatin1String("/effects/") + m_effectName + QLatin1String("/contents/config/main.xml"));
-    if (kconfigXTFile.isNull()) {
-        kconfigXTFile = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("kwin/effects/") + m_effectName + QLatin1String("/contents/config/main.xml"));
-    }
+    const QString kconfigXTFile = locateEffectFile(m_effectName, QStringLiteral("/contents/config/main.xml"));
     if (!kconfigXTFile.isNull()) {
         KConfigGroup cg = QCoreApplication::instance()->property("config").value<KSharedConfigPtr>()->group(QStringLiteral("Effect-%1").arg(m_effectName));
         QFile xmlFile(kconfigXTFile);
@@ -235,26 +239,35 @@ bool ScriptedEffect::init(const QString &effectName, const QString &pathToScript
         m_config->load();
     }
 
-    m_engine->installExtensions(QJSEngine::ConsoleExtension);
+    if (pathToScript.endsWith(QLatin1String(".json"))) {
+        return initDescriptor(scriptFile);
+    }
+    return initScript(scriptFile);
+}
+
+bool ScriptedEffect::initScript(QFile &scriptFile)
+{
+    QJSEngine *engine = this->engine();
+    engine->installExtensions(QJSEngine::ConsoleExtension);
 
-    QJSValue globalObject = m_engine->globalObject();
+    QJSValue globalObject = engine->globalObject();
 
-    QJSValue effectsObject = m_engine->newQObject(effects);
+    QJSValue effectsObject = engine->newQObject(effects);
     QJSEngine::setObjectOwnership(effects, QJSEngine::CppOwnership);
     globalObject.setProperty(QStringLiteral("effects"), effectsObject);
 
-    QJSValue selfObject = m_engine->newQObject(this);
+    QJSValue selfObject = engine->newQObject(this);
     QJSEngine::setObjectOwnership(this, QJSEngine::CppOwnership);
     globalObject.setProperty(QStringLiteral("effect"), selfObject);
 
     globalObject.setProperty(QStringLiteral("Effect"),
-                             m_engine->newQMetaObject(&ScriptedEffect::staticMetaObject));
+                             engine->newQMetaObject(&ScriptedEffect::staticMetaObject));
     globalObject.setProperty(QStringLiteral("KWin"),
-                             m_engine->newQMetaObject(&QtScriptWorkspaceWrapper::staticMetaObject));
+                             engine->newQMetaObject(&QtScriptWorkspaceWrapper::staticMetaObject));
     globalObject.setProperty(QStringLiteral("Globals"),
-                             m_engine->newQMetaObject(&KWin::staticMetaObject));
+                             engine->newQMetaObject(&KWin::staticMetaObject));
     globalObject.setProperty(QStringLiteral("QEasingCurve"),
-                             m_engine->newQMetaObject(&QEasingCurve::staticMetaObject));
+                             engine->newQMetaObject(&QEasingCurve::staticMetaObject));
 
     static const QStringList globalProperties{
         QStringLiteral("animationTime"),
@@ -283,7 +296,7 @@ bool ScriptedEffect::init(const QString &effectName, const QString &pathToScript
         globalObject.setProperty(propertyName, selfObject.property(propertyName));
     }
 
-    const QJSValue result = m_engine->evaluate(QString::fromUtf8(scriptFile.readAll()));
+    const QJSValue result = engine->evaluate(QString::fromUtf8(scriptFile.readAll()));
 
     if (result.isError()) {
         qCWarning(KWIN_SCRIPTING, "%s:%d: error: %s", qPrintable(scriptFile.fileName()),
@@ -295,6 +308,129 @@ bool ScriptedEffect::init(const QString &effectName, const QString &pathToScript
     return true;
 }
 
+bool ScriptedEffect::initDescriptor(QFile &descriptorFile)
+{
+    QString error;
+    m_descriptor = AnimationDescriptor::load(descriptorFile.fileName(), &error);
+    if (!m_descriptor) {
+        qCWarning(KWIN_SCRIPTING, "%s: error: %s", qPrintable(descriptorFile.fileName()), qPrintable(error));
+        return false;
+    }
+    m_descriptor->resolve(&EffectWindow::staticMetaObject);
+
+    connect(effects, &EffectsHandler::windowAdded, this, [this](EffectWindow *window) {
+        watchMinimized(window);
+        handleDescriptorEvent(window, AnimationDescriptor::Event::WindowAdded);
+    });
+    connect(effects, &EffectsHandler::windowClosed, this, [this](EffectWindow *window) {
+        handleDescriptorEvent(window, AnimationDescriptor::Event::WindowClosed);
+    });
+    connect(effects, &EffectsHandler::windowDataChanged, this, &ScriptedEffect::handleDescriptorDataChanged);
+    connect(effects, &EffectsHandler::windowDeleted, this, [this](EffectWindow *window) {
+        m_descriptorAnimations.remove(window);
+    });
+
+    const QList<EffectWindow *> windows = effects->stackingOrder();
+    for (EffectWindow *window : windows) {
+        watchMinimized(window);
+    }
+
+    return true;
+}
+
+void ScriptedEffect::watchMinimized(EffectWindow *window)
+{
+    if (!m_descriptor->handler(AnimationDescriptor::Event::WindowMinimized).enabled
+        && !m_descriptor->handler(AnimationDescriptor::Event::WindowUnminimized).enabled) {
+        return;
+    }
+    connect(window, &EffectWindow::minimizedChanged, this, [this](EffectWindow *window) {
+        handleDescriptorEvent(window, window->isMinimized() ? AnimationDescriptor::Event::WindowMinimized : AnimationDescriptor::Event::WindowUnminimized);
+    });
+}
+
+static ScriptedEffect::DataRole grabRoleForEvent(AnimationDescriptor::Event event)
+{
+    switch (event) {
+    case AnimationDescriptor::Event::WindowAdded:
+        return ScriptedEffect::WindowAddedGrabRole;
+    case AnimationDescriptor::Event::WindowClosed:
+        return ScriptedEffect::WindowClosedGrabRole;
+    case AnimationDescriptor::Event::WindowMinimized:
+        return ScriptedEffect::WindowMinimizedGrabRole;
+    case AnimationDescriptor::Event::WindowUnminimized:
+        return ScriptedEffect::WindowUnminimizedGrabRole;
+    }
+    Q_UNREACHABLE();
+}
+
+void ScriptedEffect::handleDescriptorEvent(EffectWindow *window, AnimationDescriptor::Event event)
+{
+    const AnimationDescriptor::Handler &handler = m_descriptor->handler(event);
+    if (!handler.enabled) {
+        return;
+    }
+    if (handler.skipDuringFullScreenEffect && effects->hasActiveFullScreenEffect()) {
+        return;
+    }
+    if (!m_descriptor->matches(event, window)) {
+        return;
+    }
+
+    const DataRole grabRole = grabRoleForEvent(event);
+    if (handler.skipIfGrabbed && isGrabbed(window, grabRole)) {
+        return;
+    }
+    if (handler.grab && !grab(window, grabRole)) {
+        return;
+    }
+
+    auto &animations = m_descriptorAnimations[window];
+    for (const AnimationDescriptor::Event cancelled : handler.cancels) {
+        cancel(std::exchange(animations[int(cancelled)], {}));
+    }
+
+    QList<quint64> &animationIds = animations[int(event)];
+    animationIds.clear();
+    for (const AnimationDescriptor::Animation &animation : handler.animations) {
+        animationIds.append(AnimationEffect::animate(window, animation.type, animation.metaData, descriptorDuration(animation.duration),
+                                                     animation.to, QEasingCurve(animation.curve), animation.delay, animation.from,
+                                                     animation.fullScreen, animation.keepAlive));
+    }
+}
+
+void ScriptedEffect::handleDescriptorDataChanged(EffectWindow *window, int role)
+{
+    if (role < WindowAddedGrabRole || role > WindowUnminimizedGrabRole) {
+        return;
+    }
+    // another effect took over the window, it animates the window on its own
+    if (!isGrabbed(window, static_cast<DataRole>(role))) {
+        return;
+    }
+    const auto it = m_descriptorAnimations.find(window);
+    if (it != m_descriptorAnimations.end()) {
+        cancel(std::exchange((*it)[role - WindowAddedGrabRole], {}));
+    }
+}
+
+int ScriptedEffect::descriptorDuration(const AnimationDescriptor::Duration &duration) const
+{
+    int milliseconds = duration.defaultValue;
+    if (m_config && !duration.configKey.isEmpty()) {
+        const QVariant value = m_config->property(duration.configKey);
+        if (value.isValid()) {
+            milliseconds = value.toInt();
+        }
+    }
+    return animationTime(milliseconds) * duration.factor;
+}
+
+bool ScriptedEffect::isDeclarative() const
+{
+    return m_descriptor.has_value();
+}
+
 void ScriptedEffect::animationEnded(KWin::EffectWindow *w, Attribute a, uint meta)
 {
     AnimationEffect::animationEnded(w, a, meta);
@@ -333,13 +469,13 @@ QJSValue ScriptedEffect::animate_helper(const QJSValue &object, AnimationType an
 {
     QJSValue windowProperty = object.property(QStringLiteral("window"));
     if (!windowProperty.isObject()) {
-        m_engine->throwError(QStringLiteral("Window property missing in animation options"));
+        engine()->throwError(QStringLiteral("Window property missing in animation options"));
         return QJSValue();
     }
 
     EffectWindow *window = qobject_cast<EffectWindow *>(windowProperty.toQObject());
     if (!window) {
-        m_engine->throwError(QStringLiteral("Window property references invalid window"));
+        engine()->throwError(QStringLiteral("Window property references invalid window"));
         return QJSValue();
     }
 
@@ -348,7 +484,7 @@ QJSValue ScriptedEffect::animate_helper(const QJSValue &object, AnimationType an
     QJSValue animations = object.property(QStringLiteral("animations")); // array
     if (!animations.isUndefined()) {
         if (!animations.isArray()) {
-            m_engine->throwError(QStringLiteral("Animations provided but not an array"));
+            engine()->throwError(QStringLiteral("Animations provided but not an array"));
             return QJSValue();
         }
 
@@ -360,11 +496,11 @@ QJSValue ScriptedEffect::animate_helper(const QJSValue &object, AnimationType an
                 const uint set = s.set | settings.at(0).set;
                 // Catch show stoppers (incompletable animation)
                 if (!(set & AnimationSettings::Type)) {
-                    m_engine->throwError(QStringLiteral("Type property missing in animation options"));
+                    engine()->throwError(QStringLiteral("Type property missing in animation options"));
                     return QJSValue();
                 }
                 if (!(set & AnimationSettings::Duration)) {
-                    m_engine->throwError(QStringLiteral("Duration property missing in animation options"));
+                    engine()->throwError(QStringLiteral("Duration property missing in animation options"));
                     return QJSValue();
                 }
                 // Complete local animations from global settings
@@ -409,11 +545,11 @@ QJSValue ScriptedEffect::animate_helper(const QJSValue &object, AnimationType an
                     auto uniformProperty = value.property(QStringLiteral("uniform")).toString();
                     auto shader = findShader(s.shader.value());
                     if (!shader) {
-                        m_engine->throwError(QStringLiteral("Shader for given shaderId not found"));
+                        engine()->throwError(QStringLiteral("Shader for given shaderId not found"));
                         return {};
                     }
                     if (!effects->makeOpenGLContextCurrent()) {
-                        m_engine->throwError(QStringLiteral("Failed to make OpenGL context current"));
+                        engine()->throwError(QStringLiteral("Failed to make OpenGL context current"));
                         return {};
                     }
                     ShaderBinder binder{shader};
@@ -428,11 +564,11 @@ QJSValue ScriptedEffect::animate_helper(const QJSValue &object, AnimationType an
     if (settings.count() == 1) {
         const uint set = settings.at(0).set;
         if (!(set & AnimationSettings::Type)) {
-            m_engine->throwError(QStringLiteral("Type property missing in animation options"));
+            engine()->throwError(QStringLiteral("Type property missing in animation options"));
             return QJSValue();
         }
         if (!(set & AnimationSettings::Duration)) {
-            m_engine->throwError(QStringLiteral("Duration property missing in animation options"));
+            engine()->throwError(QStringLiteral("Duration property missing in animation options"));
             return QJSValue();
         }
     } else if (!(settings.at(0).set & AnimationSettings::Type)) { // invalid global
@@ -440,11 +576,11 @@ QJSValue ScriptedEffect::animate_helper(const QJSValue &object, AnimationType an
     }
 
     if (settings.isEmpty()) {
-        m_engine->throwError(QStringLiteral("No animations provided"));
+        engine()->throwError(QStringLiteral("No animations provided"));
         return QJSValue();
     }
 
-    QJSValue array = m_engine->newArray(settings.length());
+    QJSValue array = engine()->newArray(settings.length());
     for (int i = 0; i < settings.count(); i++) {
         const AnimationSettings &setting = settings[i];
         int animationId;
@@ -642,7 +778,7 @@ void ScriptedEffect::registerShortcut(const QString &objectName, const QString &
                                       const QString &keySequence, const QJSValue &callback)
 {
     if (!callback.isCallable()) {
-        m_engine->throwError(QStringLiteral("Shortcut handler must be callable"));
+        engine()->throwError(QStringLiteral("Shortcut handler must be callable"));
         return;
     }
     QAction *action = new QAction(this);
@@ -651,7 +787,7 @@ void ScriptedEffect::registerShortcut(const QString &objectName, const QString &
     const QKeySequence shortcut = QKeySequence(keySequence);
     KGlobalAccel::self()->setShortcut(action, QList<QKeySequence>() << shortcut);
     connect(action, &QAction::triggered, this, [this, action, callback]() {
-        QJSValue actionObject = m_engine->newQObject(action);
+        QJSValue actionObject = engine()->newQObject(action);
         QJSEngine::setObjectOwnership(action, QJSEngine::CppOwnership);
         QJSValue(callback).call(QJSValueList{actionObject});
     });
@@ -673,7 +809,7 @@ QJSValue ScriptedEffect::readConfig(const QString &key, const QJSValue &defaultV
     if (!m_config) {
         return defaultValue;
     }
-    return m_engine->toScriptValue(m_config->property(key));
+    return engine()->toScriptValue(m_config->property(key));
 }
 
 int ScriptedEffect::displayWidth() const
@@ -694,7 +830,7 @@ int ScriptedEffect::animationTime(int defaultTime) const
 bool ScriptedEffect::registerScreenEdge(int edge, const QJSValue &callback)
 {
     if (!callback.isCallable()) {
-        m_engine->throwError(QStringLiteral("Screen edge handler must be callable"));
+        engine()->throwError(QStringLiteral("Screen edge handler must be callable"));
         return false;
     }
     auto it = screenEdgeCallbacks().find(edge);
@@ -711,7 +847,7 @@ bool ScriptedEffect::registerScreenEdge(int edge, const QJSValue &callback)
 bool ScriptedEffect::registerRealtimeScreenEdge(int edge, const QJSValue &callback)
 {
     if (!callback.isCallable()) {
-        m_engine->throwError(QStringLiteral("Screen edge handler must be callable"));
+        engine()->throwError(QStringLiteral("Screen edge handler must be callable"));
         return false;
     }
     auto it = realtimeScreenEdgeCallbacks().find(edge);
@@ -731,11 +867,11 @@ bool ScriptedEffect::registerRealtimeScreenEdge(int edge, const QJSValue &callba
             auto it = realtimeScreenEdgeCallbacks().constFind(border);
             if (it != realtimeScreenEdgeCallbacks().constEnd()) {
                 for (const QJSValue &callback : it.value()) {
-                    QJSValue delta = m_engine->newObject();
+                    QJSValue delta = engine()->newObject();
                     delta.setProperty("width", deltaProgress.x());
                     delta.setProperty("height", deltaProgress.y());
 
-                    QJSValue(callback).call({border, QJSValue(delta), m_engine->newQObject(screen)});
+                    QJSValue(callback).call({border, QJSValue(delta), engine()->newQObject(screen)});
                 }
             }
         });
@@ -763,7 +899,7 @@ bool ScriptedEffect::registerTouchScreenEdge(int edge, const QJSValue &callback)
         return false;
     }
     if (!callback.isCallable()) {
-        m_engine->throwError(QStringLiteral("Touch screen edge handler must be callable"));
+        engine()->throwError(QStringLiteral("Touch screen edge handler must be callable"));
         return false;
     }
     QAction *action = new QAction(this);
@@ -788,13 +924,16 @@ bool ScriptedEffect::unregisterTouchScreenEdge(int edge)
 
 QJSEngine *ScriptedEffect::engine() const
 {
+    if (!m_engine) {
+        m_engine = new QJSEngine(const_cast<ScriptedEffect *>(this));
+    }
     return m_engine;
 }
 
 uint ScriptedEffect::addFragmentShader(ShaderTrait traits, const QString &fragmentShaderFile)
 {
     if (!effects->makeOpenGLContextCurrent()) {
-        m_engine->throwError(QStringLiteral("Failed to make OpenGL context current"));
+        engine()->throwError(QStringLiteral("Failed to make OpenGL context current"));
         return 0;
     }
 
@@ -808,7 +947,7 @@ uint ScriptedEffect::addFragmentShader(ShaderTrait traits, const QString &fragme
 
     auto shader = ShaderManager::instance()->generateShaderFromFile(static_cast<KWin::ShaderTraits>(int(traits)), {}, fragment);
     if (!shader->isValid()) {
-        m_engine->throwError(QStringLiteral("Shader failed to load"));
+        engine()->throwError(QStringLiteral("Shader failed to load"));
         // 0 is never a valid shader identifier, it's ensured the first shader gets id 1
         return 0;
     }
@@ -831,11 +970,11 @@ void ScriptedEffect::setUniform(uint shaderId, const QString &name, const QJSVal
 {
     auto shader = findShader(shaderId);
     if (!shader) {
-        m_engine->throwError(QStringLiteral("Shader for given shaderId not found"));
+        engine()->throwError(QStringLiteral("Shader for given shaderId not found"));
         return;
     }
     if (!effects->makeOpenGLContextCurrent()) {
-        m_engine->throwError(QStringLiteral("Failed to make OpenGL context current"));
+        engine()->throwError(QStringLiteral("Failed to make OpenGL context current"));
         return;
     }
     auto setColorUniform = [this, shader, name](const QColor &color) {
@@ -843,7 +982,7 @@ void ScriptedEffect::setUniform(uint shaderId, const QString &name, const QJSVal
             return;
         }
         if (!shader->setUniform(name.toUtf8().constData(), color)) {
-            m_engine->throwError(QStringLiteral("Failed to set uniform ") + name);
+            engine()->throwError(QStringLiteral("Failed to set uniform ") + name);
         }
     };
     ShaderBinder binder{shader};
@@ -851,30 +990,30 @@ void ScriptedEffect::setUniform(uint shaderId, const QString &name, const QJSVal
         setColorUniform(value.toString());
     } else if (value.isNumber()) {
         if (!shader->setUniform(name.toUtf8().constData(), float(value.toNumber()))) {
-            m_engine->throwError(QStringLiteral("Failed to set uniform ") + name);
+            engine()->throwError(QStringLiteral("Failed to set uniform ") + name);
         }
     } else if (value.isArray()) {
         const auto length = value.property(QStringLiteral("length")).toInt();
         if (length == 2) {
             if (!shader->setUniform(name.toUtf8().constData(), QVector2D{float(value.property(0).toNumber()), float(value.property(1).toNumber())})) {
-                m_engine->throwError(QStringLiteral("Failed to set uniform ") + name);
+                engine()->throwError(QStringLiteral("Failed to set uniform ") + name);
             }
         } else if (length == 3) {
             if (!shader->setUniform(name.toUtf8().constData(), QVector3D{float(value.property(0).toNumber()), float(value.property(1).toNumber()), float(value.property(2).toNumber())})) {
-                m_engine->throwError(QStringLiteral("Failed to set uniform ") + name);
+                engine()->throwError(QStringLiteral("Failed to set uniform ") + name);
             }
         } else if (length == 4) {
             if (!shader->setUniform(name.toUtf8().constData(), QVector4D{float(value.property(0).toNumber()), float(value.property(1).toNumber()), float(value.property(2).toNumber()), float(value.property(3).toNumber())})) {
-                m_engine->throwError(QStringLiteral("Failed to set uniform ") + name);
+                engine()->throwError(QStringLiteral("Failed to set uniform ") + name);
             }
         } else {
-            m_engine->throwError(QStringLiteral("Invalid number of elements in array"));
+            engine()->throwError(QStringLiteral("Invalid number of elements in array"));
         }
     } else if (value.isVariant()) {
         const auto variant = value.toVariant();
         setColorUniform(variant.value<QColor>());
     } else {
-        m_engine->throwError(QStringLiteral("Invalid value provided for uniform"));
+        engine()->throwError(QStringLiteral("Invalid value provided for uniform"));
     }
 }
 
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "effect/animationeffect.h"
+#include "scripting/animationdescriptor.h"
 
 #include <QJSEngine>
 #include <QJSValue>
@@ -19,6 +20,7 @@ class KConfigLoader;
 class KPluginMetaData;
 
 class QAction;
+class QFile;
 
 namespace KWin
 {
@@ -181,6 +183,12 @@ public:
     QString pluginId() const;
     bool isActiveFullScreenEffect() const;
 
+    /**
+     * Whether the effect is driven by an animation descriptor rather than by a script. Such
+     * effects never create a JavaScript engine.
+     */
+    bool isDeclarative() const;
+
 public Q_SLOTS:
     bool borderActivated(ElectricBorder border) override;
 
@@ -194,6 +202,9 @@ Q_SIGNALS:
 
 protected:
     ScriptedEffect();
+    /**
+     * Returns the JavaScript engine of the effect, it is created on first use.
+     */
     QJSEngine *engine() const;
     bool init(const QString &effectName, const QString &pathToScript);
     void animationEnded(KWin::EffectWindow *w, Attribute a, uint meta) override;
@@ -208,7 +219,16 @@ private:
 
     GLShader *findShader(uint shaderId) const;
 
-    QJSEngine *m_engine;
+    bool initScript(QFile &scriptFile);
+    bool initDescriptor(QFile &descriptorFile);
+    void handleDescriptorEvent(EffectWindow *window, AnimationDescriptor::Event event);
+    void handleDescriptorDataChanged(EffectWindow *window, int role);
+    void watchMinimized(EffectWindow *window);
+    int descriptorDuration(const AnimationDescriptor::Duration &duration) const;
+
+    mutable QJSEngine *m_engine = nullptr;
+    std::optional<AnimationDescriptor> m_descriptor;
+    QHash<EffectWindow *, std::array<QList<quint64>, AnimationDescriptor::EventCount>> m_descriptorAnimations;
     QString m_effectName;
     QString m_scriptFile;
     QString m_exclusiveCategory;
@@ -28,6 +28,9 @@
 #include <QSGImageNode>
 #include <QSGTextureProvider>
 
+#include <algorithm>
+#include <list>
+
 namespace KWin
 {
 
@@ -37,11 +40,98 @@ static bool useGlThumbnails()
     return Compositor::self()->backend() && Compositor::self()->backend()->compositingType() == OpenGLCompositing && !qtQuickIsSoftware;
 }
 
+/**
+ * Keeps the last contents of thumbnails that went away, for example because the window switcher
+ * rebuilt its delegates, so a thumbnail that comes back can be shown before it is rendered again.
+ */
+class ThumbnailTextureCache
+{
+public:
+    using Key = std::pair<QQuickWindow *, Window *>;
+
+    static void insert(const Key &key, const std::shared_ptr<GLTexture> &texture);
+    static std::shared_ptr<GLTexture> take(const Key &key);
+    static void remove(const Key &key);
+
+private:
+    static void clear();
+
+    struct Entry
+    {
+        Key key;
+        std::shared_ptr<GLTexture> texture;
+    };
+    static const size_t s_maxEntries = 16;
+    static inline std::list<Entry> s_entries;
+    static inline QPointer<WorkspaceScene> s_scene;
+};
+
+void ThumbnailTextureCache::insert(const Key &key, const std::shared_ptr<GLTexture> &texture)
+{
+    // thumbnails that go away because compositing stops or is suspended must not leave their
+    // textures behind, the OpenGL context may be gone by the time they'd be shown again
+    if (!Compositor::compositing()) {
+        return;
+    }
+
+    // the textures belong to the OpenGL context of the scene, they go away together with it
+    WorkspaceScene *scene = Compositor::self()->scene();
+    if (s_scene != scene) {
+        clear();
+        s_scene = scene;
+        QObject::connect(scene, &QObject::destroyed, &ThumbnailTextureCache::clear);
+    }
+
+    remove(key);
+    s_entries.push_front(Entry{
+        .key = key,
+        .texture = texture,
+    });
+    if (s_entries.size() > s_maxEntries) {
+        s_entries.pop_back();
+    }
+}
+
+std::shared_ptr<GLTexture> ThumbnailTextureCache::take(const Key &key)
+{
+    const auto it = std::ranges::find(s_entries, key, &Entry::key);
+    if (it == s_entries.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<GLTexture> texture = std::move(it->texture);
+    s_entries.erase(it);
+    return texture;
+}
+
+void ThumbnailTextureCache::remove(const Key &key)
+{
+    const auto it = std::ranges::find(s_entries, key, &Entry::key);
+    if (it == s_entries.end()) {
+        return;
+    }
+    if (!QOpenGLContext::currentContext()) {
+        Compositor::self()->scene()->makeOpenGLContextCurrent();
+    }
+    s_entries.erase(it);
+}
+
+void ThumbnailTextureCache::clear()
+{
+    if (s_entries.empty()) {
+        return;
+    }
+    // the compositor makes the context current before it destroys the scene
+    if (!QOpenGLContext::currentContext() && Compositor::self()->scene()) {
+        Compositor::self()->scene()->makeOpenGLContextCurrent();
+    }
+    s_entries.clear();
+}
+
 WindowThumbnailSource::WindowThumbnailSource(QQuickWindow *view, Window *handle)
     : m_view(view)
     , m_handle(handle)
 {
-    connect(handle, &Window::frameGeometryChanged, this, [this]() {
+    connect(handle, &Window::coalescedFrameGeometryChanged, this, [this]() {
         m_dirty = true;
         Q_EMIT changed();
     });
@@ -52,13 +142,20 @@ WindowThumbnailSource::WindowThumbnailSource(QQuickWindow *view, Window *handle)
 
     connect(Compositor::self()->scene(), &WorkspaceScene::preFrameRender, this, &WindowThumbnailSource::update);
 
-    m_handle->refOffscreenRendering();
+    // show what the window looked like the last time until it is rendered again
+    m_offscreenTexture = ThumbnailTextureCache::take({view, handle});
+    if (m_offscreenTexture) {
+        m_offscreenTarget = std::make_unique<GLFramebuffer>(m_offscreenTexture.get());
+    }
+
+    // a hidden view, e.g. the window switcher between two uses, doesn't keep the window live
+    connect(view, &QWindow::visibleChanged, this, &WindowThumbnailSource::updateOffscreenRendering);
+    updateOffscreenRendering();
 }
 
 WindowThumbnailSource::~WindowThumbnailSource()
 {
-
-    if (m_handle) {
+    if (m_handle && m_offscreenRendering) {
         m_handle->unrefOffscreenRendering();
     }
 
@@ -69,6 +166,9 @@ WindowThumbnailSource::~WindowThumbnailSource()
         Compositor::self()->scene()->makeOpenGLContextCurrent();
     }
     m_offscreenTarget.reset();
+    if (m_view && m_handle) {
+        ThumbnailTextureCache::insert({m_view, m_handle}, m_offscreenTexture);
+    }
     m_offscreenTexture.reset();
 
     if (m_acquireFence) {
@@ -93,13 +193,40 @@ std::shared_ptr<WindowThumbnailSource> WindowThumbnailSource::getOrCreate(QQuick
 
     QObject::connect(handle, &Window::destroyed, [key]() {
         sources.erase(key);
+        ThumbnailTextureCache::remove(key);
     });
     QObject::connect(window, &QQuickWindow::destroyed, [key]() {
         sources.erase(key);
+        ThumbnailTextureCache::remove(key);
     });
     return s;
 }
 
+bool WindowThumbnailSource::isViewHidden() const
+{
+    return m_view->handle() && !m_view->isVisible();
+}
+
+void WindowThumbnailSource::updateOffscreenRendering()
+{
+    if (!m_handle || !m_view) {
+        return;
+    }
+    const bool offscreenRendering = !isViewHidden();
+    if (m_offscreenRendering == offscreenRendering) {
+        return;
+    }
+    m_offscreenRendering = offscreenRendering;
+    if (offscreenRendering) {
+        m_handle->refOffscreenRendering();
+        // the window may have changed while the view was hidden
+        m_dirty = true;
+        Q_EMIT changed();
+    } else {
+        m_handle->unrefOffscreenRendering();
+    }
+}
+
 WindowThumbnailSource::Frame WindowThumbnailSource::acquire()
 {
     return Frame{
@@ -114,6 +241,10 @@ void WindowThumbnailSource::update()
         return;
     }
     Q_ASSERT(m_view);
+    // a hidden view, e.g. the window switcher between two uses, is refreshed once it is shown
+    if (isViewHidden()) {
+        return;
+    }
 
     const QRectF geometry = m_handle->visibleGeometry();
     const qreal devicePixelRatio = m_view->devicePixelRatio();
@@ -365,12 +496,12 @@ void WindowThumbnailItem::setClient(Window *client)
         return;
     }
     if (m_client) {
-        disconnect(m_client, &Window::frameGeometryChanged,
+        disconnect(m_client, &Window::coalescedFrameGeometryChanged,
                    this, &WindowThumbnailItem::updateImplicitSize);
     }
     m_client = client;
     if (m_client) {
-        connect(m_client, &Window::frameGeometryChanged,
+        connect(m_client, &Window::coalescedFrameGeometryChanged,
                 this, &WindowThumbnailItem::updateImplicitSize);
         setWId(m_client->internalId());
     } else {
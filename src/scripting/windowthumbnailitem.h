@@ -43,9 +43,12 @@ Q_SIGNALS:
 
 private:
     void update();
+    bool isViewHidden() const;
+    void updateOffscreenRendering();
 
     QPointer<QQuickWindow> m_view;
     QPointer<Window> m_handle;
+    bool m_offscreenRendering = false;
 
     std::shared_ptr<GLTexture> m_offscreenTexture;
     std::unique_ptr<GLFramebuffer> m_offscreenTarget;
@@ -272,31 +272,39 @@ QImage Shadow::decorationShadowImage() const
 QSizeF Shadow::elementSize(Shadow::ShadowElements element) const
 {
     if (m_decorationShadow) {
-        switch (element) {
-        case ShadowElementTop:
-            return m_decorationShadow->topGeometry().size();
-        case ShadowElementTopRight:
-            return m_decorationShadow->topRightGeometry().size();
-        case ShadowElementRight:
-            return m_decorationShadow->rightGeometry().size();
-        case ShadowElementBottomRight:
-            return m_decorationShadow->bottomRightGeometry().size();
-        case ShadowElementBottom:
-            return m_decorationShadow->bottomGeometry().size();
-        case ShadowElementBottomLeft:
-            return m_decorationShadow->bottomLeftGeometry().size();
-        case ShadowElementLeft:
-            return m_decorationShadow->leftGeometry().size();
-        case ShadowElementTopLeft:
-            return m_decorationShadow->topLeftGeometry().size();
-        default:
-            return QSize();
-        }
+        return decorationElementGeometry(element).size();
     } else {
         return m_shadowElements[element].size();
     }
 }
 
+QRectF Shadow::decorationElementGeometry(Shadow::ShadowElements element) const
+{
+    if (!m_decorationShadow) {
+        return QRectF();
+    }
+    switch (element) {
+    case ShadowElementTop:
+        return m_decorationShadow->topGeometry();
+    case ShadowElementTopRight:
+        return m_decorationShadow->topRightGeometry();
+    case ShadowElementRight:
+        return m_decorationShadow->rightGeometry();
+    case ShadowElementBottomRight:
+        return m_decorationShadow->bottomRightGeometry();
+    case ShadowElementBottom:
+        return m_decorationShadow->bottomGeometry();
+    case ShadowElementBottomLeft:
+        return m_decorationShadow->bottomLeftGeometry();
+    case ShadowElementLeft:
+        return m_decorationShadow->leftGeometry();
+    case ShadowElementTopLeft:
+        return m_decorationShadow->topLeftGeometry();
+    default:
+        return QRectF();
+    }
+}
+
 } // namespace
 
 #include "moc_shadow.cpp"
@@ -98,6 +98,10 @@ public:
         ShadowElementsCount
     };
     QSizeF elementSize(ShadowElements element) const;
+    /**
+     * Returns where the given @a element is in the decorationShadowImage().
+     */
+    QRectF decorationElementGeometry(ShadowElements element) const;
 
     QRectF rect() const
     {
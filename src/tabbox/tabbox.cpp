@@ -326,6 +326,8 @@ TabBox::TabBox()
 
     m_tabBoxMode = TabBoxWindowsMode; // init variables
     connect(&m_delayedShowTimer, &QTimer::timeout, this, &TabBox::show);
+    m_prepareTimer.setSingleShot(true);
+    connect(&m_prepareTimer, &QTimer::timeout, this, &TabBox::prepare);
     connect(Workspace::self(), &Workspace::configChanged, this, &TabBox::reconfigure);
 }
 
@@ -566,6 +568,24 @@ void TabBox::reconfigure()
     };
     touchConfig(QStringLiteral("TouchBorderActivate"), m_touchActivate, TabBoxWindowsMode);
     touchConfig(QStringLiteral("TouchBorderAlternativeActivate"), m_touchAlternativeActivate, TabBoxWindowsAlternativeMode);
+
+    // load the switcher once things have calmed down after startup or a change of the layout,
+    // rather than when the user is waiting for it
+    m_prepareTimer.start(std::chrono::seconds(2));
+}
+
+void TabBox::prepare()
+{
+    if (isDisplayed() || m_delayedShowTimer.isActive()) {
+        return;
+    }
+    m_tabBox->setConfig(m_defaultConfig);
+    m_tabBox->prepare();
+}
+
+TabBoxHandler::ShowStatistics TabBox::showStatistics() const
+{
+    return m_tabBox->showStatistics();
 }
 
 void TabBox::loadConfig(const KConfigGroup &config, TabBoxConfig &tabBoxConfig)
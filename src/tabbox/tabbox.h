@@ -207,6 +207,11 @@ public:
     }
     void setCurrentIndex(QModelIndex index, bool notifyEffects = true);
 
+    /**
+     * Returns how long it took the switcher to show up the last time it was shown.
+     */
+    TabBoxHandler::ShowStatistics showStatistics() const;
+
 public Q_SLOTS:
     /**
      * Notify effects that the tab box is being shown, and only display the
@@ -260,6 +265,7 @@ private:
     void shadeActivate(Window *c);
 
     bool toggleMode(TabBoxMode mode);
+    void prepare();
 
 private Q_SLOTS:
     void reconfigure();
@@ -271,6 +277,7 @@ private:
     int m_delayShowTime;
 
     QTimer m_delayedShowTimer;
+    QTimer m_prepareTimer;
     int m_displayRefcount;
 
     TabBoxConfig m_defaultConfig;
@@ -17,6 +17,7 @@
 #include "tabbox_logging.h"
 #include "window.h"
 // Qt
+#include <QElapsedTimer>
 #include <QKeyEvent>
 #include <QQmlComponent>
 #include <QQmlContext>
@@ -54,8 +55,15 @@ public:
     void endHighlightWindows(bool abort = false);
 
     void show();
+    /**
+     * Creates the switcher of the current layout and its window ahead of time, so that
+     * showing it doesn't have to.
+     */
+    void prepare();
     QQuickWindow *window() const;
     SwitcherItem *switcherItem() const;
+    static QQuickWindow *window(QObject *mainItem);
+    static SwitcherItem *switcherItem(QObject *mainItem);
 
     ClientModel *clientModel() const;
 
@@ -76,11 +84,16 @@ public:
     bool isShown;
     Window *lastRaisedClient, *lastRaisedClientSucc;
     int wheelAngleDelta = 0;
+    TabBoxHandler::ShowStatistics showStatistics;
+    QElapsedTimer showTimer;
+    bool awaitingFirstFrame = false;
 
 private:
     QObject *createSwitcherItem();
+    QObject *loadMainItem();
 };
 
+
 TabBoxHandlerPrivate::TabBoxHandlerPrivate(TabBoxHandler *q)
     : m_qmlContext()
     , m_qmlComponent(nullptr)
@@ -101,27 +114,37 @@ TabBoxHandlerPrivate::~TabBoxHandlerPrivate()
 
 QQuickWindow *TabBoxHandlerPrivate::window() const
 {
-    if (!m_mainItem) {
+    return window(m_mainItem);
+}
+
+QQuickWindow *TabBoxHandlerPrivate::window(QObject *mainItem)
+{
+    if (!mainItem) {
         return nullptr;
     }
-    if (QQuickWindow *w = qobject_cast<QQuickWindow *>(m_mainItem)) {
+    if (QQuickWindow *w = qobject_cast<QQuickWindow *>(mainItem)) {
         return w;
     }
-    return m_mainItem->findChild<QQuickWindow *>();
+    return mainItem->findChild<QQuickWindow *>();
 }
 
 #ifndef KWIN_UNIT_TEST
 SwitcherItem *TabBoxHandlerPrivate::switcherItem() const
 {
-    if (!m_mainItem) {
+    return switcherItem(m_mainItem);
+}
+
+SwitcherItem *TabBoxHandlerPrivate::switcherItem(QObject *mainItem)
+{
+    if (!mainItem) {
         return nullptr;
     }
-    if (SwitcherItem *i = qobject_cast<SwitcherItem *>(m_mainItem)) {
+    if (SwitcherItem *i = qobject_cast<SwitcherItem *>(mainItem)) {
         return i;
-    } else if (QQuickWindow *w = qobject_cast<QQuickWindow *>(m_mainItem)) {
+    } else if (QQuickWindow *w = qobject_cast<QQuickWindow *>(mainItem)) {
         return w->contentItem()->findChild<SwitcherItem *>();
     }
-    return m_mainItem->findChild<SwitcherItem *>();
+    return mainItem->findChild<SwitcherItem *>();
 }
 #endif
 
@@ -258,11 +281,20 @@ QObject *TabBoxHandlerPrivate::createSwitcherItem()
     }
     return nullptr;
 }
-#endif
 
-void TabBoxHandlerPrivate::show()
+// Hidden switchers keep their window and scene graph, so showing them again is cheap
+static bool isPersistent()
 {
-#ifndef KWIN_UNIT_TEST
+    static const bool persistent = qEnvironmentVariableIntValue("KWIN_X11_NO_PERSISTENT_TABBOX") == 0;
+    return persistent;
+}
+
+QObject *TabBoxHandlerPrivate::loadMainItem()
+{
+    if (QObject *mainItem = m_clientTabBoxes.value(config.layoutName())) {
+        return mainItem;
+    }
+
     if (!m_qmlContext) {
         qmlRegisterType<SwitcherItem>("org.kde.kwin", 3, 0, "TabBoxSwitcher");
         m_qmlContext = std::make_unique<QQmlContext>(Scripting::self()->qmlEngine());
@@ -270,21 +302,79 @@ void TabBoxHandlerPrivate::show()
     if (!m_qmlComponent) {
         m_qmlComponent = std::make_unique<QQmlComponent>(Scripting::self()->qmlEngine());
     }
-    auto findMainItem = [this](const QMap<QString, QObject *> &tabBoxes) -> QObject * {
-        auto it = tabBoxes.constFind(config.layoutName());
-        if (it != tabBoxes.constEnd()) {
-            return it.value();
-        }
+    QObject *mainItem = createSwitcherItem();
+    if (!mainItem) {
         return nullptr;
-    };
-    m_mainItem = nullptr;
-    m_mainItem = findMainItem(m_clientTabBoxes);
-    if (!m_mainItem) {
-        m_mainItem = createSwitcherItem();
-        if (!m_mainItem) {
-            return;
+    }
+
+    // When SwitcherItem gets hidden, hide also the window and forget the main item
+    if (SwitcherItem *item = switcherItem(mainItem)) {
+        QObject::connect(item, &SwitcherItem::visibleChanged, q, [this, mainItem, item]() {
+            if (item->isVisible()) {
+                return;
+            }
+            if (QQuickWindow *w = window(mainItem)) {
+                w->hide();
+                if (!isPersistent()) {
+                    w->destroy();
+                }
+            }
+            if (m_mainItem == mainItem) {
+                m_mainItem = nullptr;
+            }
+        });
+    }
+    if (QQuickWindow *w = window(mainItem)) {
+        QObject::connect(w, &QQuickWindow::frameSwapped, q, [this]() {
+            if (!awaitingFirstFrame) {
+                return;
+            }
+            awaitingFirstFrame = false;
+            showStatistics.count++;
+            showStatistics.lastFirstFrame = std::chrono::duration_cast<std::chrono::microseconds>(showTimer.durationElapsed());
+        });
+    }
+    return mainItem;
+}
+
+void TabBoxHandlerPrivate::prepare()
+{
+    if (isShown || !config.isShowTabBox() || !isPersistent()) {
+        return;
+    }
+    QObject *mainItem = loadMainItem();
+    if (QQuickWindow *w = window(mainItem)) {
+        w->create();
+    }
+
+    // the switchers of layouts that aren't configured anymore can let go of their windows
+    for (QObject *other : std::as_const(m_clientTabBoxes)) {
+        if (other == mainItem) {
+            continue;
         }
+        QQuickWindow *w = window(other);
+        if (w && !w->isVisible()) {
+            w->destroy();
+        }
+    }
+}
+#endif
+
+void TabBoxHandlerPrivate::show()
+{
+#ifndef KWIN_UNIT_TEST
+    const bool cached = m_clientTabBoxes.contains(config.layoutName());
+    m_mainItem = loadMainItem();
+    if (!m_mainItem) {
+        return;
     }
+    const QQuickWindow *mainWindow = window();
+    if (!cached || (mainWindow && !mainWindow->handle())) {
+        showStatistics.coldCount++;
+    }
+    showTimer.start();
+    awaitingFirstFrame = true;
+
     if (SwitcherItem *item = switcherItem()) {
         // In case the model isn't yet set (see below), index will be reset and therefore we
         // need to save the current index row (https://bugs.kde.org/show_bug.cgi?id=333511).
@@ -297,17 +387,6 @@ void TabBoxHandlerPrivate::show()
         item->setNoModifierGrab(q->noModifierGrab());
         Q_EMIT item->aboutToShow();
 
-        // When SwitcherItem gets hidden, destroy also the window and main item
-        QObject::connect(item, &SwitcherItem::visibleChanged, q, [this, item]() {
-            if (!item->isVisible()) {
-                if (QQuickWindow *w = window()) {
-                    w->hide();
-                    w->destroy();
-                }
-                m_mainItem = nullptr;
-            }
-        });
-
         // everything is prepared, so let's make the whole thing visible
         item->setVisible(true);
     }
@@ -346,6 +425,18 @@ void TabBoxHandler::setConfig(const TabBoxConfig &config)
     Q_EMIT configChanged();
 }
 
+void TabBoxHandler::prepare()
+{
+#ifndef KWIN_UNIT_TEST
+    d->prepare();
+#endif
+}
+
+TabBoxHandler::ShowStatistics TabBoxHandler::showStatistics() const
+{
+    return d->showStatistics;
+}
+
 void TabBoxHandler::show()
 {
     d->isShown = true;
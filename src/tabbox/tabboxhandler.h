@@ -16,6 +16,8 @@
 #include <QScopedPointer>
 #include <QString>
 
+#include <chrono>
+
 /**
  * @file
  * This file contains the classes which hide KWin core from tabbox.
@@ -199,6 +201,11 @@ public:
      * @see TabBoxConfig::isHighlightWindows
      */
     void show();
+    /**
+     * Loads the TabBoxView of the current layout without showing it, so that the next
+     * show() finds it ready. Does nothing while the TabBoxView is shown.
+     */
+    void prepare();
     /**
      * Hides the TabBoxView if shown.
      * Deactivates highlight windows effect if active.
@@ -279,6 +286,17 @@ public:
      */
     virtual bool noModifierGrab() const = 0;
 
+    struct ShowStatistics
+    {
+        /// The number of times the TabBoxView was shown and painted its first frame
+        uint count = 0;
+        /// The number of times the TabBoxView or its window had to be created to be shown
+        uint coldCount = 0;
+        /// The time from show() to the first frame of the TabBoxView the last time it was shown
+        std::chrono::microseconds lastFirstFrame = std::chrono::microseconds::zero();
+    };
+    ShowStatistics showStatistics() const;
+
 Q_SIGNALS:
     /**
      * This signal is fired when the TabBoxConfig changes
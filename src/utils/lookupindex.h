@@ -0,0 +1,60 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+
+namespace KWin
+{
+
+/**
+ * The LookupIndex class maps a key that identifies an item, e.g. the internal id of a window,
+ * to the item, so it can be found without walking over all items.
+ *
+ * Keys can be reused by another item before the previous one is removed, like X11 window ids
+ * are. Removing an item therefore only drops the entry if the key still maps to that item.
+ */
+template<typename Key, typename Item>
+class LookupIndex
+{
+public:
+    void insert(const Key &key, Item *item)
+    {
+        m_items.insert(key, item);
+    }
+
+    void remove(const Key &key, const Item *item)
+    {
+        const auto it = m_items.find(key);
+        if (it != m_items.end() && *it == item) {
+            m_items.erase(it);
+        }
+    }
+
+    Item *find(const Key &key) const
+    {
+        return m_items.value(key, nullptr);
+    }
+
+    qsizetype size() const
+    {
+        return m_items.size();
+    }
+
+    void clear()
+    {
+        m_items.clear();
+    }
+
+private:
+    QHash<Key, Item *> m_items;
+};
+
+} // namespace KWin
@@ -0,0 +1,180 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+#include <algorithm>
+#include <iterator>
+
+namespace KWin
+{
+
+/**
+ * The MembershipIndex class keeps track of which items belong to which keys, e.g. which
+ * windows are on which virtual desktop or activity.
+ *
+ * An item with an empty list of keys is a member of every key, like a window that is on all
+ * desktops. Counting the members of a key is constant time, the members are returned sorted
+ * by the stacking order of the items, which is queried with @c Item::stackingOrder().
+ * The sorted lists are cached until invalidateOrder() is called or the members change.
+ */
+template<typename Key, typename Item>
+class MembershipIndex
+{
+public:
+    /**
+     * Sets the keys that @a item is a member of. If @a keys is empty, the item is a member of
+     * every key.
+     */
+    void update(Item *item, const QList<Key> &keys)
+    {
+        remove(item);
+        m_keys.insert(item, keys);
+        if (keys.isEmpty()) {
+            insert(m_everywhere, item);
+        } else {
+            for (const Key &key : keys) {
+                insert(m_buckets[key], item);
+            }
+        }
+    }
+
+    /**
+     * Removes @a item from all keys.
+     */
+    void remove(Item *item)
+    {
+        const auto it = m_keys.find(item);
+        if (it == m_keys.end()) {
+            return;
+        }
+        if (it->isEmpty()) {
+            erase(m_everywhere, item);
+        } else {
+            for (const Key &key : std::as_const(*it)) {
+                const auto bucket = m_buckets.find(key);
+                if (bucket == m_buckets.end()) {
+                    continue; // the key was listed more than once
+                }
+                erase(*bucket, item);
+                if (bucket->items.isEmpty()) {
+                    m_buckets.erase(bucket);
+                }
+            }
+        }
+        m_keys.erase(it);
+    }
+
+    /**
+     * Drops the sorted member lists, must be called when the stacking order of the items changes.
+     */
+    void invalidateOrder()
+    {
+        m_generation++;
+    }
+
+    bool contains(const Key &key, Item *item) const
+    {
+        if (m_everywhere.items.contains(item)) {
+            return true;
+        }
+        const auto bucket = m_buckets.constFind(key);
+        return bucket != m_buckets.constEnd() && bucket->items.contains(item);
+    }
+
+    /**
+     * Returns the number of items that are members of @a key, including the ones that are
+     * members of every key.
+     */
+    qsizetype count(const Key &key) const
+    {
+        const auto bucket = m_buckets.constFind(key);
+        return m_everywhere.items.size() + (bucket != m_buckets.constEnd() ? bucket->items.size() : 0);
+    }
+
+    bool isEmpty(const Key &key) const
+    {
+        return count(key) == 0;
+    }
+
+    /**
+     * Returns the number of items that are members of every key.
+     */
+    qsizetype countEverywhere() const
+    {
+        return m_everywhere.items.size();
+    }
+
+    /**
+     * Returns the members of @a key sorted by stacking order, the topmost item comes last.
+     */
+    QList<Item *> items(const Key &key) const
+    {
+        const QList<Item *> &everywhere = sorted(m_everywhere);
+        const auto bucket = m_buckets.constFind(key);
+        if (bucket == m_buckets.constEnd()) {
+            return everywhere;
+        }
+        const QList<Item *> &members = sorted(*bucket);
+        if (everywhere.isEmpty()) {
+            return members;
+        }
+
+        QList<Item *> merged;
+        merged.reserve(members.size() + everywhere.size());
+        std::merge(members.cbegin(), members.cend(), everywhere.cbegin(), everywhere.cend(), std::back_inserter(merged), lessThan);
+        return merged;
+    }
+
+private:
+    struct Bucket
+    {
+        QSet<Item *> items;
+        mutable QList<Item *> sorted;
+        mutable quint64 generation = 0;
+    };
+
+    static bool lessThan(const Item *a, const Item *b)
+    {
+        return a->stackingOrder() < b->stackingOrder();
+    }
+
+    void insert(Bucket &bucket, Item *item)
+    {
+        bucket.items.insert(item);
+        bucket.generation = 0;
+    }
+
+    void erase(Bucket &bucket, Item *item)
+    {
+        bucket.items.remove(item);
+        bucket.generation = 0;
+    }
+
+    const QList<Item *> &sorted(const Bucket &bucket) const
+    {
+        if (bucket.generation != m_generation) {
+            bucket.sorted = QList<Item *>(bucket.items.cbegin(), bucket.items.cend());
+            std::stable_sort(bucket.sorted.begin(), bucket.sorted.end(), lessThan);
+            bucket.generation = m_generation;
+        }
+        return bucket.sorted;
+    }
+
+    QHash<Key, Bucket> m_buckets;
+    Bucket m_everywhere;
+    QHash<Item *, QList<Key>> m_keys;
+    quint64 m_generation = 1;
+};
+
+} // namespace KWin
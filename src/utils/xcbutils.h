@@ -240,6 +240,59 @@ struct WrapperData<Reply, Cookie>
     static constexpr std::size_t argumentCount = 0;
 };
 
+/**
+ * @brief Counts the requests sent and the replies waited for through the wrappers.
+ *
+ * A round trip is counted whenever a reply is waited for whose request was sent after the
+ * last round trip. Replies arrive in order and waiting flushes the output buffer, so the
+ * replies of all requests sent before a round trip are available afterwards. Fetching a
+ * batch of cookies first and reading the replies later therefore costs one round trip, while
+ * reading every reply right after sending its request costs one per request.
+ *
+ * The counts are meant for tests and benchmarks that assert on the number of round trips of
+ * common code paths. Requests issued with plain xcb calls are not accounted for.
+ * The counter is not thread safe, it must only be used from the thread owning the connection.
+ */
+class KWIN_EXPORT RoundTripCounter
+{
+public:
+    struct Counts
+    {
+        quint64 requests = 0;
+        quint64 replies = 0;
+        quint64 roundTrips = 0;
+    };
+
+    static Counts counts()
+    {
+        return s_counts;
+    }
+    static void reset()
+    {
+        s_counts = Counts{};
+    }
+
+    static void requestSent(uint32_t sequence)
+    {
+        s_counts.requests++;
+        s_lastRequest = sequence;
+    }
+    static void replyWaited(uint32_t sequence)
+    {
+        s_counts.replies++;
+        // sequence numbers wrap around, compare them relative to each other
+        if (int32_t(sequence - s_lastSynchronized) > 0) {
+            s_counts.roundTrips++;
+            s_lastSynchronized = int32_t(s_lastRequest - sequence) > 0 ? s_lastRequest : sequence;
+        }
+    }
+
+private:
+    static inline Counts s_counts;
+    static inline uint32_t s_lastRequest = 0;
+    static inline uint32_t s_lastSynchronized = 0;
+};
+
 /**
  * @brief Abstract base class for the wrapper.
  *
@@ -343,6 +396,7 @@ protected:
         , m_window(window)
         , m_reply(nullptr)
     {
+        RoundTripCounter::requestSent(m_cookie.sequence);
     }
     explicit AbstractWrapper(const AbstractWrapper &other)
         : m_retrieved(other.m_retrieved)
@@ -357,6 +411,7 @@ protected:
         if (m_retrieved || !m_cookie.sequence) {
             return;
         }
+        RoundTripCounter::replyWaited(m_cookie.sequence);
         m_reply = Data::replyFunc(connection(), m_cookie, nullptr);
         m_retrieved = true;
     }
@@ -491,6 +546,7 @@ public:
         , m_atom(XCB_ATOM_NONE)
         , m_name(std::move(name))
     {
+        RoundTripCounter::requestSent(m_cookie.sequence);
     }
     Atom() = delete;
     Atom(const Atom &) = delete;
@@ -528,6 +584,7 @@ public:
         if (m_retrieved || !m_cookie.sequence) {
             return;
         }
+        RoundTripCounter::replyWaited(m_cookie.sequence);
         UniqueCPtr<xcb_intern_atom_reply_t> reply(xcb_intern_atom_reply(m_connection, m_cookie, nullptr));
         if (reply) {
             m_atom = reply->atom;
@@ -2057,6 +2114,8 @@ static inline void sync()
 {
     auto *c = connection();
     const auto cookie = xcb_get_input_focus(c);
+    RoundTripCounter::requestSent(cookie.sequence);
+    RoundTripCounter::replyWaited(cookie.sequence);
     xcb_generic_error_t *error = nullptr;
     UniqueCPtr<xcb_get_input_focus_reply_t> sync(xcb_get_input_focus_reply(c, cookie, &error));
     if (error) {
@@ -428,6 +428,7 @@ void VirtualDesktopManager::removeVirtualDesktop(VirtualDesktop *desktop)
 
     if (m_current == desktop) {
         m_current = (i < m_desktops.count()) ? m_desktops.at(i) : m_desktops.constLast();
+        ++m_currentGeneration;
         Q_EMIT currentChanged(desktop, m_current);
     }
 
@@ -451,6 +452,11 @@ VirtualDesktop *VirtualDesktopManager::currentDesktop() const
     return m_current;
 }
 
+quint64 VirtualDesktopManager::currentGeneration() const
+{
+    return m_currentGeneration;
+}
+
 bool VirtualDesktopManager::setCurrent(uint newDesktop)
 {
     if (newDesktop < 1 || newDesktop > count()) {
@@ -469,6 +475,7 @@ bool VirtualDesktopManager::setCurrent(VirtualDesktop *newDesktop)
     }
     VirtualDesktop *oldDesktop = currentDesktop();
     m_current = newDesktop;
+    ++m_currentGeneration;
     Q_EMIT currentChanged(oldDesktop, newDesktop);
     return true;
 }
@@ -489,6 +496,7 @@ void VirtualDesktopManager::setCount(uint count)
         if (m_current && desktopsToRemove.contains(m_current)) {
             VirtualDesktop *oldCurrent = m_current;
             m_current = m_desktops.last();
+            ++m_currentGeneration;
             Q_EMIT currentChanged(oldCurrent, m_current);
         }
         for (auto desktop : desktopsToRemove) {
@@ -519,6 +527,7 @@ void VirtualDesktopManager::setCount(uint count)
 
     if (!m_current) {
         m_current = m_desktops.at(0);
+        ++m_currentGeneration;
     }
 
     updateLayout();
@@ -197,6 +197,14 @@ public:
      */
     VirtualDesktop *currentDesktop() const;
 
+    /**
+     * @returns A counter that is incremented every time the current desktop changes.
+     * It can be used to cache results that depend on the current desktop, such as
+     * Window::isOnCurrentDesktop(). The counter never returns @c 0.
+     * @see currentChanged
+     */
+    quint64 currentGeneration() const;
+
     /**
      * Moves to the desktop through the algorithm described by Direction.
      * @param wrap If @c true wraps around to the other side of the layout
@@ -515,6 +523,7 @@ private:
 
     QList<VirtualDesktop *> m_desktops;
     QPointer<VirtualDesktop> m_current;
+    quint64 m_currentGeneration = 1;
     quint32 m_rows = 2;
     bool m_navigationWrapsAround;
     VirtualDesktopGrid m_grid;
@@ -19,11 +19,15 @@
 #include "compositor.h"
 #include "core/output.h"
 #include "decorations/decoratedwindow.h"
+#include "decorations/decorationbridge.h"
 #include "decorations/decorationpalette.h"
+#include "decorations/decorationrepaintqueue.h"
 #include "focuschain.h"
+#include "framecoalescer.h"
 #include "input.h"
 #include "outline.h"
 #include "placement.h"
+#include "scene/surfaceitem.h"
 #include "scene/windowitem.h"
 #include "scene/workspacescene.h"
 #include "screenedge.h"
@@ -43,6 +47,7 @@
 #include <QDebug>
 #include <QDir>
 #include <QJSEngine>
+#include <QMetaMethod>
 #include <QMouseEvent>
 #include <QStyleHints>
 
@@ -56,6 +61,7 @@ static inline int sign(int v)
 
 QHash<QString, std::weak_ptr<Decoration::DecorationPalette>> Window::s_palettes;
 std::shared_ptr<Decoration::DecorationPalette> Window::s_defaultPalette;
+Window::VisibilityCacheStats Window::s_visibilityCacheStats;
 
 Window::Window()
     : ready_for_painting(false)
@@ -84,6 +90,21 @@ Window::Window()
         m_keyboardGeometryRestore = QRectF();
     });
 
+    connect(this, &Window::frameGeometryChanged, this, [this](const QRectF &oldGeometry) {
+        if (!isSignalConnected(QMetaMethod::fromSignal(&Window::coalescedFrameGeometryChanged))) {
+            return;
+        }
+        if (!m_coalescedFrameGeometry) {
+            m_coalescedFrameGeometry = oldGeometry;
+        }
+        workspace()->frameCoalescer()->post(this, [this]() {
+            const std::optional<QRectF> oldGeometry = std::exchange(m_coalescedFrameGeometry, std::nullopt);
+            if (oldGeometry && *oldGeometry != frameGeometry()) {
+                Q_EMIT coalescedFrameGeometryChanged(*oldGeometry);
+            }
+        });
+    });
+
     // replace on-screen-display on size changes
     connect(this, &Window::frameGeometryChanged, this, [this](const QRectF &old) {
         if (isOnScreenDisplay() && !frameGeometry().isEmpty() && old.size() != frameGeometry().size() && isPlaceable()) {
@@ -215,6 +236,19 @@ void Window::finishCompositing()
     m_windowItem.reset();
 }
 
+void Window::suspendCompositing()
+{
+}
+
+void Window::resumeCompositing()
+{
+    if (SurfaceItem *item = surfaceItem()) {
+        // The contents need to be fetched again, that happens lazily when the window gets painted
+        item->discardPixmap();
+        item->addDamage(item->rect().toAlignedRect());
+    }
+}
+
 void Window::setReadyForPainting()
 {
     if (!ready_for_painting) {
@@ -718,6 +752,7 @@ void Window::setDesktops(QList<VirtualDesktop *> desktops)
     }
 
     m_desktops = desktops;
+    m_onCurrentDesktopGeneration = 0;
 
     auto transients_stacking_order = workspace()->ensureStackingOrder(transients());
     for (auto it = transients_stacking_order.constBegin(); it != transients_stacking_order.constEnd(); ++it) {
@@ -805,12 +840,36 @@ QStringList Window::desktopIds() const
 
 bool Window::isOnDesktop(VirtualDesktop *desktop) const
 {
-    return isOnAllDesktops() || desktops().contains(desktop);
+    if (isOnAllDesktops()) {
+        return true;
+    }
+    if (desktop == VirtualDesktopManager::self()->currentDesktop()) {
+        return isOnCurrentDesktop();
+    }
+    return m_desktops.contains(desktop);
 }
 
 bool Window::isOnCurrentDesktop() const
 {
-    return isOnDesktop(VirtualDesktopManager::self()->currentDesktop());
+    const VirtualDesktopManager *manager = VirtualDesktopManager::self();
+    if (m_onCurrentDesktopGeneration == manager->currentGeneration()) {
+        ++s_visibilityCacheStats.hits;
+        return m_onCurrentDesktop;
+    }
+    ++s_visibilityCacheStats.misses;
+    m_onCurrentDesktop = isOnAllDesktops() || m_desktops.contains(manager->currentDesktop());
+    m_onCurrentDesktopGeneration = manager->currentGeneration();
+    return m_onCurrentDesktop;
+}
+
+Window::VisibilityCacheStats Window::visibilityCacheStats()
+{
+    return s_visibilityCacheStats;
+}
+
+void Window::resetVisibilityCacheStats()
+{
+    s_visibilityCacheStats = VisibilityCacheStats();
 }
 
 ShadeMode Window::shadeMode() const
@@ -1001,7 +1060,7 @@ void Window::setColorScheme(const QString &colorScheme)
     m_colorScheme = requestedColorScheme;
 
     if (m_palette) {
-        disconnect(m_palette.get(), &Decoration::DecorationPalette::changed, this, &Window::handlePaletteChange);
+        disconnect(m_palette.get(), &Decoration::DecorationPalette::changed, this, &Window::schedulePaletteChange);
         m_palette.reset();
 
         // If there already was a palette, re-create it right away
@@ -1045,9 +1104,12 @@ void Window::ensurePalette()
         m_palette = it->lock();
     }
 
-    connect(m_palette.get(), &Decoration::DecorationPalette::changed, this, &Window::handlePaletteChange);
+    connect(m_palette.get(), &Decoration::DecorationPalette::changed, this, &Window::schedulePaletteChange);
 
-    handlePaletteChange();
+    // Otherwise the palette will announce itself once the color scheme has been parsed
+    if (!m_palette->isLoading()) {
+        handlePaletteChange();
+    }
 }
 
 void Window::handlePaletteChange()
@@ -1055,6 +1117,19 @@ void Window::handlePaletteChange()
     Q_EMIT paletteChanged(palette());
 }
 
+void Window::schedulePaletteChange()
+{
+    Decoration::DecorationBridge *bridge = workspace()->decorationBridge();
+    if (!bridge || !isDecorated()) {
+        handlePaletteChange();
+        return;
+    }
+    // Many decorations can share the palette, don't repaint all of them in the same frame
+    bridge->repaintQueue()->enqueue(this, [this]() {
+        handlePaletteChange();
+    });
+}
+
 QRectF Window::keepInArea(QRectF geometry, QRectF area, bool partial)
 {
     if (partial) {
@@ -3058,10 +3133,18 @@ QStringList Window::activities() const
 bool Window::isOnCurrentActivity() const
 {
 #if KWIN_BUILD_ACTIVITIES
-    if (!Workspace::self()->activities()) {
+    const Activities *activities = Workspace::self()->activities();
+    if (!activities) {
         return true;
     }
-    return isOnActivity(Workspace::self()->activities()->current());
+    if (m_onCurrentActivityGeneration == activities->currentGeneration()) {
+        ++s_visibilityCacheStats.hits;
+        return m_onCurrentActivity;
+    }
+    ++s_visibilityCacheStats.misses;
+    m_onCurrentActivity = isOnActivity(activities->current());
+    m_onCurrentActivityGeneration = activities->currentGeneration();
+    return m_onCurrentActivity;
 #else
     return true;
 #endif
@@ -3168,6 +3251,7 @@ void Window::setOnAllActivities(bool all)
  */
 void Window::updateActivities(bool includeTransients)
 {
+    m_onCurrentActivityGeneration = 0;
     if (m_activityUpdatesBlocked) {
         m_blockedActivityUpdatesRequireTransients |= includeTransients;
         return;
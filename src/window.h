@@ -89,22 +89,22 @@ class KWIN_EXPORT Window : public QObject
     /**
      * This property holds the x position of the Window's frame geometry.
      */
-    Q_PROPERTY(qreal x READ x NOTIFY frameGeometryChanged)
+    Q_PROPERTY(qreal x READ x NOTIFY coalescedFrameGeometryChanged)
 
     /**
      * This property holds the y position of the Window's frame geometry.
      */
-    Q_PROPERTY(qreal y READ y NOTIFY frameGeometryChanged)
+    Q_PROPERTY(qreal y READ y NOTIFY coalescedFrameGeometryChanged)
 
     /**
      * This property holds the width of the Window's frame geometry.
      */
-    Q_PROPERTY(qreal width READ width NOTIFY frameGeometryChanged)
+    Q_PROPERTY(qreal width READ width NOTIFY coalescedFrameGeometryChanged)
 
     /**
      * This property holds the height of the Window's frame geometry.
      */
-    Q_PROPERTY(qreal height READ height NOTIFY frameGeometryChanged)
+    Q_PROPERTY(qreal height READ height NOTIFY coalescedFrameGeometryChanged)
 
     Q_PROPERTY(qreal opacity READ opacity WRITE setOpacity NOTIFY opacityChanged)
 
@@ -435,8 +435,9 @@ class KWIN_EXPORT Window : public QObject
     /**
      * The geometry of this Window. Be aware that depending on resize mode the frameGeometryChanged
      * signal might be emitted at each resize step or only at the end of the resize operation.
+     * Bindings to this property are updated at most once per frame.
      */
-    Q_PROPERTY(QRectF frameGeometry READ frameGeometry WRITE moveResize NOTIFY frameGeometryChanged)
+    Q_PROPERTY(QRectF frameGeometry READ frameGeometry WRITE moveResize NOTIFY coalescedFrameGeometryChanged)
 
     /**
      * Whether the Window is currently being moved by the user.
@@ -784,6 +785,17 @@ public:
      */
     virtual void checkActivities(){};
 
+    /**
+     * Hit and miss counters of the cached isOnCurrentDesktop() and isOnCurrentActivity() results.
+     */
+    struct VisibilityCacheStats
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+    };
+    static VisibilityCacheStats visibilityCacheStats();
+    static void resetVisibilityCacheStats();
+
     virtual QString windowRole() const;
     QString resourceName() const;
     QString resourceClass() const;
@@ -797,6 +809,15 @@ public:
     qreal opacity() const;
     virtual bool setupCompositing();
     virtual void finishCompositing();
+    /**
+     * Called when compositing is suspended without tearing down the scene. The window
+     * keeps its window item, but it isn't redirected anymore.
+     */
+    virtual void suspendCompositing();
+    /**
+     * Called when compositing is resumed after suspendCompositing().
+     */
+    virtual void resumeCompositing();
     EffectWindow *effectWindow();
     const EffectWindow *effectWindow() const;
     SurfaceItem *surfaceItem() const;
@@ -1425,6 +1446,13 @@ Q_SIGNALS:
      * This signal is emitted when the Window's frame geometry changes.
      */
     void frameGeometryChanged(const QRectF &oldGeometry);
+    /**
+     * This signal is emitted at most once per frame when the Window's frame geometry changes,
+     * @p oldGeometry is the frame geometry when it was emitted last. Listeners that only need
+     * the latest geometry should use it instead of frameGeometryChanged, which is emitted for
+     * every intermediate geometry, e.g. on every pointer motion during an interactive move.
+     */
+    void coalescedFrameGeometryChanged(const QRectF &oldGeometry);
     /**
      * This signal is emitted when the Window's client geometry has changed.
      */
@@ -1585,6 +1613,7 @@ protected:
     void updateColorScheme();
     void ensurePalette();
     void handlePaletteChange();
+    void schedulePaletteChange();
 
     virtual Layer belongsToLayer() const;
     bool isActiveFullScreen() const;
@@ -1804,6 +1833,7 @@ protected:
 
     int m_refCount = 1;
     QUuid m_internalId;
+    std::optional<QRectF> m_coalescedFrameGeometry;
     std::unique_ptr<WindowItem> m_windowItem;
     std::unique_ptr<Shadow> m_shadow;
     QString resource_name;
@@ -1838,6 +1868,14 @@ protected:
     int m_activityUpdatesBlocked = 0;
     bool m_blockedActivityUpdatesRequireTransients = false;
 
+    // Cached visibility bits, valid as long as the stored generation matches the
+    // current desktop (resp. activity) generation. Generation 0 means stale.
+    mutable quint64 m_onCurrentDesktopGeneration = 0;
+    mutable quint64 m_onCurrentActivityGeneration = 0;
+    mutable bool m_onCurrentDesktop = false;
+    mutable bool m_onCurrentActivity = false;
+    static VisibilityCacheStats s_visibilityCacheStats;
+
     QString m_colorScheme;
     std::shared_ptr<Decoration::DecorationPalette> m_palette;
     static QHash<QString, std::weak_ptr<Decoration::DecorationPalette>> s_palettes;
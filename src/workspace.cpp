@@ -25,11 +25,13 @@
 #include "dbusinterface.h"
 #include "effect/effecthandler.h"
 #include "focuschain.h"
+#include "framecoalescer.h"
 #include "input.h"
 #include "internalwindow.h"
 #include "killwindow.h"
 #include "moving_client_x11_filter.h"
 #include "outline.h"
+#include "pingscheduler.h"
 #include "placement.h"
 #include "pluginmanager.h"
 #include "rules.h"
@@ -43,6 +45,7 @@
 #endif
 #include "atoms.h"
 #include "compositor.h"
+#include "compositor_x11.h"
 #include "core/brightnessdevice.h"
 #include "decorations/decorationbridge.h"
 #include "dpmsinputeventfilter.h"
@@ -54,6 +57,7 @@
 #include "placeholderinputeventfilter.h"
 #include "placeholderoutput.h"
 #include "placementtracker.h"
+#include "scene/ghostitem.h"
 #include "scene/workspacescene.h"
 #include "tabletmodemanager.h"
 #include "tiles/tilemanager.h"
@@ -77,6 +81,7 @@
 #include <QCryptographicHash>
 #include <QDBusConnection>
 #include <QDBusPendingCall>
+#include <QElapsedTimer>
 #include <QMetaProperty>
 // xcb
 #include <xcb/xinerama.h>
@@ -114,6 +119,8 @@ Workspace::Workspace()
     , m_focusChain(std::make_unique<FocusChain>())
     , m_applicationMenu(std::make_unique<ApplicationMenu>())
     , m_placementTracker(std::make_unique<PlacementTracker>(this))
+    , m_pingScheduler(std::make_unique<PingScheduler>())
+    , m_frameCoalescer(std::make_unique<FrameCoalescer>())
     , m_lidSwitchTracker(std::make_unique<LidSwitchTracker>())
     , m_orientationSensor(std::make_unique<OrientationSensor>())
 {
@@ -237,6 +244,33 @@ void Workspace::init()
 
     // TODO: ungrabXServer()
 
+    connect(m_pingScheduler.get(), &PingScheduler::unresponsiveChanged, this, [](QObject *target, bool unresponsive) {
+        if (auto window = qobject_cast<X11Window *>(target)) {
+            window->setPingTimedOut(unresponsive);
+        }
+    });
+    connect(m_pingScheduler.get(), &PingScheduler::killRequested, this, [](QObject *target) {
+        if (auto window = qobject_cast<X11Window *>(target)) {
+            window->requestKillPrompt();
+        }
+    });
+    connect(m_pingScheduler.get(), &PingScheduler::pingRequested, this, [](QObject *target) {
+        if (auto window = qobject_cast<X11Window *>(target)) {
+            window->sendPing();
+        }
+    });
+
+    // held back notifications are delivered when the next frame starts to be painted
+    if (Compositor *compositor = Compositor::self()) {
+        const auto connectScene = [this, compositor]() {
+            connect(compositor->scene(), &WorkspaceScene::preFrameRender, m_frameCoalescer.get(), &FrameCoalescer::flush);
+        };
+        connect(compositor, &Compositor::sceneCreated, this, connectScene);
+        if (compositor->scene()) {
+            connectScene();
+        }
+    }
+
     connect(this, &Workspace::windowAdded, m_placementTracker.get(), &PlacementTracker::add);
     connect(this, &Workspace::windowRemoved, m_placementTracker.get(), &PlacementTracker::remove);
     m_placementTracker->init(getPlacementTrackerHash());
@@ -652,13 +686,91 @@ void Workspace::addToStack(Window *window)
     }
     if (!stacking_order.contains(window)) {
         stacking_order.append(window);
+        // keep the stacking order of the window consistent until the next stacking update,
+        // the membership indexes sort by it
+        if (stacking_order.size() > 1) {
+            window->setStackingOrder(stacking_order.at(stacking_order.size() - 2)->stackingOrder() + 1);
+        }
+        m_desktopMembership.invalidateOrder();
+        m_activityMembership.invalidateOrder();
+        m_stackingOrderGeneration++;
     }
 }
 
+void Workspace::addToMembershipIndex(Window *window)
+{
+    if (!window->isClient()) {
+        return;
+    }
+    connect(window, &Window::desktopsChanged, this, [this, window]() {
+        updateMembershipIndex(window);
+    });
+    connect(window, &Window::activitiesChanged, this, [this, window]() {
+        updateMembershipIndex(window);
+    });
+    updateMembershipIndex(window);
+}
+
+void Workspace::updateMembershipIndex(Window *window)
+{
+    m_desktopMembership.update(window, window->desktops());
+    m_activityMembership.update(window, window->activities());
+}
+
+void Workspace::removeFromMembershipIndex(Window *window)
+{
+    disconnect(window, &Window::desktopsChanged, this, nullptr);
+    disconnect(window, &Window::activitiesChanged, this, nullptr);
+    m_desktopMembership.remove(window);
+    m_activityMembership.remove(window);
+}
+
+void Workspace::addToLookupIndex(Window *window)
+{
+    m_windowsById.insert(window->internalId(), window);
+    if (X11Window *x11Window = qobject_cast<X11Window *>(window); x11Window && x11Window->isUnmanaged()) {
+        m_unmanagedById.insert(x11Window->window(), x11Window);
+    } else if (InternalWindow *internal = qobject_cast<InternalWindow *>(window)) {
+        m_internalWindows.insert(internal->handle(), internal);
+    }
+}
+
+void Workspace::removeFromLookupIndex(Window *window)
+{
+    m_windowsById.remove(window->internalId(), window);
+    if (X11Window *x11Window = qobject_cast<X11Window *>(window); x11Window && x11Window->isUnmanaged()) {
+        m_unmanagedById.remove(x11Window->window(), x11Window);
+    } else if (InternalWindow *internal = qobject_cast<InternalWindow *>(window)) {
+        m_internalWindows.remove(internal->handle(), internal);
+    }
+}
+
+QList<Window *> Workspace::windowsOnDesktop(VirtualDesktop *desktop) const
+{
+    return m_desktopMembership.items(desktop);
+}
+
+int Workspace::windowCountOnDesktop(VirtualDesktop *desktop) const
+{
+    return m_desktopMembership.count(desktop);
+}
+
+QList<Window *> Workspace::windowsOnActivity(const QString &activity) const
+{
+    return m_activityMembership.items(activity);
+}
+
+int Workspace::windowCountOnActivity(const QString &activity) const
+{
+    return m_activityMembership.count(activity);
+}
+
 void Workspace::removeFromStack(Window *window)
 {
     unconstrained_stacking_order.removeAll(window);
-    stacking_order.removeAll(window);
+    if (stacking_order.removeAll(window)) {
+        m_stackingOrderGeneration++;
+    }
 
     for (int i = m_constraints.count() - 1; i >= 0; --i) {
         Constraint *constraint = m_constraints[i];
@@ -729,6 +841,8 @@ void Workspace::addX11Window(X11Window *window)
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
     addToStack(window);
+    addToMembershipIndex(window);
+    addToLookupIndex(window);
     if (window->hasStrut()) {
         rearrange(); // This cannot be in manage(), because the window got added only now
     }
@@ -751,6 +865,7 @@ void Workspace::addUnmanaged(X11Window *window)
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
     addToStack(window);
+    addToLookupIndex(window);
     updateXStackingOrder();
     updateStackingOrder(true);
     if (window->isOutline() && m_moveResizeWindow) {
@@ -769,6 +884,8 @@ void Workspace::removeX11Window(X11Window *window)
     if (group != nullptr) {
         group->lostLeader();
     }
+    m_pingScheduler->remove(window);
+    m_pendingFrameMappings.remove(window);
     removeWindow(window);
 }
 
@@ -776,6 +893,7 @@ void Workspace::removeUnmanaged(X11Window *window)
 {
     Q_ASSERT(m_windows.contains(window));
     m_windows.removeOne(window);
+    removeFromLookupIndex(window);
     Q_EMIT windowRemoved(window);
 }
 
@@ -821,6 +939,8 @@ void Workspace::addWaylandWindow(Window *window)
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
     addToStack(window);
+    addToMembershipIndex(window);
+    addToLookupIndex(window);
 
     updateStackingOrder(true);
     if (window->hasStrut()) {
@@ -856,6 +976,8 @@ void Workspace::removeWindow(Window *window)
     }
 
     m_windows.removeAll(window);
+    removeFromMembershipIndex(window);
+    removeFromLookupIndex(window);
     if (window == m_delayFocusWindow) {
         cancelDelayFocus();
     }
@@ -965,12 +1087,13 @@ void Workspace::updateWindowVisibilityOnDesktopChange(VirtualDesktop *newDesktop
         m_moveResizeWindow->setDesktops({newDesktop});
     }
 
-    for (int i = stacking_order.size() - 1; i >= 0; --i) {
-        X11Window *c = qobject_cast<X11Window *>(stacking_order.at(i));
+    const QList<Window *> windowsOnNewDesktop = windowsOnDesktop(newDesktop);
+    for (auto it = windowsOnNewDesktop.crbegin(); it != windowsOnNewDesktop.crend(); ++it) {
+        X11Window *c = qobject_cast<X11Window *>(*it);
         if (!c) {
             continue;
         }
-        if (c->isOnDesktop(newDesktop) && c->isOnCurrentActivity()) {
+        if (c->isOnCurrentActivity()) {
             c->updateVisibility();
         }
     }
@@ -979,16 +1102,100 @@ void Workspace::updateWindowVisibilityOnDesktopChange(VirtualDesktop *newDesktop
     }
 }
 
+static uint nextRequestSequence()
+{
+    // NoOperation has neither a reply nor an effect, it's only sent to learn the sequence number
+    xcb_connection_t *connection = kwinApp()->x11Connection();
+    return connection ? xcb_no_operation(connection).sequence : 0;
+}
+
 void Workspace::updateWindowVisibilityAndActivateOnDesktopChange(VirtualDesktop *newDesktop)
 {
+    QElapsedTimer timer;
+    timer.start();
+    const uint firstRequest = nextRequestSequence();
+
     closeActivePopup();
-    ++block_focus;
-    StackingUpdatesBlocker blocker(this);
-    updateWindowVisibilityOnDesktopChange(newDesktop);
-    // Restore the focus on this desktop
-    --block_focus;
+    {
+        ++block_focus;
+        StackingUpdatesBlocker blocker(this);
+        {
+            VisibilityTransaction transaction(this);
+            updateWindowVisibilityOnDesktopChange(newDesktop);
+        }
+        // Restore the focus on this desktop
+        --block_focus;
+
+        activateWindowOnDesktop(newDesktop);
+    }
+
+    m_desktopSwitchStatistics.count++;
+    m_desktopSwitchStatistics.lastDuration = std::chrono::duration_cast<std::chrono::microseconds>(timer.durationElapsed());
+    m_desktopSwitchStatistics.lastRequestCount = nextRequestSequence() - firstRequest - 1;
+}
 
-    activateWindowOnDesktop(newDesktop);
+void Workspace::beginVisibilityTransaction()
+{
+    blockStackingUpdates(true);
+    ++m_visibilityTransaction;
+}
+
+void Workspace::commitVisibilityTransaction()
+{
+    Q_ASSERT(m_visibilityTransaction > 0);
+    blockStackingUpdates(false);
+    if (--m_visibilityTransaction > 0) {
+        return;
+    }
+
+    const QHash<X11Window *, bool> pending = std::exchange(m_pendingFrameMappings, {});
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    // the frames are stacked even while they are unmapped, so mapping the windows that are shown
+    // before unmapping the ones that are hidden doesn't expose the root window
+    QList<X11Window *> mapping;
+    QList<X11Window *> unmapping;
+    for (auto it = stacking_order.crbegin(); it != stacking_order.crend(); ++it) {
+        X11Window *window = qobject_cast<X11Window *>(*it);
+        if (!window || window->isDeleted()) {
+            continue;
+        }
+        const auto wasMapped = pending.constFind(window);
+        if (wasMapped == pending.constEnd() || *wasMapped == window->isFrameMapped()) {
+            continue;
+        }
+        if (window->isFrameMapped()) {
+            mapping.append(window);
+        } else {
+            unmapping.prepend(window);
+        }
+    }
+    for (X11Window *window : std::as_const(mapping)) {
+        window->syncFrameMapping();
+    }
+    for (X11Window *window : std::as_const(unmapping)) {
+        window->syncFrameMapping();
+    }
+    xcb_flush(kwinApp()->x11Connection());
+}
+
+bool Workspace::deferFrameMapping(X11Window *window)
+{
+    if (!m_visibilityTransaction) {
+        return false;
+    }
+    // the mapping state has already been changed, so the frame was in the opposite state before
+    if (!m_pendingFrameMappings.contains(window)) {
+        m_pendingFrameMappings.insert(window, !window->isFrameMapped());
+    }
+    return true;
+}
+
+Workspace::DesktopSwitchStatistics Workspace::desktopSwitchStatistics() const
+{
+    return m_desktopSwitchStatistics;
 }
 
 void Workspace::activateWindowOnDesktop(VirtualDesktop *desktop)
@@ -1592,6 +1799,25 @@ QString Workspace::supportInformation() const
     support.append(QLatin1String("themeSize: ") + QString::number(cursor->themeSize()) + QLatin1Char('\n'));
     support.append(QLatin1Char('\n'));
 
+    support.append(QStringLiteral("Performance Counters\n"));
+    support.append(QStringLiteral("====================\n"));
+    const Window::VisibilityCacheStats visibilityStats = Window::visibilityCacheStats();
+    support.append(QStringLiteral("Visibility cache hits: %1\n").arg(visibilityStats.hits));
+    support.append(QStringLiteral("Visibility cache misses: %1\n").arg(visibilityStats.misses));
+    support.append(QStringLiteral("Closed window ghosts: %1 live, %2 created\n").arg(GhostItem::liveCount()).arg(GhostItem::createdCount()));
+    if (WorkspaceScene *scene = Compositor::self()->scene()) {
+        const WorkspaceScene::OcclusionStatistics occlusionStats = scene->occlusionStatistics();
+        support.append(QStringLiteral("Occlusion culled pixels: %1 in %2 frames, %3 in the last frame\n").arg(occlusionStats.culledPixels).arg(occlusionStats.frames).arg(occlusionStats.lastCulledPixels));
+    }
+    support.append(QStringLiteral("Desktop switches: %1, last took %2 us and %3 X requests\n").arg(m_desktopSwitchStatistics.count).arg(m_desktopSwitchStatistics.lastDuration.count()).arg(m_desktopSwitchStatistics.lastRequestCount));
+    if (X11Compositor *compositor = X11Compositor::self()) {
+        const X11Compositor::ToggleStatistics toggleStats = compositor->toggleStatistics();
+        support.append(QStringLiteral("Compositing warm suspends: %1, last took %2 us\n").arg(toggleStats.warmSuspends).arg(toggleStats.lastSuspendLatency.count()));
+        support.append(QStringLiteral("Compositing warm resumes: %1, last took %2 us\n").arg(toggleStats.warmResumes).arg(toggleStats.lastResumeLatency.count()));
+        support.append(QStringLiteral("Compositing last cold start took %1 us, last cold stop took %2 us\n").arg(toggleStats.lastStartLatency.count()).arg(toggleStats.lastStopLatency.count()));
+    }
+    support.append(QLatin1Char('\n'));
+
     support.append(QStringLiteral("Options\n"));
     support.append(QStringLiteral("=======\n"));
     const QMetaObject *metaOptions = options->metaObject();
@@ -1663,7 +1889,7 @@ QString Workspace::supportInformation() const
     }
     support.append(QStringLiteral("\nCompositing\n"));
     support.append(QStringLiteral("===========\n"));
-    if (effects) {
+    if (effects && Compositor::compositing()) {
         support.append(QStringLiteral("Compositing is active\n"));
         switch (effects->compositingType()) {
         case OpenGLCompositing: {
@@ -1806,9 +2032,7 @@ X11Window *Workspace::findUnmanaged(std::function<bool(const X11Window *)> func)
 
 X11Window *Workspace::findUnmanaged(xcb_window_t w) const
 {
-    return findUnmanaged([w](const X11Window *u) {
-        return u->window() == w;
-    });
+    return m_unmanagedById.find(w);
 }
 
 X11Window *Workspace::findClient(Predicate predicate, xcb_window_t w) const
@@ -1841,9 +2065,7 @@ Window *Workspace::findWindow(std::function<bool(const Window *)> func) const
 
 Window *Workspace::findWindow(const QUuid &internalId) const
 {
-    return findWindow([internalId](const KWin::Window *l) -> bool {
-        return internalId == l->internalId();
-    });
+    return m_windowsById.find(internalId);
 }
 
 void Workspace::forEachWindow(std::function<void(Window *)> func)
@@ -1867,14 +2089,7 @@ Window *Workspace::findInternal(QWindow *w) const
     if (kwinApp()->operationMode() == Application::OperationModeX11) {
         return findUnmanaged(w->winId());
     }
-    for (Window *window : m_windows) {
-        if (InternalWindow *internal = qobject_cast<InternalWindow *>(window)) {
-            if (internal->handle() == w) {
-                return internal;
-            }
-        }
-    }
-    return nullptr;
+    return m_internalWindows.find(w);
 }
 
 void Workspace::setWasUserInteraction()
@@ -1904,6 +2119,8 @@ void Workspace::addInternalWindow(InternalWindow *window)
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
     addToStack(window);
+    addToMembershipIndex(window);
+    addToLookupIndex(window);
 
     setupWindowConnections(window);
     window->updateLayer();
@@ -1923,6 +2140,8 @@ void Workspace::addInternalWindow(InternalWindow *window)
 void Workspace::removeInternalWindow(InternalWindow *window)
 {
     m_windows.removeOne(window);
+    removeFromMembershipIndex(window);
+    removeFromLookupIndex(window);
 
     updateStackingOrder();
     Q_EMIT windowRemoved(window);
@@ -2908,6 +3127,16 @@ Placement *Workspace::placement() const
     return m_placement.get();
 }
 
+PingScheduler *Workspace::pingScheduler() const
+{
+    return m_pingScheduler.get();
+}
+
+FrameCoalescer *Workspace::frameCoalescer() const
+{
+    return m_frameCoalescer.get();
+}
+
 RuleBook *Workspace::rulebook() const
 {
     return m_rulebook.get();
@@ -17,13 +17,17 @@
 #include "options.h"
 #include "sm.h"
 #include "utils/common.h"
+#include "utils/lookupindex.h"
+#include "utils/membershipindex.h"
 // KF
 #include <netwm_def.h>
 // Qt
 #include <QList>
 #include <QStringList>
 #include <QTimer>
+#include <QUuid>
 // std
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -66,6 +70,8 @@ class X11EventFilter;
 class FocusChain;
 class ApplicationMenu;
 class PlacementTracker;
+class PingScheduler;
+class FrameCoalescer;
 enum class Predicate;
 class Outline;
 class RuleBook;
@@ -249,6 +255,58 @@ public:
         return m_windows;
     }
 
+    /**
+     * @returns the client windows on @p desktop, including the ones on all desktops, in
+     * stacking order. The topmost window is the last one.
+     */
+    QList<Window *> windowsOnDesktop(VirtualDesktop *desktop) const;
+    /**
+     * @returns the number of client windows on @p desktop, including the ones on all desktops
+     */
+    int windowCountOnDesktop(VirtualDesktop *desktop) const;
+    /**
+     * @returns the client windows on @p activity, including the ones on all activities, in
+     * stacking order. The topmost window is the last one.
+     */
+    QList<Window *> windowsOnActivity(const QString &activity) const;
+    /**
+     * @returns the number of client windows on @p activity, including the ones on all activities
+     */
+    int windowCountOnActivity(const QString &activity) const;
+
+    /**
+     * Starts collecting the frame map and unmap requests of X11 windows, e.g. while switching
+     * virtual desktops. The mapping states of the windows are updated right away, but the
+     * requests are only sent when the outermost transaction is committed. A window that is hidden
+     * and shown again in the same transaction doesn't send any request. Stacking updates are
+     * blocked until the commit.
+     *
+     * @see VisibilityTransaction
+     */
+    void beginVisibilityTransaction();
+    /**
+     * Sends the collected map requests, topmost window first, and then the unmap requests,
+     * bottommost window first, so the root window doesn't get exposed in between.
+     */
+    void commitVisibilityTransaction();
+    /**
+     * Called by @p window before it maps or unmaps its frame. Returns @c true if a visibility
+     * transaction is open and the request is deferred until the transaction is committed.
+     */
+    bool deferFrameMapping(X11Window *window);
+
+    struct DesktopSwitchStatistics
+    {
+        uint count = 0;
+        std::chrono::microseconds lastDuration = std::chrono::microseconds::zero();
+        uint lastRequestCount = 0;
+    };
+    /**
+     * Returns how long the most recent switch of the virtual desktop or activity took and how
+     * many X requests it sent.
+     */
+    DesktopSwitchStatistics desktopSwitchStatistics() const;
+
     void stackScreenEdgesUnderOverrideRedirect();
 
     SessionManager *sessionManager() const;
@@ -294,6 +352,11 @@ public:
      * at the last position
      */
     const QList<Window *> &stackingOrder() const;
+    /**
+     * Returns a number that changes whenever the stacking order changes, including when windows
+     * are added to or removed from it, so copies of the stacking order can tell if they are stale.
+     */
+    quint64 stackingOrderGeneration() const;
     QList<Window *> unconstrainedStackingOrder() const;
     QList<Window *> ensureStackingOrder(const QList<Window *> &windows) const;
 
@@ -441,6 +504,8 @@ public:
     Decoration::DecorationBridge *decorationBridge() const;
     Outline *outline() const;
     Placement *placement() const;
+    PingScheduler *pingScheduler() const;
+    FrameCoalescer *frameCoalescer() const;
     RuleBook *rulebook() const;
     ScreenEdges *screenEdges() const;
 #if KWIN_BUILD_TABBOX
@@ -596,6 +661,11 @@ private:
     void saveOldScreenSizes();
     void addToStack(Window *window);
     void removeFromStack(Window *window);
+    void addToMembershipIndex(Window *window);
+    void updateMembershipIndex(Window *window);
+    void removeFromMembershipIndex(Window *window);
+    void addToLookupIndex(Window *window);
+    void removeFromLookupIndex(Window *window);
 
     void initializeX11();
     void cleanupX11();
@@ -667,7 +737,16 @@ private:
 
     QList<Window *> unconstrained_stacking_order; // Topmost last
     QList<Window *> stacking_order; // Topmost last
+    quint64 m_stackingOrderGeneration = 1;
+    MembershipIndex<VirtualDesktop *, Window> m_desktopMembership;
+    MembershipIndex<QString, Window> m_activityMembership;
+    LookupIndex<QUuid, Window> m_windowsById;
+    LookupIndex<xcb_window_t, X11Window> m_unmanagedById;
+    LookupIndex<QWindow *, InternalWindow> m_internalWindows;
     bool force_restacking;
+    int m_visibilityTransaction = 0;
+    QHash<X11Window *, bool> m_pendingFrameMappings; // Whether the frame was mapped when the transaction started
+    DesktopSwitchStatistics m_desktopSwitchStatistics;
     QList<Window *> should_get_focus; // Last is most recent
     QList<Window *> attention_chain;
 
@@ -733,6 +812,8 @@ private:
     std::unique_ptr<Activities> m_activities;
 #endif
     std::unique_ptr<PlacementTracker> m_placementTracker;
+    std::unique_ptr<PingScheduler> m_pingScheduler;
+    std::unique_ptr<FrameCoalescer> m_frameCoalescer;
 
     PlaceholderOutput *m_placeholderOutput = nullptr;
     std::unique_ptr<PlaceholderInputEventFilter> m_placeholderFilter;
@@ -767,6 +848,27 @@ private:
     Workspace *ws;
 };
 
+/**
+ * Helper for Workspace::beginVisibilityTransaction() and Workspace::commitVisibilityTransaction()
+ * being called in pairs
+ */
+class VisibilityTransaction
+{
+public:
+    explicit VisibilityTransaction(Workspace *w)
+        : ws(w)
+    {
+        ws->beginVisibilityTransaction();
+    }
+    ~VisibilityTransaction()
+    {
+        ws->commitVisibilityTransaction();
+    }
+
+private:
+    Workspace *ws;
+};
+
 //---------------------------------------------------------
 // Unsorted
 
@@ -802,6 +904,11 @@ inline const QList<Window *> &Workspace::stackingOrder() const
     return stacking_order;
 }
 
+inline quint64 Workspace::stackingOrderGeneration() const
+{
+    return m_stackingOrderGeneration;
+}
+
 inline bool Workspace::wasUserInteraction() const
 {
     return was_user_interaction;
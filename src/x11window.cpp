@@ -25,6 +25,7 @@
 #include "group.h"
 #include "killprompt.h"
 #include "netinfo.h"
+#include "pingscheduler.h"
 #include "placement.h"
 #include "scene/surfaceitem_x11.h"
 #include "scene/windowitem.h"
@@ -271,7 +272,6 @@ X11Window::X11Window()
     , m_motif(atoms->motif_wm_hints)
     , blocks_compositing(false)
     , in_group(nullptr)
-    , ping_timer(nullptr)
     , m_pingTimestamp(XCB_TIME_CURRENT_TIME)
     , m_userTime(XCB_TIME_CURRENT_TIME) // Not known yet
     , allowed_actions()
@@ -1608,7 +1608,10 @@ bool X11Window::setupCompositing()
         return false;
     }
     // If compositing is back on, stop rendering decoration in the frame window.
-    maybeDestroyX11DecorationRenderer();
+    // The window can also be set up while compositing is suspended.
+    if (Compositor::compositing()) {
+        maybeDestroyX11DecorationRenderer();
+    }
     updateVisibility(); // for internalKeep()
     return true;
 }
@@ -1621,6 +1624,20 @@ void X11Window::finishCompositing()
     maybeCreateX11DecorationRenderer();
 }
 
+void X11Window::suspendCompositing()
+{
+    Window::suspendCompositing();
+    updateVisibility();
+    maybeCreateX11DecorationRenderer();
+}
+
+void X11Window::resumeCompositing()
+{
+    Window::resumeCompositing();
+    maybeDestroyX11DecorationRenderer();
+    updateVisibility();
+}
+
 /**
  * Returns whether the window is minimizable or not
  */
@@ -1785,7 +1802,7 @@ void X11Window::updateVisibility()
         return;
     }
     if (isHidden()) {
-        info->setState(NET::Hidden, NET::Hidden);
+        exportHiddenState(true);
         setSkipTaskbar(true); // Also hide from taskbar
         if (Compositor::compositing() && options->hiddenPreviews() == HiddenPreviewsAlways) {
             internalKeep();
@@ -1804,7 +1821,7 @@ void X11Window::updateVisibility()
     }
     setSkipTaskbar(originalSkipTaskbar()); // Reset from 'hidden'
     if (isMinimized()) {
-        info->setState(NET::Hidden, NET::Hidden);
+        exportHiddenState(true);
         if (Compositor::compositing() && options->hiddenPreviews() == HiddenPreviewsAlways) {
             internalKeep();
         } else {
@@ -1812,7 +1829,7 @@ void X11Window::updateVisibility()
         }
         return;
     }
-    info->setState(NET::States(), NET::Hidden);
+    exportHiddenState(false);
     if (!isOnCurrentDesktop()) {
         if (Compositor::compositing() && options->hiddenPreviews() != HiddenPreviewsNever) {
             internalKeep();
@@ -1832,6 +1849,15 @@ void X11Window::updateVisibility()
     internalShow();
 }
 
+void X11Window::exportHiddenState(bool hidden)
+{
+    // _NET_WM_STATE is rewritten as a whole, so don't touch it if the flag stays the same
+    if (bool(info->state() & NET::Hidden) == hidden) {
+        return;
+    }
+    info->setState(hidden ? NET::Hidden : NET::States(), NET::Hidden);
+}
+
 /**
  * Sets the client window's mapping state. Possible values are
  * WithdrawnState, IconicState, NormalState.
@@ -1908,6 +1934,9 @@ void X11Window::internalKeep()
  */
 void X11Window::map()
 {
+    if (workspace()->deferFrameMapping(this)) {
+        return;
+    }
     // XComposite invalidates backing pixmaps on unmap (minimize, different
     // virtual desktop, etc.).  We kept the last known good pixmap around
     // for use in effects, but now we want to have access to the new pixmap
@@ -1930,6 +1959,9 @@ void X11Window::map()
  */
 void X11Window::unmap()
 {
+    if (workspace()->deferFrameMapping(this)) {
+        return;
+    }
     // Here it may look like a race condition, as some other client might try to unmap
     // the window between these two XSelectInput() calls. However, they're supposed to
     // use XWithdrawWindow(), which also sends a synthetic event to the root window,
@@ -1945,6 +1977,15 @@ void X11Window::unmap()
     exportMappingState(XCB_ICCCM_WM_STATE_ICONIC);
 }
 
+void X11Window::syncFrameMapping()
+{
+    if (isFrameMapped()) {
+        map();
+    } else {
+        unmap();
+    }
+}
+
 /**
  * XComposite doesn't keep window pixmaps of unmapped windows, which means
  * there wouldn't be any previews of windows that are minimized or on another
@@ -2054,28 +2095,20 @@ void X11Window::pingWindow()
     if (options->killPingTimeout() == 0) {
         return; // Turned off
     }
-    if (ping_timer != nullptr) {
-        return; // Pinging already
+    const PingScheduler::Client client{
+        .hostName = clientMachine()->hostName(),
+        .pid = info->pid(),
+    };
+    // we'll wait twice, at first we'll desaturate the window
+    // and the second time we'll show the "do you want to kill" prompt
+    if (!workspace()->pingScheduler()->schedule(this, client, std::chrono::milliseconds(options->killPingTimeout()))) {
+        return; // Pinging already, either this window or another one of the same process
     }
-    ping_timer = new QTimer(this);
-    connect(ping_timer, &QTimer::timeout, this, [this]() {
-        if (unresponsive()) {
-            qCDebug(KWIN_CORE) << "Final ping timeout, asking to kill:" << caption();
-            ping_timer->deleteLater();
-            ping_timer = nullptr;
-            killProcess(true, m_pingTimestamp);
-            return;
-        }
-
-        qCDebug(KWIN_CORE) << "First ping timeout:" << caption();
+    sendPing();
+}
 
-        setUnresponsive(true);
-        ping_timer->start();
-    });
-    ping_timer->setSingleShot(true);
-    // we'll run the timer twice, at first we'll desaturate the window
-    // and the second time we'll show the "do you want to kill" prompt
-    ping_timer->start(options->killPingTimeout() / 2);
+void X11Window::sendPing()
+{
     m_pingTimestamp = xTime();
     rootInfo()->sendPing(window(), m_pingTimestamp);
 }
@@ -2086,16 +2119,27 @@ void X11Window::gotPing(xcb_timestamp_t timestamp)
     if (NET::timestampCompare(timestamp, m_pingTimestamp) != 0) {
         return;
     }
-    delete ping_timer;
-    ping_timer = nullptr;
+    workspace()->pingScheduler()->acknowledge(this);
+}
 
-    setUnresponsive(false);
+void X11Window::setPingTimedOut(bool timedOut)
+{
+    if (timedOut) {
+        qCDebug(KWIN_CORE) << "First ping timeout:" << caption();
+    }
+    setUnresponsive(timedOut);
 
-    if (m_killPrompt) {
+    if (!timedOut && m_killPrompt) {
         m_killPrompt->quit();
     }
 }
 
+void X11Window::requestKillPrompt()
+{
+    qCDebug(KWIN_CORE) << "Final ping timeout, asking to kill:" << caption();
+    killProcess(true, m_pingTimestamp);
+}
+
 void X11Window::killProcess(bool ask, xcb_timestamp_t timestamp)
 {
     if (m_killPrompt && m_killPrompt->isRunning()) {
@@ -4993,7 +5037,10 @@ void X11Window::getWmOpaqueRegion()
     for (const auto &r : rects) {
         new_opaque_region += Xcb::fromXNative(QRect(r.pos.x, r.pos.y, r.size.width, r.size.height)).toRect();
     }
-    opaque_region = new_opaque_region;
+    if (opaque_region != new_opaque_region) {
+        opaque_region = new_opaque_region;
+        Q_EMIT opaqueRegionChanged();
+    }
 }
 
 QList<QRectF> X11Window::shapeRegion() const
@@ -202,9 +202,18 @@ public:
     /// Updates visibility depending on being shaded, virtual desktop, etc.
     void updateVisibility();
     bool hiddenPreview() const; ///< Window is mapped in order to get a window pixmap
+    /**
+     * Whether the frame is mapped according to the mapping state. Inside of a visibility
+     * transaction the map or unmap request may not have been sent yet.
+     */
+    bool isFrameMapped() const;
+    /// Maps or unmaps the frame according to the mapping state, see Workspace::commitVisibilityTransaction()
+    void syncFrameMapping();
 
     bool setupCompositing() override;
     void finishCompositing() override;
+    void suspendCompositing() override;
+    void resumeCompositing() override;
     void setBlockingCompositing(bool block);
     void blockCompositing();
     void unblockCompositing();
@@ -231,6 +240,15 @@ public:
     void restackWindow(xcb_window_t above, int detail, NET::RequestSource source, xcb_timestamp_t timestamp);
 
     void gotPing(xcb_timestamp_t timestamp);
+    /**
+     * Called by the PingScheduler when the window stops or starts answering pings.
+     */
+    void setPingTimedOut(bool timedOut);
+    /**
+     * Called by the PingScheduler when the process of this window has to be asked to be killed.
+     */
+    void requestKillPrompt();
+    void sendPing();
 
     void updateUserTime(xcb_timestamp_t time = XCB_TIME_CURRENT_TIME);
     xcb_timestamp_t userTime() const override;
@@ -354,6 +372,7 @@ protected:
 
 Q_SIGNALS:
     void shapeChanged();
+    void opaqueRegionChanged();
 
 private:
     void exportMappingState(int s); // ICCCM 4.1.3.1, 4.1.4, NETWM 2.5.1
@@ -406,6 +425,7 @@ private:
     void map();
     void unmap();
     void updateHiddenPreview();
+    void exportHiddenState(bool hidden);
 
     void updateInputShape();
     void configure(const QRect &nativeFrame, const QRect &nativeWrapper, const QRect &nativeClient);
@@ -490,7 +510,6 @@ private:
     MaximizeMode max_mode;
     QString cap_normal, cap_iconic, cap_suffix;
     Group *in_group;
-    QTimer *ping_timer;
     std::unique_ptr<KillPrompt> m_killPrompt;
     xcb_timestamp_t m_pingTimestamp;
     xcb_timestamp_t m_userTime;
@@ -642,6 +661,11 @@ inline bool X11Window::hiddenPreview() const
     return mapping_state == Kept;
 }
 
+inline bool X11Window::isFrameMapped() const
+{
+    return mapping_state == Mapped || mapping_state == Kept;
+}
+
 inline quint64 X11Window::surfaceSerial() const
 {
     return m_surfaceSerial;
@@ -0,0 +1,1153 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 Sonic-DE contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+/*
+ * This is a benchmark driver for the X11 compositor.
+ *
+ * It starts a private Xvfb server, runs kwin_x11 on it with Mesa's llvmpipe software renderer and
+ * creates synthetic X clients that map a grid of windows and damage them in fixed patterns. After
+ * each scenario, the frame timings that kwin collected are fetched over D-Bus. A stack of ARGB
+ * windows that don't draw any translucent pixels shows how much painting the occlusion culling
+ * saves. Translucent windows that ask for the background to be blurred are painted once with the
+ * configured blur quality and once with the adaptive quality of the blur effect. Many windows are
+ * opened and closed together, so the scale effect animates all of them at once. The window
+ * switcher is opened repeatedly by moving the pointer into the screen corner that it is assigned
+ * to, and the time until it painted its first frame is collected. Finally, more
+ * windows are spread over several virtual desktops, which are switched through while kwin's own
+ * measurements of the time and the X requests of each switch are collected. The results are
+ * written as JSON with sorted keys and without any timestamps, so runs from different commits
+ * can be compared with:
+ *
+ *     compositorbenchmark --compare baseline.json current.json
+ *
+ * The driver has to run inside its own D-Bus session, e.g. via the compositor-benchmark target:
+ *
+ *     dbus-run-session -- compositorbenchmark --kwin bin/kwin_x11 --output results.json
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusInterface>
+#include <QDBusMessage>
+#include <QDBusReply>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPoint>
+#include <QProcess>
+#include <QRect>
+#include <QSize>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <xcb/xcb.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+using namespace std::chrono_literals;
+
+static const int s_schemaVersion = 1;
+static const std::chrono::microseconds s_frameInterval(16667);
+static const int s_desktopCount = 4;
+static const int s_stackDepth = 8;
+// kwin answers quickly unless it's stuck, a poll must not block for the default D-Bus timeout
+static const int s_dbusTimeout = 2000;
+
+static bool waitFor(const std::function<bool()> &condition, std::chrono::milliseconds timeout)
+{
+    QDeadlineTimer deadline(timeout);
+    while (!condition()) {
+        if (deadline.hasExpired()) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        QThread::msleep(10);
+    }
+    return true;
+}
+
+struct Options
+{
+    QString kwin;
+    QSize screenSize;
+    int windowCount = 0;
+    int frameCount = 0;
+    int suspendCycles = 0;
+    int tabBoxCycles = 0;
+    int switchWindowCount = 0;
+    int desktopSwitches = 0;
+    int scaleWindowCount = 0;
+    QStringList effects;
+    QString renderThreads;
+};
+
+class SyntheticClients
+{
+public:
+    ~SyntheticClients();
+
+    bool connect(const QString &display);
+    void mapWindows(const QSize &screenSize, int count);
+    void mapDesktopWindows(const QSize &screenSize, int count, int desktopCount);
+    void mapArgbStack(const QSize &screenSize, int count);
+    void mapBlurredWindows(const QSize &screenSize);
+    void unmapBlurredWindows();
+    void mapScaleWindows(const QSize &screenSize, int count);
+    void setScaleWindowsMapped(bool mapped);
+    void destroyScaleWindows();
+    void setCurrentDesktop(int desktop);
+    void setBlockingCompositing(bool block);
+    void setMapped(int index, bool mapped);
+    void warpPointer(const QPoint &position);
+    void flush();
+
+    /**
+     * Returns whether kwin manages all windows that are mapped, i.e. lists them in
+     * _NET_CLIENT_LIST.
+     */
+    bool isManaged();
+
+    void scroll(int tick);
+    void blink(int tick);
+    void fullUpdate(int tick);
+    void updateStack(int tick);
+
+private:
+    struct ClientWindow
+    {
+        xcb_window_t window;
+        xcb_gcontext_t gc;
+    };
+
+    void fill(const ClientWindow &window, uint32_t pixel, int16_t x, int16_t y, uint16_t width, uint16_t height);
+    xcb_atom_t atom(const char *name);
+    xcb_visualid_t argbVisual() const;
+
+    xcb_connection_t *m_connection = nullptr;
+    xcb_screen_t *m_screen = nullptr;
+    QList<ClientWindow> m_windows;
+    QList<ClientWindow> m_stack;
+    QList<xcb_window_t> m_blurredWindows;
+    QList<xcb_window_t> m_scaleWindows;
+    QList<xcb_window_t> m_mappedWindows;
+    QSize m_windowSize;
+    QSize m_stackSize;
+};
+
+SyntheticClients::~SyntheticClients()
+{
+    if (m_connection) {
+        xcb_disconnect(m_connection);
+    }
+}
+
+bool SyntheticClients::connect(const QString &display)
+{
+    int screenNumber = 0;
+    m_connection = xcb_connect(display.toLatin1().constData(), &screenNumber);
+    if (xcb_connection_has_error(m_connection)) {
+        return false;
+    }
+    auto it = xcb_setup_roots_iterator(xcb_get_setup(m_connection));
+    for (int i = 0; i < screenNumber; ++i) {
+        xcb_screen_next(&it);
+    }
+    m_screen = it.data;
+    return true;
+}
+
+void SyntheticClients::mapWindows(const QSize &screenSize, int count)
+{
+    // lay the windows out in a grid that covers the whole screen, so they all stay visible
+    int columns = 1;
+    while (columns * columns < count) {
+        columns++;
+    }
+    const int rows = (count + columns - 1) / columns;
+    m_windowSize = QSize(screenSize.width() / columns, screenSize.height() / rows);
+
+    static const char windowClass[] = "kwin-benchmark\0kwin-benchmark";
+    for (int i = 0; i < count; ++i) {
+        const ClientWindow window{
+            .window = xcb_generate_id(m_connection),
+            .gc = xcb_generate_id(m_connection),
+        };
+        const uint32_t background = m_screen->black_pixel;
+        xcb_create_window(m_connection, XCB_COPY_FROM_PARENT, window.window, m_screen->root,
+                          (i % columns) * m_windowSize.width(), (i / columns) * m_windowSize.height(),
+                          m_windowSize.width(), m_windowSize.height(), 0, XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          m_screen->root_visual, XCB_CW_BACK_PIXEL, &background);
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, window.window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                            sizeof(windowClass), windowClass);
+        xcb_create_gc(m_connection, window.gc, window.window, XCB_GC_FOREGROUND, &background);
+        xcb_map_window(m_connection, window.window);
+        m_windows.append(window);
+        m_mappedWindows.append(window.window);
+    }
+    flush();
+}
+
+void SyntheticClients::mapDesktopWindows(const QSize &screenSize, int count, int desktopCount)
+{
+    // overlapping windows, spread round robin over the desktops, like a busy session
+    const xcb_atom_t desktopAtom = atom("_NET_WM_DESKTOP");
+    if (desktopAtom == XCB_ATOM_NONE) {
+        return;
+    }
+    const QSize size(screenSize.width() / 2, screenSize.height() / 2);
+    static const char windowClass[] = "kwin-benchmark\0kwin-benchmark";
+    for (int i = 0; i < count; ++i) {
+        const xcb_window_t window = xcb_generate_id(m_connection);
+        const uint32_t background = m_screen->white_pixel;
+        xcb_create_window(m_connection, XCB_COPY_FROM_PARENT, window, m_screen->root,
+                          (i * 37) % (screenSize.width() - size.width()), (i * 23) % (screenSize.height() - size.height()),
+                          size.width(), size.height(), 0, XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          m_screen->root_visual, XCB_CW_BACK_PIXEL, &background);
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                            sizeof(windowClass), windowClass);
+        const uint32_t desktop = i % desktopCount;
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, window, desktopAtom, XCB_ATOM_CARDINAL, 32, 1, &desktop);
+        xcb_map_window(m_connection, window);
+        m_mappedWindows.append(window);
+    }
+    flush();
+}
+
+void SyntheticClients::mapArgbStack(const QSize &screenSize, int count)
+{
+    // like browsers and media players, the windows use an ARGB visual but are opaque
+    const xcb_visualid_t visual = argbVisual();
+    if (visual == XCB_NONE) {
+        qWarning() << "The X server has no ARGB visual";
+        return;
+    }
+
+    const xcb_colormap_t colormap = xcb_generate_id(m_connection);
+    xcb_create_colormap(m_connection, XCB_COLORMAP_ALLOC_NONE, colormap, m_screen->root, visual);
+
+    // all windows have the same geometry, only the topmost one is visible
+    m_stackSize = QSize(screenSize.width() / 2, screenSize.height() / 2);
+    static const char windowClass[] = "kwin-benchmark\0kwin-benchmark";
+    for (int i = 0; i < count; ++i) {
+        const ClientWindow window{
+            .window = xcb_generate_id(m_connection),
+            .gc = xcb_generate_id(m_connection),
+        };
+        const uint32_t background = 0xff000000;
+        const uint32_t values[] = {background, 0, colormap};
+        xcb_create_window(m_connection, 32, window.window, m_screen->root,
+                          screenSize.width() / 4, screenSize.height() / 4, m_stackSize.width(), m_stackSize.height(), 0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT, visual, XCB_CW_BACK_PIXEL | XCB_CW_BORDER_PIXEL | XCB_CW_COLORMAP, values);
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, window.window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                            sizeof(windowClass), windowClass);
+        xcb_create_gc(m_connection, window.gc, window.window, XCB_GC_FOREGROUND, &background);
+        xcb_map_window(m_connection, window.window);
+        m_stack.append(window);
+        m_mappedWindows.append(window.window);
+    }
+    flush();
+}
+
+void SyntheticClients::mapBlurredWindows(const QSize &screenSize)
+{
+    // like a panel and terminals with a translucent background, the windows over the grid ask
+    // kwin to blur what is behind them
+    const xcb_visualid_t visual = argbVisual();
+    if (visual == XCB_NONE) {
+        qWarning() << "The X server has no ARGB visual";
+        return;
+    }
+    const xcb_atom_t blurAtom = atom("_KDE_NET_WM_BLUR_BEHIND_REGION");
+    if (blurAtom == XCB_ATOM_NONE) {
+        return;
+    }
+
+    const xcb_colormap_t colormap = xcb_generate_id(m_connection);
+    xcb_create_colormap(m_connection, XCB_COLORMAP_ALLOC_NONE, colormap, m_screen->root, visual);
+
+    const int panelHeight = 48;
+    const QList<QRect> geometries{
+        QRect(0, screenSize.height() - panelHeight, screenSize.width(), panelHeight),
+        QRect(screenSize.width() / 8, screenSize.height() / 8, screenSize.width() / 2, screenSize.height() / 2),
+        QRect(screenSize.width() * 3 / 8, screenSize.height() / 4, screenSize.width() / 2, screenSize.height() / 2),
+        QRect(screenSize.width() / 4, screenSize.height() * 3 / 8, screenSize.width() / 2, screenSize.height() / 2),
+    };
+    static const char windowClass[] = "kwin-benchmark\0kwin-benchmark";
+    for (const QRect &geometry : geometries) {
+        const xcb_window_t window = xcb_generate_id(m_connection);
+        const uint32_t values[] = {0x80202020, 0, colormap};
+        xcb_create_window(m_connection, 32, window, m_screen->root,
+                          geometry.x(), geometry.y(), geometry.width(), geometry.height(), 0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT, visual, XCB_CW_BACK_PIXEL | XCB_CW_BORDER_PIXEL | XCB_CW_COLORMAP, values);
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                            sizeof(windowClass), windowClass);
+        const uint32_t region[] = {0, 0, uint32_t(geometry.width()), uint32_t(geometry.height())};
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, window, blurAtom, XCB_ATOM_CARDINAL, 32, 4, region);
+        xcb_map_window(m_connection, window);
+        m_blurredWindows.append(window);
+        m_mappedWindows.append(window);
+    }
+    flush();
+}
+
+void SyntheticClients::unmapBlurredWindows()
+{
+    for (const xcb_window_t window : std::as_const(m_blurredWindows)) {
+        xcb_destroy_window(m_connection, window);
+        m_mappedWindows.removeOne(window);
+    }
+    m_blurredWindows.clear();
+    flush();
+}
+
+void SyntheticClients::mapScaleWindows(const QSize &screenSize, int count)
+{
+    // small overlapping windows, so that most of them are visible while they are animated
+    const QSize size(screenSize.width() / 4, screenSize.height() / 4);
+    static const char windowClass[] = "kwin-benchmark\0kwin-benchmark";
+    for (int i = 0; i < count; ++i) {
+        const xcb_window_t window = xcb_generate_id(m_connection);
+        const uint32_t background = m_screen->white_pixel;
+        xcb_create_window(m_connection, XCB_COPY_FROM_PARENT, window, m_screen->root,
+                          (i * 53) % (screenSize.width() - size.width()), (i * 31) % (screenSize.height() - size.height()),
+                          size.width(), size.height(), 0, XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          m_screen->root_visual, XCB_CW_BACK_PIXEL, &background);
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                            sizeof(windowClass), windowClass);
+        m_scaleWindows.append(window);
+    }
+    setScaleWindowsMapped(true);
+}
+
+void SyntheticClients::setScaleWindowsMapped(bool mapped)
+{
+    for (const xcb_window_t window : std::as_const(m_scaleWindows)) {
+        if (mapped) {
+            xcb_map_window(m_connection, window);
+            if (!m_mappedWindows.contains(window)) {
+                m_mappedWindows.append(window);
+            }
+        } else {
+            xcb_unmap_window(m_connection, window);
+            m_mappedWindows.removeOne(window);
+        }
+    }
+    flush();
+}
+
+void SyntheticClients::destroyScaleWindows()
+{
+    for (const xcb_window_t window : std::as_const(m_scaleWindows)) {
+        xcb_destroy_window(m_connection, window);
+        m_mappedWindows.removeOne(window);
+    }
+    m_scaleWindows.clear();
+    flush();
+}
+
+void SyntheticClients::setCurrentDesktop(int desktop)
+{
+    // like a pager does it, see the _NET_CURRENT_DESKTOP section of the EWMH spec
+    xcb_client_message_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.response_type = XCB_CLIENT_MESSAGE;
+    event.format = 32;
+    event.window = m_screen->root;
+    event.type = atom("_NET_CURRENT_DESKTOP");
+    event.data.data32[0] = desktop;
+    event.data.data32[1] = XCB_CURRENT_TIME;
+    xcb_send_event(m_connection, false, m_screen->root, XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT,
+                   reinterpret_cast<const char *>(&event));
+    flush();
+}
+
+void SyntheticClients::setBlockingCompositing(bool block)
+{
+    if (m_windows.isEmpty()) {
+        return;
+    }
+    const xcb_atom_t blockAtom = atom("_KDE_NET_WM_BLOCK_COMPOSITING");
+    if (blockAtom == XCB_ATOM_NONE) {
+        return;
+    }
+    if (block) {
+        const uint32_t value = 1;
+        xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, m_windows.first().window, blockAtom, XCB_ATOM_CARDINAL, 32, 1, &value);
+    } else {
+        xcb_delete_property(m_connection, m_windows.first().window, blockAtom);
+    }
+    flush();
+}
+
+void SyntheticClients::setMapped(int index, bool mapped)
+{
+    const xcb_window_t window = m_windows[index % m_windows.size()].window;
+    if (mapped) {
+        xcb_map_window(m_connection, window);
+        if (!m_mappedWindows.contains(window)) {
+            m_mappedWindows.append(window);
+        }
+    } else {
+        xcb_unmap_window(m_connection, window);
+        m_mappedWindows.removeOne(window);
+    }
+}
+
+void SyntheticClients::warpPointer(const QPoint &position)
+{
+    xcb_warp_pointer(m_connection, XCB_WINDOW_NONE, m_screen->root, 0, 0, 0, 0, position.x(), position.y());
+    flush();
+}
+
+void SyntheticClients::flush()
+{
+    xcb_flush(m_connection);
+}
+
+bool SyntheticClients::isManaged()
+{
+    const xcb_atom_t clientListAtom = atom("_NET_CLIENT_LIST");
+    if (clientListAtom == XCB_ATOM_NONE) {
+        return false;
+    }
+    const xcb_get_property_cookie_t cookie = xcb_get_property(m_connection, false, m_screen->root, clientListAtom, XCB_ATOM_WINDOW, 0, 0x10000);
+    xcb_get_property_reply_t *reply = xcb_get_property_reply(m_connection, cookie, nullptr);
+    if (!reply) {
+        return false;
+    }
+    const auto clients = reinterpret_cast<const xcb_window_t *>(xcb_get_property_value(reply));
+    const int clientCount = xcb_get_property_value_length(reply) / sizeof(xcb_window_t);
+    const QList<xcb_window_t> clientList(clients, clients + clientCount);
+    free(reply);
+
+    return std::all_of(m_mappedWindows.cbegin(), m_mappedWindows.cend(), [&clientList](xcb_window_t window) {
+        return clientList.contains(window);
+    });
+}
+
+void SyntheticClients::fill(const ClientWindow &window, uint32_t pixel, int16_t x, int16_t y, uint16_t width, uint16_t height)
+{
+    xcb_change_gc(m_connection, window.gc, XCB_GC_FOREGROUND, &pixel);
+    const xcb_rectangle_t rectangle{x, y, width, height};
+    xcb_poly_fill_rectangle(m_connection, window.window, window.gc, 1, &rectangle);
+}
+
+void SyntheticClients::updateStack(int tick)
+{
+    // every window of the stack is updated completely, the alpha channel stays opaque
+    for (int i = 0; i < m_stack.size(); ++i) {
+        fill(m_stack[i], 0xff000000 | (((tick + i) * 0x030507) & 0xffffff), 0, 0, m_stackSize.width(), m_stackSize.height());
+    }
+}
+
+xcb_atom_t SyntheticClients::atom(const char *name)
+{
+    xcb_intern_atom_reply_t *reply = xcb_intern_atom_reply(m_connection, xcb_intern_atom(m_connection, false, strlen(name), name), nullptr);
+    if (!reply) {
+        return XCB_ATOM_NONE;
+    }
+    const xcb_atom_t atom = reply->atom;
+    free(reply);
+    return atom;
+}
+
+xcb_visualid_t SyntheticClients::argbVisual() const
+{
+    for (auto depths = xcb_screen_allowed_depths_iterator(m_screen); depths.rem; xcb_depth_next(&depths)) {
+        if (depths.data->depth != 32) {
+            continue;
+        }
+        for (auto visuals = xcb_depth_visuals_iterator(depths.data); visuals.rem; xcb_visualtype_next(&visuals)) {
+            if (visuals.data->_class == XCB_VISUAL_CLASS_TRUE_COLOR) {
+                return visuals.data->visual_id;
+            }
+        }
+    }
+    return XCB_NONE;
+}
+
+void SyntheticClients::scroll(int tick)
+{
+    // like a terminal or a web page being scrolled, everything moves up by a line
+    const int line = 16;
+    const uint16_t width = m_windowSize.width();
+    const uint16_t height = m_windowSize.height();
+    for (const ClientWindow &window : std::as_const(m_windows)) {
+        xcb_copy_area(m_connection, window.window, window.window, window.gc, 0, line, 0, 0, width, height - line);
+        fill(window, (tick * 0x101010) & 0xffffff, 0, height - line, width, line);
+    }
+}
+
+void SyntheticClients::blink(int tick)
+{
+    // like blinking text cursors, only a tiny area of each window changes
+    const uint32_t pixel = tick % 2 ? 0xffffff : 0x000000;
+    for (const ClientWindow &window : std::as_const(m_windows)) {
+        fill(window, pixel, m_windowSize.width() / 2 - 8, m_windowSize.height() / 2 - 8, 2, 16);
+    }
+}
+
+void SyntheticClients::fullUpdate(int tick)
+{
+    // like videos being played, every window is updated completely in every frame
+    for (int i = 0; i < m_windows.size(); ++i) {
+        fill(m_windows[i], ((tick + i) * 0x030507) & 0xffffff, 0, 0, m_windowSize.width(), m_windowSize.height());
+    }
+}
+
+class CompositorBenchmark
+{
+public:
+    explicit CompositorBenchmark(const Options &options);
+    ~CompositorBenchmark();
+
+    /**
+     * Runs all scenarios. Returns @c false if kwin couldn't be started or a scenario didn't
+     * complete, the results of the other scenarios are filled in then.
+     */
+    bool run(QJsonObject *results);
+
+private:
+    bool startXvfb();
+    bool startKWin();
+    bool writeConfig(bool adaptiveBlur);
+    void stop();
+
+    /**
+     * Waits until @p condition is met, kwin exited or @p timeout expired. Returns whether the
+     * condition was met while kwin was running.
+     */
+    bool waitForKWin(const std::function<bool()> &condition, std::chrono::milliseconds timeout);
+    /**
+     * Waits until kwin manages all mapped windows, the scenarios start out with them in place.
+     */
+    bool waitForWindows();
+    void fail(const QString &message);
+
+    QJsonObject runDamageScenario(const std::function<void(int tick)> &damage);
+    QJsonObject runSuspendScenario();
+    QJsonObject runTabBoxScenario();
+    QJsonObject runOcclusionScenario();
+    void runBlurScenarios(QJsonObject *scenarios);
+    QJsonObject runScaleScenario();
+    QJsonObject runDesktopSwitchScenario();
+
+    void resetFrameStatistics();
+    QJsonObject frameStatistics();
+
+    Options m_options;
+    QTemporaryDir m_configDirectory;
+    QProcess m_xvfb;
+    QProcess m_kwin;
+    QString m_display;
+    SyntheticClients m_clients;
+    bool m_complete = true;
+};
+
+CompositorBenchmark::CompositorBenchmark(const Options &options)
+    : m_options(options)
+{
+}
+
+CompositorBenchmark::~CompositorBenchmark()
+{
+    stop();
+}
+
+bool CompositorBenchmark::startXvfb()
+{
+    // Xvfb picks a free display and writes its number to stdout
+    m_xvfb.setProgram(QStringLiteral("Xvfb"));
+    m_xvfb.setArguments({
+        QStringLiteral("-displayfd"),
+        QStringLiteral("1"),
+        QStringLiteral("-screen"),
+        QStringLiteral("0"),
+        QStringLiteral("%1x%2x24").arg(m_options.screenSize.width()).arg(m_options.screenSize.height()),
+        QStringLiteral("-nolisten"),
+        QStringLiteral("tcp"),
+        QStringLiteral("-noreset"),
+        QStringLiteral("+extension"),
+        QStringLiteral("GLX"),
+    });
+    m_xvfb.start();
+    if (!m_xvfb.waitForStarted()) {
+        qWarning() << "Failed to start Xvfb:" << m_xvfb.errorString();
+        return false;
+    }
+
+    QByteArray output;
+    const bool ready = waitFor([this, &output]() {
+        output += m_xvfb.readAllStandardOutput();
+        return output.contains('\n') || m_xvfb.state() != QProcess::Running;
+    },
+                               10s);
+    if (!ready || m_xvfb.state() != QProcess::Running) {
+        qWarning() << "Xvfb didn't start:" << m_xvfb.readAllStandardError();
+        return false;
+    }
+    m_display = QLatin1Char(':') + QString::fromLatin1(output.trimmed());
+    return true;
+}
+
+bool CompositorBenchmark::startKWin()
+{
+    if (!writeConfig(false)) {
+        return false;
+    }
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("DISPLAY"), m_display);
+    environment.insert(QStringLiteral("XDG_CONFIG_HOME"), m_configDirectory.path());
+    environment.insert(QStringLiteral("LIBGL_ALWAYS_SOFTWARE"), QStringLiteral("1"));
+    environment.insert(QStringLiteral("GALLIUM_DRIVER"), QStringLiteral("llvmpipe"));
+    environment.insert(QStringLiteral("LP_NUM_THREADS"), m_options.renderThreads);
+    environment.insert(QStringLiteral("KWIN_COMPOSE"), QStringLiteral("O2"));
+    environment.remove(QStringLiteral("WAYLAND_DISPLAY"));
+
+    m_kwin.setProcessEnvironment(environment);
+    m_kwin.setProgram(m_options.kwin);
+    m_kwin.setArguments({QStringLiteral("--replace")});
+    m_kwin.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    m_kwin.start();
+    if (!m_kwin.waitForStarted()) {
+        qWarning() << "Failed to start" << m_options.kwin << m_kwin.errorString();
+        return false;
+    }
+
+    const bool active = waitForKWin([]() {
+        QDBusInterface compositor(QStringLiteral("org.kde.KWin"), QStringLiteral("/Compositor"), QStringLiteral("org.kde.kwin.Compositing"));
+        compositor.setTimeout(s_dbusTimeout);
+        return compositor.isValid() && compositor.property("active").toBool();
+    },
+                                    30s);
+    if (!active) {
+        qWarning() << "kwin_x11 didn't start compositing";
+        return false;
+    }
+    return true;
+}
+
+bool CompositorBenchmark::writeConfig(bool adaptiveBlur)
+{
+    // start from the default configuration, with compositing forced to OpenGL on llvmpipe
+    QFile kwinrc(m_configDirectory.filePath(QStringLiteral("kwinrc")));
+    if (!kwinrc.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    kwinrc.write("[Compositing]\nEnabled=true\nBackend=OpenGL\nWindowsBlockCompositing=true\n");
+    kwinrc.write(QStringLiteral("[Desktops]\nNumber=%1\nRows=1\n").arg(s_desktopCount).toLatin1());
+    // the window switcher is toggled by the bottom right corner, which activates without any delay
+    kwinrc.write("[TabBox]\nBorderActivate=3\n");
+    kwinrc.write("[Windows]\nElectricBorderDelay=0\nElectricBorderCooldown=0\nElectricBorderPushbackPixels=0\n");
+    kwinrc.write(QStringLiteral("[Effect-blur]\nAdaptiveQuality=%1\n").arg(adaptiveBlur ? QStringLiteral("true") : QStringLiteral("false")).toLatin1());
+    return true;
+}
+
+void CompositorBenchmark::stop()
+{
+    if (m_kwin.state() != QProcess::NotRunning) {
+        m_kwin.terminate();
+        if (!m_kwin.waitForFinished(5000)) {
+            m_kwin.kill();
+            m_kwin.waitForFinished();
+        }
+    }
+    if (m_xvfb.state() != QProcess::NotRunning) {
+        m_xvfb.terminate();
+        m_xvfb.waitForFinished();
+    }
+}
+
+bool CompositorBenchmark::waitForKWin(const std::function<bool()> &condition, std::chrono::milliseconds timeout)
+{
+    const bool met = waitFor([this, &condition]() {
+        return m_kwin.state() != QProcess::Running || condition();
+    },
+                             timeout);
+    if (m_kwin.state() != QProcess::Running) {
+        qWarning() << "kwin_x11 exited with" << m_kwin.exitCode();
+        return false;
+    }
+    return met;
+}
+
+bool CompositorBenchmark::waitForWindows()
+{
+    const bool managed = waitForKWin([this]() {
+        return m_clients.isManaged();
+    },
+                                     10s);
+    if (!managed) {
+        fail(QStringLiteral("kwin didn't manage the benchmark windows"));
+    }
+    return managed;
+}
+
+void CompositorBenchmark::fail(const QString &message)
+{
+    qWarning().noquote() << message;
+    m_complete = false;
+}
+
+void CompositorBenchmark::resetFrameStatistics()
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral("org.kde.KWin"), QStringLiteral("/Compositor"),
+                                                                QStringLiteral("org.kde.kwin.Compositing"), QStringLiteral("resetFrameStatistics"));
+    QDBusConnection::sessionBus().call(message, QDBus::Block, s_dbusTimeout);
+}
+
+QJsonObject CompositorBenchmark::frameStatistics()
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral("org.kde.KWin"), QStringLiteral("/Compositor"),
+                                                                QStringLiteral("org.kde.kwin.Compositing"), QStringLiteral("frameStatistics"));
+    const QDBusReply<QString> reply = QDBusConnection::sessionBus().call(message, QDBus::Block, s_dbusTimeout);
+    if (!reply.isValid()) {
+        qWarning() << "Failed to fetch the frame statistics:" << reply.error().message();
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(reply.value().toUtf8()).object();
+}
+
+QJsonObject CompositorBenchmark::runDamageScenario(const std::function<void(int tick)> &damage)
+{
+    // let the previous scenario settle, so its frames don't leak into this one
+    QThread::msleep(500);
+    QCoreApplication::processEvents();
+    resetFrameStatistics();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int tick = 0; tick < m_options.frameCount; ++tick) {
+        damage(tick);
+        m_clients.flush();
+
+        const auto deadline = s_frameInterval * (tick + 1);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(timer.durationElapsed());
+        if (elapsed < deadline) {
+            QThread::usleep((deadline - elapsed).count());
+        }
+        QCoreApplication::processEvents();
+    }
+    QThread::msleep(100);
+
+    return frameStatistics()[QStringLiteral("outputs")].toObject();
+}
+
+QJsonObject CompositorBenchmark::runSuspendScenario()
+{
+    // the compositor is suspended by a window that blocks compositing, e.g. a fullscreen game
+    QThread::msleep(500);
+    QJsonArray suspendLatencies;
+    QJsonArray resumeLatencies;
+    for (int i = 0; i < m_options.suspendCycles; ++i) {
+        const QJsonObject before = frameStatistics()[QStringLiteral("compositingToggles")].toObject();
+
+        m_clients.setBlockingCompositing(true);
+        QJsonObject toggles;
+        const bool suspended = waitForKWin([this, &before, &toggles]() {
+            toggles = frameStatistics()[QStringLiteral("compositingToggles")].toObject();
+            return toggles[QStringLiteral("warmSuspends")].toInt() > before[QStringLiteral("warmSuspends")].toInt();
+        },
+                                           5s);
+
+        m_clients.setBlockingCompositing(false);
+        const bool resumed = waitForKWin([this, &before, &toggles]() {
+            toggles = frameStatistics()[QStringLiteral("compositingToggles")].toObject();
+            return toggles[QStringLiteral("warmResumes")].toInt() > before[QStringLiteral("warmResumes")].toInt();
+        },
+                                         5s);
+
+        if (!suspended || !resumed) {
+            fail(QStringLiteral("Compositing wasn't suspended and resumed warmly, is KWIN_X11_NO_WARM_SUSPEND set?"));
+            break;
+        }
+        suspendLatencies.append(toggles[QStringLiteral("lastSuspendUs")]);
+        resumeLatencies.append(toggles[QStringLiteral("lastResumeUs")]);
+    }
+
+    return QJsonObject{
+        {QStringLiteral("cycles"), suspendLatencies.size()},
+        {QStringLiteral("suspendUs"), suspendLatencies},
+        {QStringLiteral("resumeUs"), resumeLatencies},
+    };
+}
+
+QJsonObject CompositorBenchmark::runTabBoxScenario()
+{
+    const QPoint corner(m_options.screenSize.width() - 1, m_options.screenSize.height() - 1);
+    const QPoint center(m_options.screenSize.width() / 2, m_options.screenSize.height() / 2);
+    m_clients.warpPointer(center);
+    QThread::msleep(500);
+
+    QJsonArray firstFrames;
+    QJsonObject tabBox;
+    for (int i = 0; i < m_options.tabBoxCycles; ++i) {
+        const int before = frameStatistics()[QStringLiteral("tabBox")][QStringLiteral("count")].toInt();
+        m_clients.warpPointer(corner);
+        const bool shown = waitForKWin([this, before, &tabBox]() {
+            tabBox = frameStatistics()[QStringLiteral("tabBox")].toObject();
+            return tabBox[QStringLiteral("count")].toInt() > before;
+        },
+                                       5s);
+        if (!shown) {
+            fail(QStringLiteral("The window switcher didn't show up, is a switcher layout installed?"));
+            break;
+        }
+        firstFrames.append(tabBox[QStringLiteral("lastFirstFrameUs")]);
+
+        // touching the corner again after the cooldown accepts the selection and closes the switcher
+        m_clients.warpPointer(center);
+        QThread::msleep(500);
+        m_clients.warpPointer(corner);
+        QThread::msleep(100);
+        m_clients.warpPointer(center);
+        QThread::msleep(500);
+    }
+
+    return QJsonObject{
+        {QStringLiteral("cycles"), firstFrames.size()},
+        {QStringLiteral("coldShows"), tabBox[QStringLiteral("coldCount")]},
+        {QStringLiteral("firstFrameUs"), firstFrames},
+    };
+}
+
+QJsonObject CompositorBenchmark::runOcclusionScenario()
+{
+    m_clients.mapArgbStack(m_options.screenSize, s_stackDepth);
+    // once kwin manages the windows, give it the time to sample their alpha channels
+    if (!waitForWindows()) {
+        return QJsonObject();
+    }
+    QThread::sleep(1);
+
+    QJsonObject outputs = runDamageScenario([this](int tick) {
+        m_clients.updateStack(tick);
+    });
+    const QJsonObject occlusion = frameStatistics()[QStringLiteral("occlusion")].toObject();
+    const qint64 frames = occlusion[QStringLiteral("frames")].toInteger();
+    outputs[QStringLiteral("culledPixelsPerFrame")] = frames ? occlusion[QStringLiteral("culledPixels")].toInteger() / frames : 0;
+    return outputs;
+}
+
+void CompositorBenchmark::runBlurScenarios(QJsonObject *scenarios)
+{
+    QDBusInterface effects(QStringLiteral("org.kde.KWin"), QStringLiteral("/Effects"), QStringLiteral("org.kde.kwin.Effects"));
+    const bool wasLoaded = QDBusReply<bool>(effects.call(QStringLiteral("isEffectLoaded"), QStringLiteral("blur"))).value();
+    if (!QDBusReply<bool>(effects.call(QStringLiteral("loadEffect"), QStringLiteral("blur"))).value() && !wasLoaded) {
+        fail(QStringLiteral("Failed to load the blur effect"));
+        return;
+    }
+    effects.call(QStringLiteral("reconfigureEffect"), QStringLiteral("blur"));
+
+    m_clients.mapBlurredWindows(m_options.screenSize);
+    // once kwin manages the windows, let their open animations finish
+    if (!waitForWindows()) {
+        m_clients.unmapBlurredWindows();
+        return;
+    }
+    QThread::sleep(1);
+
+    // the windows behind the blurred ones scroll, so the blurred background changes in every frame
+    const auto scroll = [this](int tick) {
+        m_clients.scroll(tick);
+    };
+    (*scenarios)[QStringLiteral("blurFixed")] = runDamageScenario(scroll);
+
+    if (writeConfig(true)) {
+        // reconfiguring the effect also starts over at full quality with fresh statistics
+        effects.call(QStringLiteral("reconfigureEffect"), QStringLiteral("blur"));
+
+        QJsonObject outputs = runDamageScenario(scroll);
+        const QDBusReply<QString> reply = effects.call(QStringLiteral("debug"), QStringLiteral("blur"), QStringLiteral("quality"));
+        const QJsonObject quality = QJsonDocument::fromJson(reply.value().toUtf8()).object();
+        const qint64 frames = quality[QStringLiteral("frames")].toInteger();
+        outputs[QStringLiteral("degradedFramesPercent")] = frames ? quality[QStringLiteral("degradedFrames")].toInteger() * 100 / frames : 0;
+        outputs[QStringLiteral("degradations")] = quality[QStringLiteral("degradations")];
+        outputs[QStringLiteral("qualityLevel")] = quality[QStringLiteral("level")];
+        (*scenarios)[QStringLiteral("blurAdaptive")] = outputs;
+        writeConfig(false);
+    }
+
+    m_clients.unmapBlurredWindows();
+    if (!wasLoaded) {
+        effects.call(QStringLiteral("unloadEffect"), QStringLiteral("blur"));
+    } else {
+        effects.call(QStringLiteral("reconfigureEffect"), QStringLiteral("blur"));
+    }
+}
+
+QJsonObject CompositorBenchmark::runScaleScenario()
+{
+    QDBusInterface effects(QStringLiteral("org.kde.KWin"), QStringLiteral("/Effects"), QStringLiteral("org.kde.kwin.Effects"));
+    const bool wasLoaded = QDBusReply<bool>(effects.call(QStringLiteral("isEffectLoaded"), QStringLiteral("scale"))).value();
+    if (!QDBusReply<bool>(effects.call(QStringLiteral("loadEffect"), QStringLiteral("scale"))).value() && !wasLoaded) {
+        fail(QStringLiteral("Failed to load the scale effect"));
+        return QJsonObject();
+    }
+
+    m_clients.mapScaleWindows(m_options.screenSize, m_options.scaleWindowCount);
+    // once kwin manages the windows, let their open animations finish
+    if (!waitForWindows()) {
+        m_clients.destroyScaleWindows();
+        return QJsonObject();
+    }
+    QThread::sleep(1);
+
+    // all windows are closed and opened again every half second, the open and close animations
+    // only scale the windows, their contents don't change
+    const QJsonObject before = frameStatistics()[QStringLiteral("renderGeometry")].toObject();
+    QJsonObject outputs = runDamageScenario([this](int tick) {
+        if (tick % 30 == 0) {
+            m_clients.setScaleWindowsMapped(tick % 60 != 0);
+        }
+    });
+    const QJsonObject after = frameStatistics()[QStringLiteral("renderGeometry")].toObject();
+    const qint64 hits = after[QStringLiteral("hits")].toInteger() - before[QStringLiteral("hits")].toInteger();
+    const qint64 misses = after[QStringLiteral("misses")].toInteger() - before[QStringLiteral("misses")].toInteger();
+    outputs[QStringLiteral("renderGeometryHitsPercent")] = hits + misses ? hits * 100 / (hits + misses) : 0;
+
+    m_clients.destroyScaleWindows();
+    if (!wasLoaded) {
+        effects.call(QStringLiteral("unloadEffect"), QStringLiteral("scale"));
+    }
+    return outputs;
+}
+
+QJsonObject CompositorBenchmark::runDesktopSwitchScenario()
+{
+    m_clients.mapDesktopWindows(m_options.screenSize, m_options.switchWindowCount, s_desktopCount);
+    // once kwin manages the windows, let their open animations finish
+    if (!waitForWindows()) {
+        return QJsonObject();
+    }
+    QThread::sleep(1);
+
+    QJsonArray durations;
+    QJsonArray requests;
+    for (int i = 1; i <= m_options.desktopSwitches; ++i) {
+        const int before = frameStatistics()[QStringLiteral("desktopSwitches")][QStringLiteral("count")].toInt();
+        m_clients.setCurrentDesktop(i % s_desktopCount);
+
+        QJsonObject switches;
+        const bool switched = waitForKWin([this, before, &switches]() {
+            switches = frameStatistics()[QStringLiteral("desktopSwitches")].toObject();
+            return switches[QStringLiteral("count")].toInt() > before;
+        },
+                                          5s);
+        if (!switched) {
+            fail(QStringLiteral("kwin didn't switch the virtual desktop"));
+            break;
+        }
+        durations.append(switches[QStringLiteral("lastUs")]);
+        requests.append(switches[QStringLiteral("lastRequests")]);
+        // let the switch animation finish, so it doesn't slow down the next switch
+        QThread::msleep(500);
+    }
+
+    return QJsonObject{
+        {QStringLiteral("switches"), durations.size()},
+        {QStringLiteral("durationUs"), durations},
+        {QStringLiteral("requests"), requests},
+    };
+}
+
+bool CompositorBenchmark::run(QJsonObject *results)
+{
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        qWarning() << "No D-Bus session bus, run the benchmark in dbus-run-session";
+        return false;
+    }
+    if (QDBusConnection::sessionBus().interface()->isServiceRegistered(QStringLiteral("org.kde.KWin"))) {
+        qWarning() << "Another KWin is running on this session bus, run the benchmark in its own dbus-run-session";
+        return false;
+    }
+    if (!m_configDirectory.isValid() || !startXvfb() || !startKWin()) {
+        return false;
+    }
+    if (!m_clients.connect(m_display)) {
+        qWarning() << "Failed to connect to" << m_display;
+        return false;
+    }
+
+    m_clients.mapWindows(m_options.screenSize, m_options.windowCount);
+    // once kwin manages the windows, let their open animations finish
+    if (!waitForWindows()) {
+        return false;
+    }
+    QThread::sleep(1);
+
+    QJsonObject scenarios;
+    // nothing changes on an idle desktop, so effects shouldn't have to rebuild their window lists
+    const qint64 rebuildsBefore = frameStatistics()[QStringLiteral("effects")][QStringLiteral("stackingOrderRebuilds")].toInteger();
+    QJsonObject idle = runDamageScenario([](int) {});
+    idle[QStringLiteral("stackingOrderRebuilds")] = frameStatistics()[QStringLiteral("effects")][QStringLiteral("stackingOrderRebuilds")].toInteger() - rebuildsBefore;
+    scenarios[QStringLiteral("idle")] = idle;
+    scenarios[QStringLiteral("scrolling")] = runDamageScenario([this](int tick) {
+        m_clients.scroll(tick);
+    });
+    scenarios[QStringLiteral("blinking")] = runDamageScenario([this](int tick) {
+        m_clients.blink(tick);
+    });
+    scenarios[QStringLiteral("video")] = runDamageScenario([this](int tick) {
+        m_clients.fullUpdate(tick);
+    });
+    scenarios[QStringLiteral("effects")] = runDamageScenario([this](int tick) {
+        m_clients.scroll(tick);
+        if (tick % 30 == 0) {
+            QDBusInterface effects(QStringLiteral("org.kde.KWin"), QStringLiteral("/Effects"), QStringLiteral("org.kde.kwin.Effects"));
+            for (const QString &effect : std::as_const(m_options.effects)) {
+                effects.call(QStringLiteral("toggleEffect"), effect);
+            }
+        }
+        // open and close windows, so there is something for the effects to animate
+        if (tick % 10 == 0) {
+            m_clients.setMapped(tick / 20, tick % 20 != 0);
+        }
+    });
+    runBlurScenarios(&scenarios);
+    scenarios[QStringLiteral("suspendResume")] = runSuspendScenario();
+    scenarios[QStringLiteral("tabBox")] = runTabBoxScenario();
+    scenarios[QStringLiteral("occlusion")] = runOcclusionScenario();
+    scenarios[QStringLiteral("scaleAnimation")] = runScaleScenario();
+    scenarios[QStringLiteral("desktopSwitch")] = runDesktopSwitchScenario();
+    if (m_kwin.state() != QProcess::Running) {
+        fail(QStringLiteral("kwin_x11 exited during the benchmark"));
+    }
+
+    *results = QJsonObject{
+        {QStringLiteral("schemaVersion"), s_schemaVersion},
+        {QStringLiteral("configuration"), QJsonObject{
+                                              {QStringLiteral("screen"), QStringLiteral("%1x%2").arg(m_options.screenSize.width()).arg(m_options.screenSize.height())},
+                                              {QStringLiteral("windows"), m_options.windowCount},
+                                              {QStringLiteral("switchWindows"), m_options.switchWindowCount},
+                                              {QStringLiteral("scaleWindows"), m_options.scaleWindowCount},
+                                              {QStringLiteral("frames"), m_options.frameCount},
+                                              {QStringLiteral("effects"), QJsonArray::fromStringList(m_options.effects)},
+                                              {QStringLiteral("renderer"), QStringLiteral("llvmpipe")},
+                                              {QStringLiteral("renderThreads"), m_options.renderThreads},
+                                          }},
+        {QStringLiteral("scenarios"), scenarios},
+    };
+    return m_complete;
+}
+
+static QJsonObject readResults(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << fileName;
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+static int compare(const QString &baselineFileName, const QString &currentFileName)
+{
+    const QJsonObject baseline = readResults(baselineFileName)[QStringLiteral("scenarios")].toObject();
+    const QJsonObject current = readResults(currentFileName)[QStringLiteral("scenarios")].toObject();
+
+    // compare the medians, they are the least noisy
+    for (auto scenario = current.constBegin(); scenario != current.constEnd(); ++scenario) {
+        const QJsonObject outputs = scenario->toObject();
+        for (auto output = outputs.constBegin(); output != outputs.constEnd(); ++output) {
+            if (!output->isObject()) {
+                continue;
+            }
+            const QJsonObject phases = output->toObject();
+            for (auto phase = phases.constBegin(); phase != phases.constEnd(); ++phase) {
+                const double before = baseline[scenario.key()][output.key()][phase.key()][QStringLiteral("medianUs")].toDouble();
+                const double after = phase->toObject()[QStringLiteral("medianUs")].toDouble();
+                const QString change = before > 0 ? QStringLiteral("%1%").arg((after - before) / before * 100, 0, 'f', 1) : QStringLiteral("n/a");
+                std::cout << qPrintable(QStringLiteral("%1/%2/%3: %4 us -> %5 us (%6)").arg(scenario.key(), output.key(), phase.key()).arg(before).arg(after).arg(change)) << std::endl;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Benchmarks the X11 compositor of KWin under Xvfb and llvmpipe"));
+    parser.addHelpOption();
+    const QCommandLineOption kwinOption(QStringLiteral("kwin"), QStringLiteral("The kwin_x11 binary to benchmark"), QStringLiteral("path"), QStringLiteral("kwin_x11"));
+    const QCommandLineOption screenOption(QStringLiteral("screen"), QStringLiteral("The size of the virtual screen"), QStringLiteral("WxH"), QStringLiteral("1920x1080"));
+    const QCommandLineOption windowsOption(QStringLiteral("windows"), QStringLiteral("The number of windows to map"), QStringLiteral("count"), QStringLiteral("16"));
+    const QCommandLineOption framesOption(QStringLiteral("frames"), QStringLiteral("The number of frames to damage per scenario"), QStringLiteral("count"), QStringLiteral("300"));
+    const QCommandLineOption suspendOption(QStringLiteral("suspend-cycles"), QStringLiteral("The number of compositing suspend and resume cycles"), QStringLiteral("count"), QStringLiteral("10"));
+    const QCommandLineOption tabBoxOption(QStringLiteral("tabbox-cycles"), QStringLiteral("The number of times to open and close the window switcher"), QStringLiteral("count"), QStringLiteral("10"));
+    const QCommandLineOption switchWindowsOption(QStringLiteral("switch-windows"), QStringLiteral("The number of windows to spread over the virtual desktops"), QStringLiteral("count"), QStringLiteral("150"));
+    const QCommandLineOption switchesOption(QStringLiteral("desktop-switches"), QStringLiteral("The number of virtual desktop switches"), QStringLiteral("count"), QStringLiteral("20"));
+    const QCommandLineOption scaleWindowsOption(QStringLiteral("scale-windows"), QStringLiteral("The number of windows to open and close at once"), QStringLiteral("count"), QStringLiteral("100"));
+    const QCommandLineOption effectsOption(QStringLiteral("effects"), QStringLiteral("The effects to toggle, separated by commas"), QStringLiteral("names"), QStringLiteral("blur,fade,scale"));
+    const QCommandLineOption threadsOption(QStringLiteral("render-threads"), QStringLiteral("The number of llvmpipe rendering threads"), QStringLiteral("count"), QStringLiteral("1"));
+    const QCommandLineOption outputOption(QStringLiteral("output"), QStringLiteral("Write the results to this file instead of stdout"), QStringLiteral("file"));
+    const QCommandLineOption compareOption(QStringLiteral("compare"), QStringLiteral("Compare the results in the two given files instead of running the benchmark"));
+    parser.addOptions({kwinOption, screenOption, windowsOption, framesOption, suspendOption, tabBoxOption, switchWindowsOption, switchesOption, scaleWindowsOption, effectsOption, threadsOption, outputOption, compareOption});
+    parser.addPositionalArgument(QStringLiteral("files"), QStringLiteral("The baseline and the current results for --compare"), QStringLiteral("[baseline current]"));
+    parser.process(app);
+
+    if (parser.isSet(compareOption)) {
+        const QStringList files = parser.positionalArguments();
+        if (files.size() != 2) {
+            parser.showHelp(1);
+        }
+        return compare(files[0], files[1]);
+    }
+
+    const QStringList screen = parser.value(screenOption).split(QLatin1Char('x'));
+    const Options options{
+        .kwin = parser.value(kwinOption),
+        .screenSize = screen.size() == 2 ? QSize(screen[0].toInt(), screen[1].toInt()) : QSize(1920, 1080),
+        .windowCount = std::max(parser.value(windowsOption).toInt(), 1),
+        .frameCount = std::max(parser.value(framesOption).toInt(), 1),
+        .suspendCycles = std::max(parser.value(suspendOption).toInt(), 0),
+        .tabBoxCycles = std::max(parser.value(tabBoxOption).toInt(), 0),
+        .switchWindowCount = std::max(parser.value(switchWindowsOption).toInt(), 0),
+        .desktopSwitches = std::max(parser.value(switchesOption).toInt(), 0),
+        .scaleWindowCount = std::max(parser.value(scaleWindowsOption).toInt(), 0),
+        .effects = parser.value(effectsOption).split(QLatin1Char(','), Qt::SkipEmptyParts),
+        .renderThreads = parser.value(threadsOption),
+    };
+
+    QJsonObject results;
+    bool complete = false;
+    {
+        CompositorBenchmark benchmark(options);
+        complete = benchmark.run(&results);
+    }
+    if (results.isEmpty()) {
+        return 1;
+    }
+
+    const QByteArray json = QJsonDocument(results).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "Failed to write" << file.fileName();
+            return 1;
+        }
+        file.write(json);
+    } else {
+        std::cout << json.constData();
+    }
+    return complete ? 0 : 1;
+}